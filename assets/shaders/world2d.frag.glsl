@@ -8,6 +8,13 @@ layout(location=1) out uint id;
 uniform sampler2D tex;
 uniform uint u_id;
 
+// indexed textures store palette indices in the red channel
+// which are resolved with the palette lookup table
+uniform bool indexed;
+uniform sampler2D palette;
+// row in the lookup table, i.e. the player color
+uniform int palette_row;
+
 // position (top left corner) and size: (x, y, width, height)
 uniform vec4 tile_params;
 
@@ -16,8 +23,20 @@ vec2 uv = vec2(
 	vert_uv.y * tile_params.w + tile_params.y
 );
 
+vec4 get_color() {
+	if (indexed) {
+		// fetch exact texels, interpolated indices are meaningless
+		ivec2 tex_size = textureSize(tex, 0);
+		ivec2 texel = min(ivec2(uv * vec2(tex_size)), tex_size - 1);
+		int idx = int(round(texelFetch(tex, texel, 0).r * 255));
+		return texelFetch(palette, ivec2(idx, palette_row), 0);
+	}
+
+	return texture(tex, uv);
+}
+
 void main() {
-	vec4 tex_val = texture(tex, uv);
+	vec4 tex_val = get_color();
 	int alpha = int(round(tex_val.a * 255));
 	switch (alpha) {
 		case 0:
@@ -10,6 +10,7 @@
 #include "hash_functions.h"
 #include "resource.h"
 #include "../log/log.h"
+#include "../trace/trace.h"
 #include "../util/misc.h"
 
 
@@ -161,6 +162,8 @@ Sound AudioManager::get_sound(category_t category, int id) {
 
 
 void AudioManager::audio_callback(int16_t *stream, int length) {
+	TRACE_ZONE("AudioManager::audio_callback", "audio");
+
 	std::memset(mix_buffer.get(), 0, length*4);
 
 	// iterate over all categories
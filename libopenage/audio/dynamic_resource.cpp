@@ -31,7 +31,8 @@ DynamicResource::DynamicResource(AudioManager *manager,
 	preload_amount{preload_amount},
 	chunk_size{chunk_size},
 	max_chunks{max_chunks},
-	use_count{0} {}
+	use_count{0},
+	decay_queue{max_chunks} {}
 
 void DynamicResource::use() {
 	// if the resource is new in use
@@ -43,8 +44,10 @@ void DynamicResource::use() {
 		this->loading_job_group = this->manager->get_job_manager()->create_job_group();
 
 		// create the fixed amount of chunk loading buffers
+		// chunks that were still loading when the resource was last
+		// stopped may already be back in the queue
 		for (size_t i = 0; i < this->max_chunks; i++) {
-			this->decay_queue.push(
+			this->decay_queue.try_push(
 				std::make_shared<chunk_info_t>(
 					chunk_info_t::state_t::EMPTY,
 					this->chunk_size));
@@ -99,20 +102,13 @@ audio_chunk_t DynamicResource::get_data(size_t position, size_t data_length) {
 		}
 	}
 
-	// guard the .empty(), .front() and .pop() calls
-	auto chunk_info_lock = this->decay_queue.lock();
-
-	// we don't have next data to load!
-	if (this->decay_queue.empty()) {
+	// obtain a chunk info element to be used and overwritten
+	std::shared_ptr<chunk_info_t> chunk_info;
+	if (not this->decay_queue.try_pop(chunk_info)) {
+		// we don't have next data to load!
 		throw Error{ERR << "chunk decay queue ran dry, resource is dying."};
 	}
 
-	// obtain a chunk info element to be used and overwritten
-	auto chunk_info = this->decay_queue.front();
-	this->decay_queue.pop();
-
-	chunk_info_lock.unlock();
-
 	// map it to the corresponding resource offset
 	this->chunks.insert({resource_chunk_index, chunk_info});
 
@@ -153,11 +149,12 @@ void DynamicResource::start_preloading(size_t resource_chunk_index) {
 		else {
 			// chunk is unknown yet, so let's load it.
 
-			auto decay_queue_lock = this->decay_queue.lock();
 			// obtain the least-recently-used chunk to overwrite.
-			auto local_chunk_info = this->decay_queue.front();
-			this->decay_queue.pop();
-			decay_queue_lock.unlock();
+			// if all chunks are in use, preload more on the next request.
+			std::shared_ptr<chunk_info_t> local_chunk_info;
+			if (not this->decay_queue.try_pop(local_chunk_info)) {
+				break;
+			}
 
 			this->chunks.insert({resource_chunk_index, local_chunk_info});
 			this->load_chunk_async(local_chunk_info, resource_chunk_offset);
@@ -180,13 +177,14 @@ void DynamicResource::load_chunk_async(const std::shared_ptr<chunk_info_t> &chun
 		size_t loaded = this->loader->load_chunk(buffer, resource_chunk_offset, this->chunk_size);
 		if (loaded == 0) {
 			chunk_info->state.store(chunk_info_t::state_t::EMPTY);
-			this->decay_queue.push(chunk_info);
 		}
 		else {
 			chunk_info->state.store(chunk_info_t::state_t::READY);
 			chunk_info->size = loaded;
-			this->decay_queue.push(chunk_info);
 		}
+		// the queue is only full if the resource was restarted
+		// while this chunk was loading, then the chunk is dropped
+		this->decay_queue.try_push(chunk_info);
 		// as the job manager currently does not support executing void
 		// functions, we return zero
 		return 0;
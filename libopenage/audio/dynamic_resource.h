@@ -13,7 +13,7 @@
 #include "format.h"
 #include "resource.h"
 #include "types.h"
-#include "../datastructure/concurrent_queue.h"
+#include "../datastructure/mpmc_queue.h"
 #include "../job/job.h"
 #include "../job/job_group.h"
 #include "../util/path.h"
@@ -131,8 +131,11 @@ private:
 	 * This implements "forget least-recently-used chunks" when a new one
 	 * shall be loaded.
 	 * This _must_ never run empty! Otherwise the audio system will lock up.
+	 *
+	 * Chunks are pushed by the loading jobs and popped by the audio thread.
+	 * The queue holds at most `max_chunks` chunks.
 	 */
-	datastructure::ConcurrentQueue<std::shared_ptr<chunk_info_t>> decay_queue;
+	datastructure::MPMCQueue<std::shared_ptr<chunk_info_t>> decay_queue;
 
 	/**
 	 * Resource chunk index to chunk mapping.
@@ -8,6 +8,7 @@
 #include <list>
 
 #include "curve/keyframe.h"
+#include "datastructure/object_pool.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
 
@@ -36,9 +37,10 @@ public:
 	 * The underlaying container type.
 	 *
 	 * The most important property of this container is the iterator validity on
-	 * insert and remove.
+	 * insert and remove. The list nodes come from a pool, because curves
+	 * add and drop keyframes all the time.
 	 */
-	using container_t = std::list<keyframe_t>;
+	using container_t = std::list<keyframe_t, datastructure::PoolAllocator<keyframe_t>>;
 
 	/**
 	 * The iterator type to access elements in the container
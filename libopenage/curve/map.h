@@ -4,10 +4,10 @@
 
 #include <iostream>
 #include <optional>
-#include <unordered_map>
 #include <utility>
 
 #include "curve/map_filter_iterator.h"
+#include "datastructure/flat_hash_map.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
 
@@ -36,10 +36,10 @@ class UnorderedMap {
 	 * Data holder. Maps keys to map elements.
 	 * Map elements themselves store when they are valid.
 	 */
-	std::unordered_map<key_t, map_element> container;
+	datastructure::FlatHashMap<key_t, map_element> container;
 
 public:
-	using const_iterator = typename std::unordered_map<key_t, map_element>::const_iterator;
+	using const_iterator = typename datastructure::FlatHashMap<key_t, map_element>::const_iterator;
 
 	std::optional<MapFilterIterator<key_t, val_t, UnorderedMap>>
 	operator()(const time::time_t &, const key_t &) const;
@@ -0,0 +1,57 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <thread>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+namespace openage::datastructure {
+
+/**
+ * Assumed size of a cache line. Atomics that are written by different
+ * threads are aligned to it, so they don't share a line.
+ */
+constexpr size_t cache_line_size = 64;
+
+
+/**
+ * Waiting strategy for lock-free retry loops.
+ *
+ * Spins with exponentially more pause instructions first, because the
+ * other side usually makes progress within a few hundred cycles.
+ * After that, the thread yields its time slice on every wait.
+ */
+class Backoff {
+public:
+	/**
+	 * Wait before the next retry.
+	 */
+	void pause() {
+		if (this->step <= spin_limit) {
+			for (unsigned i = 0; i < (1u << this->step); i++) {
+#ifdef __SSE2__
+				_mm_pause();
+#endif
+			}
+			this->step += 1;
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	/**
+	 * Spinning stops after 2^spin_limit pauses in one wait.
+	 */
+	static constexpr unsigned spin_limit = 6;
+
+	unsigned step = 0;
+};
+
+} // namespace openage::datastructure
@@ -0,0 +1,189 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+namespace openage::datastructure {
+
+/**
+ * Unbounded lock-free queue for one producer and one consumer thread.
+ *
+ * Elements are stored in fixed-size chunks that are linked as the queue
+ * grows. Pushing never blocks and never fails. The consumer hands one
+ * drained chunk back to the producer for reuse, so a queue that is
+ * drained regularly does not allocate.
+ *
+ * \p push() must only be called from the producer thread, \p try_pop() and
+ * \p empty() only from the consumer thread.
+ *
+ * @tparam T Element type. Must be default constructible.
+ * @tparam chunk_size Number of elements per chunk.
+ */
+template <typename T, size_t chunk_size = 32>
+class ChunkedSPSCQueue {
+	static_assert(chunk_size > 0, "chunks must hold at least one element");
+
+public:
+	ChunkedSPSCQueue() :
+		head{new chunk},
+		head_pos{0},
+		tail{head},
+		tail_pos{0},
+		spare{nullptr} {}
+
+	~ChunkedSPSCQueue() {
+		while (this->head != nullptr) {
+			auto next = this->head->next.load(std::memory_order_relaxed);
+			delete this->head;
+			this->head = next;
+		}
+		delete this->spare.load(std::memory_order_relaxed);
+	}
+
+	ChunkedSPSCQueue(const ChunkedSPSCQueue &) = delete;
+	ChunkedSPSCQueue &operator=(const ChunkedSPSCQueue &) = delete;
+
+	/**
+	 * Append an element. Producer only.
+	 *
+	 * @param value Element.
+	 */
+	void push(const T &value) {
+		this->slot() = value;
+		this->publish();
+	}
+
+	/**
+	 * Append an element. Producer only.
+	 *
+	 * @param value Element.
+	 */
+	void push(T &&value) {
+		this->slot() = std::move(value);
+		this->publish();
+	}
+
+	/**
+	 * Remove the oldest element if there is one. Consumer only.
+	 *
+	 * @param value Receives the removed element.
+	 *
+	 * @return true if an element was removed, false if the queue was empty.
+	 */
+	bool try_pop(T &value) {
+		if (this->head_pos == chunk_size) {
+			auto next = this->head->next.load(std::memory_order_acquire);
+			if (next == nullptr) {
+				return false;
+			}
+
+			// the producer has moved on to the next chunk, so this one can be recycled
+			this->recycle(this->head);
+			this->head = next;
+			this->head_pos = 0;
+		}
+
+		if (this->head_pos == this->head->written.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		value = std::move(this->head->items[this->head_pos]);
+		this->head_pos += 1;
+		return true;
+	}
+
+	/**
+	 * Check if there are no elements in the queue. Consumer only.
+	 *
+	 * @return true if the queue is empty, else false.
+	 */
+	bool empty() const {
+		if (this->head_pos < chunk_size) {
+			return this->head_pos == this->head->written.load(std::memory_order_acquire);
+		}
+
+		auto next = this->head->next.load(std::memory_order_acquire);
+		return next == nullptr or next->written.load(std::memory_order_acquire) == 0;
+	}
+
+private:
+	/**
+	 * Block of queue elements.
+	 */
+	struct chunk {
+		std::array<T, chunk_size> items{};
+		/// Number of elements the producer has written to this chunk.
+		std::atomic<size_t> written{0};
+		/// Next chunk, set by the producer once this chunk is full.
+		std::atomic<chunk *> next{nullptr};
+	};
+
+	/**
+	 * Get the slot for the next element, appending a chunk if the current one is full.
+	 */
+	T &slot() {
+		if (this->tail_pos == chunk_size) {
+			auto next = this->spare.exchange(nullptr, std::memory_order_acquire);
+			if (next == nullptr) {
+				next = new chunk;
+			}
+
+			this->tail->next.store(next, std::memory_order_release);
+			this->tail = next;
+			this->tail_pos = 0;
+		}
+
+		return this->tail->items[this->tail_pos];
+	}
+
+	/**
+	 * Make the element in the current slot visible to the consumer.
+	 */
+	void publish() {
+		this->tail_pos += 1;
+		this->tail->written.store(this->tail_pos, std::memory_order_release);
+	}
+
+	/**
+	 * Hand a drained chunk back to the producer, or free it if there already is a spare chunk.
+	 */
+	void recycle(chunk *drained) {
+		drained->written.store(0, std::memory_order_relaxed);
+		drained->next.store(nullptr, std::memory_order_relaxed);
+
+		auto old = this->spare.exchange(drained, std::memory_order_release);
+		delete old;
+	}
+
+	/**
+	 * Chunk that the consumer reads from.
+	 */
+	chunk *head;
+
+	/**
+	 * Position of the next element to read in \p head.
+	 */
+	size_t head_pos;
+
+	/**
+	 * Chunk that the producer writes to.
+	 */
+	chunk *tail;
+
+	/**
+	 * Position of the next element to write in \p tail.
+	 */
+	size_t tail_pos;
+
+	/**
+	 * Drained chunk that the producer can reuse.
+	 */
+	std::atomic<chunk *> spare;
+};
+
+} // namespace openage::datastructure
@@ -0,0 +1,137 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+#include "datastructure/hash_table.h"
+#include "error/error.h"
+
+
+namespace openage::datastructure {
+
+/**
+ * Hash map with unique keys on top of \p hash_table::HashTable.
+ *
+ * The interface follows std::unordered_map, without buckets and
+ * allocators. Erasing never moves other elements, so erasing while
+ * iterating works like with std::unordered_map.
+ *
+ * @tparam storage Element storage of the hash table.
+ * @tparam Hash Hash function of the keys.
+ * @tparam Eq Equality comparison of the keys.
+ */
+template <typename storage, typename Hash, typename Eq>
+class HashMap : public hash_table::HashTable<storage, Hash, Eq> {
+	using table_t = hash_table::HashTable<storage, Hash, Eq>;
+
+public:
+	using key_type = typename table_t::key_type;
+	using mapped_type = typename table_t::value_type::second_type;
+	using value_type = typename table_t::value_type;
+	using iterator = typename table_t::iterator;
+	using const_iterator = typename table_t::const_iterator;
+
+	HashMap() = default;
+
+	HashMap(std::initializer_list<value_type> values) {
+		this->reserve(values.size());
+		for (auto &value : values) {
+			this->insert(value);
+		}
+	}
+
+	std::pair<iterator, bool> insert(const value_type &value) {
+		return this->emplace_key(value.first, value);
+	}
+
+	std::pair<iterator, bool> insert(value_type &&value) {
+		return this->emplace_key(value.first, std::move(value));
+	}
+
+	/**
+	 * Insert an element constructed from the arguments,
+	 * if its key does not exist yet.
+	 */
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(Args &&...args) {
+		value_type value(std::forward<Args>(args)...);
+		return this->emplace_key(value.first, std::move(value));
+	}
+
+	/**
+	 * Insert an element with the given key if it does not exist yet.
+	 * The value is only constructed when the element is inserted.
+	 */
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args) {
+		return this->emplace_key(key,
+		                         std::piecewise_construct,
+		                         std::forward_as_tuple(key),
+		                         std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	/**
+	 * Insert an element, or assign the value of the existing element
+	 * with the same key.
+	 */
+	template <typename M>
+	std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&value) {
+		auto it = this->find(key);
+		if (it != this->end()) {
+			it->second = std::forward<M>(value);
+			return {it, false};
+		}
+		return this->try_emplace(key, std::forward<M>(value));
+	}
+
+	/**
+	 * Get the value for a key, inserting a default-constructed
+	 * value if the key does not exist.
+	 */
+	mapped_type &operator[](const key_type &key) {
+		return this->try_emplace(key).first->second;
+	}
+
+	/**
+	 * Get the value for a key.
+	 * Throws if the key does not exist.
+	 */
+	mapped_type &at(const key_type &key) {
+		auto it = this->find(key);
+		if (it == this->end()) [[unlikely]] {
+			throw Error(MSG(err) << "The key is not in the map.");
+		}
+		return it->second;
+	}
+
+	const mapped_type &at(const key_type &key) const {
+		auto it = this->find(key);
+		if (it == this->end()) [[unlikely]] {
+			throw Error(MSG(err) << "The key is not in the map.");
+		}
+		return it->second;
+	}
+};
+
+
+/**
+ * Hash map that stores its elements inline in the slot array.
+ * Use it for small values that are looked up often.
+ * References and iterators are invalidated by insertions.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+using FlatHashMap = HashMap<hash_table::flat_storage<hash_table::map_values<K, V>>, Hash, Eq>;
+
+/**
+ * Hash map that allocates each element separately.
+ * References to elements stay valid until they are erased,
+ * iterators are invalidated by insertions.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+using NodeHashMap = HashMap<hash_table::node_storage<hash_table::map_values<K, V>>, Hash, Eq>;
+
+} // namespace openage::datastructure
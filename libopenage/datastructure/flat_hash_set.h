@@ -0,0 +1,75 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+#include "datastructure/hash_table.h"
+
+
+namespace openage::datastructure {
+
+/**
+ * Hash set that stores its elements inline in the slot array.
+ *
+ * The interface follows std::unordered_set. Elements can't be modified,
+ * so iteration is always const. Iterators are invalidated by insertions.
+ *
+ * @tparam K Type of the elements.
+ * @tparam Hash Hash function of the elements.
+ * @tparam Eq Equality comparison of the elements.
+ */
+template <typename K, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class FlatHashSet : public hash_table::HashTable<hash_table::flat_storage<hash_table::set_values<K>>, Hash, Eq> {
+	using table_t = hash_table::HashTable<hash_table::flat_storage<hash_table::set_values<K>>, Hash, Eq>;
+
+public:
+	using key_type = K;
+	using value_type = K;
+	using iterator = typename table_t::const_iterator;
+	using const_iterator = typename table_t::const_iterator;
+
+	FlatHashSet() = default;
+
+	FlatHashSet(std::initializer_list<K> values) {
+		this->reserve(values.size());
+		for (auto &value : values) {
+			this->insert(value);
+		}
+	}
+
+	const_iterator begin() const {
+		return table_t::begin();
+	}
+
+	const_iterator end() const {
+		return table_t::end();
+	}
+
+	const_iterator find(const K &key) const {
+		return table_t::find(key);
+	}
+
+	std::pair<const_iterator, bool> insert(const K &value) {
+		return this->emplace_key(value, value);
+	}
+
+	std::pair<const_iterator, bool> insert(K &&value) {
+		return this->emplace_key(value, std::move(value));
+	}
+
+	template <typename... Args>
+	std::pair<const_iterator, bool> emplace(Args &&...args) {
+		return this->insert(K(std::forward<Args>(args)...));
+	}
+
+	using table_t::erase;
+
+	const_iterator erase(const_iterator it) {
+		return table_t::erase(it);
+	}
+};
+
+} // namespace openage::datastructure
@@ -0,0 +1,758 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+/** @file
+ * Open-addressing hash table that backs \p FlatHashMap, \p NodeHashMap
+ * and \p FlatHashSet.
+ *
+ * The slots are stored in one array. Each slot has a control byte in a
+ * separate array, which is either empty, deleted, or holds the lower
+ * 7 bits of the hash of the key in the slot. Lookups compare the control
+ * bytes of 16 slots at once (with SSE2 if it is available) and only
+ * compare keys of slots whose control byte matches.
+ *
+ * The design follows the "Swiss table" of abseil:
+ * https://abseil.io/about/design/swisstables
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+namespace openage::datastructure::hash_table {
+
+/**
+ * Control byte of a slot.
+ * Full slots store the lower 7 bits of the hash of their key, so the
+ * sign bit is only set for free slots.
+ */
+using ctrl_t = int8_t;
+
+/// Slot was never used. Lookups stop at empty slots.
+constexpr ctrl_t ctrl_empty = -128;
+
+/// Slot was erased. Lookups continue past deleted slots.
+constexpr ctrl_t ctrl_deleted = -2;
+
+/// Number of control bytes that are matched at once.
+constexpr size_t group_width = 16;
+
+
+/**
+ * Control bytes of 16 consecutive slots.
+ */
+class Group {
+public:
+	explicit Group(const ctrl_t *ctrl) {
+#ifdef __SSE2__
+		this->ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+		std::memcpy(this->ctrl, ctrl, group_width);
+#endif
+	}
+
+	/**
+	 * Get the slots that hold the given hash.
+	 *
+	 * @param h2 Lower 7 bits of a hash.
+	 *
+	 * @return Bit mask of the slots, bit 0 is the first slot.
+	 */
+	uint32_t match(ctrl_t h2) const {
+#ifdef __SSE2__
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), this->ctrl));
+#else
+		uint32_t mask = 0;
+		for (size_t i = 0; i < group_width; i++) {
+			mask |= static_cast<uint32_t>(this->ctrl[i] == h2) << i;
+		}
+		return mask;
+#endif
+	}
+
+	/**
+	 * Get the empty slots.
+	 *
+	 * @return Bit mask of the slots.
+	 */
+	uint32_t match_empty() const {
+		return this->match(ctrl_empty);
+	}
+
+	/**
+	 * Get the empty and deleted slots.
+	 *
+	 * @return Bit mask of the slots.
+	 */
+	uint32_t match_free() const {
+#ifdef __SSE2__
+		return _mm_movemask_epi8(this->ctrl);
+#else
+		uint32_t mask = 0;
+		for (size_t i = 0; i < group_width; i++) {
+			mask |= static_cast<uint32_t>(this->ctrl[i] < 0) << i;
+		}
+		return mask;
+#endif
+	}
+
+private:
+#ifdef __SSE2__
+	__m128i ctrl;
+#else
+	ctrl_t ctrl[group_width];
+#endif
+};
+
+
+/**
+ * Elements of maps: key-value pairs.
+ */
+template <typename K, typename V>
+struct map_values {
+	using key_type = K;
+	using value_type = std::pair<const K, V>;
+
+	static const key_type &key(const value_type &value) {
+		return value.first;
+	}
+};
+
+
+/**
+ * Elements of sets: the keys themselves.
+ */
+template <typename K>
+struct set_values {
+	using key_type = K;
+	using value_type = K;
+
+	static const key_type &key(const value_type &value) {
+		return value;
+	}
+};
+
+
+/**
+ * Storage of the elements inside of the slot array.
+ * References to elements are invalidated when the table grows.
+ */
+template <typename values>
+struct flat_storage : values {
+	using value_type = typename values::value_type;
+	using slot_type = value_type;
+
+	static value_type &element(slot_type &slot) {
+		return slot;
+	}
+
+	template <typename... Args>
+	static void construct(slot_type *slot, Args &&...args) {
+		std::construct_at(slot, std::forward<Args>(args)...);
+	}
+
+	static void destroy(slot_type *slot) {
+		std::destroy_at(slot);
+	}
+
+	static void transfer(slot_type *to, slot_type *from) {
+		std::construct_at(to, std::move(*from));
+		std::destroy_at(from);
+	}
+};
+
+
+/**
+ * Storage of each element in its own allocation, the slots only hold
+ * pointers. References to elements stay valid until they are erased.
+ */
+template <typename values>
+struct node_storage : values {
+	using value_type = typename values::value_type;
+	using slot_type = value_type *;
+
+	static value_type &element(slot_type &slot) {
+		return *slot;
+	}
+
+	template <typename... Args>
+	static void construct(slot_type *slot, Args &&...args) {
+		std::construct_at(slot, new value_type(std::forward<Args>(args)...));
+	}
+
+	static void destroy(slot_type *slot) {
+		delete *slot;
+	}
+
+	static void transfer(slot_type *to, slot_type *from) {
+		std::construct_at(to, *from);
+	}
+};
+
+
+/**
+ * Open-addressing hash table with unique keys.
+ *
+ * @tparam storage Element storage, \p flat_storage or \p node_storage.
+ * @tparam Hash Hash function of the keys.
+ * @tparam Eq Equality comparison of the keys.
+ */
+template <typename storage, typename Hash, typename Eq>
+class HashTable {
+public:
+	using key_type = typename storage::key_type;
+	using value_type = typename storage::value_type;
+	using size_type = size_t;
+	using hasher = Hash;
+	using key_equal = Eq;
+
+private:
+	using slot_type = typename storage::slot_type;
+
+public:
+	/**
+	 * Forward iterator over the full slots, in slot order.
+	 */
+	template <bool is_const>
+	class Iterator {
+		friend class HashTable;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename HashTable::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<is_const, const value_type &, value_type &>;
+		using pointer = std::conditional_t<is_const, const value_type *, value_type *>;
+
+		Iterator() :
+			ctrl{nullptr},
+			slot{nullptr},
+			ctrl_end{nullptr} {}
+
+		/**
+		 * Iterators are convertible to const iterators.
+		 */
+		template <bool other_const>
+			requires(is_const and not other_const)
+		Iterator(const Iterator<other_const> &other) :
+			ctrl{other.ctrl},
+			slot{other.slot},
+			ctrl_end{other.ctrl_end} {}
+
+		reference operator*() const {
+			return storage::element(*this->slot);
+		}
+
+		pointer operator->() const {
+			return &storage::element(*this->slot);
+		}
+
+		Iterator &operator++() {
+			++this->ctrl;
+			++this->slot;
+			this->skip_free();
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator ret = *this;
+			++(*this);
+			return ret;
+		}
+
+		template <bool other_const>
+		bool operator==(const Iterator<other_const> &other) const {
+			return this->ctrl == other.ctrl;
+		}
+
+	private:
+		template <bool>
+		friend class Iterator;
+
+		Iterator(const ctrl_t *ctrl, slot_type *slot, const ctrl_t *ctrl_end) :
+			ctrl{ctrl},
+			slot{slot},
+			ctrl_end{ctrl_end} {
+			this->skip_free();
+		}
+
+		/**
+		 * Advance to the next full slot or the end.
+		 */
+		void skip_free() {
+			while (this->ctrl != this->ctrl_end and *this->ctrl < 0) {
+				++this->ctrl;
+				++this->slot;
+			}
+		}
+
+		const ctrl_t *ctrl;
+		slot_type *slot;
+		const ctrl_t *ctrl_end;
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	HashTable() :
+		ctrl{nullptr},
+		slots{nullptr},
+		slot_count{0},
+		element_count{0},
+		growth_left{0} {}
+
+	HashTable(const HashTable &other) :
+		HashTable{} {
+		this->hash_fn = other.hash_fn;
+		this->eq_fn = other.eq_fn;
+		this->reserve(other.element_count);
+		for (auto &value : other) {
+			this->emplace_key(storage::key(value), value);
+		}
+	}
+
+	HashTable(HashTable &&other) noexcept :
+		HashTable{} {
+		this->swap(other);
+	}
+
+	HashTable &operator=(const HashTable &other) {
+		if (this != &other) {
+			HashTable copy{other};
+			this->swap(copy);
+		}
+		return *this;
+	}
+
+	HashTable &operator=(HashTable &&other) noexcept {
+		HashTable moved{std::move(other)};
+		this->swap(moved);
+		return *this;
+	}
+
+	~HashTable() {
+		this->destroy_slots();
+		this->deallocate();
+	}
+
+	iterator begin() {
+		return iterator{this->ctrl, this->slots, this->ctrl + this->slot_count};
+	}
+
+	iterator end() {
+		return iterator{this->ctrl + this->slot_count, this->slots + this->slot_count, this->ctrl + this->slot_count};
+	}
+
+	const_iterator begin() const {
+		return const_iterator{this->ctrl, this->slots, this->ctrl + this->slot_count};
+	}
+
+	const_iterator end() const {
+		return const_iterator{this->ctrl + this->slot_count, this->slots + this->slot_count, this->ctrl + this->slot_count};
+	}
+
+	const_iterator cbegin() const {
+		return this->begin();
+	}
+
+	const_iterator cend() const {
+		return this->end();
+	}
+
+	/**
+	 * Get the number of elements.
+	 */
+	size_t size() const {
+		return this->element_count;
+	}
+
+	/**
+	 * Check if there are no elements.
+	 */
+	bool empty() const {
+		return this->element_count == 0;
+	}
+
+	/**
+	 * Get the number of slots.
+	 */
+	size_t capacity() const {
+		return this->slot_count;
+	}
+
+	/**
+	 * Find the element with the given key.
+	 *
+	 * @param key Key of the element.
+	 *
+	 * @return Iterator to the element, or end() if there is none.
+	 */
+	iterator find(const key_type &key) {
+		size_t index = this->find_index(key);
+		if (index == npos) {
+			return this->end();
+		}
+		return this->iterator_at(index);
+	}
+
+	const_iterator find(const key_type &key) const {
+		size_t index = this->find_index(key);
+		if (index == npos) {
+			return this->end();
+		}
+		return const_iterator{this->ctrl + index, this->slots + index, this->ctrl + this->slot_count};
+	}
+
+	/**
+	 * Check if there is an element with the given key.
+	 */
+	bool contains(const key_type &key) const {
+		return this->find_index(key) != npos;
+	}
+
+	/**
+	 * Get the number of elements with the given key, which is 0 or 1.
+	 */
+	size_t count(const key_type &key) const {
+		return this->contains(key) ? 1 : 0;
+	}
+
+	/**
+	 * Erase the element with the given key.
+	 *
+	 * @param key Key of the element.
+	 *
+	 * @return Number of erased elements, 0 or 1.
+	 */
+	size_t erase(const key_type &key) {
+		size_t index = this->find_index(key);
+		if (index == npos) {
+			return 0;
+		}
+		this->erase_index(index);
+		return 1;
+	}
+
+	/**
+	 * Erase the element at an iterator.
+	 * Other iterators stay valid, erasing never moves elements.
+	 *
+	 * @param it Iterator to the element.
+	 *
+	 * @return Iterator to the next element.
+	 */
+	iterator erase(const_iterator it) {
+		size_t index = it.ctrl - this->ctrl;
+		this->erase_index(index);
+		return iterator{this->ctrl + index + 1, this->slots + index + 1, this->ctrl + this->slot_count};
+	}
+
+	iterator erase(iterator it) {
+		return this->erase(const_iterator{it});
+	}
+
+	/**
+	 * Erase all elements. The slots are kept.
+	 */
+	void clear() {
+		this->destroy_slots();
+		if (this->slot_count > 0) {
+			std::memset(this->ctrl, ctrl_empty, this->slot_count + group_width);
+		}
+		this->element_count = 0;
+		this->growth_left = max_growth(this->slot_count);
+	}
+
+	/**
+	 * Allocate slots for the given number of elements.
+	 *
+	 * @param size Number of elements that fit without growing.
+	 */
+	void reserve(size_t size) {
+		size_t needed = slots_for(size);
+		if (needed > this->slot_count) {
+			this->resize(needed);
+		}
+	}
+
+	void swap(HashTable &other) noexcept {
+		std::swap(this->ctrl, other.ctrl);
+		std::swap(this->slots, other.slots);
+		std::swap(this->slot_count, other.slot_count);
+		std::swap(this->element_count, other.element_count);
+		std::swap(this->growth_left, other.growth_left);
+		std::swap(this->hash_fn, other.hash_fn);
+		std::swap(this->eq_fn, other.eq_fn);
+	}
+
+protected:
+	/**
+	 * Insert an element if its key does not exist yet.
+	 *
+	 * @param key Key of the element.
+	 * @param args Constructor arguments of the element,
+	 *             only used if the key does not exist.
+	 *
+	 * @return Iterator to the element with the key and whether it was inserted.
+	 */
+	template <typename... Args>
+	std::pair<iterator, bool> emplace_key(const key_type &key, Args &&...args) {
+		size_t hash = this->hash_of(key);
+		size_t index = this->find_index(key, hash);
+		if (index != npos) {
+			return {this->iterator_at(index), false};
+		}
+
+		index = this->prepare_insert(hash);
+		try {
+			storage::construct(this->slots + index, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			this->set_ctrl(index, ctrl_deleted);
+			this->element_count -= 1;
+			throw;
+		}
+
+		return {this->iterator_at(index), true};
+	}
+
+	iterator iterator_at(size_t index) {
+		return iterator{this->ctrl + index, this->slots + index, this->ctrl + this->slot_count};
+	}
+
+private:
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	/**
+	 * Maximum number of used (full or deleted) slots for a slot count.
+	 * Tables are at most 7/8 full.
+	 */
+	static size_t max_growth(size_t slot_count) {
+		return slot_count - slot_count / 8;
+	}
+
+	/**
+	 * Number of slots that are needed for a number of elements.
+	 */
+	static size_t slots_for(size_t size) {
+		if (size == 0) {
+			return 0;
+		}
+		return std::max(group_width, std::bit_ceil(size + size / 7 + 1));
+	}
+
+	/**
+	 * Hash a key. The hash is mixed, because std::hash is the identity
+	 * for integers and pointers, and both the lower and the upper bits
+	 * of the hash are used.
+	 */
+	size_t hash_of(const key_type &key) const {
+		uint64_t hash = this->hash_fn(key);
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		return static_cast<size_t>(hash);
+	}
+
+	size_t find_index(const key_type &key) const {
+		if (this->slot_count == 0) {
+			return npos;
+		}
+		return this->find_index(key, this->hash_of(key));
+	}
+
+	/**
+	 * Find the slot of a key.
+	 *
+	 * Groups are probed quadratically. Because the slot count is a
+	 * power of two, the probe sequence visits every group.
+	 */
+	size_t find_index(const key_type &key, size_t hash) const {
+		if (this->slot_count == 0) {
+			return npos;
+		}
+
+		const size_t mask = this->slot_count - 1;
+		const ctrl_t h2 = hash & 0x7f;
+		size_t offset = (hash >> 7) & mask;
+		size_t step = 0;
+
+		while (true) {
+			Group group{this->ctrl + offset};
+			for (uint32_t match = group.match(h2); match != 0; match &= match - 1) {
+				size_t index = (offset + std::countr_zero(match)) & mask;
+				if (this->eq_fn(storage::key(storage::element(this->slots[index])), key)) [[likely]] {
+					return index;
+				}
+			}
+
+			if (group.match_empty() != 0) {
+				return npos;
+			}
+
+			step += group_width;
+			offset = (offset + step) & mask;
+		}
+	}
+
+	/**
+	 * Find the first free slot in the probe sequence of a hash.
+	 */
+	size_t find_free(size_t hash) const {
+		const size_t mask = this->slot_count - 1;
+		size_t offset = (hash >> 7) & mask;
+		size_t step = 0;
+
+		while (true) {
+			uint32_t free = Group{this->ctrl + offset}.match_free();
+			if (free != 0) {
+				return (offset + std::countr_zero(free)) & mask;
+			}
+
+			step += group_width;
+			offset = (offset + step) & mask;
+		}
+	}
+
+	/**
+	 * Claim a free slot for a new element with the given hash.
+	 * Grows the table if needed.
+	 *
+	 * @return Index of the slot. The element is not constructed yet.
+	 */
+	size_t prepare_insert(size_t hash) {
+		size_t index = (this->slot_count == 0) ? npos : this->find_free(hash);
+
+		// deleted slots are reused without using up growth
+		if (index == npos or (this->growth_left == 0 and this->ctrl[index] == ctrl_empty)) {
+			// drop the deleted slots if they take up most of the growth,
+			// otherwise double the size
+			if (this->slot_count > 0 and this->element_count <= max_growth(this->slot_count) / 2) {
+				this->resize(this->slot_count);
+			}
+			else {
+				this->resize(std::max(group_width, this->slot_count * 2));
+			}
+			index = this->find_free(hash);
+		}
+
+		if (this->ctrl[index] == ctrl_empty) {
+			this->growth_left -= 1;
+		}
+
+		this->set_ctrl(index, hash & 0x7f);
+		this->element_count += 1;
+		return index;
+	}
+
+	void erase_index(size_t index) {
+		storage::destroy(this->slots + index);
+		this->set_ctrl(index, ctrl_deleted);
+		this->element_count -= 1;
+	}
+
+	/**
+	 * Set the control byte of a slot.
+	 * The control bytes of the first group are mirrored after the last
+	 * slot, so groups can be loaded at every slot without wrapping.
+	 */
+	void set_ctrl(size_t index, ctrl_t value) {
+		this->ctrl[index] = value;
+		if (index < group_width) {
+			this->ctrl[this->slot_count + index] = value;
+		}
+	}
+
+	/**
+	 * Move all elements into a new slot array.
+	 *
+	 * @param new_slot_count Number of slots, a power of two.
+	 */
+	void resize(size_t new_slot_count) {
+		ctrl_t *old_ctrl = this->ctrl;
+		slot_type *old_slots = this->slots;
+		size_t old_slot_count = this->slot_count;
+
+		this->ctrl = new ctrl_t[new_slot_count + group_width];
+		std::memset(this->ctrl, ctrl_empty, new_slot_count + group_width);
+		this->slots = std::allocator<slot_type>{}.allocate(new_slot_count);
+		this->slot_count = new_slot_count;
+
+		for (size_t i = 0; i < old_slot_count; i++) {
+			if (old_ctrl[i] >= 0) {
+				size_t hash = this->hash_of(storage::key(storage::element(old_slots[i])));
+				size_t index = this->find_free(hash);
+				this->set_ctrl(index, hash & 0x7f);
+				storage::transfer(this->slots + index, old_slots + i);
+			}
+		}
+
+		this->growth_left = max_growth(new_slot_count) - this->element_count;
+
+		delete[] old_ctrl;
+		if (old_slots != nullptr) {
+			std::allocator<slot_type>{}.deallocate(old_slots, old_slot_count);
+		}
+	}
+
+	void destroy_slots() {
+		for (size_t i = 0; i < this->slot_count; i++) {
+			if (this->ctrl[i] >= 0) {
+				storage::destroy(this->slots + i);
+			}
+		}
+	}
+
+	void deallocate() {
+		delete[] this->ctrl;
+		if (this->slots != nullptr) {
+			std::allocator<slot_type>{}.deallocate(this->slots, this->slot_count);
+		}
+		this->ctrl = nullptr;
+		this->slots = nullptr;
+		this->slot_count = 0;
+	}
+
+	/**
+	 * Control bytes of the slots, followed by a copy of the first group.
+	 */
+	ctrl_t *ctrl;
+
+	/**
+	 * Slots with the elements.
+	 */
+	slot_type *slots;
+
+	/**
+	 * Number of slots, 0 or a power of two of at least the group width.
+	 */
+	size_t slot_count;
+
+	/**
+	 * Number of elements.
+	 */
+	size_t element_count;
+
+	/**
+	 * Number of empty slots that can be used before the table grows.
+	 */
+	size_t growth_left;
+
+	[[no_unique_address]] Hash hash_fn;
+	[[no_unique_address]] Eq eq_fn;
+};
+
+} // namespace openage::datastructure::hash_table
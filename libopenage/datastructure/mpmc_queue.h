@@ -0,0 +1,290 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "datastructure/backoff.h"
+
+
+namespace openage::datastructure {
+
+/**
+ * Bounded lock-free queue for any number of producer and consumer threads.
+ *
+ * Elements are stored in a ring buffer of cells. Every cell has a sequence
+ * number that tells producers and consumers whether the cell is free for
+ * the current round of the ring buffer. Threads claim a cell by advancing
+ * the shared enqueue or dequeue index with a CAS, and hand it over by
+ * updating the sequence number of the cell. There is no lock, so a thread
+ * that is descheduled never blocks the others for longer than the
+ * duration of a single element move.
+ *
+ * Based on Dmitry Vyukov's bounded MPMC queue:
+ * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * @tparam T Element type. Must be move constructible.
+ */
+template <typename T>
+class MPMCQueue {
+public:
+	/**
+	 * Create a queue.
+	 *
+	 * @param capacity Minimum number of elements the queue can hold.
+	 *                 Rounded up to a power of two.
+	 */
+	explicit MPMCQueue(size_t capacity) :
+		cells{std::make_unique<cell[]>(std::bit_ceil(std::max<size_t>(capacity, 2)))},
+		mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1},
+		enqueue_pos{0},
+		dequeue_pos{0} {
+		for (size_t i = 0; i <= this->mask; i++) {
+			this->cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~MPMCQueue() {
+		this->clear();
+	}
+
+	MPMCQueue(const MPMCQueue &) = delete;
+	MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+	/**
+	 * Append an element if there is space.
+	 *
+	 * @param value Element.
+	 *
+	 * @return true if the element was appended, false if the queue is full.
+	 */
+	bool try_push(const T &value) {
+		return this->try_emplace(value);
+	}
+
+	bool try_push(T &&value) {
+		return this->try_emplace(std::move(value));
+	}
+
+	/**
+	 * Construct an element at the end if there is space.
+	 *
+	 * @param args Constructor arguments of the element.
+	 *
+	 * @return true if the element was appended, false if the queue is full.
+	 */
+	template <typename... Args>
+	bool try_emplace(Args &&...args) {
+		size_t pos = this->enqueue_pos.load(std::memory_order_relaxed);
+		cell *target;
+
+		while (true) {
+			target = &this->cells[pos & this->mask];
+			size_t seq = target->sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+			if (diff == 0) {
+				// the cell is free in this round, try to claim it
+				if (this->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (diff < 0) {
+				// the cell still holds the element of the previous round
+				return false;
+			}
+			else {
+				// another producer claimed the cell
+				pos = this->enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+
+		std::construct_at(target->get(), std::forward<Args>(args)...);
+		target->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Append an element, waiting until there is space.
+	 *
+	 * @param value Element.
+	 */
+	void push(const T &value) {
+		Backoff backoff;
+		while (not this->try_emplace(value)) {
+			backoff.pause();
+		}
+	}
+
+	void push(T &&value) {
+		Backoff backoff;
+		while (not this->try_emplace(std::move(value))) {
+			backoff.pause();
+		}
+	}
+
+	/**
+	 * Remove the oldest element if there is one.
+	 *
+	 * @param value Receives the removed element.
+	 *
+	 * @return true if an element was removed, false if the queue was empty.
+	 */
+	bool try_pop(T &value) {
+		cell *source = this->claim_pop();
+		if (source == nullptr) {
+			return false;
+		}
+
+		value = std::move(*source->get());
+		this->release_pop(source);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element, waiting until there is one.
+	 *
+	 * @return Removed element.
+	 */
+	T pop() {
+		Backoff backoff;
+		cell *source;
+		while ((source = this->claim_pop()) == nullptr) {
+			backoff.pause();
+		}
+
+		T ret = std::move(*source->get());
+		this->release_pop(source);
+		return ret;
+	}
+
+	/**
+	 * Remove all elements that were in the queue when the call started.
+	 */
+	void clear() {
+		size_t count = this->size();
+		for (size_t i = 0; i < count; i++) {
+			cell *source = this->claim_pop();
+			if (source == nullptr) {
+				break;
+			}
+			this->release_pop(source);
+		}
+	}
+
+	/**
+	 * Check if there are no elements in the queue.
+	 * Only a snapshot if other threads use the queue.
+	 *
+	 * @return true if the queue is empty, else false.
+	 */
+	bool empty() const {
+		return this->size() == 0;
+	}
+
+	/**
+	 * Get the number of elements in the queue, including elements
+	 * that are being pushed or popped right now.
+	 * Only a snapshot if other threads use the queue.
+	 *
+	 * @return Number of elements.
+	 */
+	size_t size() const {
+		size_t pos = this->dequeue_pos.load(std::memory_order_acquire);
+		auto diff = static_cast<intptr_t>(this->enqueue_pos.load(std::memory_order_acquire) - pos);
+		return (diff > 0) ? diff : 0;
+	}
+
+	/**
+	 * Get the maximum number of elements in the queue.
+	 *
+	 * @return Capacity of the queue.
+	 */
+	size_t capacity() const {
+		return this->mask + 1;
+	}
+
+private:
+	/**
+	 * Element storage with its sequence number.
+	 */
+	struct cell {
+		/// Index that the cell is ready for. The enqueue index if the
+		/// cell is free, the enqueue index + 1 if it holds an element.
+		std::atomic<size_t> sequence;
+		alignas(T) unsigned char data[sizeof(T)];
+
+		T *get() {
+			return reinterpret_cast<T *>(this->data);
+		}
+	};
+
+	/**
+	 * Claim the cell with the oldest element.
+	 *
+	 * @return Claimed cell, or nullptr if the queue is empty.
+	 */
+	cell *claim_pop() {
+		size_t pos = this->dequeue_pos.load(std::memory_order_relaxed);
+
+		while (true) {
+			cell *source = &this->cells[pos & this->mask];
+			size_t seq = source->sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+			if (diff == 0) {
+				if (this->dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					return source;
+				}
+			}
+			else if (diff < 0) {
+				// the element of this round was not pushed yet
+				return nullptr;
+			}
+			else {
+				pos = this->dequeue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * Destroy the element in a claimed cell and free the cell
+	 * for the next round.
+	 *
+	 * @param source Cell returned by \p claim_pop().
+	 */
+	void release_pop(cell *source) {
+		std::destroy_at(source->get());
+		// the cell was claimed at the dequeue index seq - 1
+		size_t seq = source->sequence.load(std::memory_order_relaxed);
+		source->sequence.store(seq + this->mask, std::memory_order_release);
+	}
+
+	/**
+	 * Ring buffer of cells.
+	 */
+	std::unique_ptr<cell[]> cells;
+
+	/**
+	 * Capacity - 1, for wrapping the indices.
+	 */
+	const size_t mask;
+
+	/**
+	 * Index of the next cell that is pushed to.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> enqueue_pos;
+
+	/**
+	 * Index of the next cell that is popped from.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> dequeue_pos;
+};
+
+} // namespace openage::datastructure
@@ -0,0 +1,364 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace openage::datastructure {
+
+/**
+ * Statistics of an object pool.
+ */
+struct pool_stats {
+	/// Size of the blocks of the pool.
+	size_t block_size;
+	/// Number of chunks allocated from the system.
+	size_t chunks;
+	/// Number of blocks in all chunks.
+	size_t blocks;
+};
+
+
+/**
+ * Number of chunks that all object pools have allocated from the system.
+ */
+inline std::atomic<size_t> pool_chunk_count{0};
+
+
+/**
+ * Pool of equally sized memory blocks, shared by all threads.
+ *
+ * Blocks are carved from large chunks and recycled through free lists.
+ * Every thread keeps its own free list, so allocating and freeing is
+ * a pointer swap without synchronization. Only when the list of a thread
+ * runs empty or grows too long, blocks are moved from or to the shared
+ * free list in batches. Blocks may be freed by another thread than the
+ * one that allocated them; they then continue their life in the free list
+ * of the freeing thread.
+ *
+ * When a thread exits, its free list is handed to the shared list.
+ * Blocks that the thread allocates or frees after that, e.g. in the
+ * destructors of other thread-local objects, bypass its free list.
+ *
+ * Chunks are never returned to the system. The pool state is never
+ * destroyed either, so objects with static storage duration can still
+ * release their blocks during program shutdown.
+ *
+ * @tparam size Size of the blocks.
+ * @tparam align Alignment of the blocks.
+ */
+template <size_t size, size_t align>
+class ObjectPool {
+	static_assert(size % align == 0, "block size must be a multiple of the alignment");
+	static_assert(size >= sizeof(void *), "blocks must be able to hold a free list link");
+
+public:
+	/**
+	 * Get a free block.
+	 *
+	 * @return Uninitialized block of \p size bytes.
+	 */
+	static void *allocate() {
+		auto &cache = local_cache();
+		if (cache.head == nullptr) [[unlikely]] {
+			if (not cache.attach()) {
+				return shared().take();
+			}
+			shared().refill(cache);
+		}
+
+		free_block *block = cache.head;
+		cache.head = block->next;
+		cache.count -= 1;
+		return block;
+	}
+
+	/**
+	 * Return a block to the pool.
+	 *
+	 * @param ptr Block that was returned by \p allocate().
+	 */
+	static void deallocate(void *ptr) {
+		auto &cache = local_cache();
+		auto block = static_cast<free_block *>(ptr);
+		if (cache.state != cache_state::attached) [[unlikely]] {
+			if (not cache.attach()) {
+				shared().give(block);
+				return;
+			}
+		}
+
+		block->next = cache.head;
+		cache.head = block;
+		cache.count += 1;
+
+		if (cache.count >= 2 * batch_size) [[unlikely]] {
+			shared().drain(cache, batch_size);
+		}
+	}
+
+	/**
+	 * Get the statistics of the pool.
+	 *
+	 * @return Statistics of all threads.
+	 */
+	static pool_stats get_stats() {
+		auto &state = shared();
+		std::scoped_lock lock{state.mutex};
+		return {size, state.chunks.size(), state.chunks.size() * blocks_per_chunk};
+	}
+
+private:
+	/**
+	 * Blocks are moved between the thread caches and the shared list in
+	 * batches of this size.
+	 */
+	static constexpr size_t batch_size = 64;
+
+	/**
+	 * Number of blocks in a chunk. Chunks are about 64 KiB,
+	 * but hold at least one batch.
+	 */
+	static constexpr size_t blocks_per_chunk = std::max<size_t>(batch_size, (64 * 1024) / size);
+
+	/**
+	 * Link in a free list, stored inside the free block.
+	 */
+	struct free_block {
+		free_block *next;
+	};
+
+	/**
+	 * Life cycle of a thread cache.
+	 */
+	enum class cache_state {
+		/// The thread has not used the pool yet.
+		unused,
+		/// The exit hook of the thread is registered.
+		attached,
+		/// The thread is exiting, its blocks went to the shared list.
+		detached,
+	};
+
+	/**
+	 * Free list of a thread.
+	 *
+	 * It is trivially destructible, so it stays usable until the thread
+	 * is gone, even while other thread-local objects are destroyed.
+	 * Its blocks are handed to the shared list by \p thread_exit_hook.
+	 */
+	struct thread_cache {
+		free_block *head = nullptr;
+		size_t count = 0;
+		cache_state state = cache_state::unused;
+
+		/**
+		 * Register the exit hook on the first use of the cache.
+		 *
+		 * @return true if the cache can be used, false if the thread
+		 *         is exiting and the shared list has to be used.
+		 */
+		bool attach();
+	};
+
+	/**
+	 * Hands the free list of a thread to the shared list when the thread exits.
+	 */
+	struct thread_exit_hook {
+		~thread_exit_hook() {
+			auto &cache = local_cache();
+			shared().drain(cache, cache.count);
+			cache.state = cache_state::detached;
+		}
+	};
+
+	/**
+	 * Chunks and free blocks shared by all threads.
+	 */
+	struct shared_state {
+		std::mutex mutex;
+		free_block *head = nullptr;
+		std::vector<void *> chunks;
+
+		/**
+		 * Move a batch of free blocks to a thread cache,
+		 * allocating a new chunk if there are not enough.
+		 */
+		void refill(thread_cache &cache) {
+			std::scoped_lock lock{this->mutex};
+			for (size_t i = 0; i < batch_size; i++) {
+				if (this->head == nullptr) {
+					this->add_chunk();
+				}
+				free_block *block = this->head;
+				this->head = block->next;
+				block->next = cache.head;
+				cache.head = block;
+			}
+			cache.count += batch_size;
+		}
+
+		/**
+		 * Move free blocks from a thread cache to the shared list.
+		 */
+		void drain(thread_cache &cache, size_t count) {
+			if (count == 0) {
+				return;
+			}
+
+			std::scoped_lock lock{this->mutex};
+			for (size_t i = 0; i < count; i++) {
+				free_block *block = cache.head;
+				cache.head = block->next;
+				block->next = this->head;
+				this->head = block;
+			}
+			cache.count -= count;
+		}
+
+		/**
+		 * Take a single block from the shared list.
+		 */
+		void *take() {
+			std::scoped_lock lock{this->mutex};
+			if (this->head == nullptr) {
+				this->add_chunk();
+			}
+			free_block *block = this->head;
+			this->head = block->next;
+			return block;
+		}
+
+		/**
+		 * Put a single block into the shared list.
+		 */
+		void give(free_block *block) {
+			std::scoped_lock lock{this->mutex};
+			block->next = this->head;
+			this->head = block;
+		}
+
+		void add_chunk() {
+			auto chunk = static_cast<std::byte *>(::operator new(size * blocks_per_chunk, std::align_val_t{align}));
+			this->chunks.push_back(chunk);
+			pool_chunk_count.fetch_add(1, std::memory_order_relaxed);
+			for (size_t i = blocks_per_chunk; i-- > 0;) {
+				auto block = reinterpret_cast<free_block *>(chunk + i * size);
+				block->next = this->head;
+				this->head = block;
+			}
+		}
+	};
+
+	static shared_state &shared() {
+		// intentionally leaked, see the class documentation
+		static shared_state *state = new shared_state;
+		return *state;
+	}
+
+	static thread_cache &local_cache() {
+		static_assert(std::is_trivially_destructible_v<thread_cache>);
+		constinit thread_local thread_cache cache;
+		return cache;
+	}
+};
+
+
+template <size_t size, size_t align>
+bool ObjectPool<size, align>::thread_cache::attach() {
+	switch (this->state) {
+	case cache_state::unused: {
+		// thread-locals that are destroyed after the hook
+		// find the cache detached
+		thread_local thread_exit_hook hook;
+		this->state = cache_state::attached;
+		return true;
+	}
+	case cache_state::attached:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+/**
+ * Standard allocator that takes single objects from an \p ObjectPool.
+ * Arrays are allocated with operator new.
+ *
+ * Use it with std::allocate_shared to pool the objects of shared pointers
+ * together with their control blocks, or with node-based containers such
+ * as std::list to pool their nodes. All types of the same size and
+ * alignment share a pool.
+ *
+ * @tparam T Type of the allocated objects.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+	using value_type = T;
+
+	/**
+	 * Alignment of the blocks, large enough for a free list link.
+	 */
+	static constexpr size_t block_align = std::max(alignof(T), alignof(void *));
+
+	/**
+	 * Size of the blocks, rounded up to the alignment.
+	 */
+	static constexpr size_t block_size = (std::max(sizeof(T), sizeof(void *)) + block_align - 1) / block_align * block_align;
+
+	/**
+	 * Pool that serves the allocations.
+	 */
+	using pool_t = ObjectPool<block_size, block_align>;
+
+	PoolAllocator() noexcept = default;
+
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+	T *allocate(size_t n) {
+		if (n == 1) [[likely]] {
+			return static_cast<T *>(pool_t::allocate());
+		}
+		return std::allocator<T>{}.allocate(n);
+	}
+
+	void deallocate(T *ptr, size_t n) noexcept {
+		if (n == 1) [[likely]] {
+			pool_t::deallocate(ptr);
+			return;
+		}
+		std::allocator<T>{}.deallocate(ptr, n);
+	}
+
+	template <typename U>
+	bool operator==(const PoolAllocator<U> &) const noexcept {
+		return true;
+	}
+};
+
+
+/**
+ * Create an object that is managed by a shared pointer in a pool.
+ *
+ * @param args Constructor arguments of the object.
+ *
+ * @return Shared pointer to the object.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> make_pooled(Args &&...args) {
+	return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<Args>(args)...);
+}
+
+} // namespace openage::datastructure
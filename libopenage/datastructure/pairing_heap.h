@@ -23,6 +23,7 @@
 
 #include "../util/compiler.h"
 #include "../error/error.h"
+#include "object_pool.h"
 
 
 #define OPENAGE_PAIRINGHEAP_DEBUG false
@@ -215,7 +216,7 @@ public:
 	 * O(1)
 	 */
 	element_t push(const T &item) {
-		element_t new_node = std::make_shared<node_t>(item);
+		element_t new_node = make_pooled<node_t>(item);
 		this->push_node(new_node);
 		return new_node;
 	}
@@ -225,7 +226,7 @@ public:
 	 * O(1)
 	 */
 	element_t push(T &&item) {
-		element_t new_node = std::make_shared<node_t>(std::move(item));
+		element_t new_node = make_pooled<node_t>(std::move(item));
 		this->push_node(new_node);
 		return new_node;
 	}
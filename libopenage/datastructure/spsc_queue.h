@@ -0,0 +1,240 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "datastructure/backoff.h"
+
+
+namespace openage::datastructure {
+
+/**
+ * Bounded lock-free queue for one producer and one consumer thread.
+ *
+ * Elements are stored in a ring buffer. The producer only writes the tail
+ * index and the consumer only writes the head index, so each side needs a
+ * single atomic store per element. Both sides cache the index of the other
+ * side and only reload it when the queue looks full or empty.
+ *
+ * \p try_push() and \p push() must only be called from the producer thread,
+ * \p try_pop(), \p pop() and \p clear() only from the consumer thread.
+ *
+ * @tparam T Element type. Must be move constructible.
+ */
+template <typename T>
+class SPSCQueue {
+public:
+	/**
+	 * Create a queue.
+	 *
+	 * @param capacity Minimum number of elements the queue can hold.
+	 *                 Rounded up to a power of two.
+	 */
+	explicit SPSCQueue(size_t capacity) :
+		slots{std::make_unique<slot[]>(std::bit_ceil(std::max<size_t>(capacity, 1)))},
+		mask{std::bit_ceil(std::max<size_t>(capacity, 1)) - 1},
+		head{0},
+		cached_tail{0},
+		tail{0},
+		cached_head{0} {}
+
+	~SPSCQueue() {
+		this->clear();
+	}
+
+	SPSCQueue(const SPSCQueue &) = delete;
+	SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+	/**
+	 * Append an element if there is space. Producer only.
+	 *
+	 * @param value Element.
+	 *
+	 * @return true if the element was appended, false if the queue is full.
+	 */
+	bool try_push(const T &value) {
+		return this->try_emplace(value);
+	}
+
+	bool try_push(T &&value) {
+		return this->try_emplace(std::move(value));
+	}
+
+	/**
+	 * Construct an element at the end if there is space. Producer only.
+	 *
+	 * @param args Constructor arguments of the element.
+	 *
+	 * @return true if the element was appended, false if the queue is full.
+	 */
+	template <typename... Args>
+	bool try_emplace(Args &&...args) {
+		size_t pos = this->tail.load(std::memory_order_relaxed);
+		if (pos - this->cached_head > this->mask) {
+			this->cached_head = this->head.load(std::memory_order_acquire);
+			if (pos - this->cached_head > this->mask) {
+				return false;
+			}
+		}
+
+		std::construct_at(this->slots[pos & this->mask].get(), std::forward<Args>(args)...);
+		this->tail.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Append an element, waiting until there is space. Producer only.
+	 *
+	 * @param value Element.
+	 */
+	void push(const T &value) {
+		Backoff backoff;
+		while (not this->try_emplace(value)) {
+			backoff.pause();
+		}
+	}
+
+	void push(T &&value) {
+		Backoff backoff;
+		while (not this->try_emplace(std::move(value))) {
+			backoff.pause();
+		}
+	}
+
+	/**
+	 * Remove the oldest element if there is one. Consumer only.
+	 *
+	 * @param value Receives the removed element.
+	 *
+	 * @return true if an element was removed, false if the queue was empty.
+	 */
+	bool try_pop(T &value) {
+		size_t pos = this->head.load(std::memory_order_relaxed);
+		if (pos == this->cached_tail) {
+			this->cached_tail = this->tail.load(std::memory_order_acquire);
+			if (pos == this->cached_tail) {
+				return false;
+			}
+		}
+
+		T *elem = this->slots[pos & this->mask].get();
+		value = std::move(*elem);
+		std::destroy_at(elem);
+		this->head.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element, waiting until there is one. Consumer only.
+	 *
+	 * @return Removed element.
+	 */
+	T pop() {
+		size_t pos = this->head.load(std::memory_order_relaxed);
+		Backoff backoff;
+		while (pos == this->cached_tail) {
+			this->cached_tail = this->tail.load(std::memory_order_acquire);
+			if (pos == this->cached_tail) {
+				backoff.pause();
+			}
+		}
+
+		T *elem = this->slots[pos & this->mask].get();
+		T ret = std::move(*elem);
+		std::destroy_at(elem);
+		this->head.store(pos + 1, std::memory_order_release);
+		return ret;
+	}
+
+	/**
+	 * Remove all elements. Consumer only.
+	 */
+	void clear() {
+		size_t pos = this->head.load(std::memory_order_relaxed);
+		size_t end = this->tail.load(std::memory_order_acquire);
+		for (; pos != end; pos++) {
+			std::destroy_at(this->slots[pos & this->mask].get());
+		}
+		this->head.store(pos, std::memory_order_release);
+	}
+
+	/**
+	 * Check if there are no elements in the queue.
+	 * Only a snapshot if called while the other side is active.
+	 *
+	 * @return true if the queue is empty, else false.
+	 */
+	bool empty() const {
+		return this->size() == 0;
+	}
+
+	/**
+	 * Get the number of elements in the queue.
+	 * Only a snapshot if called while the other side is active.
+	 *
+	 * @return Number of elements.
+	 */
+	size_t size() const {
+		size_t pos = this->head.load(std::memory_order_acquire);
+		return this->tail.load(std::memory_order_acquire) - pos;
+	}
+
+	/**
+	 * Get the maximum number of elements in the queue.
+	 *
+	 * @return Capacity of the queue.
+	 */
+	size_t capacity() const {
+		return this->mask + 1;
+	}
+
+private:
+	/**
+	 * Uninitialized storage of one element.
+	 */
+	struct slot {
+		alignas(T) unsigned char data[sizeof(T)];
+
+		T *get() {
+			return reinterpret_cast<T *>(this->data);
+		}
+	};
+
+	/**
+	 * Ring buffer of elements.
+	 */
+	std::unique_ptr<slot[]> slots;
+
+	/**
+	 * Capacity - 1, for wrapping the indices.
+	 */
+	const size_t mask;
+
+	/**
+	 * Index of the next element to read. Written by the consumer.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> head;
+
+	/**
+	 * Last seen value of \p tail, for the consumer.
+	 */
+	size_t cached_tail;
+
+	/**
+	 * Index of the next element to write. Written by the producer.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> tail;
+
+	/**
+	 * Last seen value of \p head, for the producer.
+	 */
+	size_t cached_head;
+};
+
+} // namespace openage::datastructure
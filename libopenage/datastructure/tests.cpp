@@ -3,15 +3,33 @@
 #include "tests.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 #include <mutex>
+#include <thread>
 #include <utility>
 
+#include "log/log.h"
 #include "testing/testing.h"
 
+#include "datastructure/chunked_spsc_queue.h"
 #include "datastructure/concurrent_queue.h"
 #include "datastructure/constexpr_map.h"
+#include "datastructure/flat_hash_map.h"
+#include "datastructure/flat_hash_set.h"
+#include "datastructure/mpmc_queue.h"
+#include "datastructure/object_pool.h"
 #include "datastructure/pairing_heap.h"
+#include "datastructure/spsc_queue.h"
 
 
 namespace openage::datastructure::tests {
@@ -352,4 +370,703 @@ void concurrent_queue() {
 	concurrent_queue_copy_move_elements_compilation();
 }
 
+
+// exported test
+void chunked_spsc_queue() {
+	ChunkedSPSCQueue<int, 4> queue;
+	int value = -1;
+
+	queue.empty() or TESTFAIL;
+	(not queue.try_pop(value)) or TESTFAIL;
+
+	// fill more than one chunk
+	for (int i = 0; i < 10; ++i) {
+		queue.push(i);
+	}
+	(not queue.empty()) or TESTFAIL;
+	for (int i = 0; i < 10; ++i) {
+		queue.try_pop(value) or TESTFAIL;
+		TESTEQUALS(value, i);
+	}
+	queue.empty() or TESTFAIL;
+	(not queue.try_pop(value)) or TESTFAIL;
+
+	// interleaved pushing and popping across chunk boundaries
+	for (int i = 0; i < 100; ++i) {
+		queue.push(i);
+		queue.push(i + 1000);
+		queue.try_pop(value) or TESTFAIL;
+		TESTEQUALS(value, i);
+		queue.try_pop(value) or TESTFAIL;
+		TESTEQUALS(value, i + 1000);
+	}
+	queue.empty() or TESTFAIL;
+
+	// producer and consumer on different threads
+	const int count = 200000;
+	ChunkedSPSCQueue<int, 16> threaded;
+	std::thread producer{[&threaded]() {
+		for (int i = 0; i < count; ++i) {
+			threaded.push(i);
+		}
+	}};
+
+	// check after joining so that a failure does not leave the producer running
+	bool ordered = true;
+	int expected = 0;
+	while (expected < count) {
+		if (threaded.try_pop(value)) {
+			ordered = ordered and value == expected;
+			expected += 1;
+		}
+	}
+	producer.join();
+	ordered or TESTFAIL;
+	threaded.empty() or TESTFAIL;
+}
+
+
+// exported test
+void flat_hash_map() {
+	FlatHashMap<int, std::string> map;
+	map.empty() or TESTFAIL;
+	(map.find(1) == map.end()) or TESTFAIL;
+	TESTEQUALS(map.erase(1), 0);
+
+	// grow through several rehashes
+	for (int i = 0; i < 1000; ++i) {
+		map.insert({i, std::to_string(i)}).second or TESTFAIL;
+	}
+	TESTEQUALS(map.size(), 1000);
+	(not map.insert({5, "five"}).second) or TESTFAIL;
+	for (int i = 0; i < 1000; ++i) {
+		map.contains(i) or TESTFAIL;
+		TESTEQUALS(map.at(i), std::to_string(i));
+	}
+	(not map.contains(1000)) or TESTFAIL;
+	TESTTHROWS(map.at(1000));
+
+	map[1000] = "1000";
+	TESTEQUALS(map.size(), 1001);
+	map.insert_or_assign(1000, "thousand");
+	TESTEQUALS(map.at(1000), "thousand");
+	(not map.try_emplace(1000, "other").second) or TESTFAIL;
+	map.emplace(1001, "1001").second or TESTFAIL;
+	TESTEQUALS(map.count(1001), 1);
+
+	// erase the odd keys while iterating
+	size_t visited = 0;
+	for (auto it = map.begin(); it != map.end();) {
+		visited += 1;
+		if (it->first % 2 == 1) {
+			it = map.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	TESTEQUALS(visited, 1002);
+	TESTEQUALS(map.size(), 501);
+	for (int i = 0; i < 1002; ++i) {
+		TESTEQUALS(map.contains(i), i % 2 == 0);
+	}
+
+	// the tombstones of erased elements are reused
+	size_t capacity = map.capacity();
+	for (int round = 0; round < 100; ++round) {
+		for (int i = 1; i < 1002; i += 2) {
+			map.insert({i, ""});
+		}
+		for (int i = 1; i < 1002; i += 2) {
+			TESTEQUALS(map.erase(i), 1);
+		}
+	}
+	TESTEQUALS(map.size(), 501);
+	TESTEQUALS(map.capacity(), capacity);
+
+	// copies are independent
+	auto copy = map;
+	copy.erase(0);
+	map.contains(0) or TESTFAIL;
+	(not copy.contains(0)) or TESTFAIL;
+	TESTEQUALS(copy.size(), 500);
+
+	auto moved = std::move(copy);
+	TESTEQUALS(moved.size(), 500);
+	copy.empty() or TESTFAIL;
+
+	map.clear();
+	map.empty() or TESTFAIL;
+	(map.begin() == map.end()) or TESTFAIL;
+	map[3] = "3";
+	TESTEQUALS(map.size(), 1);
+
+	// references into a node map survive rehashing
+	NodeHashMap<std::string, std::unique_ptr<int>> nodes;
+	nodes.try_emplace("first", std::make_unique<int>(1));
+	std::unique_ptr<int> &first = nodes.at("first");
+	for (int i = 0; i < 1000; ++i) {
+		nodes.try_emplace(std::to_string(i), std::make_unique<int>(i));
+	}
+	(&first == &nodes.at("first")) or TESTFAIL;
+	TESTEQUALS(*first, 1);
+	nodes.erase("first");
+	TESTEQUALS(nodes.size(), 1000);
+
+	// colliding hashes
+	FlatHashMap<heap_elem, int> collisions;
+	for (int i = 0; i < 100; ++i) {
+		collisions[heap_elem{i * 1024}] = i;
+	}
+	for (int i = 0; i < 100; ++i) {
+		TESTEQUALS(collisions.at(heap_elem{i * 1024}), i);
+	}
+
+	FlatHashSet<std::string> set{"a", "b", "c"};
+	TESTEQUALS(set.size(), 3);
+	(not set.insert("a").second) or TESTFAIL;
+	set.emplace(2, 'd').second or TESTFAIL;
+	set.contains("dd") or TESTFAIL;
+	TESTEQUALS(set.erase("b"), 1);
+	std::vector<std::string> elements{set.begin(), set.end()};
+	std::sort(elements.begin(), elements.end());
+	(elements == std::vector<std::string>{"a", "c", "dd"}) or TESTFAIL;
+}
+
+
+/**
+ * Time insert, lookup, iteration and erase on a map.
+ *
+ * @param name Name of the map type in the log.
+ * @param keys Keys in insertion order.
+ * @param lookups Keys that are looked up, about half of them are missing.
+ */
+template <typename map_t>
+void time_map(const char *name, const std::vector<uint64_t> &keys, const std::vector<uint64_t> &lookups) {
+	using clock = std::chrono::steady_clock;
+	auto ms = [](auto duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	};
+
+	map_t map;
+	auto start = clock::now();
+	for (auto key : keys) {
+		map[key] = key;
+	}
+	auto insert_time = clock::now() - start;
+
+	size_t found = 0;
+	start = clock::now();
+	for (auto key : lookups) {
+		found += map.contains(key);
+	}
+	auto lookup_time = clock::now() - start;
+
+	uint64_t sum = 0;
+	start = clock::now();
+	for (int i = 0; i < 10; ++i) {
+		for (auto &elem : map) {
+			sum += elem.second;
+		}
+	}
+	auto iterate_time = clock::now() - start;
+	TESTEQUALS(sum, 10 * std::accumulate(keys.begin(), keys.end(), uint64_t{0}));
+
+	start = clock::now();
+	for (auto key : keys) {
+		map.erase(key);
+	}
+	auto erase_time = clock::now() - start;
+	map.empty() or TESTFAIL;
+
+	log::log(MSG(info) << name << ": insert " << ms(insert_time) << " ms, lookup "
+	                   << ms(lookup_time) << " ms (" << found << " hits), 10x iteration "
+	                   << ms(iterate_time) << " ms, erase "
+	                   << ms(erase_time) << " ms");
+}
+
+
+// exported benchmark
+void flat_hash_map_benchmark() {
+	const size_t count = 1000000;
+	std::mt19937_64 rng{42};
+
+	std::vector<uint64_t> keys(count);
+	for (auto &key : keys) {
+		key = rng() >> 1;
+	}
+
+	// half hits, half misses, in random order
+	std::vector<uint64_t> lookups = keys;
+	for (size_t i = 0; i < count; i += 2) {
+		lookups[i] = rng() | (1ull << 63);
+	}
+	std::shuffle(lookups.begin(), lookups.end(), rng);
+
+	log::log(MSG(info) << count << " random uint64_t keys");
+	time_map<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", keys, lookups);
+	time_map<FlatHashMap<uint64_t, uint64_t>>("FlatHashMap       ", keys, lookups);
+	time_map<NodeHashMap<uint64_t, uint64_t>>("NodeHashMap       ", keys, lookups);
+}
+
+
+/**
+ * Checks that apply to both bounded queues without other threads.
+ */
+template <template <typename> class queue_t>
+void bounded_queue_single_thread() {
+	queue_t<int> queue{5};
+	int value = -1;
+
+	TESTEQUALS(queue.capacity(), 8);
+	queue.empty() or TESTFAIL;
+	(not queue.try_pop(value)) or TESTFAIL;
+
+	// fill up, wrap around and drain
+	for (int round = 0; round < 3; ++round) {
+		for (int i = 0; i < 8; ++i) {
+			queue.try_push(round * 10 + i) or TESTFAIL;
+		}
+		(not queue.try_push(-1)) or TESTFAIL;
+		TESTEQUALS(queue.size(), 8);
+
+		queue.try_pop(value) or TESTFAIL;
+		TESTEQUALS(value, round * 10);
+		queue.push(round * 10 + 8);
+		for (int i = 1; i < 9; ++i) {
+			TESTEQUALS(queue.pop(), round * 10 + i);
+		}
+		queue.empty() or TESTFAIL;
+	}
+
+	// move-only elements
+	queue_t<std::unique_ptr<int>> unique{2};
+	unique.try_push(std::make_unique<int>(1)) or TESTFAIL;
+	unique.try_emplace(new int{2}) or TESTFAIL;
+	(not unique.try_push(std::make_unique<int>(3))) or TESTFAIL;
+	std::unique_ptr<int> elem = unique.pop();
+	TESTEQUALS(*elem, 1);
+	unique.try_pop(elem) or TESTFAIL;
+	TESTEQUALS(*elem, 2);
+
+	// remaining elements are destroyed by clear() and the destructor
+	auto shared = std::make_shared<int>(0);
+	{
+		queue_t<std::shared_ptr<int>> refs{4};
+		refs.push(shared);
+		refs.push(shared);
+		refs.clear();
+		refs.empty() or TESTFAIL;
+		TESTEQUALS(shared.use_count(), 1);
+		refs.push(shared);
+		TESTEQUALS(shared.use_count(), 2);
+	}
+	TESTEQUALS(shared.use_count(), 1);
+}
+
+
+// exported test
+void spsc_queue() {
+	bounded_queue_single_thread<SPSCQueue>();
+
+	// producer and consumer on different threads, through a small buffer
+	const int count = 200000;
+	SPSCQueue<int> queue{16};
+	std::thread producer{[&queue]() {
+		for (int i = 0; i < count; ++i) {
+			if (i % 2 == 0) {
+				queue.push(i);
+			}
+			else {
+				while (not queue.try_push(i)) {
+					std::this_thread::yield();
+				}
+			}
+		}
+	}};
+
+	// check after joining so that a failure does not leave the producer running
+	bool ordered = true;
+	int value;
+	for (int i = 0; i < count; ++i) {
+		if (i % 2 == 0) {
+			value = queue.pop();
+		}
+		else {
+			while (not queue.try_pop(value)) {
+				std::this_thread::yield();
+			}
+		}
+		ordered = ordered and value == i;
+	}
+	producer.join();
+	ordered or TESTFAIL;
+	queue.empty() or TESTFAIL;
+}
+
+
+// exported test
+void mpmc_queue() {
+	bounded_queue_single_thread<MPMCQueue>();
+
+	// every producer pushes an ascending sequence tagged with its index.
+	// each consumer must see the sequence of every producer in order,
+	// and all consumers together must see every element exactly once.
+	const size_t threads = 4;
+	const uint64_t count = 50000;
+	MPMCQueue<uint64_t> queue{64};
+
+	std::vector<std::thread> producers;
+	for (uint64_t p = 0; p < threads; ++p) {
+		producers.emplace_back([&queue, p]() {
+			for (uint64_t i = 0; i < count; ++i) {
+				if (i % 2 == 0) {
+					queue.push((p << 32) | i);
+				}
+				else {
+					while (not queue.try_push((p << 32) | i)) {
+						std::this_thread::yield();
+					}
+				}
+			}
+		});
+	}
+
+	// each consumer only writes its own result vector
+	std::vector<std::vector<uint64_t>> received(threads);
+	std::vector<std::thread> consumers;
+	for (size_t c = 0; c < threads; ++c) {
+		consumers.emplace_back([&queue, &received, c]() {
+			auto &values = received[c];
+			values.reserve(count);
+			for (uint64_t i = 0; i < count; ++i) {
+				values.push_back(queue.pop());
+			}
+		});
+	}
+
+	for (auto &thread : producers) {
+		thread.join();
+	}
+	for (auto &thread : consumers) {
+		thread.join();
+	}
+	queue.empty() or TESTFAIL;
+
+	std::vector<uint64_t> all;
+	for (auto &values : received) {
+		std::vector<int64_t> last(threads, -1);
+		for (auto value : values) {
+			auto producer = value >> 32;
+			auto seq = static_cast<int64_t>(value & 0xffffffff);
+			(seq > last[producer]) or TESTFAILMSG("elements of a producer were reordered");
+			last[producer] = seq;
+		}
+		all.insert(all.end(), values.begin(), values.end());
+	}
+
+	std::sort(all.begin(), all.end());
+	TESTEQUALS(all.size(), threads * count);
+	for (uint64_t p = 0; p < threads; ++p) {
+		for (uint64_t i = 0; i < count; ++i) {
+			TESTEQUALS(all[p * count + i], (p << 32) | i);
+		}
+	}
+}
+
+
+/**
+ * Move integers from producer to consumer threads through a queue.
+ *
+ * @param producers Number of producer threads.
+ * @param consumers Number of consumer threads.
+ * @param count Number of integers per producer.
+ * @param push Pushes an integer.
+ * @param pop Pops an integer, waiting until there is one.
+ *
+ * @return Time until all integers were consumed, in milliseconds.
+ */
+template <typename push_t, typename pop_t>
+double time_queue(size_t producers, size_t consumers, size_t count, push_t push, pop_t pop) {
+	std::atomic<int64_t> total{0};
+	std::vector<std::thread> threads;
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t p = 0; p < producers; ++p) {
+		threads.emplace_back([&push, count]() {
+			for (size_t i = 0; i < count; ++i) {
+				push(static_cast<int>(i));
+			}
+		});
+	}
+	for (size_t c = 0; c < consumers; ++c) {
+		threads.emplace_back([&pop, &total, count = producers * count / consumers]() {
+			int64_t sum = 0;
+			for (size_t i = 0; i < count; ++i) {
+				sum += pop();
+			}
+			total += sum;
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	auto duration = std::chrono::steady_clock::now() - start;
+
+	int64_t expected = producers * (static_cast<int64_t>(count) * (count - 1) / 2);
+	TESTEQUALS(total.load(), expected);
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+
+// exported benchmark
+void queue_benchmark() {
+	const size_t count = 1000000;
+	const size_t capacity = 1024;
+
+	const std::vector<std::pair<size_t, size_t>> setups{{1, 1}, {2, 2}, {4, 4}};
+	for (auto [producers, consumers] : setups) {
+		size_t elements = producers * count;
+		auto mops = [elements](double ms) {
+			return elements / ms / 1e3;
+		};
+
+		// ConcurrentQueue::pop() holds the recursive mutex twice while it waits
+		// for an element, so producers could never push. Poll under the lock instead.
+		ConcurrentQueue<int> locked;
+		auto locked_pop = [&locked]() {
+			while (true) {
+				auto lock = locked.lock();
+				if (not locked.empty()) {
+					return locked.pop();
+				}
+				lock.unlock();
+				std::this_thread::yield();
+			}
+		};
+		double locked_ms = time_queue(
+			producers, consumers, count, [&locked](int v) { locked.push(v); }, locked_pop);
+
+		MPMCQueue<int> mpmc{capacity};
+		double mpmc_ms = time_queue(
+			producers, consumers, count, [&mpmc](int v) { mpmc.push(v); }, [&mpmc]() { return mpmc.pop(); });
+
+		log::log(MSG(info) << producers << " producers, " << consumers << " consumers, "
+		                   << elements << " elements");
+		log::log(MSG(info) << "  ConcurrentQueue: " << locked_ms << " ms, " << mops(locked_ms) << " Mops/s");
+		log::log(MSG(info) << "  MPMCQueue:       " << mpmc_ms << " ms, " << mops(mpmc_ms) << " Mops/s");
+
+		if (producers == 1) {
+			SPSCQueue<int> spsc{capacity};
+			double spsc_ms = time_queue(
+				1, 1, count, [&spsc](int v) { spsc.push(v); }, [&spsc]() { return spsc.pop(); });
+			log::log(MSG(info) << "  SPSCQueue:       " << spsc_ms << " ms, " << mops(spsc_ms) << " Mops/s");
+		}
+	}
+}
+
+
+/**
+ * Over-aligned pool element.
+ */
+struct alignas(64) aligned_elem {
+	int data;
+};
+
+
+/**
+ * Pool element with a size that no other test uses.
+ */
+struct pool_elem {
+	uint64_t data[5];
+};
+
+
+/**
+ * Pool element for thread exit tests, with a pool of its own.
+ */
+struct exit_elem {
+	uint64_t data[9];
+};
+
+
+// exported test
+void object_pool() {
+	using pool_t = PoolAllocator<pool_elem>::pool_t;
+
+	// freed blocks are reused first
+	void *block = pool_t::allocate();
+	pool_t::deallocate(block);
+	(pool_t::allocate() == block) or TESTFAIL;
+	pool_t::deallocate(block);
+
+	PoolAllocator<aligned_elem> aligned;
+	std::vector<aligned_elem *> elems;
+	for (int i = 0; i < 100; ++i) {
+		elems.push_back(aligned.allocate(1));
+		(reinterpret_cast<uintptr_t>(elems.back()) % 64 == 0) or TESTFAIL;
+	}
+	for (auto elem : elems) {
+		aligned.deallocate(elem, 1);
+	}
+
+	// arrays bypass the pool
+	aligned_elem *array = aligned.allocate(3);
+	(reinterpret_cast<uintptr_t>(array) % 64 == 0) or TESTFAIL;
+	aligned.deallocate(array, 3);
+
+	// pooled objects are destroyed with their last reference
+	auto counted = std::make_shared<int>(0);
+	auto holder = make_pooled<std::shared_ptr<int>>(counted);
+	TESTEQUALS(counted.use_count(), 2);
+	holder.reset();
+	TESTEQUALS(counted.use_count(), 1);
+
+	std::list<int, PoolAllocator<int>> list;
+	for (int i = 0; i < 1000; ++i) {
+		list.push_back(i);
+	}
+	list.remove_if([](int i) { return i % 2 == 0; });
+	TESTEQUALS(list.size(), 500);
+	TESTEQUALS(list.front(), 1);
+
+	// blocks allocated on short-lived threads and freed on this one
+	// are recycled, so the pool stops growing after the first rounds
+	size_t chunks = 0;
+	for (int round = 0; round < 5; ++round) {
+		std::vector<std::shared_ptr<pool_elem>> objects;
+		std::thread producer{[&objects]() {
+			for (int i = 0; i < 10000; ++i) {
+				objects.push_back(std::allocate_shared<pool_elem>(PoolAllocator<pool_elem>{}));
+			}
+		}};
+		producer.join();
+		objects.clear();
+
+		if (round == 2) {
+			chunks = pool_chunk_count;
+		}
+	}
+	TESTEQUALS(pool_chunk_count, chunks);
+
+	// blocks that are freed by thread-locals after the pool has detached
+	// from the exiting thread are not lost
+	for (int round = 0; round < 50; ++round) {
+		std::thread worker{[]() {
+			thread_local std::vector<std::shared_ptr<exit_elem>> objects;
+			for (int i = 0; i < 100; ++i) {
+				objects.push_back(make_pooled<exit_elem>());
+			}
+		}};
+		worker.join();
+
+		if (round == 2) {
+			chunks = pool_chunk_count;
+		}
+	}
+	TESTEQUALS(pool_chunk_count, chunks);
+}
+
+
+/**
+ * Allocator that counts its allocations.
+ */
+template <typename T>
+struct counting_allocator {
+	using value_type = T;
+
+	explicit counting_allocator(size_t *count) :
+		count{count} {}
+
+	template <typename U>
+	counting_allocator(const counting_allocator<U> &other) :
+		count{other.count} {}
+
+	T *allocate(size_t n) {
+		*this->count += 1;
+		return std::allocator<T>{}.allocate(n);
+	}
+
+	void deallocate(T *ptr, size_t n) {
+		std::allocator<T>{}.deallocate(ptr, n);
+	}
+
+	template <typename U>
+	bool operator==(const counting_allocator<U> &other) const {
+		return this->count == other.count;
+	}
+
+	size_t *count;
+};
+
+
+/**
+ * Payload of about the size of an event.
+ */
+struct event_sized {
+	uint64_t data[12];
+};
+
+
+// exported benchmark
+void object_pool_benchmark() {
+	const size_t live = 10000;
+	const size_t replacements = 2000000;
+	using clock = std::chrono::steady_clock;
+
+	// keep a working set of shared objects and replace random ones,
+	// like the event store does while a game is running
+	auto churn = [live, replacements](auto make) {
+		std::mt19937 rng{42};
+		std::vector<std::shared_ptr<event_sized>> objects;
+		for (size_t i = 0; i < live; ++i) {
+			objects.push_back(make());
+		}
+
+		auto start = clock::now();
+		for (size_t i = 0; i < replacements; ++i) {
+			objects[rng() % live] = make();
+		}
+		return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	};
+
+	size_t heap_allocations = 0;
+	double heap_ms = churn([&heap_allocations]() {
+		return std::allocate_shared<event_sized>(counting_allocator<event_sized>{&heap_allocations});
+	});
+
+	size_t chunks_before = pool_chunk_count;
+	double pool_ms = churn([]() {
+		return make_pooled<event_sized>();
+	});
+	size_t pool_allocations = pool_chunk_count - chunks_before;
+
+	log::log(MSG(info) << live << " live shared objects, " << replacements << " replacements");
+	log::log(MSG(info) << "  allocate_shared: " << heap_ms << " ms, "
+	                   << heap_allocations << " allocations");
+	log::log(MSG(info) << "  make_pooled:     " << pool_ms << " ms, "
+	                   << pool_allocations << " chunk allocations");
+
+	// list nodes, like keyframe containers that grow and shrink
+	auto list_churn = [](auto list) {
+		auto start = clock::now();
+		for (size_t round = 0; round < 2000; ++round) {
+			for (int i = 0; i < 1000; ++i) {
+				list.push_back(i);
+			}
+			list.erase(++list.begin(), list.end());
+		}
+		return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	};
+
+	size_t list_allocations = 0;
+	double list_heap_ms = list_churn(std::list<int, counting_allocator<int>>{counting_allocator<int>{&list_allocations}});
+	double list_pool_ms = list_churn(std::list<int, PoolAllocator<int>>{});
+
+	log::log(MSG(info) << "2000 x 1000 list insertions and erasures");
+	log::log(MSG(info) << "  std::allocator: " << list_heap_ms << " ms, "
+	                   << list_allocations << " allocations");
+	log::log(MSG(info) << "  PoolAllocator:  " << list_pool_ms << " ms");
+}
+
 } // namespace openage::datastructure::tests
@@ -15,7 +15,8 @@ namespace openage::engine {
 
 Engine::Engine(mode mode,
                const util::Path &root_dir,
-               const std::vector<std::string> &mods) :
+               const std::vector<std::string> &mods,
+               const std::optional<util::Path> &journal_path) :
 	running{true},
 	run_mode{mode},
 	root_dir{root_dir},
@@ -35,6 +36,9 @@ Engine::Engine(mode mode,
 	                                                               this->cvar_manager,
 	                                                               this->time_loop);
 	this->simulation->set_modpacks(mods);
+	if (journal_path) {
+		this->simulation->record_journal(*journal_path);
+	}
 
 	if (this->run_mode == mode::FULL) {
 		this->presenter = std::make_shared<presenter::Presenter>(this->root_dir,
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
@@ -71,10 +72,12 @@ public:
      * @param mode The run mode to use.
      * @param root_dir openage root directory.
      * @param mods The mods to load.
+     * @param journal_path If set, the player input is recorded in a command journal at this path.
 	 */
 	Engine(mode mode,
 	       const util::Path &root_dir,
-	       const std::vector<std::string> &mods);
+	       const std::vector<std::string> &mods,
+	       const std::optional<util::Path> &journal_path = std::nullopt);
 
 	// engine should not be copied or moved
 	Engine(const Engine &) = delete;
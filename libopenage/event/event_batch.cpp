@@ -0,0 +1,105 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "event_batch.h"
+
+#include "event/event.h"
+#include "event/event_loop.h"
+#include "event/evententity.h"
+#include "log/log.h"
+
+
+namespace openage::event {
+
+
+EventBatch::EventBatch(EventLoop &loop,
+                       const std::shared_ptr<Event> &first,
+                       const std::shared_ptr<State> &state) :
+	loop{loop},
+	state{state},
+	handler{first->get_eventhandler()},
+	time{first->get_time()},
+	events{first},
+	next_idx{0},
+	count{0},
+	repeat_time{0} {
+	this->loop.queue.take_events_like(this->handler, this->time, this->events);
+	this->queue_next = this->loop.queue.peek_event();
+}
+
+
+std::shared_ptr<EventEntity> EventBatch::next() {
+	this->end_turn();
+
+	// events that earlier turns enqueued for the time of the batch come first
+	auto queue_next = this->loop.queue.peek_event();
+	if (queue_next != nullptr and queue_next != this->queue_next
+	    and queue_next->get_time() <= this->time) {
+		for (size_t i = this->next_idx; i < this->events.size(); ++i) {
+			this->loop.queue.reenqueue(this->events[i]);
+		}
+		this->next_idx = this->events.size();
+	}
+
+	while (this->next_idx < this->events.size()) {
+		auto &next = this->events[this->next_idx++];
+
+		auto target = next->get_entity().lock();
+		if (target) {
+			this->event = std::move(next);
+			this->target = std::move(target);
+			this->loop.active_event = this->event;
+			this->count += 1;
+			return this->target;
+		}
+
+		log::log(DBG << "Loop: event \"" << this->handler->id()
+		             << "\" ignored because its target does not exist anymore"
+		             << " for time t=" << this->time);
+	}
+
+	this->loop.active_event = nullptr;
+	return nullptr;
+}
+
+
+const std::shared_ptr<Event> &EventBatch::get_event() const {
+	return this->event;
+}
+
+
+size_t EventBatch::get_count() const {
+	return this->count;
+}
+
+
+const std::chrono::nanoseconds &EventBatch::get_repeat_time() const {
+	return this->repeat_time;
+}
+
+
+void EventBatch::finish() {
+	this->end_turn();
+	this->loop.active_event = nullptr;
+}
+
+
+void EventBatch::end_turn() {
+	if (this->event == nullptr) {
+		return;
+	}
+
+	if (this->loop.profiler.is_enabled()) {
+		auto start = std::chrono::steady_clock::now();
+		this->loop.repeat_event(this->event, this->target, this->state);
+		this->repeat_time += std::chrono::steady_clock::now() - start;
+	}
+	else {
+		this->loop.repeat_event(this->event, this->target, this->state);
+	}
+
+	this->event = nullptr;
+	this->target = nullptr;
+}
+
+
+} // namespace openage::event
@@ -0,0 +1,150 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "time/time.h"
+
+
+namespace openage::event {
+
+class Event;
+class EventEntity;
+class EventHandler;
+class EventLoop;
+class State;
+
+
+/**
+ * Events of a batchable event handler that happen at the same time.
+ *
+ * The events are taken from the event queue together when the batch is created,
+ * but the batch behaves exactly like invoking the events one after another:
+ * The target of an event is locked right before its turn, so events whose target
+ * was removed by an earlier event are skipped. If an earlier event of the batch
+ * enqueues an event that is due before the remaining ones, the batch ends and
+ * its remaining events are returned to the queue.
+ */
+class EventBatch {
+public:
+	/**
+	 * Create a new batch.
+	 *
+	 * @param loop Event loop that invokes the events.
+	 * @param first First event of the batch. Already taken from the queue.
+	 *              The following events of its handler and time are taken, too.
+	 * @param state Global state.
+	 */
+	EventBatch(EventLoop &loop,
+	           const std::shared_ptr<Event> &first,
+	           const std::shared_ptr<State> &state);
+	~EventBatch() = default;
+
+	EventBatch(const EventBatch &) = delete;
+	EventBatch &operator=(const EventBatch &) = delete;
+
+	/**
+	 * Advance to the next event of the batch.
+	 *
+	 * The previous event is reenqueued if it repeats. Event handlers must call
+	 * this until it returns \p nullptr and invoke every returned event.
+	 *
+	 * @return Target of the next event, \p nullptr if the batch has ended.
+	 */
+	std::shared_ptr<EventEntity> next();
+
+	/**
+	 * Get the event that was returned by the last \p next() call.
+	 *
+	 * @return Current event.
+	 */
+	const std::shared_ptr<Event> &get_event() const;
+
+	/**
+	 * Get the number of events whose turn has started.
+	 *
+	 * @return Number of invoked events.
+	 */
+	size_t get_count() const;
+
+	/**
+	 * Get the time spent in reenqueuing repeating events. Only measured
+	 * if profiling is enabled.
+	 *
+	 * @return Time spent for reenqueuing events.
+	 */
+	const std::chrono::nanoseconds &get_repeat_time() const;
+
+	/**
+	 * End the turn of the current event.
+	 */
+	void finish();
+
+private:
+	/**
+	 * Reenqueue the current event if it repeats and reset it.
+	 */
+	void end_turn();
+
+	/**
+	 * Event loop that invokes the events.
+	 */
+	EventLoop &loop;
+
+	/**
+	 * Global state.
+	 */
+	const std::shared_ptr<State> &state;
+
+	/**
+	 * Event handler of all events in the batch.
+	 */
+	std::shared_ptr<EventHandler> handler;
+
+	/**
+	 * Execution time of all events in the batch.
+	 */
+	time::time_t time;
+
+	/**
+	 * Events of the batch in execution order.
+	 */
+	std::vector<std::shared_ptr<Event>> events;
+
+	/**
+	 * Index of the next event in \p events.
+	 */
+	size_t next_idx;
+
+	/**
+	 * Next event in the queue after the events of the batch were taken.
+	 */
+	std::shared_ptr<Event> queue_next;
+
+	/**
+	 * Event of the current turn.
+	 */
+	std::shared_ptr<Event> event;
+
+	/**
+	 * Target of the current event, locked during its turn.
+	 */
+	std::shared_ptr<EventEntity> target;
+
+	/**
+	 * Number of invoked events.
+	 */
+	size_t count;
+
+	/**
+	 * Time spent in reenqueuing repeating events.
+	 */
+	std::chrono::nanoseconds repeat_time;
+};
+
+
+} // namespace openage::event
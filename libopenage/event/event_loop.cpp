@@ -2,8 +2,11 @@
 
 #include "event_loop.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -12,20 +15,55 @@
 
 #include "error/error.h"
 #include "event/event.h"
+#include "event/event_batch.h"
 #include "event/evententity.h"
 #include "event/eventhandler.h"
 #include "event/eventqueue.h"
 #include "event/eventstore.h"
+#include "job/job_manager.h"
+#include "trace/trace.h"
 #include "util/fixed_point.h"
 
 
 namespace openage::event {
 
+namespace {
+
+/**
+ * Change that was announced by an event running in a parallel batch.
+ */
+struct deferred_change {
+	std::shared_ptr<Event> evnt;
+	time::time_t time;
+};
+
+/**
+ * Change buffer of the event that is executed by the current thread
+ * in a parallel batch. nullptr outside of parallel execution.
+ */
+thread_local std::vector<deferred_change> *deferred_changes = nullptr;
+
+/**
+ * Redirects changes of the current thread into a buffer while it is alive.
+ */
+class defer_changes {
+public:
+	defer_changes(std::vector<deferred_change> &buffer) {
+		deferred_changes = &buffer;
+	}
+
+	~defer_changes() {
+		deferred_changes = nullptr;
+	}
+};
+
+} // namespace
+
 
 void EventLoop::add_event_handler(const std::shared_ptr<EventHandler> eventhandler) {
 	std::unique_lock lock{this->mutex};
 
-	classstore.insert(std::make_pair(eventhandler->id(), eventhandler));
+	classstore.insert(std::make_pair(util::Symbol{eventhandler->id()}, eventhandler));
 }
 
 
@@ -34,6 +72,19 @@ std::shared_ptr<Event> EventLoop::create_event(const std::string name,
                                                const std::shared_ptr<State> state,
                                                const time::time_t reference_time,
                                                const EventHandler::param_map params) {
+	return this->create_event(util::Symbol{name}, target, state, reference_time, params);
+}
+
+
+std::shared_ptr<Event> EventLoop::create_event(const util::Symbol &name,
+                                               const std::shared_ptr<EventEntity> target,
+                                               const std::shared_ptr<State> state,
+                                               const time::time_t reference_time,
+                                               const EventHandler::param_map params) {
+	if (deferred_changes != nullptr) {
+		throw Error{ERR << "target local events must not create events"};
+	}
+
 	std::unique_lock lock{this->mutex};
 
 	auto it = classstore.find(name);
@@ -51,11 +102,16 @@ std::shared_ptr<Event> EventLoop::create_event(const std::shared_ptr<EventHandle
                                                const std::shared_ptr<State> state,
                                                const time::time_t reference_time,
                                                const EventHandler::param_map params) {
+	if (deferred_changes != nullptr) {
+		throw Error{ERR << "target local events must not create events"};
+	}
+
 	std::unique_lock lock{this->mutex};
 
-	auto it = this->classstore.find(eventhandler->id());
+	util::Symbol id{eventhandler->id()};
+	auto it = this->classstore.find(id);
 	if (it == this->classstore.end()) {
-		auto res = this->classstore.insert(std::make_pair(eventhandler->id(), eventhandler));
+		auto res = this->classstore.insert(std::make_pair(id, eventhandler));
 		if (res.second) {
 			it = res.first;
 		}
@@ -70,6 +126,7 @@ std::shared_ptr<Event> EventLoop::create_event(const std::shared_ptr<EventHandle
 
 void EventLoop::reach_time(const time::time_t &time_until,
                            const std::shared_ptr<State> &state) {
+	TRACE_ZONE("EventLoop::reach_time", "event");
 	std::unique_lock lock{this->mutex};
 
 	// TODO detect infinite loops (is this a halting problem?)
@@ -104,6 +161,13 @@ void EventLoop::reach_time(const time::time_t &time_until,
 	// in the main loop for one frame - which is bad btw.
 	this->queue.swap_changesets();
 	log::log(SPAM << "Loop: t=" << time_until << " was reached! ========");
+
+	if (this->profiler.is_enabled()) {
+		this->profiler.record_reach(attempts);
+		this->profiler.sample_queue(time_until,
+		                            this->queue.get_event_queue().size(),
+		                            this->queue.get_changes().size());
+	}
 }
 
 
@@ -123,61 +187,296 @@ int EventLoop::execute_events(const time::time_t &time_until,
 
 	int cnt = 0;
 
+	// target local events that are collected for parallel execution
+	std::vector<std::shared_ptr<Event>> batch;
+	std::unordered_set<EventEntity *> batch_targets;
+
 	while (true) {
-		// fetch an event from the queue that happens before <= time_until
-		std::shared_ptr<Event> event = this->queue.take_event(time_until);
+		// fetch an event from the queue that happens before <= time_until.
+		// only events with the same time are collected, because repeating
+		// events of the batch are reenqueued after the batch and may be due
+		// before any later event.
+		auto max_time = batch.empty() ? time_until : batch.front()->get_time();
+		std::shared_ptr<Event> event = this->queue.take_event(max_time);
 		if (event == nullptr) {
-			break;
+			if (batch.empty()) {
+				break;
+			}
+
+			cnt += this->invoke_parallel(batch, state);
+			batch_targets.clear();
+			continue;
 		}
 
-		auto target = event->get_entity().lock();
+		if (this->job_manager != nullptr and event->get_eventhandler()->is_target_local()) {
+			auto target = event->get_entity().lock();
+			if (target) {
+				if (batch_targets.contains(target.get())) {
+					// events for the same target must not run concurrently
+					cnt += this->invoke_parallel(batch, state);
+					batch_targets.clear();
+				}
 
-		if (target) {
-			log::log(DBG << "Loop: invoking event \"" << event->get_eventhandler()->id()
-			             << "\" on target \"" << target->idstr()
-			             << "\" for time t=" << event->get_time());
+				batch.push_back(event);
+				batch_targets.insert(target.get());
+				continue;
+			}
+		}
+
+		// keep the execution order of previously collected events
+		cnt += this->invoke_parallel(batch, state);
+		batch_targets.clear();
+
+		if (event->get_eventhandler()->is_batchable()) {
+			cnt += this->invoke_batch(event, state);
+			continue;
+		}
+
+		cnt += this->invoke_event(event, state);
+	}
+
+	return cnt;
+}
+
+
+int EventLoop::invoke_event(const std::shared_ptr<Event> &event,
+                            const std::shared_ptr<State> &state) {
+	auto target = event->get_entity().lock();
 
-			this->active_event = event;
+	if (target) {
+		TRACE_ZONE("EventLoop::invoke_event", "event");
 
-			// apply the event effects
+		log::log(DBG << "Loop: invoking event \"" << event->get_eventhandler()->id()
+		             << "\" on target \"" << target->idstr()
+		             << "\" for time t=" << event->get_time());
+
+		this->active_event = event;
+
+		// apply the event effects
+		if (this->profiler.is_enabled()) {
+			auto start = std::chrono::steady_clock::now();
 			event->get_eventhandler()->invoke(
 				*this, target, state, event->get_time(), event->get_params());
+			this->profiler.record_invoke(event->get_eventhandler()->id(),
+			                             std::chrono::steady_clock::now() - start);
+		}
+		else {
+			event->get_eventhandler()->invoke(
+				*this, target, state, event->get_time(), event->get_params());
+		}
 
-			this->active_event = nullptr;
-			cnt += 1;
+		this->active_event = nullptr;
 
-			// if the event is REPEAT, readd the event.
-			if (event->get_eventhandler()->type == EventHandler::trigger_type::REPEAT) {
-				time::time_t new_time = event->get_eventhandler()->predict_invoke_time(
-					target, state, event->get_time());
+		this->repeat_event(event, target, state);
 
-				if (new_time != std::numeric_limits<time::time_t>::min()) {
-					event->set_time(new_time);
+		return 1;
+	}
+
+	// The element was already removed from the queue, so we can safely
+	// kill it by ignoring it.
+	log::log(DBG << "Loop: event \"" << event->get_eventhandler()->id()
+	             << "\" ignored because its target does not exist anymore "
+	             << "\" for time t=" << event->get_time());
+
+	return 0;
+}
+
+
+int EventLoop::invoke_parallel(std::vector<std::shared_ptr<Event>> &batch,
+                               const std::shared_ptr<State> &state) {
+	int cnt = 0;
 
-					log::log(DBG << "Loop: repeating event \"" << event->get_eventhandler()->id()
-					             << "\" on target \"" << target->idstr()
-					             << "\" will be reenqueued for time t=" << event->get_time());
+	if (batch.size() < this->parallel_batch_size) {
+		// not worth the job overhead
+		for (const auto &event : batch) {
+			cnt += this->invoke_event(event, state);
+		}
+		batch.clear();
+		return cnt;
+	}
 
-					this->queue.reenqueue(event);
+	log::log(SPAM << "Loop: invoking " << batch.size() << " events in parallel");
+
+	// the targets are kept alive until all jobs are done
+	std::vector<std::shared_ptr<EventEntity>> targets;
+	targets.reserve(batch.size());
+	for (const auto &event : batch) {
+		targets.push_back(event->get_entity().lock());
+	}
+
+	bool profile = this->profiler.is_enabled();
+	std::vector<std::chrono::nanoseconds> durations(profile ? batch.size() : 0);
+
+	// the active event is not set for the jobs, since several events run at once.
+	// it is only used to attribute changes, which are collected per event instead.
+	std::vector<std::vector<deferred_change>> changes(batch.size());
+	std::vector<job::Job<bool>> jobs;
+	for (size_t start = 0; start < batch.size(); start += this->parallel_batch_size) {
+		size_t end = std::min(start + this->parallel_batch_size, batch.size());
+
+		jobs.push_back(this->job_manager->enqueue<bool>([&, start, end]() {
+			TRACE_ZONE("EventLoop::invoke_parallel", "event");
+			for (size_t i = start; i < end; ++i) {
+				const auto &event = batch[i];
+				defer_changes defer{changes[i]};
+
+				if (profile) {
+					auto start = std::chrono::steady_clock::now();
+					event->get_eventhandler()->invoke(
+						*this, targets[i], state, event->get_time(), event->get_params());
+					durations[i] = std::chrono::steady_clock::now() - start;
+				}
+				else {
+					event->get_eventhandler()->invoke(
+						*this, targets[i], state, event->get_time(), event->get_params());
 				}
 			}
+			return true;
+		}));
+	}
+
+	for (auto &job : jobs) {
+		job.wait();
+	}
+
+	// clean up the finished jobs and rethrow exceptions from the workers
+	this->job_manager->execute_callbacks();
+	for (auto &job : jobs) {
+		job.get_result();
+	}
+
+	// apply the collected changes in the original event order
+	for (size_t i = 0; i < batch.size(); ++i) {
+		if (profile) {
+			const auto &handler = batch[i]->get_eventhandler()->id();
+			this->profiler.record_invoke(handler, durations[i]);
+			for (size_t j = 0; j < changes[i].size(); ++j) {
+				this->profiler.record_change(handler);
+			}
 		}
-		else {
-			// The element was already removed from the queue, so we can safely
-			// kill it by ignoring it.
-			log::log(DBG << "Loop: event \"" << event->get_eventhandler()->id()
-			             << "\" ignored because its target does not exist anymore "
-			             << "\" for time t=" << event->get_time());
+
+		for (const auto &change : changes[i]) {
+			this->queue.add_change(change.evnt, change.time);
 		}
+
+		this->repeat_event(batch[i], targets[i], state);
+		cnt += 1;
 	}
+
+	batch.clear();
 	return cnt;
 }
 
 
+int EventLoop::invoke_batch(const std::shared_ptr<Event> &event,
+                            const std::shared_ptr<State> &state) {
+	auto handler = event->get_eventhandler();
+	auto time = event->get_time();
+
+	log::log(DBG << "Loop: invoking batch of events \"" << handler->id()
+	             << "\" for time t=" << time);
+
+	// the batch takes the following events of the handler and time from the queue
+	EventBatch batch{*this, event, state};
+
+	if (this->profiler.is_enabled()) {
+		auto start = std::chrono::steady_clock::now();
+		handler->invoke_batch(*this, batch, state, time);
+		batch.finish();
+		auto duration = std::chrono::steady_clock::now() - start - batch.get_repeat_time();
+
+		// individual invoke times are unknown, so the batch is one sample
+		if (batch.get_count() > 0) {
+			this->profiler.record_invoke(handler->id(), duration);
+		}
+	}
+	else {
+		handler->invoke_batch(*this, batch, state, time);
+		batch.finish();
+	}
+
+	return batch.get_count();
+}
+
+
+void EventLoop::repeat_event(const std::shared_ptr<Event> &event,
+                             const std::shared_ptr<EventEntity> &target,
+                             const std::shared_ptr<State> &state) {
+	// if the event is REPEAT, readd the event.
+	if (event->get_eventhandler()->type == EventHandler::trigger_type::REPEAT) {
+		time::time_t new_time = this->predict_invoke_time(event, target, state, event->get_time());
+
+		if (new_time != std::numeric_limits<time::time_t>::min()) {
+			event->set_time(new_time);
+
+			log::log(DBG << "Loop: repeating event \"" << event->get_eventhandler()->id()
+			             << "\" on target \"" << target->idstr()
+			             << "\" will be reenqueued for time t=" << event->get_time());
+
+			this->queue.reenqueue(event);
+
+			if (this->profiler.is_enabled()) {
+				this->profiler.record_reenqueue(event->get_eventhandler()->id());
+			}
+		}
+	}
+}
+
+
+time::time_t EventLoop::predict_invoke_time(const std::shared_ptr<Event> &event,
+                                            const std::shared_ptr<EventEntity> &target,
+                                            const std::shared_ptr<State> &state,
+                                            const time::time_t &at) {
+	if (not this->profiler.is_enabled()) {
+		return event->get_eventhandler()->predict_invoke_time(target, state, at);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	auto result = event->get_eventhandler()->predict_invoke_time(target, state, at);
+	this->profiler.record_predict(event->get_eventhandler()->id(),
+	                              std::chrono::steady_clock::now() - start);
+
+	return result;
+}
+
+
+EventProfiler &EventLoop::get_profiler() {
+	return this->profiler;
+}
+
+
+void EventLoop::set_parallel(job::JobManager *job_manager, size_t batch_size) {
+	std::unique_lock lock{this->mutex};
+
+	ENSURE(batch_size > 0, "parallel batch size must be greater than 0");
+
+	this->job_manager = job_manager;
+	this->parallel_batch_size = batch_size;
+}
+
+
+std::optional<time::time_t> EventLoop::next_event_time() {
+	std::unique_lock lock{this->mutex};
+
+	return this->queue.next_event_time();
+}
+
+
 void EventLoop::create_change(const std::shared_ptr<Event> evnt,
                               const time::time_t changes_at) {
+	if (deferred_changes != nullptr) {
+		// the loop is locked by the thread that executes the batch,
+		// the change is applied after the batch has finished
+		deferred_changes->push_back({evnt, changes_at});
+		return;
+	}
+
 	std::unique_lock lock{this->mutex};
 
+	if (this->active_event and this->profiler.is_enabled()) {
+		this->profiler.record_change(this->active_event->get_eventhandler()->id());
+	}
+
 	this->queue.add_change(evnt, changes_at);
 }
 
@@ -201,8 +500,7 @@ void EventLoop::update_changes(const std::shared_ptr<State> &state) {
 				auto entity = evnt->get_entity().lock();
 
 				if (entity) {
-					time::time_t new_time = evnt->get_eventhandler()
-					                            ->predict_invoke_time(entity, state, change.time);
+					time::time_t new_time = this->predict_invoke_time(evnt, entity, state, change.time);
 
 					if (new_time != std::numeric_limits<time::time_t>::min()) {
 						log::log(DBG << "Loop: due to a change, rescheduling event of '"
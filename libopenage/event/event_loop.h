@@ -4,15 +4,24 @@
 
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "event/eventhandler.h"
 #include "event/eventqueue.h"
+#include "event/profiler.h"
 #include "time/time.h"
+#include "util/symbol.h"
 
 
-namespace openage::event {
+namespace openage {
+namespace job {
+class JobManager;
+} // namespace job
+
+namespace event {
 
 // The demo wants to display internal details
 namespace demo {
@@ -31,6 +40,9 @@ class EventLoop {
 	// because the demo function displays internal info.
 	friend int demo::curvepong();
 
+	// invokes the events of a batch in turn
+	friend class EventBatch;
+
 public:
 	/**
      * Create a new event loop.
@@ -65,6 +77,26 @@ public:
 	                                    const time::time_t reference_time,
 	                                    const EventHandler::param_map params = EventHandler::param_map({}));
 
+	/**
+	 * Add a new event to the queue using a registered event handler.
+     *
+     * Prefer this over passing the handler ID as string in hot paths, as the
+     * handler lookup does not need to hash the string.
+     *
+     * @param eventhandler Interned event handler ID. The handler must already be registered on the loop.
+     * @param target Target entity. Can be \p nullptr.
+     * @param state Global state.
+     * @param reference_time Reference time to calculate the event execution time. The actual
+     *                       depends execution time on the type of event and may be changed
+     *                       by other events.
+     * @param params Event parameters map (default = {}). Passed to the event handler on event execution.
+	 */
+	std::shared_ptr<Event> create_event(const util::Symbol &eventhandler,
+	                                    const std::shared_ptr<EventEntity> target,
+	                                    const std::shared_ptr<State> state,
+	                                    const time::time_t reference_time,
+	                                    const EventHandler::param_map params = EventHandler::param_map({}));
+
 	/**
 	 * Add a new event to the queue using an arbritary event handler. If an event handler
      * with the same ID is already registered, the registered event handler will be used
@@ -111,6 +143,41 @@ public:
 	void create_change(const std::shared_ptr<Event> event,
 	                   const time::time_t changes_at);
 
+	/**
+	 * Enable parallel execution of events.
+	 *
+	 * Events whose handlers are target local (see \p EventHandler::is_target_local())
+	 * and that happen at the same time are partitioned by target and
+	 * invoked on the workers of the job manager. Events for the
+	 * same target and events of other handlers are still executed serially
+	 * in their original order. Changes announced by parallel events are applied
+	 * in the original event order, so the results are deterministic.
+	 *
+	 * @param job_manager Job manager whose workers invoke the events. Must be started.
+	 *                    If \p nullptr, all events are executed serially.
+	 * @param batch_size Number of events that are invoked by a single job. If fewer
+	 *                   events can run in parallel, they are executed serially.
+	 */
+	void set_parallel(job::JobManager *job_manager, size_t batch_size = 64);
+
+	/**
+	 * Get the profiler that collects handler and queue statistics of this loop.
+	 * Profiling is disabled until it is enabled on the profiler.
+	 *
+	 * @return Event profiler.
+	 */
+	EventProfiler &get_profiler();
+
+	/**
+	 * Get the time of the next pending event or change in the queue.
+	 *
+	 * Simulations running in virtual time can advance their clock directly
+	 * to this point, since nothing happens in between.
+	 *
+	 * @return Time of the next pending event, \p std::nullopt if the queue is empty.
+	 */
+	std::optional<time::time_t> next_event_time();
+
 	/**
      * Get the event queue.
      *
@@ -132,6 +199,68 @@ private:
 	int execute_events(const time::time_t &time_until,
 	                   const std::shared_ptr<State> &state);
 
+	/**
+	 * Invoke a single event and reenqueue it if it repeats.
+	 *
+	 * @param event Event to invoke.
+	 * @param state Global state.
+	 *
+	 * @returns 1 if the event was invoked, 0 if its target does not exist anymore.
+	 */
+	int invoke_event(const std::shared_ptr<Event> &event,
+	                 const std::shared_ptr<State> &state);
+
+	/**
+	 * Invoke a batch of target local events for pairwise different targets
+	 * that happen at the same time. The batch is cleared afterwards.
+	 *
+	 * @param batch Events to invoke, in execution order.
+	 * @param state Global state.
+	 *
+	 * @returns number of events processed
+	 */
+	int invoke_parallel(std::vector<std::shared_ptr<Event>> &batch,
+	                    const std::shared_ptr<State> &state);
+
+	/**
+	 * Invoke an event of a batchable handler together with the following
+	 * events of the handler that happen at the same time with a single
+	 * \p EventHandler::invoke_batch() call.
+	 *
+	 * @param event First event of the batch.
+	 * @param state Global state.
+	 *
+	 * @returns number of events processed
+	 */
+	int invoke_batch(const std::shared_ptr<Event> &event,
+	                 const std::shared_ptr<State> &state);
+
+	/**
+	 * Let the handler of an event predict its next invoke time.
+	 *
+	 * @param event Event whose invoke time is predicted.
+	 * @param target Target of the event.
+	 * @param state Global state.
+	 * @param at Reference time for the prediction.
+	 *
+	 * @returns predicted invoke time.
+	 */
+	time::time_t predict_invoke_time(const std::shared_ptr<Event> &event,
+	                                 const std::shared_ptr<EventEntity> &target,
+	                                 const std::shared_ptr<State> &state,
+	                                 const time::time_t &at);
+
+	/**
+	 * Reenqueue an event after it was invoked if its handler is REPEAT.
+	 *
+	 * @param event Invoked event.
+	 * @param target Target of the event.
+	 * @param state Global state.
+	 */
+	void repeat_event(const std::shared_ptr<Event> &event,
+	                  const std::shared_ptr<EventEntity> &target,
+	                  const std::shared_ptr<State> &state);
+
 	/**
 	 * Call all the time change functions. This is constant on the state!
      *
@@ -142,7 +271,7 @@ private:
 	/**
 	 * Here we do the bookkeeping of registered event handleres.
 	 */
-	std::unordered_map<std::string, std::shared_ptr<EventHandler>> classstore;
+	std::unordered_map<util::Symbol, std::shared_ptr<EventHandler>> classstore;
 
 	/**
 	 * All events are enqueued here.
@@ -152,13 +281,30 @@ private:
 	/**
 	 * The currently processed event.
 	 * This is useful for event cancelations (so one can't cancel itself).
+	 * Not set while events are invoked in parallel.
 	 */
 	std::shared_ptr<Event> active_event;
 
+	/**
+	 * Job manager for parallel event execution. \p nullptr if disabled.
+	 */
+	job::JobManager *job_manager = nullptr;
+
+	/**
+	 * Number of events invoked by one job in parallel execution.
+	 */
+	size_t parallel_batch_size = 64;
+
+	/**
+	 * Collects profiling data of executed events.
+	 */
+	EventProfiler profiler;
+
 	/**
 	 * Mutex for protecting threaded access.
 	 */
 	std::recursive_mutex mutex;
 };
 
-} // namespace openage::event
+} // namespace event
+} // namespace openage
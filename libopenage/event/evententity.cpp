@@ -31,7 +31,7 @@ void EventEntity::changes(const time::time_t &time) {
 
 	// This is a maybe-erase construct so obsolete dependents are cleaned up.
 	for (auto it = this->dependents.begin(); it != this->dependents.end();) {
-		auto dependent = it->lock();
+		auto dependent = it->second.lock();
 		if (dependent and not dependent->get_entity().expired()) {
 			switch (dependent->get_eventhandler()->type) {
 			case EventHandler::trigger_type::DEPENDENCY_IMMEDIATELY:
@@ -82,7 +82,7 @@ void EventEntity::trigger(const time::time_t &last_valid_time) {
 	// the only events that is "notified" by are TRIGGER.
 
 	for (auto it = this->dependents.begin(); it != this->dependents.end();) {
-		auto dependent = it->lock();
+		auto dependent = it->second.lock();
 		if (dependent) {
 			if (dependent->get_eventhandler()->type == EventHandler::trigger_type::TRIGGER) {
 				log::log(DBG << "Target: trigger creates a change for "
@@ -102,13 +102,14 @@ void EventEntity::trigger(const time::time_t &last_valid_time) {
 
 
 void EventEntity::add_dependent(const std::shared_ptr<Event> &event) {
-	this->dependents.emplace_back(event);
+	// a dead event may have left an entry at the same address
+	this->dependents.insert_or_assign(event.get(), event);
 }
 
 void EventEntity::show_dependents() const {
 	log::log(DBG << "Dependent list:");
 	for (auto &dep : this->dependents) {
-		auto dependent = dep.lock();
+		auto dependent = dep.second.lock();
 		if (dependent) {
 			log::log(DBG << " - " << dependent->get_eventhandler()->id());
 		}
@@ -4,10 +4,10 @@
 
 #include <cstddef>
 #include <functional>
-#include <list>
 #include <memory>
 #include <string>
 
+#include "datastructure/flat_hash_map.h"
 #include "time/time.h"
 
 namespace openage::event {
@@ -72,8 +72,11 @@ private:
 	/** Event loop this target is registered to */
 	std::shared_ptr<EventLoop> loop;
 
-	/** List of events that depend on this target */
-	std::list<std::weak_ptr<Event>> dependents;
+	/**
+	 * Events that depend on this target, by their address.
+	 * An event is only notified once, even if it was added several times.
+	 */
+	datastructure::FlatHashMap<const Event *, std::weak_ptr<Event>> dependents;
 
 	single_change_notifier parent_notifier;
 };
@@ -2,6 +2,10 @@
 
 #include "eventhandler.h"
 
+#include "event/event.h"
+#include "event/event_batch.h"
+
+
 namespace openage::event {
 
 
@@ -15,6 +19,26 @@ const std::string &EventHandler::id() {
 }
 
 
+bool EventHandler::is_target_local() const {
+	return false;
+}
+
+
+bool EventHandler::is_batchable() const {
+	return false;
+}
+
+
+void EventHandler::invoke_batch(EventLoop &loop,
+                                EventBatch &batch,
+                                const std::shared_ptr<State> &state,
+                                const time::time_t &time) {
+	while (auto target = batch.next()) {
+		this->invoke(loop, target, state, time, batch.get_event()->get_params());
+	}
+}
+
+
 DependencyEventHandler::DependencyEventHandler(const std::string &name) :
 	EventHandler(name, EventHandler::trigger_type::DEPENDENCY) {}
 
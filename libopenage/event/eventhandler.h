@@ -16,6 +16,7 @@
 namespace openage::event {
 
 class Event;
+class EventBatch;
 class EventLoop;
 class EventEntity;
 class State;
@@ -184,6 +185,47 @@ public:
 	                                         const std::shared_ptr<State> &state,
 	                                         const time::time_t &at) = 0;
 
+	/**
+	 * Check if the events of this handler only access their target.
+	 *
+	 * Such events can be invoked in parallel with events for other targets
+	 * if the event loop has parallel execution enabled. This must only return true
+	 * if \p invoke() exclusively writes to its target, reads no state that
+	 * other events write and does not create new events. Changes that
+	 * the target announces are collected and applied in the original event order.
+	 *
+	 * @return true if the events can run in parallel, false if they must be executed serially.
+	 */
+	virtual bool is_target_local() const;
+
+	/**
+	 * Check if the events of this handler can be invoked in batches.
+	 *
+	 * If true, the loop passes consecutive ready events of this handler with
+	 * the same time to \p invoke_batch() in a single call.
+	 *
+	 * @return true if the events are invoked in batches, false if \p invoke() is called per event.
+	 */
+	virtual bool is_batchable() const;
+
+	/**
+	 * Implements the effects of multiple events of this handler that happen
+	 * at the same time. Only called if \p is_batchable() returns true.
+	 *
+	 * The events are invoked in turn by calling \p EventBatch::next() until
+	 * it returns \p nullptr. The default implementation calls \p invoke()
+	 * for every event.
+	 *
+	 * @param loop Event loop that invokes the events.
+	 * @param batch Events in execution order.
+	 * @param state Global state.
+	 * @param time Execution time of all events.
+	 */
+	virtual void invoke_batch(EventLoop &loop,
+	                          EventBatch &batch,
+	                          const std::shared_ptr<State> &state,
+	                          const time::time_t &time);
+
 private:
 	/**
 	 * String identifier for this event handler.
@@ -8,6 +8,7 @@
 
 #include "log/message.h"
 
+#include "datastructure/object_pool.h"
 #include "event/event.h"
 #include "event/evententity.h"
 #include "event/eventhandler.h"
@@ -24,7 +25,7 @@ std::shared_ptr<Event> EventQueue::create_event(const std::shared_ptr<EventEntit
                                                 const std::shared_ptr<State> &state,
                                                 const time::time_t &reference_time,
                                                 const EventHandler::param_map &params) {
-	auto event = std::make_shared<Event>(trgt, cls, params);
+	auto event = datastructure::make_pooled<Event>(trgt, cls, params);
 
 	cls->setup_event(event, state);
 
@@ -182,6 +183,48 @@ std::shared_ptr<Event> EventQueue::take_event(const time::time_t &max_time) {
 }
 
 
+std::shared_ptr<Event> EventQueue::peek_event() {
+	if (this->event_queue.size() == 0) {
+		return nullptr;
+	}
+
+	return this->event_queue.top();
+}
+
+
+void EventQueue::take_events_like(const std::shared_ptr<EventHandler> &handler,
+                                  const time::time_t &time,
+                                  std::vector<std::shared_ptr<Event>> &events) {
+	while (this->event_queue.size() > 0) {
+		const auto &next = this->event_queue.top();
+		if (next->get_eventhandler() != handler
+		    or next->get_time() != time) {
+			break;
+		}
+
+		events.push_back(this->event_queue.pop());
+	}
+}
+
+
+std::optional<time::time_t> EventQueue::next_event_time() const {
+	std::optional<time::time_t> next;
+	if (not this->event_queue.empty()) {
+		next = this->event_queue.heap.top()->get_time();
+	}
+
+	for (const auto *changeset : {this->changes, this->future_changes}) {
+		for (const auto &change : *changeset) {
+			if (not next or change.time < *next) {
+				next = change.time;
+			}
+		}
+	}
+
+	return next;
+}
+
+
 const EventQueue::change_set &EventQueue::get_changes() const {
 	return *this->changes;
 }
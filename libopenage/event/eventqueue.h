@@ -4,7 +4,9 @@
 
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <unordered_set>
+#include <vector>
 
 #include "event/eventhandler.h"
 #include "event/eventstore.h"
@@ -105,6 +107,34 @@ public:
 	 */
 	std::shared_ptr<Event> take_event(const time::time_t &max_time);
 
+	/**
+	 * Get the next event from the `event_queue` without removing it.
+	 *
+	 * @return Next event or \p nullptr if the queue is empty.
+	 */
+	std::shared_ptr<Event> peek_event();
+
+	/**
+	 * Obtain the next events from the `event_queue` as long as they have
+	 * the given event handler and time.
+	 *
+	 * @param handler Event handler of the events.
+	 * @param time Execution time of the events.
+	 * @param events The events are appended to this vector in queue order.
+	 */
+	void take_events_like(const std::shared_ptr<EventHandler> &handler,
+	                      const time::time_t &time,
+	                      std::vector<std::shared_ptr<Event>> &events);
+
+	/**
+	 * Get the earliest time at which something is pending in the queue, i.e.
+	 * the execution time of the next event or the time of the earliest
+	 * change that still has to be processed.
+	 *
+	 * @return Time of the next pending event or change, \p std::nullopt if nothing is pending.
+	 */
+	std::optional<time::time_t> next_event_time() const;
+
 	/**
 	 * Get the change_set to process changes.
 	 */
@@ -4,9 +4,9 @@
 
 #include <cstddef>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
+#include "datastructure/flat_hash_map.h"
 #include "datastructure/pairing_heap.h"
 #include "event/event.h"
 #include "util/misc.h"
@@ -24,7 +24,7 @@ public:
 	//       instead, use the event-sharedpointer directly.
 	using heap_t = datastructure::PairingHeap<std::shared_ptr<Event>,
 	                                          util::SharedPtrLess<Event>>;
-	using elemmap_t = std::unordered_map<std::shared_ptr<Event>, heap_t::element_t>;
+	using elemmap_t = datastructure::FlatHashMap<std::shared_ptr<Event>, heap_t::element_t>;
 
 	void push(const std::shared_ptr<Event> &event);
 	std::shared_ptr<Event> pop();
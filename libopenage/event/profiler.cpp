@@ -0,0 +1,223 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "log/log.h"
+#include "log/message.h"
+
+#include "util/file.h"
+#include "util/path.h"
+#include "util/strings.h"
+
+
+namespace openage::event {
+
+EventProfiler::EventProfiler(const time::time_t &sample_interval,
+                             size_t max_samples) :
+	enabled{false},
+	sample_interval{sample_interval},
+	max_samples{max_samples},
+	handlers{},
+	reach{},
+	samples{} {
+}
+
+
+void EventProfiler::set_enabled(bool enabled) {
+	this->enabled.store(enabled, std::memory_order_relaxed);
+
+	log::log(MSG(info) << "Event profiling " << (enabled ? "enabled" : "disabled"));
+}
+
+
+void EventProfiler::record_invoke(const std::string &handler,
+                                  const std::chrono::nanoseconds &duration) {
+	std::unique_lock lock{this->mutex};
+
+	auto &record = this->handlers[handler];
+	record.profile.invocations += 1;
+	record.profile.invoke_time += duration;
+	record.profile.invoke_max = std::max(record.profile.invoke_max, duration);
+
+	// only the recent durations are kept for the percentile
+	if (record.durations.size() < this->max_samples) {
+		record.durations.push_back(duration);
+	}
+	else {
+		record.durations[record.next_duration] = duration;
+		record.next_duration = (record.next_duration + 1) % this->max_samples;
+	}
+}
+
+
+void EventProfiler::record_predict(const std::string &handler,
+                                   const std::chrono::nanoseconds &duration) {
+	std::unique_lock lock{this->mutex};
+
+	auto &profile = this->handlers[handler].profile;
+	profile.predictions += 1;
+	profile.predict_time += duration;
+}
+
+
+void EventProfiler::record_change(const std::string &handler) {
+	std::unique_lock lock{this->mutex};
+
+	this->handlers[handler].profile.changes += 1;
+}
+
+
+void EventProfiler::record_reenqueue(const std::string &handler) {
+	std::unique_lock lock{this->mutex};
+
+	this->handlers[handler].profile.reenqueues += 1;
+}
+
+
+void EventProfiler::record_reach(size_t attempts) {
+	std::unique_lock lock{this->mutex};
+
+	this->reach.calls += 1;
+	this->reach.attempts += attempts;
+	this->reach.max_attempts = std::max(this->reach.max_attempts, attempts);
+}
+
+
+void EventProfiler::sample_queue(const time::time_t &time,
+                                 size_t events,
+                                 size_t changes) {
+	std::unique_lock lock{this->mutex};
+
+	if (not this->samples.empty()
+	    and time < this->samples.back().time + this->sample_interval) {
+		return;
+	}
+
+	this->samples.push_back({time, events, changes});
+	if (this->samples.size() > this->max_samples) {
+		this->samples.pop_front();
+	}
+}
+
+
+std::unordered_map<std::string, handler_profile> EventProfiler::get_handler_profiles() const {
+	std::unique_lock lock{this->mutex};
+
+	std::unordered_map<std::string, handler_profile> result;
+	for (const auto &[id, record] : this->handlers) {
+		result.emplace(id, EventProfiler::make_profile(record));
+	}
+	return result;
+}
+
+
+std::optional<handler_profile> EventProfiler::get_handler_profile(const std::string &handler) const {
+	std::unique_lock lock{this->mutex};
+
+	auto it = this->handlers.find(handler);
+	if (it == this->handlers.end()) {
+		return std::nullopt;
+	}
+	return EventProfiler::make_profile(it->second);
+}
+
+
+reach_profile EventProfiler::get_reach_profile() const {
+	std::unique_lock lock{this->mutex};
+
+	return this->reach;
+}
+
+
+std::vector<queue_sample> EventProfiler::get_queue_samples() const {
+	std::unique_lock lock{this->mutex};
+
+	return {this->samples.begin(), this->samples.end()};
+}
+
+
+void EventProfiler::reset() {
+	std::unique_lock lock{this->mutex};
+
+	this->handlers.clear();
+	this->reach = {};
+	this->samples.clear();
+}
+
+
+std::string EventProfiler::to_json() const {
+	auto profiles = this->get_handler_profiles();
+	auto reach = this->get_reach_profile();
+	auto samples = this->get_queue_samples();
+
+	// sort by cumulative invoke time, the most expensive handlers come first
+	std::vector<std::pair<std::string, handler_profile>> sorted{profiles.begin(), profiles.end()};
+	std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+		return a.second.invoke_time > b.second.invoke_time;
+	});
+
+	std::ostringstream out;
+	out << "{\"handlers\": [";
+	for (size_t i = 0; i < sorted.size(); ++i) {
+		const auto &[id, profile] = sorted[i];
+		out << (i > 0 ? ", " : "") << "{\"id\": ";
+		util::json_string(out, id);
+		out << ", \"invocations\": " << profile.invocations
+		    << ", \"invoke_ns\": " << profile.invoke_time.count()
+		    << ", \"invoke_max_ns\": " << profile.invoke_max.count()
+		    << ", \"invoke_p99_ns\": " << profile.invoke_p99.count()
+		    << ", \"predictions\": " << profile.predictions
+		    << ", \"predict_ns\": " << profile.predict_time.count()
+		    << ", \"changes\": " << profile.changes
+		    << ", \"reenqueues\": " << profile.reenqueues
+		    << "}";
+	}
+	out << "], \"reach_time\": {"
+	    << "\"calls\": " << reach.calls
+	    << ", \"attempts\": " << reach.attempts
+	    << ", \"max_attempts\": " << reach.max_attempts
+	    << "}, \"queue\": [";
+	for (size_t i = 0; i < samples.size(); ++i) {
+		out << (i > 0 ? ", " : "")
+		    << "{\"time\": " << samples[i].time.to_double()
+		    << ", \"events\": " << samples[i].events
+		    << ", \"changes\": " << samples[i].changes
+		    << "}";
+	}
+	out << "]}";
+
+	return out.str();
+}
+
+
+void EventProfiler::save_json(const util::Path &path) const {
+	auto file = path.open_w();
+	file.write(this->to_json());
+	file.close();
+
+	log::log(MSG(info) << "Event profile has been written to " << path);
+}
+
+
+std::chrono::nanoseconds EventProfiler::percentile_99(const handler_record &record) {
+	if (record.durations.empty()) {
+		return std::chrono::nanoseconds{0};
+	}
+
+	auto durations = record.durations;
+	auto nth = durations.begin() + (durations.size() - 1) * 99 / 100;
+	std::nth_element(durations.begin(), nth, durations.end());
+	return *nth;
+}
+
+
+handler_profile EventProfiler::make_profile(const handler_record &record) {
+	handler_profile profile = record.profile;
+	profile.invoke_p99 = EventProfiler::percentile_99(record);
+	return profile;
+}
+
+} // namespace openage::event
@@ -0,0 +1,266 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "time/time.h"
+
+
+namespace openage {
+namespace util {
+class Path;
+}
+
+namespace event {
+
+/**
+ * Collected profiling data of one event handler.
+ */
+struct handler_profile {
+	/// Number of invoked events.
+	size_t invocations = 0;
+	/// Cumulative time spent in \p invoke().
+	std::chrono::nanoseconds invoke_time{0};
+	/// Longest \p invoke() call.
+	std::chrono::nanoseconds invoke_max{0};
+	/// 99th percentile of the recent \p invoke() calls.
+	std::chrono::nanoseconds invoke_p99{0};
+
+	/// Number of \p predict_invoke_time() calls.
+	size_t predictions = 0;
+	/// Cumulative time spent in \p predict_invoke_time().
+	std::chrono::nanoseconds predict_time{0};
+
+	/// Number of changes announced while the handler's events were invoked.
+	size_t changes = 0;
+	/// Number of times a REPEAT event of the handler was reenqueued.
+	size_t reenqueues = 0;
+};
+
+/**
+ * Size of the event queue at a point in time.
+ */
+struct queue_sample {
+	/// Time that the event loop has reached.
+	time::time_t time;
+	/// Number of scheduled events.
+	size_t events;
+	/// Number of pending changes.
+	size_t changes;
+};
+
+/**
+ * Collected profiling data of \p EventLoop::reach_time() calls.
+ */
+struct reach_profile {
+	/// Number of \p reach_time() calls.
+	size_t calls = 0;
+	/// Total number of attempts until the events settled.
+	size_t attempts = 0;
+	/// Largest number of attempts of a single call.
+	size_t max_attempts = 0;
+};
+
+/**
+ * Collects timing and count statistics of an event loop.
+ *
+ * Profiling is disabled by default. While it is disabled, the event loop
+ * only checks \p is_enabled() and records nothing.
+ */
+class EventProfiler {
+public:
+	/**
+	 * Create a new profiler.
+	 *
+	 * @param sample_interval Minimum simulation time between two queue samples.
+	 * @param max_samples Number of queue samples and invoke durations per handler that are kept.
+	 */
+	EventProfiler(const time::time_t &sample_interval = 1,
+	              size_t max_samples = 1024);
+	~EventProfiler() = default;
+
+	/**
+	 * Check if profiling is enabled.
+	 *
+	 * @return true if enabled, else false.
+	 */
+	bool is_enabled() const {
+		return this->enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Enable or disable profiling. Data that has already been collected is kept.
+	 *
+	 * @param enabled true to enable profiling, false to disable it.
+	 */
+	void set_enabled(bool enabled);
+
+	/**
+	 * Record an invoked event.
+	 *
+	 * @param handler ID of the event handler.
+	 * @param duration Time spent in \p invoke(), or in \p invoke_batch() for
+	 *                 a batch of events.
+	 */
+	void record_invoke(const std::string &handler,
+	                   const std::chrono::nanoseconds &duration);
+
+	/**
+	 * Record an invoke time prediction.
+	 *
+	 * @param handler ID of the event handler.
+	 * @param duration Time spent in \p predict_invoke_time().
+	 */
+	void record_predict(const std::string &handler,
+	                    const std::chrono::nanoseconds &duration);
+
+	/**
+	 * Record a change that was announced by an invoked event.
+	 *
+	 * @param handler ID of the handler of the invoked event.
+	 */
+	void record_change(const std::string &handler);
+
+	/**
+	 * Record a reenqueued REPEAT event.
+	 *
+	 * @param handler ID of the event handler.
+	 */
+	void record_reenqueue(const std::string &handler);
+
+	/**
+	 * Record a finished \p reach_time() call.
+	 *
+	 * @param attempts Number of attempts until the events settled.
+	 */
+	void record_reach(size_t attempts);
+
+	/**
+	 * Sample the queue size. Samples are only stored if the sample interval
+	 * has passed since the last sample.
+	 *
+	 * @param time Time that the event loop has reached.
+	 * @param events Number of scheduled events.
+	 * @param changes Number of pending changes.
+	 */
+	void sample_queue(const time::time_t &time,
+	                  size_t events,
+	                  size_t changes);
+
+	/**
+	 * Get the profiles of all handlers that were recorded.
+	 *
+	 * @return Map of handler ID to profile.
+	 */
+	std::unordered_map<std::string, handler_profile> get_handler_profiles() const;
+
+	/**
+	 * Get the profile of a single handler.
+	 *
+	 * @param handler ID of the event handler.
+	 *
+	 * @return Profile of the handler, \p std::nullopt if nothing was recorded for it.
+	 */
+	std::optional<handler_profile> get_handler_profile(const std::string &handler) const;
+
+	/**
+	 * Get the statistics of \p reach_time() calls.
+	 *
+	 * @return Reach time profile.
+	 */
+	reach_profile get_reach_profile() const;
+
+	/**
+	 * Get the recent queue samples, oldest first.
+	 *
+	 * @return Queue samples.
+	 */
+	std::vector<queue_sample> get_queue_samples() const;
+
+	/**
+	 * Discard all collected data.
+	 */
+	void reset();
+
+	/**
+	 * Get the collected data as JSON.
+	 *
+	 * @return JSON document.
+	 */
+	std::string to_json() const;
+
+	/**
+	 * Write the collected data as JSON to a file.
+	 *
+	 * @param path Output path.
+	 */
+	void save_json(const util::Path &path) const;
+
+private:
+	/**
+	 * Profile and recent invoke durations of a handler.
+	 */
+	struct handler_record {
+		handler_profile profile;
+		std::vector<std::chrono::nanoseconds> durations;
+		size_t next_duration = 0;
+	};
+
+	/**
+	 * Calculate the 99th percentile of the recent invoke durations.
+	 */
+	static std::chrono::nanoseconds percentile_99(const handler_record &record);
+
+	/**
+	 * Get the profile of a handler with the percentile filled in.
+	 */
+	static handler_profile make_profile(const handler_record &record);
+
+	/**
+	 * Whether profiling is enabled.
+	 */
+	std::atomic<bool> enabled;
+
+	/**
+	 * Minimum simulation time between two queue samples.
+	 */
+	const time::time_t sample_interval;
+
+	/**
+	 * Number of kept queue samples and invoke durations per handler.
+	 */
+	const size_t max_samples;
+
+	/**
+	 * Recorded handler data by handler ID.
+	 */
+	std::unordered_map<std::string, handler_record> handlers;
+
+	/**
+	 * Recorded reach time data.
+	 */
+	reach_profile reach;
+
+	/**
+	 * Recent queue samples.
+	 */
+	std::deque<queue_sample> samples;
+
+	/**
+	 * Mutex for protecting threaded access.
+	 */
+	mutable std::mutex mutex;
+};
+
+} // namespace event
+} // namespace openage
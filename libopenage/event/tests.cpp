@@ -1,23 +1,34 @@
 // Copyright 2017-2023 the openage authors. See copying.md for legal info.
 
+#include <algorithm>
+#include <chrono>
 #include <compare>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <list>
+#include <sstream>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "log/log.h"
 #include "log/message.h"
 #include "testing/testing.h"
 
 #include "event/event.h"
+#include "event/event_batch.h"
 #include "event/event_loop.h"
 #include "event/evententity.h"
 #include "event/eventhandler.h"
+#include "event/profiler.h"
 #include "event/state.h"
+#include "job/job_manager.h"
+#include "time/clock.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
 
@@ -231,6 +242,341 @@ public:
 };
 
 
+/**
+ * Steps the number of its target once per second.
+ * Only writes to its target, so it can run in parallel.
+ */
+class TargetLocalEventHandler : public EventHandler {
+public:
+	explicit TargetLocalEventHandler(const std::string &name) :
+		EventHandler(name, EventHandler::trigger_type::REPEAT) {}
+
+	void setup_event(const std::shared_ptr<Event> & /*event*/,
+	                 const std::shared_ptr<State> & /*state*/) override {}
+
+	void invoke(EventLoop & /*loop*/,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> & /*state*/,
+	            const time::time_t &time,
+	            const EventHandler::param_map & /*param*/) override {
+		auto t = std::dynamic_pointer_cast<TestState::TestObject>(target);
+		t->set_number(t->number + 1, time);
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		return at + time::time_t::from_double(1);
+	}
+
+	bool is_target_local() const override {
+		return true;
+	}
+};
+
+
+/**
+ * Records the changes of its target in the state trace.
+ */
+class ObserverEventHandler : public EventHandler {
+public:
+	explicit ObserverEventHandler(const std::string &name) :
+		EventHandler(name, EventHandler::trigger_type::DEPENDENCY) {}
+
+	void setup_event(const std::shared_ptr<Event> &event,
+	                 const std::shared_ptr<State> & /*state*/) override {
+		event->depend_on(event->get_entity().lock());
+	}
+
+	void invoke(EventLoop & /*loop*/,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> &gstate,
+	            const time::time_t &time,
+	            const EventHandler::param_map & /*param*/) override {
+		auto state = std::dynamic_pointer_cast<TestState>(gstate);
+		auto t = std::dynamic_pointer_cast<TestState::TestObject>(target);
+
+		std::stringstream ss;
+		ss << t->idstr() << "=" << t->number;
+		state->trace.emplace_back(ss.str(), time);
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		return at;
+	}
+};
+
+
+/**
+ * Object that records the events invoked on it.
+ */
+class TracedObject : public TestState::TestObject {
+public:
+	TracedObject(const std::shared_ptr<EventLoop> &loop, int id) :
+		TestState::TestObject(loop, id) {}
+
+	std::list<TestState::traceelement> trace;
+};
+
+
+/**
+ * Repeats with a fixed period and records its invocations in its target.
+ * Only writes to its target, so it can run in parallel.
+ */
+class PeriodicEventHandler : public EventHandler {
+public:
+	PeriodicEventHandler(const std::string &name, const time::time_t &period) :
+		EventHandler(name, EventHandler::trigger_type::REPEAT),
+		period{period} {}
+
+	void setup_event(const std::shared_ptr<Event> & /*event*/,
+	                 const std::shared_ptr<State> & /*state*/) override {}
+
+	void invoke(EventLoop & /*loop*/,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> & /*state*/,
+	            const time::time_t &time,
+	            const EventHandler::param_map & /*param*/) override {
+		auto t = std::dynamic_pointer_cast<TracedObject>(target);
+		t->trace.emplace_back(this->id(), time);
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		return at + this->period;
+	}
+
+	bool is_target_local() const override {
+		return true;
+	}
+
+private:
+	const time::time_t period;
+};
+
+
+/**
+ * Run repeating events with different periods on two objects until t=2.
+ *
+ * @param job_manager Job manager for parallel execution. nullptr runs the events serially.
+ * @param batch_size Parallel batch size of the loop.
+ *
+ * @return The two objects.
+ */
+std::vector<std::shared_ptr<TracedObject>> run_periodic(job::JobManager *job_manager,
+                                                        size_t batch_size) {
+	auto loop = std::make_shared<EventLoop>();
+	if (job_manager != nullptr) {
+		loop->set_parallel(job_manager, batch_size);
+	}
+
+	loop->add_event_handler(std::make_shared<PeriodicEventHandler>("fast", time::time_t::from_double(0.5)));
+	loop->add_event_handler(std::make_shared<PeriodicEventHandler>("slow", 1));
+
+	auto state = std::make_shared<State>(loop);
+	auto x = std::make_shared<TracedObject>(loop, 0);
+	auto y = std::make_shared<TracedObject>(loop, 1);
+
+	// fast on x at 1, 1.5, 2; slow on y at 1.2; slow on x at 1.7
+	loop->create_event("fast", x, state, time::time_t::from_double(0.5));
+	loop->create_event("slow", y, state, time::time_t::from_double(0.2));
+	loop->create_event("slow", x, state, time::time_t::from_double(0.7));
+
+	loop->reach_time(2, state);
+
+	return {x, y};
+}
+
+
+/**
+ * Run objects with target local events until the given time.
+ *
+ * @param job_manager Job manager for parallel execution. nullptr runs the events serially.
+ * @param objects Number of objects.
+ * @param until Time that the loop should reach.
+ * @param observe Whether changes of the objects are observed by non-local events.
+ *
+ * @return Final state.
+ */
+std::shared_ptr<TestState> run_target_local(job::JobManager *job_manager,
+                                            size_t objects,
+                                            const time::time_t &until,
+                                            bool observe) {
+	auto loop = std::make_shared<EventLoop>();
+	if (job_manager != nullptr) {
+		loop->set_parallel(job_manager, 16);
+	}
+
+	loop->add_event_handler(std::make_shared<TargetLocalEventHandler>("step"));
+	loop->add_event_handler(std::make_shared<ObserverEventHandler>("observe"));
+
+	auto state = std::make_shared<TestState>(loop);
+	auto gstate = std::static_pointer_cast<State>(state);
+
+	std::vector<std::shared_ptr<TestState::TestObject>> units;
+	for (size_t i = 0; i < objects; ++i) {
+		auto unit = std::make_shared<TestState::TestObject>(loop, i + 2);
+		loop->create_event("step", unit, gstate, 0);
+		if (observe) {
+			loop->create_event("observe", unit, gstate, 0);
+		}
+		units.push_back(unit);
+	}
+
+	for (time::time_t t = 1; t <= until; t += 1) {
+		loop->reach_time(t, gstate);
+	}
+
+	for (const auto &unit : units) {
+		TESTEQUALS(unit->number, until.to_int());
+	}
+
+	return state;
+}
+
+
+/**
+ * Counts up the number of its target once per second without announcing changes.
+ */
+class CountEventHandler : public EventHandler {
+public:
+	CountEventHandler(const std::string &name, bool batchable) :
+		EventHandler(name, EventHandler::trigger_type::REPEAT),
+		batchable{batchable} {}
+
+	void setup_event(const std::shared_ptr<Event> & /*event*/,
+	                 const std::shared_ptr<State> & /*state*/) override {}
+
+	void invoke(EventLoop & /*loop*/,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> & /*state*/,
+	            const time::time_t & /*time*/,
+	            const EventHandler::param_map & /*param*/) override {
+		static_cast<TestState::TestObject *>(target.get())->number += 1;
+		this->largest_batch = std::max<size_t>(this->largest_batch, 1);
+	}
+
+	void invoke_batch(EventLoop & /*loop*/,
+	                  EventBatch &batch,
+	                  const std::shared_ptr<State> & /*state*/,
+	                  const time::time_t & /*time*/) override {
+		size_t size = 0;
+		while (auto target = batch.next()) {
+			static_cast<TestState::TestObject *>(target.get())->number += 1;
+			size += 1;
+		}
+		this->largest_batch = std::max(this->largest_batch, size);
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		return at + time::time_t::from_double(1);
+	}
+
+	bool is_batchable() const override {
+		return this->batchable;
+	}
+
+	const bool batchable;
+	size_t largest_batch = 0;
+};
+
+
+/**
+ * Records the order of its invocations and calls a hook on the first one.
+ */
+class HookEventHandler : public EventHandler {
+public:
+	using hook_t = std::function<void(EventLoop &, const std::shared_ptr<EventEntity> &, const time::time_t &)>;
+
+	HookEventHandler(const std::string &name, bool batchable, std::vector<std::string> &order) :
+		EventHandler(name, EventHandler::trigger_type::ONCE),
+		batchable{batchable},
+		order{order} {}
+
+	void setup_event(const std::shared_ptr<Event> & /*event*/,
+	                 const std::shared_ptr<State> & /*state*/) override {}
+
+	void invoke(EventLoop &loop,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> & /*state*/,
+	            const time::time_t &time,
+	            const EventHandler::param_map & /*param*/) override {
+		this->order.push_back(this->id());
+		if (this->hook) {
+			auto hook = std::move(this->hook);
+			this->hook = nullptr;
+			hook(loop, target, time);
+		}
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		return at;
+	}
+
+	bool is_batchable() const override {
+		return this->batchable;
+	}
+
+	const bool batchable;
+	std::vector<std::string> &order;
+	hook_t hook;
+};
+
+
+/**
+ * Run objects with counting events until the given time.
+ *
+ * @param objects Number of objects.
+ * @param until Time that the loop should reach.
+ * @param batchable Whether the events are invoked in batches.
+ *
+ * @return Time spent in the event loop.
+ */
+std::chrono::nanoseconds run_count(size_t objects,
+                                   const time::time_t &until,
+                                   bool batchable) {
+	auto loop = std::make_shared<EventLoop>();
+	auto handler = std::make_shared<CountEventHandler>("count", batchable);
+	loop->add_event_handler(handler);
+
+	auto state = std::make_shared<TestState>(loop);
+	auto gstate = std::static_pointer_cast<State>(state);
+
+	std::vector<std::shared_ptr<TestState::TestObject>> units;
+	for (size_t i = 0; i < objects; ++i) {
+		auto unit = std::make_shared<TestState::TestObject>(loop, i + 2);
+		loop->create_event("count", unit, gstate, 0);
+		units.push_back(unit);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (time::time_t t = 1; t <= until; t += 1) {
+		loop->reach_time(t, gstate);
+	}
+	auto duration = std::chrono::steady_clock::now() - start;
+
+	for (const auto &unit : units) {
+		TESTEQUALS(unit->number, until.to_int());
+	}
+
+	if (batchable and objects > 1) {
+		(handler->largest_batch > 1) or TESTFAILMSG("events were not batched");
+	}
+	else {
+		TESTEQUALS(handler->largest_batch, 1);
+	}
+
+	return duration;
+}
+
+
 void eventtrigger() {
 	log::log(DBG << "------------- [ Starting Test: Basic Ping Pong ] ------------");
 
@@ -593,4 +939,361 @@ void eventtrigger() {
 	}
 }
 
+
+void virtual_time() {
+	auto loop = std::make_shared<EventLoop>();
+
+	loop->add_event_handler(std::make_shared<TestEventHandler>("test_on_A", 0));
+	loop->add_event_handler(std::make_shared<TestEventHandler>("test_on_B", 1));
+
+	auto state = std::make_shared<TestState>(loop);
+	auto gstate = std::static_pointer_cast<State>(state);
+
+	// same setup as the ping pong test
+	loop->create_event("test_on_B", state->objectB, gstate, 1);
+	loop->create_event("test_on_A", state->objectA, gstate, 1);
+	state->objectA->set_number(0, 0);
+
+	time::Clock clock;
+	clock.set_mode(time::ClockMode::VIRTUAL);
+	clock.start();
+
+	// virtual time does not follow real time
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	clock.update_time();
+	TESTEQUALS(clock.get_time(), 0);
+
+	// time can't go backwards
+	clock.advance_to(5);
+	clock.advance_to(3);
+	TESTEQUALS(clock.get_time(), 5);
+	TESTEQUALS(clock.get_real_time(), 5);
+
+	// jump directly from one event to the next
+	time::Clock sim_clock;
+	sim_clock.set_mode(time::ClockMode::VIRTUAL);
+	sim_clock.start();
+
+	size_t steps = 0;
+	while (sim_clock.get_time() < 20) {
+		auto next_time = loop->next_event_time();
+		next_time or TESTFAILMSG("event queue ran empty");
+
+		sim_clock.advance_to(*next_time);
+		loop->reach_time(sim_clock.get_time(), gstate);
+
+		steps += 1;
+		(steps < 100) or TESTFAILMSG("virtual time does not advance");
+	}
+
+	// the events happen at the same times as in the ping pong test
+	const std::vector<std::pair<std::string, time::time_t>> expected{
+		{"B", 3},
+		{"A", 6},
+		{"B", 9},
+		{"A", 12},
+		{"B", 15},
+		{"A", 18},
+	};
+	(state->trace.size() >= expected.size()) or TESTFAILMSG("not enough items collected");
+
+	auto it = state->trace.begin();
+	for (const auto &[name, time] : expected) {
+		TESTEQUALS(it->name, name);
+		TESTEQUALS(it->time, time);
+		++it;
+	}
+
+	(sim_clock.get_throughput() > 0) or TESTFAIL;
+
+	// a speed limit makes advancing wait for real time
+	sim_clock.set_virtual_speed(1000);
+	auto start = std::chrono::steady_clock::now();
+	sim_clock.advance_to(sim_clock.get_time() + 5);
+	auto passed = std::chrono::steady_clock::now() - start;
+	(passed >= std::chrono::milliseconds(4)) or TESTFAILMSG("virtual speed limit is ignored");
+
+	// real time continues from the virtual time
+	auto virtual_end = sim_clock.get_time();
+	sim_clock.set_mode(time::ClockMode::REALTIME);
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	sim_clock.update_time();
+	(sim_clock.get_time() > virtual_end) or TESTFAIL;
+	(sim_clock.get_time() < virtual_end + 1) or TESTFAIL;
+}
+
+
+void parallel_execution() {
+	job::JobManager job_manager{4};
+	job_manager.start();
+
+	auto serial = run_target_local(nullptr, 100, 10, true);
+	auto parallel = run_target_local(&job_manager, 100, 10, true);
+
+	// non-local events see the same changes at the same times.
+	// the order of events with the same time is not defined, so compare sorted traces.
+	auto by_time = [](const auto &a, const auto &b) {
+		return std::tie(a.time, a.name) < std::tie(b.time, b.name);
+	};
+	serial->trace.sort(by_time);
+	parallel->trace.sort(by_time);
+
+	TESTEQUALS(serial->trace.size(), parallel->trace.size());
+	(not serial->trace.empty()) or TESTFAIL;
+
+	auto it = parallel->trace.begin();
+	for (const auto &elem : serial->trace) {
+		TESTEQUALS(it->name, elem.name);
+		TESTEQUALS(it->time, elem.time);
+		++it;
+	}
+
+	// without observers, all events of a time step run in parallel batches
+	run_target_local(&job_manager, 100, 10, false);
+
+	auto loop = std::make_shared<EventLoop>();
+	TESTTHROWS(loop->set_parallel(&job_manager, 0));
+
+	job_manager.stop();
+}
+
+
+void parallel_repeat_order() {
+	job::JobManager job_manager{4};
+	job_manager.start();
+
+	auto serial = run_periodic(nullptr, 1);
+
+	// the events of x are invoked in time order
+	std::vector<std::pair<std::string, time::time_t>> expected{
+		{"fast", 1},
+		{"fast", time::time_t::from_double(1.5)},
+		{"slow", time::time_t::from_double(1.7)},
+		{"fast", 2},
+	};
+	TESTEQUALS(serial[0]->trace.size(), expected.size());
+	auto it = serial[0]->trace.begin();
+	for (const auto &[name, time] : expected) {
+		TESTEQUALS(it->name, name);
+		TESTEQUALS(it->time, time);
+		++it;
+	}
+
+	// repeating events are due again before the later events of their target,
+	// both with parallel jobs and with the serial fallback for small batches
+	for (size_t batch_size : {1, 16}) {
+		auto parallel = run_periodic(&job_manager, batch_size);
+
+		for (size_t i = 0; i < serial.size(); ++i) {
+			TESTEQUALS(parallel[i]->trace.size(), serial[i]->trace.size());
+
+			auto it = parallel[i]->trace.begin();
+			for (const auto &elem : serial[i]->trace) {
+				TESTEQUALS(it->name, elem.name);
+				TESTEQUALS(it->time, elem.time);
+				++it;
+			}
+		}
+	}
+
+	job_manager.stop();
+}
+
+
+void parallel_benchmark() {
+	const size_t units = 10000;
+	const time::time_t until = 20;
+
+	job::JobManager job_manager{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+	job_manager.start();
+
+	auto start = std::chrono::steady_clock::now();
+	run_target_local(nullptr, units, until, false);
+	auto serial = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	run_target_local(&job_manager, units, until, false);
+	auto parallel = std::chrono::steady_clock::now() - start;
+
+	job_manager.stop();
+
+	auto serial_ms = std::chrono::duration<double, std::milli>(serial).count();
+	auto parallel_ms = std::chrono::duration<double, std::milli>(parallel).count();
+
+	log::log(MSG(info) << units << " units, " << until << "s of events: "
+	                   << "serial " << serial_ms << " ms, "
+	                   << "parallel " << parallel_ms << " ms "
+	                   << "(" << serial_ms / parallel_ms << "x)");
+}
+
+
+void profiling() {
+	auto loop = std::make_shared<EventLoop>();
+	loop->add_event_handler(std::make_shared<TargetLocalEventHandler>("step"));
+	loop->add_event_handler(std::make_shared<ObserverEventHandler>("observe"));
+
+	auto state = std::make_shared<TestState>(loop);
+	auto gstate = std::static_pointer_cast<State>(state);
+
+	auto unit = std::make_shared<TestState::TestObject>(loop, 2);
+	loop->create_event("step", unit, gstate, 0);
+	loop->create_event("observe", unit, gstate, 0);
+
+	auto &profiler = loop->get_profiler();
+
+	// nothing is recorded while profiling is disabled
+	loop->reach_time(1, gstate);
+	profiler.get_handler_profiles().empty() or TESTFAIL;
+	TESTEQUALS(profiler.get_reach_profile().calls, 0);
+
+	profiler.set_enabled(true);
+	for (time::time_t t = 2; t <= 10; t += 1) {
+		loop->reach_time(t, gstate);
+	}
+
+	auto step = profiler.get_handler_profile("step");
+	step or TESTFAIL;
+	TESTEQUALS(step->invocations, 9);
+	TESTEQUALS(step->predictions, 9);
+	TESTEQUALS(step->reenqueues, 9);
+	TESTEQUALS(step->changes, 9);
+	(step->invoke_p99 <= step->invoke_max) or TESTFAIL;
+	(step->invoke_max <= step->invoke_time) or TESTFAIL;
+
+	auto observe = profiler.get_handler_profile("observe");
+	observe or TESTFAIL;
+	(observe->invocations > 0) or TESTFAIL;
+	(observe->predictions > 0) or TESTFAIL;
+	TESTEQUALS(observe->changes, 0);
+	TESTEQUALS(observe->reenqueues, 0);
+
+	auto reach = profiler.get_reach_profile();
+	TESTEQUALS(reach.calls, 9);
+	(reach.attempts >= 2 * reach.calls) or TESTFAIL;
+	(reach.max_attempts >= 2) or TESTFAIL;
+
+	// one sample per second
+	auto samples = profiler.get_queue_samples();
+	TESTEQUALS(samples.size(), 9);
+	TESTEQUALS(samples.front().time, 2);
+	TESTEQUALS(samples.back().time, 10);
+	(samples.back().events > 0) or TESTFAIL;
+
+	auto json = profiler.to_json();
+	(json.find("\"id\": \"step\"") != std::string::npos) or TESTFAIL;
+	(json.find("\"reach_time\": {\"calls\": 9") != std::string::npos) or TESTFAIL;
+
+	// handler IDs are escaped in the JSON dump
+	profiler.record_invoke("tab\tname\x01", std::chrono::nanoseconds{1});
+	json = profiler.to_json();
+	(json.find("\"id\": \"tab\\tname\\u0001\"") != std::string::npos) or TESTFAIL;
+
+	profiler.reset();
+	profiler.get_handler_profiles().empty() or TESTFAIL;
+	profiler.get_queue_samples().empty() or TESTFAIL;
+}
+
+
+void batch_dispatch() {
+	run_count(100, 10, false);
+	run_count(100, 10, true);
+
+	// events of removed targets are skipped
+	{
+		auto loop = std::make_shared<EventLoop>();
+		loop->add_event_handler(std::make_shared<CountEventHandler>("count", true));
+
+		auto state = std::make_shared<TestState>(loop);
+		auto gstate = std::static_pointer_cast<State>(state);
+
+		auto kept = std::make_shared<TestState::TestObject>(loop, 2);
+		auto removed = std::make_shared<TestState::TestObject>(loop, 3);
+		loop->create_event("count", kept, gstate, 0);
+		loop->create_event("count", removed, gstate, 0);
+		removed.reset();
+
+		loop->reach_time(3, gstate);
+		TESTEQUALS(kept->number, 3);
+	}
+
+	// events of a batch see the effects of the earlier events
+	{
+		auto loop = std::make_shared<EventLoop>();
+		std::vector<std::string> order;
+		auto batch = std::make_shared<HookEventHandler>("batch", true, order);
+		loop->add_event_handler(batch);
+		loop->add_event_handler(std::make_shared<HookEventHandler>("mark", false, order));
+
+		auto state = std::make_shared<TestState>(loop);
+		auto gstate = std::static_pointer_cast<State>(state);
+
+		std::vector<std::shared_ptr<TestState::TestObject>> units;
+		for (int i = 0; i < 3; ++i) {
+			units.push_back(std::make_shared<TestState::TestObject>(loop, i + 2));
+			loop->create_event("batch", units.back(), gstate, 1);
+		}
+
+		batch->hook = [&](EventLoop &loop,
+		                  const std::shared_ptr<EventEntity> &target,
+		                  const time::time_t &time) {
+			// remove a unit whose event has not been invoked yet
+			for (auto it = units.begin(); it != units.end(); ++it) {
+				if (it->get() != target.get()) {
+					units.erase(it);
+					break;
+				}
+			}
+
+			// must run before the remaining event of the batch
+			loop.create_event("mark", target, gstate, time - time::time_t::from_double(0.5));
+		};
+
+		loop->reach_time(1, gstate);
+
+		TESTEQUALS(order.size(), 3);
+		TESTEQUALS(order[0], "batch");
+		TESTEQUALS(order[1], "mark");
+		TESTEQUALS(order[2], "batch");
+	}
+
+	// a batch is profiled as one sample
+	{
+		auto loop = std::make_shared<EventLoop>();
+		auto handler = std::make_shared<CountEventHandler>("count", true);
+		loop->add_event_handler(handler);
+		loop->get_profiler().set_enabled(true);
+
+		auto state = std::make_shared<TestState>(loop);
+		auto gstate = std::static_pointer_cast<State>(state);
+
+		std::vector<std::shared_ptr<TestState::TestObject>> units;
+		for (int i = 0; i < 5; ++i) {
+			units.push_back(std::make_shared<TestState::TestObject>(loop, i + 2));
+			loop->create_event("count", units.back(), gstate, 0);
+		}
+
+		loop->reach_time(1, gstate);
+		TESTEQUALS(handler->largest_batch, 5);
+
+		auto count = loop->get_profiler().get_handler_profile("count");
+		count or TESTFAIL;
+		TESTEQUALS(count->invocations, 1);
+		TESTEQUALS(count->reenqueues, 5);
+	}
+}
+
+
+void dispatch_benchmark() {
+	const size_t units = 10000;
+	const time::time_t until = 20;
+	const double events = units * until.to_double();
+
+	auto single = run_count(units, until, false);
+	auto batched = run_count(units, until, true);
+
+	log::log(MSG(info) << "Event dispatch overhead: "
+	                   << "single " << single.count() / events << " ns/event, "
+	                   << "batched " << batched.count() / events << " ns/event");
+}
+
 } // namespace openage::event::tests
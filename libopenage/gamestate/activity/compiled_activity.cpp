@@ -0,0 +1,151 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "compiled_activity.h"
+
+#include <deque>
+#include <sstream>
+#include <unordered_map>
+
+#include "error/error.h"
+#include "log/message.h"
+
+#include "gamestate/activity/activity.h"
+#include "gamestate/activity/task_system_node.h"
+
+
+namespace openage::gamestate::activity {
+
+CompiledActivity::CompiledActivity(const std::shared_ptr<Activity> &activity) :
+	activity{activity},
+	nodes{},
+	successors{},
+	successor_ids{},
+	labels{},
+	tasks{},
+	conditions{},
+	primers{},
+	next_funcs{} {}
+
+std::shared_ptr<const CompiledActivity> CompiledActivity::compile(const std::shared_ptr<Activity> &activity) {
+	auto start = activity->get_start();
+	if (not start) {
+		throw Error{MSG(err) << "Activity " << activity->get_id() << " has no start node."};
+	}
+
+	auto result = std::shared_ptr<CompiledActivity>{new CompiledActivity{activity}};
+
+	// assign indices in breadth-first order, so the start node gets index 0
+	std::unordered_map<node_id, node_index> indices;
+	std::vector<std::shared_ptr<Node>> graph;
+	std::deque<std::shared_ptr<Node>> open{start};
+	indices.emplace(start->get_id(), 0);
+	graph.push_back(start);
+
+	while (not open.empty()) {
+		auto node = open.front();
+		open.pop_front();
+
+		for (const auto &output : node->get_outputs()) {
+			auto found = indices.find(output->get_id());
+			if (found == indices.end()) {
+				indices.emplace(output->get_id(), graph.size());
+				graph.push_back(output);
+				open.push_back(output);
+			}
+			else if (graph[found->second] != output) [[unlikely]] {
+				throw Error{MSG(err) << "Activity " << activity->get_id() << " contains "
+				                     << "multiple nodes with id " << output->get_id()};
+			}
+		}
+	}
+
+	result->nodes.reserve(graph.size());
+	for (const auto &node : graph) {
+		compiled_node record{node->get_type(), node->get_id()};
+
+		auto outputs = node->get_outputs();
+		record.outputs_begin = result->successors.size();
+		record.output_count = outputs.size();
+		for (const auto &output : outputs) {
+			result->successors.push_back(indices.at(output->get_id()));
+			result->successor_ids.push_back(output->get_id());
+		}
+
+		switch (record.type) {
+		case node_t::START:
+		case node_t::END:
+			break;
+		case node_t::TASK_CUSTOM:
+			record.func = result->tasks.size();
+			result->tasks.push_back(std::static_pointer_cast<TaskCustom>(node)->get_task_func());
+			break;
+		case node_t::TASK_SYSTEM:
+			record.system_id = std::static_pointer_cast<TaskSystemNode>(node)->get_system_id();
+			break;
+		case node_t::XOR_GATE:
+			record.func = result->conditions.size();
+			result->conditions.push_back(std::static_pointer_cast<XorGate>(node)->get_condition_func());
+			break;
+		case node_t::XOR_EVENT_GATE: {
+			auto gate = std::static_pointer_cast<XorEventGate>(node);
+			record.func = result->primers.size();
+			result->primers.push_back(gate->get_primer_func());
+			result->next_funcs.push_back(gate->get_next_func());
+		} break;
+		default:
+			throw Error{MSG(err) << "Cannot compile node " << node->str() << " of unknown type"};
+		}
+
+		result->nodes.push_back(record);
+		result->labels.push_back(node->get_label());
+	}
+
+	return result;
+}
+
+const std::shared_ptr<Activity> &CompiledActivity::get_activity() const {
+	return this->activity;
+}
+
+node_index CompiledActivity::get_start() const {
+	return 0;
+}
+
+size_t CompiledActivity::get_node_count() const {
+	return this->nodes.size();
+}
+
+node_index CompiledActivity::next(const compiled_node &node, size_t output) const {
+	if (output >= node.output_count) [[unlikely]] {
+		throw Error{MSG(err) << "Node " << node.id << " has no output at position " << output};
+	}
+
+	return this->successors[node.outputs_begin + output];
+}
+
+node_index CompiledActivity::next_id(const compiled_node &node, node_id id) const {
+	// nodes only have a few outputs, so a linear search is fastest
+	for (size_t i = node.outputs_begin; i < node.outputs_begin + node.output_count; ++i) {
+		if (this->successor_ids[i] == id) {
+			return this->successors[i];
+		}
+	}
+
+	throw Error{MSG(err) << "Node " << node.id << " has no output with id " << id};
+}
+
+std::string CompiledActivity::str(node_index index) const {
+	const auto &node = this->nodes.at(index);
+	const auto &label = this->labels.at(index);
+
+	std::stringstream ret;
+	if (label.empty()) {
+		ret << node.id;
+	}
+	else {
+		ret << label << " (id=" << node.id << ")";
+	}
+	return ret.str();
+}
+
+} // namespace openage::gamestate::activity
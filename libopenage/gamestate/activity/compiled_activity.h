@@ -0,0 +1,201 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gamestate/activity/event_node.h"
+#include "gamestate/activity/node.h"
+#include "gamestate/activity/task_node.h"
+#include "gamestate/activity/types.h"
+#include "gamestate/activity/xor_node.h"
+#include "gamestate/system/types.h"
+
+
+namespace openage::gamestate::activity {
+class Activity;
+
+/**
+ * Node record in the node table of a compiled activity.
+ */
+struct compiled_node {
+	/// Type of the node.
+	node_t type;
+	/// ID of the node in the source graph.
+	node_id id;
+	/// System that is run by a \p TASK_SYSTEM node.
+	system::system_id_t system_id = system::system_id_t::NONE;
+	/// Index of the function of the node in the function table for its type.
+	uint32_t func = 0;
+	/// First entry of the node's successors in the successor table.
+	uint32_t outputs_begin = 0;
+	/// Number of successors.
+	uint32_t output_count = 0;
+};
+
+/**
+ * Immutable, flattened form of an activity node graph.
+ *
+ * The nodes are stored in a table in which successors are referenced by
+ * index instead of through shared pointers and ID lookups. Node functions are
+ * stored in one table per node type and referenced by index. A compiled
+ * activity can be shared by all game entities that use the same activity.
+ */
+class CompiledActivity {
+public:
+	/**
+	 * Compile an activity node graph.
+	 *
+	 * All nodes reachable from the start node are added to the node table.
+	 * The start node gets index 0, successors of each node are ordered by node ID.
+	 *
+	 * @param activity Activity to compile.
+	 *
+	 * @return Compiled activity.
+	 */
+	static std::shared_ptr<const CompiledActivity> compile(const std::shared_ptr<Activity> &activity);
+
+	/**
+	 * Get the source activity.
+	 *
+	 * @return Activity that was compiled.
+	 */
+	const std::shared_ptr<Activity> &get_activity() const;
+
+	/**
+	 * Get the index of the start node.
+	 *
+	 * @return Start node index.
+	 */
+	node_index get_start() const;
+
+	/**
+	 * Get the number of nodes in the node table.
+	 *
+	 * @return Number of nodes.
+	 */
+	size_t get_node_count() const;
+
+	/**
+	 * Get a node from the node table.
+	 *
+	 * @param index Node index.
+	 *
+	 * @return Node record.
+	 */
+	const compiled_node &get_node(node_index index) const {
+		return this->nodes[index];
+	}
+
+	/**
+	 * Get a successor of a node by its position.
+	 *
+	 * @param node Node record.
+	 * @param output Position of the successor in the node's successors.
+	 *
+	 * @return Successor node index.
+	 */
+	node_index next(const compiled_node &node, size_t output = 0) const;
+
+	/**
+	 * Get a successor of a node by its ID in the source graph.
+	 * This resolves the node IDs returned by conditions and event next functions.
+	 *
+	 * @param node Node record.
+	 * @param id ID of the successor node.
+	 *
+	 * @return Successor node index.
+	 */
+	node_index next_id(const compiled_node &node, node_id id) const;
+
+	/**
+	 * Get the task function of a \p TASK_CUSTOM node.
+	 */
+	const task_func_t &get_task(const compiled_node &node) const {
+		return this->tasks[node.func];
+	}
+
+	/**
+	 * Get the condition function of a \p XOR_GATE node.
+	 */
+	const condition_func_t &get_condition(const compiled_node &node) const {
+		return this->conditions[node.func];
+	}
+
+	/**
+	 * Get the event primer function of a \p XOR_EVENT_GATE node.
+	 */
+	const event_primer_func_t &get_primer(const compiled_node &node) const {
+		return this->primers[node.func];
+	}
+
+	/**
+	 * Get the event next function of a \p XOR_EVENT_GATE node.
+	 */
+	const event_next_func_t &get_next_func(const compiled_node &node) const {
+		return this->next_funcs[node.func];
+	}
+
+	/**
+	 * Get a human-readable string representation of a node.
+	 *
+	 * @param index Node index.
+	 *
+	 * @return Human-readable representation.
+	 */
+	std::string str(node_index index) const;
+
+private:
+	CompiledActivity(const std::shared_ptr<Activity> &activity);
+
+	/**
+	 * Source activity.
+	 */
+	std::shared_ptr<Activity> activity;
+
+	/**
+	 * Node table.
+	 */
+	std::vector<compiled_node> nodes;
+
+	/**
+	 * Successor node indices of all nodes.
+	 */
+	std::vector<node_index> successors;
+
+	/**
+	 * Source graph IDs of the successors, in the same order as \p successors.
+	 */
+	std::vector<node_id> successor_ids;
+
+	/**
+	 * Labels of the nodes for error messages.
+	 */
+	std::vector<node_label> labels;
+
+	/**
+	 * Task functions of \p TASK_CUSTOM nodes.
+	 */
+	std::vector<task_func_t> tasks;
+
+	/**
+	 * Condition functions of \p XOR_GATE nodes.
+	 */
+	std::vector<condition_func_t> conditions;
+
+	/**
+	 * Event primer functions of \p XOR_EVENT_GATE nodes.
+	 */
+	std::vector<event_primer_func_t> primers;
+
+	/**
+	 * Event next functions of \p XOR_EVENT_GATE nodes.
+	 */
+	std::vector<event_next_func_t> next_funcs;
+};
+
+} // namespace openage::gamestate::activity
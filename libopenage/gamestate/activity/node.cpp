@@ -2,6 +2,7 @@
 
 #include "node.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "error/error.h"
@@ -50,4 +51,19 @@ const std::shared_ptr<Node> &Node::next(node_id id) const {
 	return this->outputs.at(id);
 }
 
+std::vector<std::shared_ptr<Node>> Node::get_outputs() const {
+	std::vector<std::shared_ptr<Node>> result;
+	result.reserve(this->outputs.size());
+	for (const auto &[id, output] : this->outputs) {
+		result.push_back(output);
+	}
+
+	// the output map is unordered
+	std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) {
+		return a->get_id() < b->get_id();
+	});
+
+	return result;
+}
+
 } // namespace openage::gamestate::activity
@@ -69,6 +69,13 @@ public:
 	 */
 	const std::shared_ptr<Node> &next(node_id id) const;
 
+	/**
+	 * Get all output nodes.
+	 *
+	 * @return Output nodes, ordered by their IDs.
+	 */
+	std::vector<std::shared_ptr<Node>> get_outputs() const;
+
 	/**
 	 * Add an output node.
 	 *
@@ -1,9 +1,11 @@
 // Copyright 2023-2023 the openage authors. See copying.md for legal info.
 
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "event/event_loop.h"
 #include "event/evententity.h"
@@ -13,7 +15,10 @@
 #include "error/error.h"
 #include "log/log.h"
 #include "log/message.h"
+#include "testing/testing.h"
 
+#include "gamestate/activity/activity.h"
+#include "gamestate/activity/compiled_activity.h"
 #include "gamestate/activity/end_node.h"
 #include "gamestate/activity/event_node.h"
 #include "gamestate/activity/node.h"
@@ -21,6 +26,10 @@
 #include "gamestate/activity/task_node.h"
 #include "gamestate/activity/types.h"
 #include "gamestate/activity/xor_node.h"
+#include "gamestate/component/internal/activity.h"
+#include "gamestate/component/types.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/system/activity.h"
 #include "time/time.h"
 
 
@@ -258,4 +267,141 @@ void activity_demo() {
 	loop->reach_time(0, state);
 }
 
+
+/**
+ * Create a graph that loops through a task node a number of times before
+ * it waits at an event gate.
+ *
+ * Graph:
+ * Start -> Task 1 -> XOR -> Event -> Task 2 -> End
+ *            ^--------|
+ *
+ * @param loops Number of times that the XOR gate goes back to task 1.
+ * @param counter Incremented by task 1, reset by task 2.
+ */
+std::shared_ptr<activity::Activity> create_loop_activity(size_t loops, size_t &counter) {
+	auto start = std::make_shared<activity::StartNode>(0);
+	auto task1 = std::make_shared<activity::TaskCustom>(1);
+	auto xor_node = std::make_shared<activity::XorGate>(2);
+	auto event_node = std::make_shared<activity::XorEventGate>(3);
+	auto task2 = std::make_shared<activity::TaskCustom>(4);
+	auto end = std::make_shared<activity::EndNode>(5);
+
+	start->add_output(task1);
+
+	task1->add_output(xor_node);
+	task1->set_task_func([&counter](const time::time_t &,
+	                                const std::shared_ptr<gamestate::GameEntity> &) {
+		counter++;
+	});
+
+	xor_node->add_output(task1);
+	xor_node->add_output(event_node);
+	xor_node->set_condition_func([&counter, loops](const time::time_t &,
+	                                               const std::shared_ptr<gamestate::GameEntity> &) {
+		return (counter <= loops) ? 1 : 3;
+	});
+
+	event_node->add_output(task2);
+	event_node->set_primer_func([](const time::time_t &,
+	                               const std::shared_ptr<gamestate::GameEntity> &,
+	                               const std::shared_ptr<event::EventLoop> &,
+	                               const std::shared_ptr<gamestate::GameState> &) {
+		return activity::event_store_t{};
+	});
+	event_node->set_next_func([](const time::time_t &,
+	                             const std::shared_ptr<gamestate::GameEntity> &,
+	                             const std::shared_ptr<event::EventLoop> &,
+	                             const std::shared_ptr<gamestate::GameState> &) {
+		return 4;
+	});
+
+	task2->add_output(end);
+	task2->set_task_func([&counter](const time::time_t &,
+	                                const std::shared_ptr<gamestate::GameEntity> &) {
+		counter = 0;
+	});
+
+	return std::make_shared<activity::Activity>(0, "loop", start);
+}
+
+
+void compiled_activity() {
+	size_t counter = 0;
+	auto compiled = activity::CompiledActivity::compile(create_loop_activity(4, counter));
+
+	TESTEQUALS(compiled->get_node_count(), 6);
+	TESTEQUALS(compiled->get_start(), 0);
+	(compiled->get_node(0).type == activity::node_t::START) or TESTFAIL;
+
+	// successors are referenced by index
+	auto &start = compiled->get_node(compiled->get_start());
+	auto &task1 = compiled->get_node(compiled->next(start));
+	TESTEQUALS(task1.id, 1);
+	auto &xor_node = compiled->get_node(compiled->next(task1));
+	TESTEQUALS(xor_node.output_count, 2);
+	TESTEQUALS(compiled->get_node(compiled->next_id(xor_node, 3)).id, 3);
+	TESTTHROWS(compiled->next_id(xor_node, 5));
+	TESTTHROWS(compiled->next(xor_node, 2));
+
+	// advance an entity through the compiled graph
+	auto loop = std::make_shared<event::EventLoop>();
+	auto entity = std::make_shared<GameEntity>(0);
+	auto component = std::make_shared<component::Activity>(loop, compiled);
+	entity->add_component(component);
+	component->init(0);
+
+	// runs task 1 until the XOR gate goes to the event gate
+	system::Activity::advance(entity, 0, loop, nullptr);
+	TESTEQUALS(counter, 5);
+	TESTEQUALS(compiled->get_node(component->get_node(0)).id, 3);
+
+	// continues after the event
+	system::Activity::advance(entity, 1, loop, nullptr);
+	TESTEQUALS(counter, 0);
+	(compiled->get_node(component->get_node(1)).type == activity::node_t::END) or TESTFAIL;
+
+	// node IDs must be unique
+	auto dup_start = std::make_shared<activity::StartNode>(0);
+	auto dup_task = std::make_shared<activity::TaskCustom>(0);
+	dup_start->add_output(dup_task);
+	TESTTHROWS(activity::CompiledActivity::compile(std::make_shared<activity::Activity>(1, "dup", dup_start)));
+}
+
+
+void activity_benchmark() {
+	const size_t entities = 1000;
+	const size_t rounds = 100;
+
+	size_t counter = 0;
+	auto source = create_loop_activity(4, counter);
+	auto compiled = activity::CompiledActivity::compile(source);
+
+	auto loop = std::make_shared<event::EventLoop>();
+	std::vector<std::shared_ptr<GameEntity>> units;
+	for (size_t i = 0; i < entities; ++i) {
+		auto entity = std::make_shared<GameEntity>(i);
+		auto component = std::make_shared<component::Activity>(loop, compiled);
+		entity->add_component(component);
+		component->init(0);
+		units.push_back(entity);
+	}
+
+	// each entity runs to the event gate and then to the end node
+	auto start = std::chrono::steady_clock::now();
+	for (size_t round = 0; round < rounds; ++round) {
+		for (auto &entity : units) {
+			auto component = std::dynamic_pointer_cast<component::Activity>(
+				entity->get_component(component::component_t::ACTIVITY));
+			component->init(round);
+			system::Activity::advance(entity, round, loop, nullptr);
+			system::Activity::advance(entity, round, loop, nullptr);
+		}
+	}
+	auto passed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	log::log(MSG(info) << "Compiled activity: "
+	                   << 2 * entities * rounds / passed.count() << " advances/s");
+}
+
 } // namespace openage::gamestate::tests
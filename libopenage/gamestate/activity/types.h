@@ -2,9 +2,16 @@
 
 #pragma once
 
+#include <cstdint>
+
 
 namespace openage::gamestate::activity {
 
+/**
+ * Index of a node in the node table of a compiled activity.
+ */
+using node_index = uint32_t;
+
 /**
  * Node types in the flow graph.
  */
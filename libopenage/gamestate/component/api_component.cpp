@@ -10,6 +10,7 @@ APIComponent::APIComponent(const std::shared_ptr<event::EventLoop> &loop,
                            const time::time_t &creation_time,
                            const bool enabled) :
 	ability{ability},
+	animation{},
 	enabled(loop, 0) {
 	this->enabled.set_insert(creation_time, enabled);
 }
@@ -18,6 +19,7 @@ APIComponent::APIComponent(const std::shared_ptr<event::EventLoop> &loop,
                            nyan::Object &ability,
                            bool enabled) :
 	ability{ability},
+	animation{},
 	enabled(loop, 0, "", nullptr, enabled) {
 }
 
@@ -25,4 +27,12 @@ const nyan::Object &APIComponent::get_ability() const {
 	return this->ability;
 }
 
+void APIComponent::set_animation(const util::Symbol &animation) {
+	this->animation = animation;
+}
+
+const util::Symbol &APIComponent::get_animation() const {
+	return this->animation;
+}
+
 } // namespace openage::gamestate::component
@@ -9,6 +9,7 @@
 #include "curve/discrete.h"
 #include "gamestate/component/base_component.h"
 #include "time/time.h"
+#include "util/symbol.h"
 
 
 namespace openage {
@@ -56,12 +57,32 @@ public:
 	 */
 	const nyan::Object &get_ability() const;
 
+	/**
+	 * Set the animation that is displayed while the ability is used.
+	 *
+	 * @param animation Interned sprite path of the animation.
+	 */
+	void set_animation(const util::Symbol &animation);
+
+	/**
+	 * Get the animation that is displayed while the ability is used.
+	 *
+	 * @return Interned sprite path of the animation, empty if the ability is not animated.
+	 */
+	const util::Symbol &get_animation() const;
+
 private:
 	/**
      * nyan object holding the data for the component.
      */
 	nyan::Object ability;
 
+	/**
+	 * Sprite path of the first animation of the ability.
+	 * Resolved once, so that systems don't query the nyan object on every use.
+	 */
+	util::Symbol animation;
+
 	/**
      * Determines if the component is available to its game entity.
      */
@@ -3,14 +3,14 @@
 #include "activity.h"
 
 #include "event/event.h"
-#include "gamestate/activity/activity.h"
+#include "gamestate/activity/compiled_activity.h"
 #include "gamestate/component/internal/activity.h"
 
 
 namespace openage::gamestate::component {
 
 Activity::Activity(const std::shared_ptr<openage::event::EventLoop> &loop,
-                   const std::shared_ptr<activity::Activity> &start_activity) :
+                   const std::shared_ptr<const activity::CompiledActivity> &start_activity) :
 	start_activity{start_activity},
 	node{loop, 0} {
 }
@@ -19,16 +19,16 @@ component_t Activity::get_type() const {
 	return component_t::ACTIVITY;
 }
 
-const std::shared_ptr<activity::Activity> &Activity::get_start_activity() const {
+const std::shared_ptr<const activity::CompiledActivity> &Activity::get_start_activity() const {
 	return this->start_activity;
 }
 
-const std::shared_ptr<activity::Node> Activity::get_node(const time::time_t &time) const {
+activity::node_index Activity::get_node(const time::time_t &time) const {
 	return this->node.get(time);
 }
 
 void Activity::set_node(const time::time_t &time,
-                        const std::shared_ptr<activity::Node> &node) {
+                        activity::node_index node) {
 	this->node.set_last(time, node);
 }
 
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "curve/discrete.h"
+#include "gamestate/activity/types.h"
 #include "gamestate/component/internal_component.h"
 #include "gamestate/component/types.h"
 #include "time/time.h"
@@ -21,8 +22,7 @@ class EventLoop;
 namespace gamestate {
 
 namespace activity {
-class Activity;
-class Node;
+class CompiledActivity;
 } // namespace activity
 
 namespace component {
@@ -36,7 +36,7 @@ public:
      * @param start_activity Initial activity flow graph.
      */
 	Activity(const std::shared_ptr<openage::event::EventLoop> &loop,
-	         const std::shared_ptr<activity::Activity> &start_activity);
+	         const std::shared_ptr<const activity::CompiledActivity> &start_activity);
 
 	component_t get_type() const override;
 
@@ -45,24 +45,24 @@ public:
      *
      * @return Initial activity.
      */
-	const std::shared_ptr<activity::Activity> &get_start_activity() const;
+	const std::shared_ptr<const activity::CompiledActivity> &get_start_activity() const;
 
 	/**
      * Get the node in the activity flow graph at a given time.
      *
      * @param time Time at which the node is requested.
-     * @return Current node in the flow graph.
+     * @return Index of the current node in the compiled flow graph.
      */
-	const std::shared_ptr<activity::Node> get_node(const time::time_t &time) const;
+	activity::node_index get_node(const time::time_t &time) const;
 
 	/**
      * Sets the current node in the activity flow graph at a given time.
      *
      * @param time Time at which the node is set.
-     * @param node Current node in the flow graph.
+     * @param node Index of the current node in the compiled flow graph.
      */
 	void set_node(const time::time_t &time,
-	              const std::shared_ptr<activity::Node> &node);
+	              activity::node_index node);
 
 	/**
      * Set the current node to the start node of the start activity.
@@ -94,12 +94,12 @@ private:
      *
      * TODO: Define as curve, so it's changeable?
      */
-	std::shared_ptr<activity::Activity> start_activity;
+	std::shared_ptr<const activity::CompiledActivity> start_activity;
 
 	/**
-     * Current node in the activity flow graph.
+     * Index of the current node in the activity flow graph.
      */
-	curve::Discrete<std::shared_ptr<activity::Node>> node;
+	curve::Discrete<activity::node_index> node;
 
 	/**
      * Scheduled events that are waited for to progress in the node graph.
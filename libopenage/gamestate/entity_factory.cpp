@@ -7,18 +7,26 @@
 #include <mutex>
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "error/error.h"
 
 #include "curve/discrete.h"
 #include "curve/queue.h"
+#include "datastructure/object_pool.h"
 #include "event/event_loop.h"
 #include "gamestate/activity/activity.h"
+#include "gamestate/activity/compiled_activity.h"
 #include "gamestate/activity/end_node.h"
 #include "gamestate/activity/event_node.h"
 #include "gamestate/activity/start_node.h"
 #include "gamestate/activity/task_system_node.h"
 #include "gamestate/activity/xor_node.h"
+#include "gamestate/api/ability.h"
+#include "gamestate/api/animation.h"
+#include "gamestate/api/property.h"
+#include "gamestate/api/types.h"
 #include "gamestate/component/api/idle.h"
 #include "gamestate/component/api/live.h"
 #include "gamestate/component/api/move.h"
@@ -36,10 +44,17 @@
 #include "renderer/render_factory.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
+#include "util/symbol.h"
 
 
 namespace openage::gamestate {
 
+/**
+ * Event handler IDs used by the test activity.
+ */
+static const util::Symbol process_command_handler{"game.process_command"};
+static const util::Symbol wait_handler{"game.wait"};
+
 /**
  * Create a simple test activity for the game entity.
  *
@@ -93,7 +108,7 @@ std::shared_ptr<activity::Activity> create_test_activity() {
 	                                     const std::shared_ptr<GameEntity> &entity,
 	                                     const std::shared_ptr<event::EventLoop> &loop,
 	                                     const std::shared_ptr<gamestate::GameState> &state) {
-		auto ev = loop->create_event("game.process_command",
+		auto ev = loop->create_event(process_command_handler,
 		                             entity->get_manager(),
 		                             state,
 		                             // event is not executed until a command is available
@@ -134,7 +149,7 @@ std::shared_ptr<activity::Activity> create_test_activity() {
 	                                  const std::shared_ptr<GameEntity> &entity,
 	                                  const std::shared_ptr<event::EventLoop> &loop,
 	                                  const std::shared_ptr<gamestate::GameState> &state) {
-		auto ev = loop->create_event("game.wait",
+		auto ev = loop->create_event(wait_handler,
 		                             entity->get_manager(),
 		                             state,
 		                             time);
@@ -153,16 +168,21 @@ std::shared_ptr<activity::Activity> create_test_activity() {
 
 EntityFactory::EntityFactory() :
 	next_id{0},
-	render_factory{nullptr} {
+	render_factory{nullptr},
+	default_activity{activity::CompiledActivity::compile(create_test_activity())},
+	prototypes{},
+	prototype_db{nullptr} {
 }
 
 std::shared_ptr<GameEntity> EntityFactory::add_game_entity(const std::shared_ptr<openage::event::EventLoop> &loop,
                                                            const std::shared_ptr<GameState> &state,
                                                            const nyan::fqon_t &nyan_entity) {
+	auto prototype = this->get_prototype(state, nyan_entity);
+
 	auto entity = std::make_shared<GameEntity>(this->get_next_id());
 	entity->set_manager(std::make_shared<GameEntityManager>(loop, state, entity));
 
-	init_components(loop, state, entity, nyan_entity);
+	this->init_components(loop, entity, *prototype);
 
 	if (this->render_factory) {
 		entity->set_render_entity(this->render_factory->add_world_render_entity());
@@ -171,78 +191,199 @@ std::shared_ptr<GameEntity> EntityFactory::add_game_entity(const std::shared_ptr
 	return entity;
 }
 
+std::vector<std::shared_ptr<GameEntity>> EntityFactory::add_game_entities(const std::shared_ptr<openage::event::EventLoop> &loop,
+                                                                          const std::shared_ptr<GameState> &state,
+                                                                          const nyan::fqon_t &nyan_entity,
+                                                                          size_t count) {
+	auto prototype = this->get_prototype(state, nyan_entity);
+	auto first_id = this->get_next_ids(count);
+
+	std::vector<std::shared_ptr<GameEntity>> entities;
+	entities.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		auto entity = std::make_shared<GameEntity>(first_id + i);
+		entity->set_manager(std::make_shared<GameEntityManager>(loop, state, entity));
+
+		this->init_components(loop, entity, *prototype);
+
+		if (this->render_factory) {
+			entity->set_render_entity(this->render_factory->add_world_render_entity());
+		}
+
+		entities.push_back(std::move(entity));
+	}
+
+	return entities;
+}
+
 void EntityFactory::attach_renderer(const std::shared_ptr<renderer::RenderFactory> &render_factory) {
 	std::unique_lock lock{this->mutex};
 
 	this->render_factory = render_factory;
 }
 
-void EntityFactory::init_components(const std::shared_ptr<openage::event::EventLoop> &loop,
-                                    const std::shared_ptr<GameState> &state,
-                                    const std::shared_ptr<GameEntity> &entity,
-                                    const nyan::fqon_t &nyan_entity) {
-	auto position = std::make_shared<component::Position>(loop);
-	entity->add_component(position);
+std::shared_ptr<const EntityFactory::entity_prototype> EntityFactory::get_prototype(const std::shared_ptr<GameState> &state,
+                                                                                    const nyan::fqon_t &nyan_entity) {
+	std::unique_lock lock{this->mutex};
 
-	auto ownership = std::make_shared<component::Ownership>(loop);
-	entity->add_component(ownership);
+	// prototypes reference objects of the view they were created from,
+	// so they cannot be used for another game
+	auto &db_view = state->get_nyan_db();
+	if (this->prototype_db != db_view) {
+		this->prototypes.clear();
+		this->prototype_db = db_view;
+	}
 
-	auto command_queue = std::make_shared<component::CommandQueue>(loop);
-	entity->add_component(command_queue);
+	// outdated prototypes are resolved again to pick up the patched values
+	auto cached = this->prototypes.find(nyan_entity);
+	if (cached != this->prototypes.end() and not cached->second->outdated->load()) {
+		return cached->second;
+	}
+
+	auto prototype = EntityFactory::create_prototype(db_view, nyan_entity);
+	this->prototypes.insert_or_assign(nyan_entity, prototype);
+
+	return prototype;
+}
+
+std::shared_ptr<const EntityFactory::entity_prototype> EntityFactory::create_prototype(const std::shared_ptr<nyan::View> &db_view,
+                                                                                       const nyan::fqon_t &nyan_entity) {
+	auto prototype = std::make_shared<entity_prototype>();
+	prototype->outdated = std::make_shared<std::atomic<bool>>(false);
+
+	// notifications are also sent for patches of parent objects
+	auto subscribe = [&prototype](nyan::Object &obj) {
+		prototype->notifiers.push_back(obj.subscribe([outdated = prototype->outdated](auto &&...) {
+			outdated->store(true);
+		}));
+	};
+
+	// the sprite path is interned here once instead of on every use by a system
+	auto get_animation = [&subscribe](nyan::Object &ability_obj) {
+		if (not api::APIAbility::check_property(ability_obj, api::ability_property_t::ANIMATED)) {
+			return util::Symbol{};
+		}
+
+		auto property = api::APIAbility::get_property(ability_obj, api::ability_property_t::ANIMATED);
+		auto animations = api::APIAbilityProperty::get_animations(property);
+		if (animations.empty()) {
+			return util::Symbol{};
+		}
+
+		subscribe(animations[0]);
+		return util::Symbol{api::APIAnimation::get_animation_path(animations[0])};
+	};
 
-	auto db_view = state->get_nyan_db();
 	auto nyan_obj = db_view->get_object(nyan_entity);
+	subscribe(nyan_obj);
 	nyan::set_t abilities = nyan_obj.get_set("GameEntity.abilities");
 
 	for (const auto &ability_val : abilities) {
 		auto ability_fqon = std::dynamic_pointer_cast<nyan::ObjectValue>(ability_val.get_ptr())->get_name();
 		auto ability_obj = db_view->get_object(ability_fqon);
+		subscribe(ability_obj);
 
 		auto ability_parent = ability_obj.get_parents()[0];
 		if (ability_parent == "engine.ability.type.Move") {
-			auto move = std::make_shared<component::Move>(loop, ability_obj);
-			entity->add_component(move);
+			prototype->abilities.push_back({component::component_t::MOVE, ability_obj, get_animation(ability_obj)});
 		}
 		else if (ability_parent == "engine.ability.type.Turn") {
-			auto turn = std::make_shared<component::Turn>(loop, ability_obj);
-			entity->add_component(turn);
+			prototype->abilities.push_back({component::component_t::TURN, ability_obj, get_animation(ability_obj)});
 		}
 		else if (ability_parent == "engine.ability.type.Idle") {
-			auto idle = std::make_shared<component::Idle>(loop, ability_obj);
-			entity->add_component(idle);
+			prototype->abilities.push_back({component::component_t::IDLE, ability_obj, get_animation(ability_obj)});
 		}
 		else if (ability_parent == "engine.ability.type.Live") {
-			auto live = std::make_shared<component::Live>(loop, ability_obj);
-			entity->add_component(live);
+			prototype->abilities.push_back({component::component_t::LIVE, ability_obj, get_animation(ability_obj)});
 
 			auto attr_settings = ability_obj.get_set("Live.attributes");
 			for (auto &setting : attr_settings) {
 				auto setting_obj_val = std::dynamic_pointer_cast<nyan::ObjectValue>(setting.get_ptr());
 				auto setting_obj = db_view->get_object(setting_obj_val->get_name());
+				subscribe(setting_obj);
 				auto attribute = setting_obj.get_object("AttributeSetting.attribute");
 				auto start_value = setting_obj.get_int("AttributeSetting.starting_value");
 
+				prototype->attributes.emplace_back(attribute.get_name(), start_value);
+			}
+		}
+	}
+
+	return prototype;
+}
+
+void EntityFactory::init_components(const std::shared_ptr<openage::event::EventLoop> &loop,
+                                    const std::shared_ptr<GameEntity> &entity,
+                                    const entity_prototype &prototype) {
+	auto position = datastructure::make_pooled<component::Position>(loop);
+	entity->add_component(position);
+
+	auto ownership = datastructure::make_pooled<component::Ownership>(loop);
+	entity->add_component(ownership);
+
+	auto command_queue = datastructure::make_pooled<component::CommandQueue>(loop);
+	entity->add_component(command_queue);
+
+	for (const auto &[type, ability, animation] : prototype.abilities) {
+		// components take a mutable handle of the ability
+		auto ability_obj = ability;
+		switch (type) {
+		case component::component_t::MOVE: {
+			auto move = datastructure::make_pooled<component::Move>(loop, ability_obj);
+			move->set_animation(animation);
+			entity->add_component(move);
+		} break;
+		case component::component_t::TURN: {
+			auto turn = datastructure::make_pooled<component::Turn>(loop, ability_obj);
+			turn->set_animation(animation);
+			entity->add_component(turn);
+		} break;
+		case component::component_t::IDLE: {
+			auto idle = datastructure::make_pooled<component::Idle>(loop, ability_obj);
+			idle->set_animation(animation);
+			entity->add_component(idle);
+		} break;
+		case component::component_t::LIVE: {
+			auto live = datastructure::make_pooled<component::Live>(loop, ability_obj);
+			live->set_animation(animation);
+			entity->add_component(live);
+
+			for (const auto &[attribute, start_value] : prototype.attributes) {
 				live->add_attribute(std::numeric_limits<time::time_t>::min(),
-				                    attribute.get_name(),
-				                    std::make_shared<curve::Discrete<int64_t>>(loop,
-				                                                               0,
-				                                                               "",
-				                                                               nullptr,
-				                                                               start_value));
+				                    attribute,
+				                    datastructure::make_pooled<curve::Discrete<int64_t>>(loop,
+				                                                                         0,
+				                                                                         "",
+				                                                                         nullptr,
+				                                                                         start_value));
 			}
+		} break;
+		default:
+			throw Error{MSG(err) << "Entity prototype contains unsupported component type"};
 		}
 	}
 
 	// must be initialized after all other components
-	auto activity = std::make_shared<component::Activity>(loop, create_test_activity());
+	auto activity = datastructure::make_pooled<component::Activity>(loop, this->default_activity);
 	entity->add_component(activity);
 }
 
 entity_id_t EntityFactory::get_next_id() {
+	std::unique_lock lock{this->mutex};
+
 	auto new_id = this->next_id;
 	this->next_id++;
 
 	return new_id;
 }
 
+entity_id_t EntityFactory::get_next_ids(size_t count) {
+	std::unique_lock lock{this->mutex};
+
+	auto first_id = this->next_id;
+	this->next_id += count;
+
+	return first_id;
+}
+
 } // namespace openage::gamestate
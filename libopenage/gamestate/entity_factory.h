@@ -2,12 +2,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <nyan/nyan.h>
 
+#include "gamestate/component/types.h"
 #include "gamestate/types.h"
+#include "util/symbol.h"
 
 
 namespace openage {
@@ -24,6 +32,10 @@ namespace gamestate {
 class GameEntity;
 class GameState;
 
+namespace activity {
+class CompiledActivity;
+} // namespace activity
+
 /**
  * Creates game entities that contain data of objects inside the game world.
  */
@@ -51,6 +63,27 @@ public:
 	                                            const std::shared_ptr<GameState> &state,
 	                                            const nyan::fqon_t &nyan_entity);
 
+	/**
+	 * Create multiple game entities from the same nyan object.
+	 *
+	 * The nyan object is only resolved once per factory, so this is much
+	 * cheaper than calling \p add_game_entity() for every entity.
+	 * Components of the entities are allocated in bulk from object pools.
+	 * As in \p add_game_entity(), the caller is responsible for initializing
+	 * the components of the entities and placing them into the game.
+	 *
+	 * @param loop Event loop for the gamestate.
+	 * @param state State of the game.
+	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 * @param count Number of created entities.
+	 *
+	 * @return New game entities with consecutive IDs.
+	 */
+	std::vector<std::shared_ptr<GameEntity>> add_game_entities(const std::shared_ptr<openage::event::EventLoop> &loop,
+	                                                           const std::shared_ptr<GameState> &state,
+	                                                           const nyan::fqon_t &nyan_entity,
+	                                                           size_t count);
+
 	/**
 	 * Attach a renderer which enables graphical display options for all ingame entities.
 	 *
@@ -60,18 +93,70 @@ public:
 	void attach_renderer(const std::shared_ptr<renderer::RenderFactory> &render_factory);
 
 private:
+	/**
+	 * Component setup of a game entity type, resolved from the nyan database.
+	 *
+	 * Components hold per-entity state, so they cannot be shared between
+	 * entities. Instead, the prototype stores everything that is needed to
+	 * create them without querying the nyan database again.
+	 *
+	 * The prototype is outdated as soon as one of the nyan objects it was
+	 * resolved from is patched, e.g. by a researched tech.
+	 */
+	struct entity_prototype {
+		/// Ability that has a component.
+		struct ability {
+			/// Type of the component.
+			component::component_t type;
+			/// nyan object of the ability.
+			nyan::Object obj;
+			/// Sprite path of the first animation, empty if the ability is not animated.
+			util::Symbol animation;
+		};
+
+		/// Abilities that have a component, in the order of the nyan set.
+		std::vector<ability> abilities;
+		/// Attribute fqons and starting values of the \p Live ability.
+		std::vector<std::pair<nyan::fqon_t, int64_t>> attributes;
+		/// Subscriptions to changes of the resolved nyan objects.
+		std::vector<std::shared_ptr<nyan::ObjectNotifier>> notifiers;
+		/// Set by the subscriptions when a resolved nyan object changes.
+		std::shared_ptr<std::atomic<bool>> outdated;
+	};
+
+	/**
+	 * Get the prototype for a nyan game entity. The prototype is created
+	 * on first use and cached until its nyan objects are patched.
+	 *
+	 * @param state State of the game.
+	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 *
+	 * @return Prototype of the game entity.
+	 */
+	std::shared_ptr<const entity_prototype> get_prototype(const std::shared_ptr<GameState> &state,
+	                                                      const nyan::fqon_t &nyan_entity);
+
+	/**
+	 * Resolve the prototype of a nyan game entity.
+	 *
+	 * @param db_view View of the nyan database.
+	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 *
+	 * @return Prototype of the game entity.
+	 */
+	static std::shared_ptr<const entity_prototype> create_prototype(const std::shared_ptr<nyan::View> &db_view,
+	                                                                const nyan::fqon_t &nyan_entity);
+
 	/**
 	 * Initialize components of a game entity.
 	 *
 	 * @param loop Event loop for the gamestate.
-	 * @param state State of the game.
 	 * @param entity Game entity.
-	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 * @param prototype Prototype of the game entity.
 	 */
 	void init_components(const std::shared_ptr<openage::event::EventLoop> &loop,
-	                     const std::shared_ptr<GameState> &state,
 	                     const std::shared_ptr<GameEntity> &entity,
-	                     const nyan::fqon_t &nyan_entity);
+	                     const entity_prototype &prototype);
 
 	/**
      * Get a unique ID for creating a game entity.
@@ -80,6 +165,15 @@ private:
      */
 	entity_id_t get_next_id();
 
+	/**
+	 * Reserve a range of unique IDs for creating game entities.
+	 *
+	 * @param count Number of IDs.
+	 *
+	 * @return First ID of the range.
+	 */
+	entity_id_t get_next_ids(size_t count);
+
 	/**
      * ID of the next game entity to be created.
      */
@@ -90,7 +184,21 @@ private:
 	 */
 	std::shared_ptr<renderer::RenderFactory> render_factory;
 
-	// TODO: Cache created game entities.
+	/**
+	 * Activity of created game entities. It is compiled once and shared by all entities.
+	 */
+	std::shared_ptr<const activity::CompiledActivity> default_activity;
+
+	/**
+	 * Cached prototypes of game entities by fqon.
+	 */
+	std::unordered_map<nyan::fqon_t, std::shared_ptr<const entity_prototype>> prototypes;
+
+	/**
+	 * nyan database view that the cached prototypes were resolved from.
+	 * The cache is cleared when the view of the game changes.
+	 */
+	std::shared_ptr<nyan::View> prototype_db;
 
 	/**
      * Mutex for thread safety.
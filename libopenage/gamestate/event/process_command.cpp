@@ -2,6 +2,7 @@
 
 #include "process_command.h"
 
+#include "event/event_batch.h"
 #include "gamestate/manager.h"
 
 
@@ -24,6 +25,20 @@ void ProcessCommandHandler::invoke(openage::event::EventLoop & /* loop */,
 	mgr->run_activity_system(time);
 }
 
+bool ProcessCommandHandler::is_batchable() const {
+	return true;
+}
+
+void ProcessCommandHandler::invoke_batch(openage::event::EventLoop & /* loop */,
+                                         openage::event::EventBatch &batch,
+                                         const std::shared_ptr<openage::event::State> & /* state */,
+                                         const time::time_t &time) {
+	while (auto target = batch.next()) {
+		auto mgr = static_cast<openage::gamestate::GameEntityManager *>(target.get());
+		mgr->run_activity_system(time);
+	}
+}
+
 time::time_t ProcessCommandHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
                                                          const std::shared_ptr<openage::event::State> & /* state */,
                                                          const time::time_t &at) {
@@ -13,6 +13,7 @@ namespace openage {
 namespace event {
 class EventLoop;
 class Event;
+class EventBatch;
 class EventEntity;
 class State;
 } // namespace event
@@ -39,6 +40,13 @@ public:
 	time::time_t predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> &target,
 	                                 const std::shared_ptr<openage::event::State> &state,
 	                                 const time::time_t &at) override;
+
+	bool is_batchable() const override;
+
+	void invoke_batch(openage::event::EventLoop &loop,
+	                  openage::event::EventBatch &batch,
+	                  const std::shared_ptr<openage::event::State> &state,
+	                  const time::time_t &time) override;
 };
 
 
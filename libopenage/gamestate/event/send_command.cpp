@@ -11,6 +11,7 @@
 #include "gamestate/component/types.h"
 #include "gamestate/game_entity.h"
 #include "gamestate/game_state.h"
+#include "gamestate/journal.h"
 #include "gamestate/types.h"
 
 
@@ -78,6 +79,10 @@ void SendCommandHandler::invoke(openage::event::EventLoop & /* loop */,
 			break;
 		}
 	}
+
+	if (gstate->get_journal()) {
+		gstate->get_journal()->record(this->id(), time, params);
+	}
 }
 
 time::time_t SendCommandHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
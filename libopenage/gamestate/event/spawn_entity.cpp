@@ -18,6 +18,7 @@
 #include "gamestate/entity_factory.h"
 #include "gamestate/game_entity.h"
 #include "gamestate/game_state.h"
+#include "gamestate/journal.h"
 #include "gamestate/manager.h"
 #include "gamestate/types.h"
 
@@ -48,6 +49,36 @@ static const std::vector<nyan::fqon_t> swgb_test_entities = {
 	"swgb_base.data.game_entity.generic.heavy_weapons_factory.heavy_weapons_factory.HeavyWeaponsFactory",
 };
 
+/**
+ * Get the spawn positions for a group of entities.
+ *
+ * The entities are placed on a square grid with one tile between them
+ * that is centered on the spawn position.
+ *
+ * @param center Spawn position of the group.
+ * @param count Number of entities.
+ *
+ * @return Spawn position of each entity.
+ */
+static std::vector<coord::phys3> get_formation(const coord::phys3 &center, size_t count) {
+	size_t columns = 1;
+	while (columns * columns < count) {
+		++columns;
+	}
+
+	std::vector<coord::phys3> positions;
+	positions.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		auto column = static_cast<double>(i % columns) - (columns - 1) / 2.0;
+		auto row = static_cast<double>(i / columns) - (columns - 1) / 2.0;
+		positions.push_back(center + coord::phys3_delta{coord::phys_t::from_double(column),
+		                                                coord::phys_t::from_double(row),
+		                                                0});
+	}
+
+	return positions;
+}
+
 Spawner::Spawner(const std::shared_ptr<openage::event::EventLoop> &loop) :
 	EventEntity(loop) {
 }
@@ -65,7 +96,9 @@ SpawnEntityHandler::SpawnEntityHandler(const std::shared_ptr<openage::event::Eve
                                        const std::shared_ptr<gamestate::EntityFactory> &factory) :
 	OnceEventHandler("game.spawn_entity"),
 	loop{loop},
-	factory{factory} {
+	factory{factory},
+	test_entities{},
+	test_entity_index{0} {
 }
 
 void SpawnEntityHandler::setup_event(const std::shared_ptr<openage::event::Event> & /* event */,
@@ -80,14 +113,55 @@ void SpawnEntityHandler::invoke(openage::event::EventLoop & /* loop */,
                                 const param_map &params) {
 	auto gstate = std::dynamic_pointer_cast<gamestate::GameState>(state);
 
-	auto nyan_db = gstate->get_nyan_db();
+	auto position = params.get("position", gamestate::WORLD_ORIGIN);
+	auto owner = params.get<size_t>("owner", 0);
+	auto count = params.get<size_t>("count", 1);
+	if (count == 0) {
+		return;
+	}
+
+	auto nyan_entity = params.get<nyan::fqon_t>("game_entity", "");
+	if (nyan_entity.empty()) {
+		nyan_entity = this->next_test_entity(gstate);
+	}
+
+	// Create entities
+	auto entities = this->spawn_batch(gstate,
+	                                  nyan_entity,
+	                                  get_formation(position, count),
+	                                  owner,
+	                                  time);
 
-	auto game_entities = nyan_db->get_obj_children_all("engine.util.game_entity.GameEntity");
+	// TODO: Select the unit when it's created
+	// very dumb but it gets the job done
+	auto select_cb = params.get("select_cb", std::function<void(entity_id_t id)>{});
+	if (select_cb) {
+		select_cb(entities.front()->get_id());
+	}
+
+	if (gstate->get_journal()) {
+		// the spawned game entity is recorded, so that replays don't depend on the test entity order
+		param_map journal_params{
+			{"position", position},
+			{"owner", owner},
+			{"count", count},
+			{"game_entity", nyan_entity},
+		};
+		gstate->get_journal()->record(this->id(), time, journal_params);
+	}
+}
+
+time::time_t SpawnEntityHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
+                                                     const std::shared_ptr<openage::event::State> & /* state */,
+                                                     const time::time_t &at) {
+	return at;
+}
 
+const nyan::fqon_t &SpawnEntityHandler::next_test_entity(const std::shared_ptr<GameState> &state) {
 	// TODO: Remove hardcoded test entity references
-	static std::vector<nyan::fqon_t> test_entities; // declared static so we only have to do this once
+	auto &test_entities = this->test_entities;
 	if (test_entities.empty()) {
-		auto modpack_ids = gstate->get_mod_manager()->get_load_order();
+		auto modpack_ids = state->get_mod_manager()->get_load_order();
 		for (auto &modpack_id : modpack_ids) {
 			if (modpack_id == "aoe1_base") {
 				test_entities.insert(test_entities.end(),
@@ -107,45 +181,50 @@ void SpawnEntityHandler::invoke(openage::event::EventLoop & /* loop */,
 		}
 	}
 
-	static uint8_t index = 0;
-	nyan::fqon_t nyan_entity = test_entities.at(index);
-	++index;
-	if (index >= test_entities.size()) {
-		index = 0;
+	const auto &nyan_entity = test_entities.at(this->test_entity_index);
+	++this->test_entity_index;
+	if (this->test_entity_index >= test_entities.size()) {
+		this->test_entity_index = 0;
+	}
+
+	return nyan_entity;
+}
+
+std::vector<std::shared_ptr<GameEntity>> SpawnEntityHandler::spawn_batch(const std::shared_ptr<GameState> &state,
+                                                                         const nyan::fqon_t &nyan_entity,
+                                                                         const std::vector<coord::phys3> &positions,
+                                                                         component::ownership_id_t owner,
+                                                                         const time::time_t &time) {
+	auto entities = this->factory->add_game_entities(this->loop,
+	                                                 state,
+	                                                 nyan_entity,
+	                                                 positions.size());
+
+	for (size_t i = 0; i < entities.size(); ++i) {
+		this->init_entity(entities[i], positions[i], owner, time);
+		state->add_game_entity(entities[i]);
 	}
 
-	// Create entity
-	auto entity = this->factory->add_game_entity(this->loop, gstate, nyan_entity);
+	return entities;
+}
 
-	// Setup components
+void SpawnEntityHandler::init_entity(const std::shared_ptr<GameEntity> &entity,
+                                     const coord::phys3 &position,
+                                     component::ownership_id_t owner,
+                                     const time::time_t &time) {
 	auto entity_pos = std::dynamic_pointer_cast<component::Position>(
 		entity->get_component(component::component_t::POSITION));
-
-	auto pos = params.get("position", gamestate::WORLD_ORIGIN);
-	entity_pos->set_position(time, pos);
+	entity_pos->set_position(time, position);
 	entity_pos->set_angle(time, coord::phys_angle_t::from_int(315));
 
 	auto entity_owner = std::dynamic_pointer_cast<component::Ownership>(
 		entity->get_component(component::component_t::OWNERSHIP));
-	entity_owner->set_owner(time, params.get("owner", 0));
+	entity_owner->set_owner(time, owner);
 
 	auto activity = std::dynamic_pointer_cast<component::Activity>(
 		entity->get_component(component::component_t::ACTIVITY));
 	activity->init(time);
 	entity->get_manager()->run_activity_system(time);
-
-	// TODO: Select the unit when it's created
-	// very dumb but it gets the job done
-	auto select_cb = params.get("select_cb", std::function<void(entity_id_t id)>{});
-	select_cb(entity->get_id());
-
-	gstate->add_game_entity(entity);
-}
-
-time::time_t SpawnEntityHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
-                                                     const std::shared_ptr<openage::event::State> & /* state */,
-                                                     const time::time_t &at) {
-	return at;
 }
 
 } // namespace openage::gamestate::event
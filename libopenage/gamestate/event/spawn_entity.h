@@ -5,9 +5,14 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include <nyan/nyan.h>
+
+#include "coord/phys.h"
 #include "event/evententity.h"
 #include "event/eventhandler.h"
+#include "gamestate/component/internal/ownership.h"
 #include "time/time.h"
 
 
@@ -22,6 +27,8 @@ class State;
 namespace gamestate {
 
 class EntityFactory;
+class GameEntity;
+class GameState;
 
 namespace event {
 
@@ -62,6 +69,14 @@ public:
 	 * This method implements the effects of the event.
 	 * It will be called at the time that was determined by `predict_invoke_time`.
 	 *
+	 * Event parameters:
+	 *   - position: Spawn position (default: world origin).
+	 *   - owner: ID of the player owning the entities (default: 0).
+	 *   - count: Number of spawned entities. Groups are placed on a grid
+	 *            around the spawn position (default: 1).
+	 *   - game_entity: fqon of the spawned game entity (default: the
+	 *                  test entities of the loaded modpacks in turn).
+	 *
 	 * Called from the Loop.
 	 */
 	void invoke(openage::event::EventLoop &loop,
@@ -92,6 +107,48 @@ public:
 
 private:
 	/**
+	 * Get the next game entity of the test entities that are spawned in turn.
+	 *
+	 * @param state State of the game.
+	 *
+	 * @return fqon of the GameEntity data in the nyan database.
+	 */
+	const nyan::fqon_t &next_test_entity(const std::shared_ptr<GameState> &state);
+
+	/**
+	 * Spawn multiple game entities of the same type.
+	 *
+	 * The entities are created in one batch by the entity factory, placed at
+	 * the given positions and added to the game state.
+	 *
+	 * @param state State of the game.
+	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 * @param positions Spawn positions. One entity is spawned per position.
+	 * @param owner ID of the player owning the entities.
+	 * @param time Spawn time.
+	 *
+	 * @return Spawned game entities.
+	 */
+	std::vector<std::shared_ptr<GameEntity>> spawn_batch(const std::shared_ptr<GameState> &state,
+	                                                     const nyan::fqon_t &nyan_entity,
+	                                                     const std::vector<coord::phys3> &positions,
+	                                                     component::ownership_id_t owner,
+	                                                     const time::time_t &time);
+
+	/**
+	 * Initialize the components of a newly created game entity and start its activity.
+	 *
+	 * @param entity Game entity.
+	 * @param position Spawn position.
+	 * @param owner ID of the player owning the entity.
+	 * @param time Spawn time.
+	 */
+	void init_entity(const std::shared_ptr<GameEntity> &entity,
+	                 const coord::phys3 &position,
+	                 component::ownership_id_t owner,
+	                 const time::time_t &time);
+
+	/**
      * Event loop that the entity components are registered on.
      */
 	std::shared_ptr<openage::event::EventLoop> loop;
@@ -100,6 +157,17 @@ private:
      * The factory that is used to create the entity.
      */
 	std::shared_ptr<gamestate::EntityFactory> factory;
+
+	/**
+	 * Game entities of the loaded modpacks that are spawned in turn.
+	 * Filled on the first spawn.
+	 */
+	std::vector<std::string> test_entities;
+
+	/**
+	 * Index of the next spawned entity in \p test_entities.
+	 */
+	size_t test_entity_index;
 };
 
 } // namespace event
@@ -2,6 +2,7 @@
 
 #include "wait.h"
 
+#include "event/event_batch.h"
 #include "gamestate/manager.h"
 
 
@@ -24,6 +25,20 @@ void WaitHandler::invoke(openage::event::EventLoop & /* loop */,
 	mgr->run_activity_system(time);
 }
 
+bool WaitHandler::is_batchable() const {
+	return true;
+}
+
+void WaitHandler::invoke_batch(openage::event::EventLoop & /* loop */,
+                               openage::event::EventBatch &batch,
+                               const std::shared_ptr<openage::event::State> & /* state */,
+                               const time::time_t &time) {
+	while (auto target = batch.next()) {
+		auto mgr = static_cast<openage::gamestate::GameEntityManager *>(target.get());
+		mgr->run_activity_system(time);
+	}
+}
+
 time::time_t WaitHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
                                                const std::shared_ptr<openage::event::State> & /* state */,
                                                const time::time_t &at) {
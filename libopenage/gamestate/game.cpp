@@ -12,19 +12,19 @@
 #include "assets/mod_manager.h"
 #include "assets/modpack.h"
 #include "gamestate/game_state.h"
+#include "gamestate/nyan_loader.h"
 #include "gamestate/universe.h"
-#include "util/path.h"
-#include "util/strings.h"
 
 
 namespace openage::gamestate {
 
 Game::Game(const std::shared_ptr<openage::event::EventLoop> &event_loop,
-           const std::shared_ptr<assets::ModManager> &mod_manager) :
+           const std::shared_ptr<assets::ModManager> &mod_manager,
+           job::JobManager *job_manager) :
 	db{nyan::Database::create()},
 	state{std::make_shared<GameState>(this->db, event_loop)},
 	universe{std::make_shared<Universe>(state)} {
-	this->load_data(mod_manager);
+	this->load_data(mod_manager, job_manager);
 
 	// TODO: This lets the spawner event check which modpacks are loaded,
 	//       so that it can decide which entities it can spawn.
@@ -41,73 +41,21 @@ void Game::attach_renderer(const std::shared_ptr<renderer::RenderFactory> &rende
 	this->universe->attach_renderer(render_factory);
 }
 
-void Game::load_data(const std::shared_ptr<assets::ModManager> &mod_manager) {
-	auto load_order = mod_manager->get_load_order();
+void Game::load_data(const std::shared_ptr<assets::ModManager> &mod_manager,
+                     job::JobManager *job_manager) {
+	NyanLoader loader{this->db, job_manager};
 
+	auto load_order = mod_manager->get_load_order();
 	for (auto &mod_id : load_order) {
 		auto mod = mod_manager->get_modpack(mod_id);
 		auto info = mod->get_info();
 
-		auto includes = info.includes;
-		for (const auto &include : includes) {
-			// handle wildcards
-			auto parts = util::split(include, '/');
-			auto last_part = parts.back();
-			bool recursive = false;
-			auto search = include;
-			if (last_part == "**") {
-				recursive = true;
-				if (parts.size() == 1) {
-					// include = "**"
-					search = include.substr(0, include.size() - 2);
-				}
-				else {
-					// include = "path/to/somewhere/**"
-					// remove the slash '/' too
-					search = include.substr(0, include.size() - 3);
-				}
-			}
-
-			this->load_path(info.path.get_parent(), info.path.get_name(), search, recursive);
+		for (const auto &include : info.includes) {
+			loader.add_include(info.path.get_parent(), info.path.get_name(), include);
 		}
 	}
-}
 
-void Game::load_path(const util::Path &base_dir,
-                     const std::string &mod_dir,
-                     const std::string &search,
-                     bool recursive) {
-	auto base_path = base_dir.resolve_native_path();
-	auto search_path = base_dir / mod_dir / search;
-
-	auto fileload_func = [&base_path, &mod_dir](const std::string &filename) {
-		// nyan wants a string filepath, so we have to construct it from the
-		// path and subpath parameters
-		log::log(INFO << "Loading .nyan file: " << filename);
-		auto loc = base_path + "/" + filename;
-		return std::make_shared<nyan::File>(loc);
-	};
-
-	// file loading
-	if (search_path.is_file() && search_path.get_suffix() == ".nyan") {
-		auto loc = mod_dir + "/" + search;
-		this->db->load(loc, fileload_func);
-		return;
-	}
-
-	// directory loading
-	if (search_path.is_dir()) {
-		// load all files in a directory
-		for (auto p : search_path.iterdir()) {
-			if (p.is_dir() and not recursive) {
-				// folders are skipped unless we read recursively
-				continue;
-			}
-
-			auto new_search = search + "/" + p.get_name();
-			this->load_path(base_dir, mod_dir, new_search, recursive);
-		}
-	}
+	loader.load();
 }
 
 } // namespace openage::gamestate
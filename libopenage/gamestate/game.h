@@ -19,6 +19,10 @@ namespace event {
 class EventLoop;
 }
 
+namespace job {
+class JobManager;
+}
+
 namespace renderer {
 class RenderFactory;
 }
@@ -49,9 +53,11 @@ public:
 	 * @param root_dir openage root directory.
      * @param event_loop Event simulation loop for the gamestate.
      * @param mod_manager Mod manager.
+     * @param job_manager Job manager for reading the game data ahead (optional).
 	 */
 	Game(const std::shared_ptr<openage::event::EventLoop> &event_loop,
-	     const std::shared_ptr<assets::ModManager> &mod_manager);
+	     const std::shared_ptr<assets::ModManager> &mod_manager,
+	     job::JobManager *job_manager = nullptr);
 	~Game() = default;
 
 	/**
@@ -73,23 +79,10 @@ private:
      * Load game data from the filesystem.
      *
      * @param mod_manager Mod manager.
+     * @param job_manager Job manager for reading the game data ahead (optional).
      */
-	void load_data(const std::shared_ptr<assets::ModManager> &mod_manager);
-
-	/**
-     * Load game data from the filesystem recursively.
-     *
-     * TODO: Move this into nyan.
-     *
-     * @param base_dir Base directory where mods are stored.
-     * @param mod_dir Name of the mod directory.
-     * @param search Search path relative to the mod directory.
-     * @param recursive if true, recursively search subfolders if the the search path is a directory.
-     */
-	void load_path(const util::Path &base_dir,
-	               const std::string &mod_dir,
-	               const std::string &search,
-	               bool recursive = false);
+	void load_data(const std::shared_ptr<assets::ModManager> &mod_manager,
+	               job::JobManager *job_manager);
 
 	/**
      * Nyan game data database.
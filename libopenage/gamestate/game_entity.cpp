@@ -8,6 +8,7 @@
 #include "gamestate/component/api/idle.h"
 #include "gamestate/component/api/move.h"
 #include "gamestate/component/base_component.h"
+#include "gamestate/component/internal/ownership.h"
 #include "gamestate/component/internal/position.h"
 #include "renderer/stages/world/world_render_entity.h"
 
@@ -57,7 +58,7 @@ bool GameEntity::has_component(component::component_t type) {
 }
 
 void GameEntity::render_update(const time::time_t &time,
-                               const std::string &animation_path) {
+                               const util::Symbol &animation_path) {
 	if (this->render_entity != nullptr) {
 		const auto &pos = dynamic_pointer_cast<component::Position>(
 							  this->components.at(component::component_t::POSITION))
@@ -65,6 +66,13 @@ void GameEntity::render_update(const time::time_t &time,
 		const auto &angle = dynamic_pointer_cast<component::Position>(
 								this->components.at(component::component_t::POSITION))
 		                        ->get_angles();
+		if (this->components.contains(component::component_t::OWNERSHIP)) {
+			const auto &owners = dynamic_pointer_cast<component::Ownership>(
+									 this->components.at(component::component_t::OWNERSHIP))
+			                         ->get_owners();
+			this->render_entity->set_owner(owners.get(time));
+		}
+
 		this->render_entity->update(this->id, pos, angle, animation_path, time);
 	}
 }
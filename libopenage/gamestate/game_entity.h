@@ -4,11 +4,12 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 
+#include "datastructure/flat_hash_map.h"
 #include "gamestate/component/types.h"
 #include "gamestate/types.h"
 #include "time/time.h"
+#include "util/symbol.h"
 
 
 namespace openage {
@@ -106,7 +107,7 @@ public:
      * @param animation_path Animation path used at \p time.
      */
 	void render_update(const time::time_t &time,
-	                   const std::string &animation_path);
+	                   const util::Symbol &animation_path);
 
 protected:
 	/**
@@ -133,9 +134,12 @@ private:
 	entity_id_t id;
 
 	/**
-     * Data components.
-     */
-	std::unordered_map<component::component_t, std::shared_ptr<component::Component>> components;
+	 * Data components.
+	 *
+	 * Node map because \p get_component() hands out references
+	 * that must survive adding other components.
+	 */
+	datastructure::NodeHashMap<component::component_t, std::shared_ptr<component::Component>> components;
 
 	/**
 	 * Render entity for pushing updates to the renderer. Can be \p nullptr.
@@ -48,4 +48,12 @@ void GameState::set_mod_manager(const std::shared_ptr<assets::ModManager> &mod_m
 	this->mod_manager = mod_manager;
 }
 
+const std::shared_ptr<CommandJournal> &GameState::get_journal() const {
+	return this->journal;
+}
+
+void GameState::set_journal(const std::shared_ptr<CommandJournal> &journal) {
+	this->journal = journal;
+}
+
 } // namespace openage::gamestate
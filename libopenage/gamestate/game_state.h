@@ -25,6 +25,7 @@ class EventLoop;
 }
 
 namespace gamestate {
+class CommandJournal;
 class GameEntity;
 
 /**
@@ -79,6 +80,20 @@ public:
 	const std::shared_ptr<assets::ModManager> &get_mod_manager() const;
 	void set_mod_manager(const std::shared_ptr<assets::ModManager> &mod_manager);
 
+	/**
+	 * Get the journal that records the player input of the game.
+	 *
+	 * @return Command journal. Can be \p nullptr if the game is not recorded.
+	 */
+	const std::shared_ptr<CommandJournal> &get_journal() const;
+
+	/**
+	 * Set the journal that records the player input of the game.
+	 *
+	 * @param journal Command journal. Can be \p nullptr to stop recording.
+	 */
+	void set_journal(const std::shared_ptr<CommandJournal> &journal);
+
 private:
 	/**
      * View for the nyan game data database.
@@ -94,6 +109,11 @@ private:
      * TODO: Only for testing
      */
 	std::shared_ptr<assets::ModManager> mod_manager;
+
+	/**
+	 * Records player input events. Can be \p nullptr.
+	 */
+	std::shared_ptr<CommandJournal> journal;
 };
 } // namespace gamestate
 } // namespace openage
@@ -0,0 +1,327 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "journal.h"
+
+#include <algorithm>
+#include <mutex>
+#include <type_traits>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+
+#include "gamestate/component/internal/ownership.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/component/types.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
+#include "util/file.h"
+#include "util/path.h"
+
+
+namespace openage::gamestate {
+
+namespace {
+
+/**
+ * Append an integer to a binary buffer in little endian byte order.
+ */
+template <typename T>
+void put(std::string &out, T value) {
+	static_assert(std::is_integral_v<T>);
+
+	auto bits = static_cast<std::make_unsigned_t<T>>(value);
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		out.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+	}
+}
+
+/**
+ * Append a position to a binary buffer.
+ */
+void put_position(std::string &out, const coord::phys3 &pos) {
+	put<int64_t>(out, pos.ne.get_raw_value());
+	put<int64_t>(out, pos.se.get_raw_value());
+	put<int64_t>(out, pos.up.get_raw_value());
+}
+
+/**
+ * Reads values from a binary buffer.
+ */
+class Reader {
+public:
+	Reader(const std::string &data, const util::Path &path) :
+		data{data},
+		path{path},
+		offset{0} {}
+
+	/**
+	 * Read an integer in little endian byte order.
+	 */
+	template <typename T>
+	T get() {
+		static_assert(std::is_integral_v<T>);
+
+		if (this->offset + sizeof(T) > this->data.size()) {
+			throw Error(MSG(err) << "Command journal " << this->path << " is truncated.");
+		}
+
+		std::make_unsigned_t<T> bits = 0;
+		for (size_t i = 0; i < sizeof(T); ++i) {
+			auto byte = static_cast<uint8_t>(this->data[this->offset + i]);
+			bits |= static_cast<std::make_unsigned_t<T>>(byte) << (8 * i);
+		}
+		this->offset += sizeof(T);
+		return static_cast<T>(bits);
+	}
+
+	std::string get_string(size_t length) {
+		if (this->offset + length > this->data.size()) {
+			throw Error(MSG(err) << "Command journal " << this->path << " is truncated.");
+		}
+
+		auto result = this->data.substr(this->offset, length);
+		this->offset += length;
+		return result;
+	}
+
+	coord::phys3 get_position() {
+		auto ne = coord::phys_t::from_raw_value(this->get<int64_t>());
+		auto se = coord::phys_t::from_raw_value(this->get<int64_t>());
+		auto up = coord::phys_t::from_raw_value(this->get<int64_t>());
+		return coord::phys3{ne, se, up};
+	}
+
+	bool done() const {
+		return this->offset >= this->data.size();
+	}
+
+private:
+	const std::string &data;
+	const util::Path &path;
+	size_t offset;
+};
+
+/**
+ * FNV-1a hash step. Unlike \p std::hash, the result is stable across runs.
+ */
+void hash_value(uint64_t &hash, uint64_t value) {
+	for (size_t i = 0; i < sizeof(value); ++i) {
+		hash ^= (value >> (i * 8)) & 0xff;
+		hash *= 0x100000001b3;
+	}
+}
+
+} // namespace
+
+
+CommandJournal::CommandJournal(const std::vector<std::string> &modpacks,
+                               const time::time_t &checkpoint_interval) :
+	modpacks{modpacks},
+	checkpoint_interval{checkpoint_interval},
+	next_checkpoint{checkpoint_interval},
+	entries{} {
+}
+
+void CommandJournal::record(const std::string &handler_id,
+                            const time::time_t &time,
+                            const openage::event::EventHandler::param_map &params) {
+	journal_entry entry;
+	entry.time = time;
+
+	if (handler_id == "game.spawn_entity") {
+		entry.type = journal_entry_t::SPAWN_ENTITY;
+		entry.owner = params.get<size_t>("owner", 0);
+		entry.position = params.get("position", coord::phys3{0, 0, 0});
+		entry.count = params.get<size_t>("count", 1);
+		entry.game_entity = params.get<std::string>("game_entity", "");
+	}
+	else if (handler_id == "game.send_command") {
+		entry.type = journal_entry_t::SEND_COMMAND;
+		entry.command = params.get("type", component::command::command_t::NONE);
+		entry.position = params.get("target", coord::phys3{0, 0, 0});
+		entry.entity_ids = params.get("entity_ids", std::vector<entity_id_t>{});
+	}
+	else {
+		return;
+	}
+
+	std::unique_lock lock{this->mutex};
+	this->entries.push_back(std::move(entry));
+}
+
+bool CommandJournal::checkpoint(const time::time_t &time,
+                                const std::shared_ptr<GameState> &state) {
+	std::unique_lock lock{this->mutex};
+
+	if (time < this->next_checkpoint) {
+		return false;
+	}
+
+	journal_entry entry;
+	entry.type = journal_entry_t::CHECKPOINT;
+	entry.time = time;
+	entry.state_hash = CommandJournal::state_hash(state, time);
+	this->entries.push_back(std::move(entry));
+
+	while (this->next_checkpoint <= time) {
+		this->next_checkpoint += this->checkpoint_interval;
+	}
+
+	return true;
+}
+
+std::vector<journal_entry> CommandJournal::get_entries() {
+	std::shared_lock lock{this->mutex};
+	return this->entries;
+}
+
+const std::vector<std::string> &CommandJournal::get_modpacks() const {
+	return this->modpacks;
+}
+
+void CommandJournal::save(const util::Path &path) {
+	std::shared_lock lock{this->mutex};
+
+	std::string out;
+	put<uint32_t>(out, JOURNAL_MAGIC);
+	put<uint16_t>(out, JOURNAL_VERSION);
+	put<uint16_t>(out, this->modpacks.size());
+	for (auto &modpack : this->modpacks) {
+		put<uint16_t>(out, modpack.size());
+		out.append(modpack);
+	}
+
+	for (auto &entry : this->entries) {
+		put<uint8_t>(out, static_cast<uint8_t>(entry.type));
+		put<int64_t>(out, entry.time.get_raw_value());
+
+		switch (entry.type) {
+		case journal_entry_t::SPAWN_ENTITY:
+			put<uint64_t>(out, entry.owner);
+			put_position(out, entry.position);
+			put<uint32_t>(out, entry.count);
+			put<uint16_t>(out, entry.game_entity.size());
+			out.append(entry.game_entity);
+			break;
+		case journal_entry_t::SEND_COMMAND:
+			put<uint8_t>(out, static_cast<uint8_t>(entry.command));
+			put_position(out, entry.position);
+			put<uint32_t>(out, entry.entity_ids.size());
+			for (auto id : entry.entity_ids) {
+				put<uint64_t>(out, id);
+			}
+			break;
+		case journal_entry_t::CHECKPOINT:
+			put<uint64_t>(out, entry.state_hash);
+			break;
+		}
+	}
+
+	auto file = path.open_w();
+	file.write(out);
+	file.close();
+
+	log::log(MSG(info) << "Command journal with " << this->entries.size()
+	                   << " entries has been written to " << path);
+}
+
+std::shared_ptr<CommandJournal> CommandJournal::load(const util::Path &path) {
+	auto file = path.open_r();
+	auto data = file.read();
+	file.close();
+
+	Reader reader{data, path};
+	if (reader.get<uint32_t>() != JOURNAL_MAGIC) {
+		throw Error(MSG(err) << "File " << path << " is not a command journal.");
+	}
+
+	auto version = reader.get<uint16_t>();
+	if (version != JOURNAL_VERSION) {
+		throw Error(MSG(err) << "Command journal " << path << " has unsupported version " << version);
+	}
+
+	std::vector<std::string> modpacks;
+	auto modpack_count = reader.get<uint16_t>();
+	for (size_t i = 0; i < modpack_count; ++i) {
+		auto length = reader.get<uint16_t>();
+		modpacks.push_back(reader.get_string(length));
+	}
+
+	auto journal = std::make_shared<CommandJournal>(modpacks);
+	while (not reader.done()) {
+		journal_entry entry;
+		entry.type = static_cast<journal_entry_t>(reader.get<uint8_t>());
+		entry.time = time::time_t::from_raw_value(reader.get<int64_t>());
+
+		switch (entry.type) {
+		case journal_entry_t::SPAWN_ENTITY: {
+			entry.owner = reader.get<uint64_t>();
+			entry.position = reader.get_position();
+			entry.count = reader.get<uint32_t>();
+			auto length = reader.get<uint16_t>();
+			entry.game_entity = reader.get_string(length);
+		} break;
+		case journal_entry_t::SEND_COMMAND: {
+			entry.command = static_cast<component::command::command_t>(reader.get<uint8_t>());
+			entry.position = reader.get_position();
+			auto count = reader.get<uint32_t>();
+			for (size_t i = 0; i < count; ++i) {
+				entry.entity_ids.push_back(reader.get<uint64_t>());
+			}
+		} break;
+		case journal_entry_t::CHECKPOINT:
+			entry.state_hash = reader.get<uint64_t>();
+			break;
+		default:
+			throw Error(MSG(err) << "Command journal " << path << " contains an entry "
+			                     << "of unknown type " << static_cast<int>(entry.type));
+		}
+
+		journal->entries.push_back(std::move(entry));
+	}
+
+	log::log(MSG(info) << "Command journal with " << journal->entries.size()
+	                   << " entries has been loaded from " << path);
+
+	return journal;
+}
+
+uint64_t CommandJournal::state_hash(const std::shared_ptr<GameState> &state,
+                                    const time::time_t &time) {
+	// iterate in a fixed order, the entity map is unordered
+	std::vector<std::shared_ptr<GameEntity>> entities;
+	for (auto &[id, entity] : state->get_game_entities()) {
+		entities.push_back(entity);
+	}
+	std::sort(entities.begin(), entities.end(), [](auto &a, auto &b) {
+		return a->get_id() < b->get_id();
+	});
+
+	uint64_t hash = 0xcbf29ce484222325;
+	for (auto &entity : entities) {
+		hash_value(hash, entity->get_id());
+
+		if (entity->has_component(component::component_t::POSITION)) {
+			auto position = std::dynamic_pointer_cast<component::Position>(
+				entity->get_component(component::component_t::POSITION));
+
+			auto pos = position->get_positions().get(time);
+			hash_value(hash, pos.ne.get_raw_value());
+			hash_value(hash, pos.se.get_raw_value());
+			hash_value(hash, pos.up.get_raw_value());
+			hash_value(hash, position->get_angles().get(time).get_raw_value());
+		}
+
+		if (entity->has_component(component::component_t::OWNERSHIP)) {
+			auto ownership = std::dynamic_pointer_cast<component::Ownership>(
+				entity->get_component(component::component_t::OWNERSHIP));
+
+			hash_value(hash, ownership->get_owners().get(time));
+		}
+	}
+
+	return hash;
+}
+
+} // namespace openage::gamestate
@@ -0,0 +1,202 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "coord/phys.h"
+#include "event/eventhandler.h"
+#include "gamestate/component/internal/commands/types.h"
+#include "gamestate/types.h"
+#include "time/time.h"
+
+
+namespace openage {
+namespace util {
+class Path;
+}
+
+namespace gamestate {
+class GameState;
+
+/**
+ * Magic bytes at the start of command journal files.
+ */
+constexpr uint32_t JOURNAL_MAGIC = 0x524a414f; // "OAJR"
+
+/**
+ * Version of the command journal format.
+ */
+constexpr uint16_t JOURNAL_VERSION = 2;
+
+/**
+ * Types of journal entries.
+ */
+enum class journal_entry_t : uint8_t {
+	/// Entity spawned by a \p game.spawn_entity event.
+	SPAWN_ENTITY = 1,
+	/// Command sent by a \p game.send_command event.
+	SEND_COMMAND = 2,
+	/// Hash of the game state after the simulation reached a point in time.
+	CHECKPOINT = 3,
+};
+
+/**
+ * Entry in a command journal.
+ *
+ * Only the fields relevant for the entry type are used.
+ */
+struct journal_entry {
+	/// Type of the entry.
+	journal_entry_t type;
+	/// Execution time of the event or time of the checkpoint.
+	time::time_t time;
+
+	/// Owner of the spawned entities.
+	uint64_t owner = 0;
+	/// Position of the spawned entities or target of the command.
+	coord::phys3 position{0, 0, 0};
+	/// Number of spawned entities.
+	uint32_t count = 1;
+	/// fqon of the spawned game entity.
+	std::string game_entity = "";
+
+	/// Command type.
+	component::command::command_t command = component::command::command_t::NONE;
+	/// Entities that receive the command.
+	std::vector<entity_id_t> entity_ids = {};
+
+	/// State hash at the checkpoint.
+	uint64_t state_hash = 0;
+};
+
+/**
+ * Records all player input that enters the game simulation together with
+ * regular state hash checkpoints.
+ *
+ * The journal can be stored in a compact binary log and fed back into a fresh
+ * game simulation to deterministically replay a game (see \p replay.h).
+ *
+ * File format (little endian):
+ *
+ *     header: magic (u32), version (u16), modpack count (u16),
+ *             for each modpack: length (u16), modpack ID
+ *     entries: type (u8), time (i64 raw fixed point value), followed by
+ *       SPAWN_ENTITY: owner (u64), position (3x i64), count (u32),
+ *                     game entity length (u16), game entity fqon
+ *       SEND_COMMAND: command (u8), target (3x i64), entity count (u32), entity IDs (u64)
+ *       CHECKPOINT:   state hash (u64)
+ */
+class CommandJournal {
+public:
+	/**
+	 * Create a new empty journal.
+	 *
+	 * @param modpacks IDs of the modpacks that the game was started with.
+	 * @param checkpoint_interval Simulation time between two state checkpoints (in seconds).
+	 */
+	CommandJournal(const std::vector<std::string> &modpacks = {},
+	               const time::time_t &checkpoint_interval = 10);
+	~CommandJournal() = default;
+
+	/**
+	 * Record an executed input event.
+	 *
+	 * Only \p game.spawn_entity and \p game.send_command events are recorded,
+	 * other events are ignored.
+	 *
+	 * @param handler_id ID of the event handler.
+	 * @param time Execution time of the event.
+	 * @param params Parameters of the event.
+	 */
+	void record(const std::string &handler_id,
+	            const time::time_t &time,
+	            const openage::event::EventHandler::param_map &params);
+
+	/**
+	 * Record a checkpoint if the checkpoint interval has passed since the last one.
+	 *
+	 * @param time Time that the simulation has reached.
+	 * @param state Game state.
+	 *
+	 * @return true if a checkpoint was recorded, else false.
+	 */
+	bool checkpoint(const time::time_t &time,
+	                const std::shared_ptr<GameState> &state);
+
+	/**
+	 * Get the recorded entries in recording order.
+	 *
+	 * @return Journal entries.
+	 */
+	std::vector<journal_entry> get_entries();
+
+	/**
+	 * Get the IDs of the modpacks that the game was started with.
+	 *
+	 * @return Modpack IDs.
+	 */
+	const std::vector<std::string> &get_modpacks() const;
+
+	/**
+	 * Store the journal in a binary log file.
+	 *
+	 * @param path Output path.
+	 */
+	void save(const util::Path &path);
+
+	/**
+	 * Load a journal from a binary log file.
+	 *
+	 * @param path Path to the journal file.
+	 *
+	 * @return Loaded journal.
+	 */
+	static std::shared_ptr<CommandJournal> load(const util::Path &path);
+
+	/**
+	 * Calculate a hash of the game state at a given time. The hash only depends on
+	 * the simulated values, so it is the same across runs and machines.
+	 *
+	 * @param state Game state.
+	 * @param time Time at which the state is evaluated.
+	 *
+	 * @return State hash.
+	 */
+	static uint64_t state_hash(const std::shared_ptr<GameState> &state,
+	                           const time::time_t &time);
+
+private:
+	/**
+	 * Modpacks that the game was started with.
+	 */
+	std::vector<std::string> modpacks;
+
+	/**
+	 * Simulation time between two checkpoints.
+	 */
+	time::time_t checkpoint_interval;
+
+	/**
+	 * Time of the next checkpoint.
+	 */
+	time::time_t next_checkpoint;
+
+	/**
+	 * Recorded entries.
+	 */
+	std::vector<journal_entry> entries;
+
+	/**
+	 * Mutex for protecting threaded access.
+	 */
+	std::shared_mutex mutex;
+};
+
+} // namespace gamestate
+} // namespace openage
@@ -0,0 +1,304 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "nyan_loader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include <nyan/nyan.h>
+
+#include "log/log.h"
+#include "log/message.h"
+
+#include "job/job_manager.h"
+#include "trace/trace.h"
+#include "util/file.h"
+#include "util/strings.h"
+
+
+namespace openage::gamestate {
+
+namespace {
+
+/**
+ * Append a name to a path relative to the mod directory.
+ */
+std::string join(const std::string &search, const std::string &name) {
+	if (search.empty()) {
+		return name;
+	}
+	return search + "/" + name;
+}
+
+/**
+ * Check if a name from a directory listing is a file or subdirectory.
+ * Native listings also contain the links to the directory itself and its parent.
+ */
+bool is_entry(const std::string &name) {
+	return not (name.empty() or name == "." or name == "..");
+}
+
+} // namespace
+
+
+NyanLoader::NyanLoader(const std::shared_ptr<nyan::Database> &db,
+                       job::JobManager *job_manager) :
+	db{db},
+	job_manager{job_manager},
+	includes{} {}
+
+
+void NyanLoader::add_include(const util::Path &base_dir,
+                             const std::string &mod_dir,
+                             const std::string &include) {
+	// handle wildcards
+	auto parts = util::split(include, '/');
+	auto last_part = parts.back();
+	bool recursive = false;
+	auto search = include;
+	if (last_part == "**") {
+		recursive = true;
+		if (parts.size() == 1) {
+			// include = "**"
+			search = include.substr(0, include.size() - 2);
+		}
+		else {
+			// include = "path/to/somewhere/**"
+			// remove the slash '/' too
+			search = include.substr(0, include.size() - 3);
+		}
+	}
+
+	this->includes.push_back({base_dir, mod_dir, search, recursive});
+}
+
+
+std::vector<std::string> NyanLoader::find_files() {
+	std::vector<std::string> ret;
+	for (auto &file : this->find_all_files()) {
+		ret.push_back(std::move(file.name));
+	}
+	return ret;
+}
+
+
+size_t NyanLoader::load() {
+	TRACE_ZONE("NyanLoader::load", "gamestate");
+	using clock = std::chrono::steady_clock;
+
+	auto start = clock::now();
+	auto files = this->find_all_files();
+	auto found = clock::now();
+
+	// nyan resolves imports by native file names
+	std::vector<std::string> base_paths;
+	for (const auto &inc : this->includes) {
+		base_paths.push_back(inc.base_dir.resolve_native_path());
+	}
+
+	using batch_t = std::vector<std::shared_ptr<nyan::File>>;
+	std::vector<job::Job<batch_t>> reads;
+
+	if (this->job_manager != nullptr) {
+		for (size_t begin = 0; begin < files.size(); begin += read_batch_size) {
+			size_t end = std::min(begin + read_batch_size, files.size());
+			reads.push_back(this->job_manager->enqueue<batch_t>([&, begin, end]() {
+				TRACE_ZONE("NyanLoader::read", "gamestate");
+
+				batch_t batch;
+				for (size_t i = begin; i < end; ++i) {
+					size_t inc = files[i].include;
+					batch.push_back(NyanLoader::read_file(base_paths[inc],
+					                                      this->includes[inc].base_dir,
+					                                      files[i].name));
+				}
+				return batch;
+			}));
+		}
+	}
+
+	try {
+		// the database is filled in file order while the next batches are read
+		batch_t batch;
+		for (size_t i = 0; i < files.size(); ++i) {
+			const auto &file = files[i];
+			const auto &base_path = base_paths[file.include];
+			const auto &base_dir = this->includes[file.include].base_dir;
+
+			std::shared_ptr<nyan::File> ahead;
+			if (this->job_manager != nullptr) {
+				if (i % read_batch_size == 0) {
+					auto &job = reads[i / read_batch_size];
+					job.wait();
+
+					// rethrows errors of the read job
+					batch = job.get_result();
+				}
+				ahead = std::move(batch[i % read_batch_size]);
+			}
+
+			auto fileload_func = [&](const std::string &filename) {
+				log::log(INFO << "Loading .nyan file: " << filename);
+				if (ahead and filename == file.name) {
+					return std::move(ahead);
+				}
+				return NyanLoader::read_file(base_path, base_dir, filename);
+			};
+
+			TRACE_ZONE("NyanLoader::insert", "gamestate");
+			this->db->load(file.name, fileload_func);
+		}
+	}
+	catch (...) {
+		// the jobs reference the file list
+		for (auto &job : reads) {
+			job.wait();
+		}
+		if (this->job_manager != nullptr) {
+			this->job_manager->execute_callbacks();
+		}
+		throw;
+	}
+
+	if (this->job_manager != nullptr) {
+		this->job_manager->execute_callbacks();
+	}
+
+	auto loaded = clock::now();
+	log::log(MSG(info) << "Loaded " << files.size() << " .nyan files in "
+	                   << std::chrono::duration<double, std::milli>(loaded - start).count() << " ms"
+	                   << " (search: "
+	                   << std::chrono::duration<double, std::milli>(found - start).count() << " ms)");
+
+	return files.size();
+}
+
+
+void NyanLoader::find_include_files(const include &inc,
+                                    const std::string &search,
+                                    bool recursive,
+                                    std::vector<std::string> &files) {
+	auto search_path = inc.base_dir / inc.mod_dir / search;
+
+	// file loading
+	if (search_path.is_file() and search_path.get_suffix() == ".nyan") {
+		files.push_back(search);
+		return;
+	}
+
+	// directory loading
+	if (search_path.is_dir()) {
+		for (auto &name : search_path.list()) {
+			if (not is_entry(name)) {
+				continue;
+			}
+			if ((search_path / name).is_dir() and not recursive) {
+				// folders are skipped unless we read recursively
+				continue;
+			}
+
+			NyanLoader::find_include_files(inc, join(search, name), recursive, files);
+		}
+	}
+}
+
+
+std::vector<NyanLoader::nyan_file> NyanLoader::find_all_files() {
+	TRACE_ZONE("NyanLoader::find_files", "gamestate");
+
+	struct search_task {
+		size_t include;
+		std::string search;
+		bool recursive;
+	};
+
+	std::vector<std::vector<std::string>> include_files(this->includes.size());
+
+	// the subfolders of recursive includes are searched in parallel
+	std::vector<search_task> tasks;
+	for (size_t i = 0; i < this->includes.size(); ++i) {
+		const auto &inc = this->includes[i];
+		auto search_path = inc.base_dir / inc.mod_dir / inc.search;
+
+		if (this->job_manager == nullptr or not inc.recursive or not search_path.is_dir()) {
+			tasks.push_back({i, inc.search, inc.recursive});
+			continue;
+		}
+
+		for (auto &name : search_path.list()) {
+			if (not is_entry(name)) {
+				continue;
+			}
+			auto search = join(inc.search, name);
+			if ((search_path / name).is_dir()) {
+				tasks.push_back({i, search, true});
+			}
+			else {
+				NyanLoader::find_include_files(inc, search, false, include_files[i]);
+			}
+		}
+	}
+
+	auto run_task = [this](const search_task &task) {
+		std::vector<std::string> files;
+		NyanLoader::find_include_files(this->includes[task.include],
+		                               task.search,
+		                               task.recursive,
+		                               files);
+		return files;
+	};
+
+	if (this->job_manager == nullptr) {
+		for (const auto &task : tasks) {
+			auto files = run_task(task);
+			auto &target = include_files[task.include];
+			target.insert(target.end(), files.begin(), files.end());
+		}
+	}
+	else {
+		std::vector<job::Job<std::vector<std::string>>> jobs;
+		for (const auto &task : tasks) {
+			jobs.push_back(this->job_manager->enqueue<std::vector<std::string>>([&run_task, &task]() {
+				return run_task(task);
+			}));
+		}
+
+		for (auto &job : jobs) {
+			job.wait();
+		}
+
+		// rethrow errors of the jobs
+		this->job_manager->execute_callbacks();
+		for (size_t i = 0; i < jobs.size(); ++i) {
+			auto files = jobs[i].get_result();
+			auto &target = include_files[tasks[i].include];
+			target.insert(target.end(), files.begin(), files.end());
+		}
+	}
+
+	// the directory order of the filesystem is not stable
+	std::vector<nyan_file> ret;
+	for (size_t i = 0; i < include_files.size(); ++i) {
+		auto &files = include_files[i];
+		std::sort(files.begin(), files.end());
+
+		for (const auto &file : files) {
+			ret.push_back({i, this->includes[i].mod_dir + "/" + file});
+		}
+	}
+
+	return ret;
+}
+
+
+std::shared_ptr<nyan::File> NyanLoader::read_file(const std::string &base_path,
+                                                  const util::Path &base_dir,
+                                                  const std::string &name) {
+	// nyan wants a string filepath, so we have to construct it from the
+	// path and subpath parameters
+	auto data = (base_dir / name).open_r().read();
+	return std::make_shared<nyan::File>(base_path + "/" + name, std::move(data));
+}
+
+} // namespace openage::gamestate
@@ -0,0 +1,150 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "util/path.h"
+
+namespace nyan {
+class Database;
+class File;
+} // namespace nyan
+
+namespace openage {
+
+namespace job {
+class JobManager;
+}
+
+namespace gamestate {
+
+/**
+ * Loads the .nyan files of modpacks into a nyan database.
+ *
+ * If a job manager is given, the directories are searched and the files are
+ * read ahead on its workers. Loading into the database happens on the calling
+ * thread while the following files are still read. The files are loaded in
+ * the order of the includes, and the files of one include in alphabetical
+ * order, so the result does not depend on the scheduling of the jobs.
+ *
+ * TODO: Move this into nyan.
+ */
+class NyanLoader {
+public:
+	/**
+	 * Create a new loader.
+	 *
+	 * @param db Database that the files are loaded into.
+	 * @param job_manager Job manager for reading ahead. If it is \p nullptr,
+	 *                    everything is done on the calling thread.
+	 */
+	NyanLoader(const std::shared_ptr<nyan::Database> &db,
+	           job::JobManager *job_manager = nullptr);
+
+	~NyanLoader() = default;
+
+	/**
+	 * Add the files matched by an include of a modpack.
+	 *
+	 * @param base_dir Base directory where mods are stored.
+	 * @param mod_dir Name of the mod directory.
+	 * @param include Path of a file or directory relative to the mod directory.
+	 *                Directories ending in "**" are searched recursively.
+	 */
+	void add_include(const util::Path &base_dir,
+	                 const std::string &mod_dir,
+	                 const std::string &include);
+
+	/**
+	 * Search the directories of the added includes.
+	 *
+	 * @return Names of the .nyan files relative to their base directory, in load order.
+	 */
+	std::vector<std::string> find_files();
+
+	/**
+	 * Load the files of all added includes into the database.
+	 *
+	 * @return Number of loaded files.
+	 */
+	size_t load();
+
+	/**
+	 * Number of files that are read by one job.
+	 */
+	static constexpr size_t read_batch_size = 16;
+
+private:
+	/**
+	 * Files or directory of a modpack to load.
+	 */
+	struct include {
+		util::Path base_dir;
+		std::string mod_dir;
+		/// path relative to the mod directory
+		std::string search;
+		/// if true, subfolders are searched too
+		bool recursive;
+	};
+
+	/**
+	 * .nyan file that is loaded.
+	 */
+	struct nyan_file {
+		/// index of the include that the file belongs to
+		size_t include;
+		/// path relative to the base directory, e.g. "engine/ability/type.nyan"
+		std::string name;
+	};
+
+	/**
+	 * Search the .nyan files of an include.
+	 *
+	 * @param inc Include to search.
+	 * @param search Path relative to the mod directory.
+	 * @param recursive If true, subfolders are searched too.
+	 * @param files Found file names relative to the mod directory are appended to this.
+	 */
+	static void find_include_files(const include &inc,
+	                               const std::string &search,
+	                               bool recursive,
+	                               std::vector<std::string> &files);
+
+	/**
+	 * Search the .nyan files of all includes.
+	 */
+	std::vector<nyan_file> find_all_files();
+
+	/**
+	 * Read a .nyan file.
+	 *
+	 * @param base_path Native path of the base directory.
+	 * @param base_dir Base directory.
+	 * @param name File name relative to the base directory.
+	 */
+	static std::shared_ptr<nyan::File> read_file(const std::string &base_path,
+	                                             const util::Path &base_dir,
+	                                             const std::string &name);
+
+	/**
+	 * Database that the files are loaded into.
+	 */
+	std::shared_ptr<nyan::Database> db;
+
+	/**
+	 * Job manager for reading ahead.
+	 */
+	job::JobManager *job_manager;
+
+	/**
+	 * Added includes in load order.
+	 */
+	std::vector<include> includes;
+};
+
+} // namespace gamestate
+} // namespace openage
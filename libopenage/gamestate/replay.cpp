@@ -0,0 +1,154 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "replay.h"
+
+#include <chrono>
+#include <ostream>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+
+#include "cvar/cvar.h"
+#include "event/event_loop.h"
+#include "event/eventhandler.h"
+#include "gamestate/event/send_command.h"
+#include "gamestate/event/spawn_entity.h"
+#include "gamestate/game.h"
+#include "gamestate/game_state.h"
+#include "gamestate/journal.h"
+#include "gamestate/simulation.h"
+#include "time/clock.h"
+#include "time/time_loop.h"
+#include "util/path.h"
+
+
+namespace openage::gamestate {
+
+double replay_report::get_throughput() const {
+	if (this->real_time <= 0.0) {
+		return 0.0;
+	}
+	return this->sim_time.to_double() / this->real_time;
+}
+
+std::ostream &operator<<(std::ostream &os, const replay_report &report) {
+	os << report.commands << " commands replayed up to t=" << report.sim_time
+	   << " in " << report.real_time << "s (" << report.get_throughput() << " simulated s per real s), "
+	   << report.checkpoints - report.mismatches << "/" << report.checkpoints << " checkpoints match";
+	if (report.first_mismatch) {
+		os << ", first mismatch at t=" << *report.first_mismatch;
+	}
+	return os;
+}
+
+
+replay_report replay_journal(const std::shared_ptr<GameSimulation> &simulation,
+                             const std::shared_ptr<CommandJournal> &journal) {
+	simulation->start();
+
+	return replay_journal(simulation->get_event_loop(),
+	                      simulation->get_game()->get_state(),
+	                      simulation->get_spawner(),
+	                      simulation->get_commander(),
+	                      journal);
+}
+
+
+replay_report replay_journal(const std::shared_ptr<openage::event::EventLoop> &event_loop,
+                             const std::shared_ptr<GameState> &state,
+                             const std::shared_ptr<event::Spawner> &spawner,
+                             const std::shared_ptr<event::Commander> &commander,
+                             const std::shared_ptr<CommandJournal> &journal) {
+	// the clock only follows the journal
+	time::Clock clock;
+	clock.set_mode(time::ClockMode::VIRTUAL);
+	clock.start();
+
+	replay_report report;
+	auto start = std::chrono::steady_clock::now();
+
+	for (auto &entry : journal->get_entries()) {
+		clock.advance_to(entry.time);
+
+		switch (entry.type) {
+		case journal_entry_t::SPAWN_ENTITY: {
+			openage::event::EventHandler::param_map::map_t params{
+				{"position", entry.position},
+				{"owner", static_cast<size_t>(entry.owner)},
+				{"count", static_cast<size_t>(entry.count)},
+				{"game_entity", entry.game_entity},
+			};
+			event_loop->create_event("game.spawn_entity",
+			                         spawner,
+			                         state,
+			                         entry.time,
+			                         params);
+			report.commands += 1;
+		} break;
+		case journal_entry_t::SEND_COMMAND: {
+			openage::event::EventHandler::param_map::map_t params{
+				{"type", entry.command},
+				{"target", entry.position},
+				{"entity_ids", entry.entity_ids},
+			};
+			event_loop->create_event("game.send_command",
+			                         commander,
+			                         state,
+			                         entry.time,
+			                         params);
+			report.commands += 1;
+		} break;
+		case journal_entry_t::CHECKPOINT:
+			break;
+		}
+
+		event_loop->reach_time(clock.get_time(), state);
+
+		if (entry.type == journal_entry_t::CHECKPOINT) {
+			report.checkpoints += 1;
+
+			auto hash = CommandJournal::state_hash(state, entry.time);
+			if (hash != entry.state_hash) {
+				log::log(MSG(warn) << "Replay: state hash mismatch at t=" << entry.time);
+
+				report.mismatches += 1;
+				if (not report.first_mismatch) {
+					report.first_mismatch = entry.time;
+				}
+			}
+		}
+	}
+
+	report.sim_time = clock.get_time();
+	report.real_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	clock.stop();
+
+	return report;
+}
+
+
+void replay_journal_file(const util::Path &root_dir,
+                         const util::Path &journal_path) {
+	auto journal = CommandJournal::load(journal_path);
+
+	auto cvar_manager = std::make_shared<cvar::CVarManager>(root_dir["cfg"]);
+	cvar_manager->load_all();
+
+	auto time_loop = std::make_shared<time::TimeLoop>();
+	auto simulation = std::make_shared<GameSimulation>(root_dir, cvar_manager, time_loop);
+	simulation->set_modpacks(journal->get_modpacks());
+
+	auto report = replay_journal(simulation, journal);
+	simulation->stop();
+
+	log::log(MSG(info) << "Replay of " << journal_path << ": " << report);
+
+	if (report.mismatches > 0) {
+		throw Error(MSG(err) << "Replay of " << journal_path << " diverged from the recording "
+		                     << "at t=" << *report.first_mismatch);
+	}
+}
+
+} // namespace openage::gamestate
@@ -0,0 +1,113 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+
+#include "time/time.h"
+#include "util/compiler.h"
+
+// pxd: from libopenage.util.path cimport Path
+
+
+namespace openage {
+namespace event {
+class EventLoop;
+}
+
+namespace util {
+class Path;
+}
+
+namespace gamestate {
+class CommandJournal;
+class GameSimulation;
+class GameState;
+
+namespace event {
+class Commander;
+class Spawner;
+} // namespace event
+
+/**
+ * Result of a journal replay.
+ */
+struct replay_report {
+	/// Number of replayed spawn and command entries.
+	size_t commands = 0;
+	/// Number of verified checkpoints.
+	size_t checkpoints = 0;
+	/// Number of checkpoints where the state hash differed from the recording.
+	size_t mismatches = 0;
+	/// Time of the first checkpoint with a different state hash.
+	std::optional<time::time_t> first_mismatch = std::nullopt;
+	/// Simulation time reached by the replay.
+	time::time_t sim_time = 0;
+	/// Real time that the replay took (in seconds).
+	double real_time = 0.0;
+
+	/**
+	 * Get the replay throughput.
+	 *
+	 * @return Simulated seconds per real second.
+	 */
+	double get_throughput() const;
+};
+
+std::ostream &operator<<(std::ostream &os, const replay_report &report);
+
+/**
+ * Feed the entries of a command journal into a fresh game simulation.
+ *
+ * The simulation must have the modpacks of the journal set but must not
+ * have been started yet. Input events are created at their recorded execution times
+ * and the simulation clock jumps straight from one entry to the next, so the
+ * replay runs as fast as possible. At every checkpoint, the state hash
+ * is compared to the recorded one.
+ *
+ * @param simulation Game simulation that the journal is replayed in.
+ * @param journal Recorded command journal.
+ *
+ * @return Replay report.
+ */
+replay_report replay_journal(const std::shared_ptr<GameSimulation> &simulation,
+                             const std::shared_ptr<CommandJournal> &journal);
+
+/**
+ * Feed the entries of a command journal into an event loop.
+ *
+ * Same as the replay in a game simulation, but the loop must already
+ * have the game event handlers registered.
+ *
+ * @param loop Event loop that the input events are created in.
+ * @param state Game state that the journal is replayed in.
+ * @param spawner Event entity for the spawn events.
+ * @param commander Event entity for the command events.
+ * @param journal Recorded command journal.
+ *
+ * @return Replay report.
+ */
+replay_report replay_journal(const std::shared_ptr<openage::event::EventLoop> &loop,
+                             const std::shared_ptr<GameState> &state,
+                             const std::shared_ptr<event::Spawner> &spawner,
+                             const std::shared_ptr<event::Commander> &commander,
+                             const std::shared_ptr<CommandJournal> &journal);
+
+/**
+ * Load a command journal and replay it headlessly in a new game simulation.
+ *
+ * The report is logged and an error is thrown if any checkpoint does not
+ * match the recording.
+ *
+ * @param root_dir openage root directory.
+ * @param journal_path Path to the command journal file.
+ */
+// pxd: void replay_journal_file(Path root_dir, Path journal_path) except +
+OAAPI void replay_journal_file(const util::Path &root_dir,
+                               const util::Path &journal_path);
+
+} // namespace gamestate
+} // namespace openage
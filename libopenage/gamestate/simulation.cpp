@@ -2,15 +2,24 @@
 
 #include "simulation.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 #include "assets/mod_manager.h"
+#include "cvar/cvar.h"
 #include "event/event_loop.h"
+#include "event/profiler.h"
 #include "gamestate/entity_factory.h"
 #include "gamestate/event/process_command.h"
 #include "gamestate/event/send_command.h"
 #include "gamestate/event/spawn_entity.h"
 #include "gamestate/event/wait.h"
+#include "gamestate/journal.h"
+#include "job/job_manager.h"
 #include "time/clock.h"
 #include "time/time_loop.h"
+#include "trace/trace.h"
 
 // TODO
 #include "gamestate/game.h"
@@ -29,21 +38,52 @@ GameSimulation::GameSimulation(const util::Path &root_dir,
 	entity_factory{std::make_shared<gamestate::EntityFactory>()},
 	mod_manager{std::make_shared<assets::ModManager>(this->root_dir / "assets" / "converted")},
 	spawner{std::make_shared<gamestate::event::Spawner>(this->event_loop)},
-	commander{std::make_shared<gamestate::event::Commander>(this->event_loop)} {
+	commander{std::make_shared<gamestate::event::Commander>(this->event_loop)},
+	modpacks{},
+	journal{nullptr},
+	journal_path{std::nullopt},
+	journal_interval{10} {
 	auto mods = mod_manager->enumerate_modpacks(root_dir / "assets" / "converted");
 	for (const auto &mod : mods) {
 		this->mod_manager->register_modpack(mod);
 	}
 
+	if (this->cvar_manager) {
+		this->init_cvars();
+	}
+
 	log::log(MSG(info) << "Created game simulation");
 }
 
 
 void GameSimulation::run() {
+	trace::set_thread_name("simulation");
 	this->start();
+	auto clock = this->time_loop->get_clock();
 	while (this->running) {
-		auto current_time = this->time_loop->get_clock()->get_time();
+		if (clock->get_mode() == openage::time::ClockMode::VIRTUAL) {
+			// nothing happens until the next event, so we can skip there directly
+			auto next_time = this->event_loop->next_event_time();
+			if (next_time) {
+				clock->advance_to(*next_time);
+			}
+			else {
+				// wait for new events, e.g. from player input
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		TRACE_ZONE("GameSimulation::run", "simulation");
+		auto current_time = clock->get_time();
 		this->event_loop->reach_time(current_time, this->game->get_state());
+
+		if (this->journal) {
+			this->journal->checkpoint(current_time, this->game->get_state());
+		}
+	}
+
+	if (this->journal and this->journal_path) {
+		this->journal->save(*this->journal_path);
 	}
 	log::log(MSG(info) << "Game simulation loop exited");
 }
@@ -54,7 +94,17 @@ void GameSimulation::start() {
 
 	this->init_event_handlers();
 
-	this->game = std::make_shared<gamestate::Game>(event_loop, this->mod_manager);
+	// the game data is read ahead on workers that are only needed while loading
+	job::JobManager loader{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+	loader.start();
+	this->game = std::make_shared<gamestate::Game>(event_loop, this->mod_manager, &loader);
+	loader.stop();
+
+	if (this->journal_path) {
+		this->journal = std::make_shared<gamestate::CommandJournal>(this->modpacks,
+		                                                            this->journal_interval);
+		this->game->get_state()->set_journal(this->journal);
+	}
 
 	this->running = true;
 
@@ -71,6 +121,21 @@ void GameSimulation::stop() {
 }
 
 
+void GameSimulation::record_journal(const util::Path &path,
+                                    const openage::time::time_t &checkpoint_interval) {
+	std::unique_lock lock{this->mutex};
+
+	this->journal_path = path;
+	this->journal_interval = checkpoint_interval;
+}
+
+const std::shared_ptr<gamestate::CommandJournal> GameSimulation::get_journal() {
+	std::shared_lock lock{this->mutex};
+
+	return this->journal;
+}
+
+
 const util::Path &GameSimulation::get_root_dir() {
 	std::shared_lock lock{this->mutex};
 
@@ -117,6 +182,8 @@ void GameSimulation::attach_renderer(const std::shared_ptr<renderer::RenderFacto
 void GameSimulation::set_modpacks(const std::vector<std::string> &modpacks) {
 	std::unique_lock lock{this->mutex};
 
+	this->modpacks = modpacks;
+
 	std::vector<std::string> mods{"engine"};
 	mods.insert(mods.end(), modpacks.begin(), modpacks.end());
 
@@ -137,4 +204,49 @@ void GameSimulation::init_event_handlers() {
 	this->event_loop->add_event_handler(wait_handler);
 }
 
+void GameSimulation::init_cvars() {
+	// the cvar manager may outlive the simulation, so the accessors keep the loop alive
+	auto loop = this->event_loop;
+
+	// enable/disable event profiling, e.g. "set event_profiling 1"
+	this->cvar_manager->create("event_profiling", std::make_pair(
+		[loop]() {
+			return std::string{loop->get_profiler().is_enabled() ? "1" : "0"};
+		},
+		[loop](const std::string &value) {
+			loop->get_profiler().set_enabled(value == "1" or value == "true" or value == "on");
+		}));
+
+	// JSON dump of the collected data; setting it to "reset" clears the data
+	this->cvar_manager->create("event_profile", std::make_pair(
+		[loop]() {
+			return loop->get_profiler().to_json();
+		},
+		[loop](const std::string &value) {
+			if (value == "reset") {
+				loop->get_profiler().reset();
+			}
+		}));
+
+	// enable/disable the scoped profiling zones of all threads
+	this->cvar_manager->create("tracing", std::make_pair(
+		[]() {
+			return std::string{trace::is_enabled() ? "1" : "0"};
+		},
+		[](const std::string &value) {
+			trace::set_enabled(value == "1" or value == "true" or value == "on");
+		}));
+
+	// Chrome trace JSON of the recorded zones; setting it to "reset" clears the records
+	this->cvar_manager->create("trace", std::make_pair(
+		[]() {
+			return trace::to_json();
+		},
+		[](const std::string &value) {
+			if (value == "reset") {
+				trace::clear();
+			}
+		}));
+}
+
 } // namespace openage::gamestate
@@ -2,8 +2,12 @@
 
 #pragma once
 
+#include <optional>
 #include <shared_mutex>
+#include <string>
+#include <vector>
 
+#include "time/time.h"
 #include "util/path.h"
 
 namespace openage {
@@ -29,6 +33,7 @@ class TimeLoop;
 } // namespace time
 
 namespace gamestate {
+class CommandJournal;
 class EntityFactory;
 class Game;
 
@@ -135,6 +140,26 @@ public:
      */
 	void set_modpacks(const std::vector<std::string> &modpacks);
 
+	/**
+	 * Record the player input of the game in a command journal. Must be
+	 * called before the simulation is started.
+	 *
+	 * The journal is created when the simulation starts and written
+	 * to \p path when the simulation loop exits.
+	 *
+	 * @param path Output path of the journal.
+	 * @param checkpoint_interval Simulation time between two state checkpoints (in seconds).
+	 */
+	void record_journal(const util::Path &path,
+	                    const openage::time::time_t &checkpoint_interval = 10);
+
+	/**
+	 * Get the command journal of the simulation.
+	 *
+	 * @return Command journal. Can be \p nullptr if the game is not recorded.
+	 */
+	const std::shared_ptr<gamestate::CommandJournal> get_journal();
+
 	/**
 	 * current simulation state variable.
 	 * to be set to false to stop the simulation loop.
@@ -147,6 +172,11 @@ private:
      */
 	void init_event_handlers();
 
+	/**
+	 * Register the simulation's configuration entries in the cvar manager.
+	 */
+	void init_cvars();
+
 	/**
 	 * The simulation root directory.
 	 * Uses the openage fslike path abstraction that can mount paths into one.
@@ -190,6 +220,26 @@ private:
 	// TODO: The game run by the engine
 	std::shared_ptr<gamestate::Game> game;
 
+	/**
+	 * IDs of the modpacks selected for the game (without the engine modpack).
+	 */
+	std::vector<std::string> modpacks;
+
+	/**
+	 * Records the player input. Can be \p nullptr.
+	 */
+	std::shared_ptr<gamestate::CommandJournal> journal;
+
+	/**
+	 * Output path of the command journal.
+	 */
+	std::optional<util::Path> journal_path;
+
+	/**
+	 * Simulation time between two state checkpoints in the command journal (in seconds).
+	 */
+	openage::time::time_t journal_interval;
+
 	/**
      * Mutex for thread-safe access to the simulation.
      */
@@ -13,10 +13,6 @@
 #include "coord/phys.h"
 #include "curve/continuous.h"
 #include "curve/segmented.h"
-#include "gamestate/api/ability.h"
-#include "gamestate/api/animation.h"
-#include "gamestate/api/property.h"
-#include "gamestate/api/types.h"
 #include "gamestate/component/api/move.h"
 #include "gamestate/component/api/turn.h"
 #include "gamestate/component/internal/command_queue.h"
@@ -25,6 +21,7 @@
 #include "gamestate/component/types.h"
 #include "gamestate/game_entity.h"
 #include "util/fixed_point.h"
+#include "util/symbol.h"
 
 
 namespace openage::gamestate::system {
@@ -102,15 +99,9 @@ const time::time_t Move::move_default(const std::shared_ptr<gamestate::GameEntit
 	pos_component->set_position(start_time, current_pos);
 	pos_component->set_position(start_time + turn_time + move_time, destination);
 
-	auto ability = move_component->get_ability();
-	if (api::APIAbility::check_property(ability, api::ability_property_t::ANIMATED)) {
-		auto property = api::APIAbility::get_property(ability, api::ability_property_t::ANIMATED);
-		auto animations = api::APIAbilityProperty::get_animations(property);
-		auto animation_paths = api::APIAnimation::get_animation_paths(animations);
-
-		if (animation_paths.size() > 0) [[likely]] {
-			entity->render_update(start_time, animation_paths[0]);
-		}
+	auto &animation = move_component->get_animation();
+	if (not animation.empty()) [[likely]] {
+		entity->render_update(start_time, animation);
 	}
 
 	return turn_time + move_time;
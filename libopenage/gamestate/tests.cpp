@@ -0,0 +1,545 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nyan/nyan.h>
+
+#include "coord/phys.h"
+#include "error/error.h"
+#include "event/event_loop.h"
+#include "event/eventhandler.h"
+#include "job/job_manager.h"
+#include "log/log.h"
+#include "log/message.h"
+#include "testing/temp_dir.h"
+#include "testing/testing.h"
+#include "util/file.h"
+#include "util/path.h"
+
+#include "gamestate/component/internal/commands/types.h"
+#include "gamestate/component/internal/ownership.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/component/types.h"
+#include "gamestate/entity_factory.h"
+#include "gamestate/event/process_command.h"
+#include "gamestate/event/send_command.h"
+#include "gamestate/event/spawn_entity.h"
+#include "gamestate/event/wait.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
+#include "gamestate/journal.h"
+#include "gamestate/nyan_loader.h"
+#include "gamestate/replay.h"
+#include "gamestate/types.h"
+#include "time/time.h"
+
+
+namespace openage::gamestate::tests {
+
+/**
+ * Minimal subset of the engine API and a unit that uses it.
+ */
+static const std::unordered_map<std::string, std::string> test_nyan_files{
+	{"engine/util/attribute.nyan",
+	 "Attribute():\n"
+	 "    pass\n"
+	 "\n"
+	 "AttributeSetting():\n"
+	 "    attribute : Attribute\n"
+	 "    starting_value : int\n"},
+	{"engine/ability/type.nyan",
+	 "import engine.util.attribute\n"
+	 "\n"
+	 "AbilityProperty():\n"
+	 "    pass\n"
+	 "\n"
+	 "Ability():\n"
+	 "    properties : dict(abstract(children(AbilityProperty)), AbilityProperty) = {}\n"
+	 "\n"
+	 "Idle(Ability):\n"
+	 "    pass\n"
+	 "\n"
+	 "Move(Ability):\n"
+	 "    pass\n"
+	 "\n"
+	 "Turn(Ability):\n"
+	 "    pass\n"
+	 "\n"
+	 "Live(Ability):\n"
+	 "    attributes : set(engine.util.attribute.AttributeSetting)\n"},
+	{"engine/util/game_entity.nyan",
+	 "import engine.ability.type\n"
+	 "\n"
+	 "GameEntity():\n"
+	 "    abilities : set(engine.ability.type.Ability)\n"},
+	{"test/unit.nyan",
+	 "import engine.ability.type\n"
+	 "import engine.util.attribute\n"
+	 "import engine.util.game_entity\n"
+	 "\n"
+	 "HP(engine.util.attribute.Attribute):\n"
+	 "    pass\n"
+	 "\n"
+	 "UnitHP(engine.util.attribute.AttributeSetting):\n"
+	 "    attribute = HP\n"
+	 "    starting_value = 100\n"
+	 "\n"
+	 "UnitIdle(engine.ability.type.Idle):\n"
+	 "    pass\n"
+	 "\n"
+	 "UnitMove(engine.ability.type.Move):\n"
+	 "    pass\n"
+	 "\n"
+	 "UnitTurn(engine.ability.type.Turn):\n"
+	 "    pass\n"
+	 "\n"
+	 "UnitLive(engine.ability.type.Live):\n"
+	 "    attributes = {UnitHP}\n"
+	 "\n"
+	 "Unit(engine.util.game_entity.GameEntity):\n"
+	 "    abilities = {UnitIdle, UnitMove, UnitTurn, UnitLive}\n"
+	 "\n"
+	 "Building(engine.util.game_entity.GameEntity):\n"
+	 "    abilities = {UnitIdle, UnitLive}\n"
+	 "\n"
+	 "BuildingMove<Building>():\n"
+	 "    abilities += {UnitMove}\n"},
+};
+
+/**
+ * Create a game state with the test unit in its nyan database.
+ *
+ * @param loop Event loop for the gamestate.
+ *
+ * @return Game state.
+ */
+std::shared_ptr<GameState> create_test_state(const std::shared_ptr<openage::event::EventLoop> &loop) {
+	auto db = nyan::Database::create();
+	db->load("test/unit.nyan", [](const std::string &filename) {
+		auto file = test_nyan_files.find(filename);
+		if (file == test_nyan_files.end()) {
+			throw Error{MSG(err) << "Unknown nyan file: " << filename};
+		}
+		return std::make_shared<nyan::File>(filename, std::string{file->second});
+	});
+
+	return std::make_shared<GameState>(db, loop);
+}
+
+/**
+ * Write a modpack with generated objects into a directory.
+ *
+ * @param base_dir Base directory of the modpack.
+ * @param dirs Number of subdirectories of "synthetic/units".
+ * @param files Number of .nyan files per subdirectory.
+ * @param objects Number of objects per file.
+ */
+void write_synthetic_modpack(const util::Path &base_dir, size_t dirs, size_t files, size_t objects) {
+	auto mod = base_dir / "synthetic";
+	mod.mkdirs();
+
+	auto base = (mod / "base.nyan").open_w();
+	base.write("Base():\n"
+	           "    value : int\n");
+	base.close();
+
+	auto readme = (mod / "readme.txt").open_w();
+	readme.write("not a nyan file");
+	readme.close();
+
+	for (size_t d = 0; d < dirs; ++d) {
+		auto dir = mod / "units" / ("dir" + std::to_string(d));
+		dir.mkdirs();
+
+		for (size_t f = 0; f < files; ++f) {
+			std::string content = "import synthetic.base\n\n";
+			for (size_t o = 0; o < objects; ++o) {
+				content += "Obj" + std::to_string(o) + "(synthetic.base.Base):\n"
+				           "    value = " + std::to_string(o) + "\n\n";
+			}
+
+			auto file = (dir / ("file" + std::to_string(f) + ".nyan")).open_w();
+			file.write(content);
+			file.close();
+		}
+	}
+}
+
+void command_journal() {
+	testing::TempDir tmpdir{"journal"};
+	auto root = tmpdir.get_path();
+	auto path = root / "game.oajr";
+
+	CommandJournal journal{{"aoe2_base"}};
+
+	coord::phys3 spawn_pos{1, 2, 0};
+	coord::phys3 move_target{3.5, -4, 0};
+	std::vector<entity_id_t> ids{7, 42};
+
+	openage::event::EventHandler::param_map spawn_params{{
+		{"position", spawn_pos},
+		{"owner", static_cast<size_t>(2)},
+	}};
+	openage::event::EventHandler::param_map move_params{{
+		{"type", component::command::command_t::MOVE},
+		{"target", move_target},
+		{"entity_ids", ids},
+	}};
+
+	journal.record("game.spawn_entity", 1, spawn_params);
+	journal.record("game.send_command", time::time_t::from_double(2.5), move_params);
+
+	// other events are not player input
+	journal.record("game.wait", 3, {});
+	TESTEQUALS(journal.get_entries().size(), 2);
+
+	journal.save(path);
+
+	// values are stored in little endian byte order
+	auto raw = path.open_r().read();
+	TESTEQUALS(raw.substr(0, 4), "OAJR");
+
+	auto loaded = CommandJournal::load(path);
+
+	TESTEQUALS(loaded->get_modpacks().size(), 1);
+	TESTEQUALS(loaded->get_modpacks().at(0), "aoe2_base");
+
+	auto entries = loaded->get_entries();
+	TESTEQUALS(entries.size(), 2);
+
+	(entries[0].type == journal_entry_t::SPAWN_ENTITY) or TESTFAIL;
+	TESTEQUALS(entries[0].time, 1);
+	TESTEQUALS(entries[0].owner, 2);
+	(entries[0].position == spawn_pos) or TESTFAIL;
+
+	(entries[1].type == journal_entry_t::SEND_COMMAND) or TESTFAIL;
+	TESTEQUALS(entries[1].time, time::time_t::from_double(2.5));
+	(entries[1].command == component::command::command_t::MOVE) or TESTFAIL;
+	(entries[1].position == move_target) or TESTFAIL;
+	(entries[1].entity_ids == ids) or TESTFAIL;
+
+	// files that are not journals are rejected
+	auto other = root / "other.oajr";
+	auto file = other.open_w();
+	file.write("not a journal");
+	file.close();
+	TESTTHROWS(CommandJournal::load(other));
+}
+
+void entity_prototypes() {
+	auto loop = std::make_shared<openage::event::EventLoop>();
+	auto state = create_test_state(loop);
+	EntityFactory factory;
+
+	auto single = factory.add_game_entity(loop, state, "test.unit.Unit");
+	auto batch = factory.add_game_entities(loop, state, "test.unit.Unit", 3);
+	TESTEQUALS(batch.size(), 3);
+
+	// IDs continue after the single entity
+	for (size_t i = 0; i < batch.size(); ++i) {
+		TESTEQUALS(batch[i]->get_id(), single->get_id() + 1 + i);
+	}
+
+	// entities built from the cached prototype get the same components
+	for (auto type : {component::component_t::POSITION,
+	                  component::component_t::OWNERSHIP,
+	                  component::component_t::COMMANDQUEUE,
+	                  component::component_t::IDLE,
+	                  component::component_t::MOVE,
+	                  component::component_t::TURN,
+	                  component::component_t::LIVE,
+	                  component::component_t::ACTIVITY}) {
+		single->has_component(type) or TESTFAIL;
+		for (auto &entity : batch) {
+			entity->has_component(type) or TESTFAIL;
+
+			// but each entity has its own component instances
+			(entity->get_component(type) != single->get_component(type)) or TESTFAIL;
+		}
+	}
+
+	// unknown entities are not cached
+	TESTTHROWS(factory.add_game_entities(loop, state, "test.unit.Missing", 1));
+
+	// patches of the nyan objects are applied to the next spawned entities
+	auto building = factory.add_game_entity(loop, state, "test.unit.Building");
+	(not building->has_component(component::component_t::MOVE)) or TESTFAIL;
+
+	auto &db_view = state->get_nyan_db();
+	auto tx = db_view->new_transaction(1);
+	tx.add(db_view->get_object("test.unit.BuildingMove"));
+	tx.commit() or TESTFAIL;
+
+	auto moving_building = factory.add_game_entity(loop, state, "test.unit.Building");
+	moving_building->has_component(component::component_t::MOVE) or TESTFAIL;
+}
+
+
+void spawn_entities() {
+	auto loop = std::make_shared<openage::event::EventLoop>();
+	auto state = create_test_state(loop);
+	auto factory = std::make_shared<EntityFactory>();
+	loop->add_event_handler(std::make_shared<event::SpawnEntityHandler>(loop, factory));
+	loop->add_event_handler(std::make_shared<event::ProcessCommandHandler>());
+	loop->add_event_handler(std::make_shared<event::WaitHandler>());
+
+	auto journal = std::make_shared<CommandJournal>();
+	state->set_journal(journal);
+
+	coord::phys3 spawn_pos{10, 10, 0};
+	openage::event::EventHandler::param_map::map_t params{
+		{"position", spawn_pos},
+		{"owner", size_t{1}},
+		{"count", size_t{5}},
+		{"game_entity", nyan::fqon_t{"test.unit.Unit"}},
+	};
+	auto spawner = std::make_shared<event::Spawner>(loop);
+	loop->create_event("game.spawn_entity", spawner, state, 1, params);
+	loop->reach_time(1, state);
+
+	// the group is spawned in a batch on a grid around the spawn position
+	auto &entities = state->get_game_entities();
+	TESTEQUALS(entities.size(), 5);
+
+	std::vector<coord::phys3> positions;
+	for (const auto &[id, entity] : entities) {
+		auto ownership = std::dynamic_pointer_cast<component::Ownership>(
+			entity->get_component(component::component_t::OWNERSHIP));
+		TESTEQUALS(ownership->get_owners().get(1), 1);
+
+		auto position = std::dynamic_pointer_cast<component::Position>(
+			entity->get_component(component::component_t::POSITION));
+		auto pos = position->get_positions().get(1);
+		(std::abs((pos - spawn_pos).ne.to_double()) <= 1.0) or TESTFAIL;
+		(std::abs((pos - spawn_pos).se.to_double()) <= 1.0) or TESTFAIL;
+
+		(std::find(positions.begin(), positions.end(), pos) == positions.end()) or TESTFAIL;
+		positions.push_back(pos);
+	}
+
+	// the spawned game entity is journaled with the group size
+	auto entries = journal->get_entries();
+	TESTEQUALS(entries.size(), 1);
+	(entries[0].type == journal_entry_t::SPAWN_ENTITY) or TESTFAIL;
+	TESTEQUALS(entries[0].time, 1);
+	TESTEQUALS(entries[0].owner, 1);
+	TESTEQUALS(entries[0].count, 5);
+	TESTEQUALS(entries[0].game_entity, "test.unit.Unit");
+	(entries[0].position == spawn_pos) or TESTFAIL;
+}
+
+
+void journal_replay() {
+	openage::event::EventHandler::param_map::map_t first_group{
+		{"position", coord::phys3{10, 10, 0}},
+		{"owner", size_t{1}},
+		{"count", size_t{3}},
+		{"game_entity", nyan::fqon_t{"test.unit.Unit"}},
+	};
+	openage::event::EventHandler::param_map::map_t second_group{
+		{"position", coord::phys3{-5, 20, 0}},
+		{"owner", size_t{2}},
+		{"count", size_t{2}},
+		{"game_entity", nyan::fqon_t{"test.unit.Building"}},
+	};
+
+	// loop with the game event handlers and a fresh entity factory
+	auto create_loop = []() {
+		auto loop = std::make_shared<openage::event::EventLoop>();
+		auto factory = std::make_shared<EntityFactory>();
+		loop->add_event_handler(std::make_shared<event::SpawnEntityHandler>(loop, factory));
+		loop->add_event_handler(std::make_shared<event::SendCommandHandler>());
+		loop->add_event_handler(std::make_shared<event::ProcessCommandHandler>());
+		loop->add_event_handler(std::make_shared<event::WaitHandler>());
+		return loop;
+	};
+
+	// record a session with a checkpoint every 2 seconds
+	auto journal = std::make_shared<CommandJournal>(std::vector<std::string>{}, 2);
+	{
+		auto loop = create_loop();
+		auto state = create_test_state(loop);
+		state->set_journal(journal);
+
+		auto spawner = std::make_shared<event::Spawner>(loop);
+		loop->create_event("game.spawn_entity", spawner, state, 1, first_group);
+		loop->create_event("game.spawn_entity", spawner, state, 4, second_group);
+
+		for (time::time_t time = 1; time <= 6; time += 1) {
+			loop->reach_time(time, state);
+			journal->checkpoint(time, state);
+		}
+	}
+
+	// spawns and checkpoints at t=2, t=4 and t=6
+	auto entries = journal->get_entries();
+	TESTEQUALS(entries.size(), 5);
+	(entries[1].type == journal_entry_t::CHECKPOINT) or TESTFAIL;
+	TESTEQUALS(entries[1].time, 2);
+	(entries[3].type == journal_entry_t::CHECKPOINT) or TESTFAIL;
+	TESTEQUALS(entries[3].time, 4);
+
+	// the hash covers the entities that were spawned in between
+	(entries[1].state_hash != entries[3].state_hash) or TESTFAIL;
+
+	// replaying into a fresh state arrives at the same state hashes
+	{
+		auto loop = create_loop();
+		auto state = create_test_state(loop);
+		auto report = replay_journal(loop,
+		                             state,
+		                             std::make_shared<event::Spawner>(loop),
+		                             std::make_shared<event::Commander>(loop),
+		                             journal);
+
+		TESTEQUALS(report.commands, 2);
+		TESTEQUALS(report.checkpoints, 3);
+		TESTEQUALS(report.mismatches, 0);
+		(not report.first_mismatch) or TESTFAIL;
+		TESTEQUALS(report.sim_time, 6);
+		TESTEQUALS(state->get_game_entities().size(), 5);
+		TESTEQUALS(CommandJournal::state_hash(state, 6), entries[4].state_hash);
+	}
+
+	// a state that differs from the recording is reported at the first checkpoint
+	{
+		auto loop = create_loop();
+		auto state = create_test_state(loop);
+		auto spawner = std::make_shared<event::Spawner>(loop);
+
+		openage::event::EventHandler::param_map::map_t extra{
+			{"position", coord::phys3{0, 0, 0}},
+			{"owner", size_t{3}},
+			{"count", size_t{1}},
+			{"game_entity", nyan::fqon_t{"test.unit.Unit"}},
+		};
+		loop->create_event("game.spawn_entity", spawner, state, 1, extra);
+
+		auto report = replay_journal(loop,
+		                             state,
+		                             spawner,
+		                             std::make_shared<event::Commander>(loop),
+		                             journal);
+
+		TESTEQUALS(report.checkpoints, 3);
+		TESTEQUALS(report.mismatches, 3);
+		report.first_mismatch or TESTFAIL;
+		TESTEQUALS(*report.first_mismatch, 2);
+	}
+}
+
+void nyan_loader() {
+	testing::TempDir tmpdir{"nyan"};
+	auto root = tmpdir.get_path();
+	write_synthetic_modpack(root, 3, 4, 2);
+
+	job::JobManager job_manager{2};
+	job_manager.start();
+
+	auto add_includes = [&root](NyanLoader &loader) {
+		loader.add_include(root, "synthetic", "base.nyan");
+		loader.add_include(root, "synthetic", "units/**");
+		// only subdirectories, which are skipped without "**"
+		loader.add_include(root, "synthetic", "units");
+	};
+
+	auto serial_db = nyan::Database::create();
+	NyanLoader serial{serial_db};
+	add_includes(serial);
+
+	auto parallel_db = nyan::Database::create();
+	NyanLoader parallel{parallel_db, &job_manager};
+	add_includes(parallel);
+
+	// the files are in include order and sorted, no matter how they are searched
+	auto files = serial.find_files();
+	TESTEQUALS(files.size(), 1 + 3 * 4);
+	TESTEQUALS(files[0], "synthetic/base.nyan");
+	TESTEQUALS(files[1], "synthetic/units/dir0/file0.nyan");
+	TESTEQUALS(files.back(), "synthetic/units/dir2/file3.nyan");
+	(parallel.find_files() == files) or TESTFAIL;
+
+	TESTEQUALS(serial.load(), files.size());
+	TESTEQUALS(parallel.load(), files.size());
+	job_manager.stop();
+
+	auto serial_objs = serial_db->new_view()->get_obj_children_all("synthetic.base.Base");
+	auto parallel_objs = parallel_db->new_view()->get_obj_children_all("synthetic.base.Base");
+	TESTEQUALS(serial_objs.size(), 3 * 4 * 2);
+	(serial_objs == parallel_objs) or TESTFAIL;
+
+	// includes that match nothing load no files
+	NyanLoader missing{nyan::Database::create()};
+	missing.add_include(root, "synthetic", "missing.nyan");
+	TESTEQUALS(missing.load(), 0);
+}
+
+
+void nyan_load_benchmark() {
+	const size_t dirs = 20;
+	const size_t files = 100;
+	const size_t objects = 5;
+
+	testing::TempDir tmpdir{"nyan"};
+	auto root = tmpdir.get_path();
+	write_synthetic_modpack(root, dirs, files, objects);
+
+	auto measure = [&root](job::JobManager *job_manager) {
+		auto start = std::chrono::steady_clock::now();
+		NyanLoader loader{nyan::Database::create(), job_manager};
+		loader.add_include(root, "synthetic", "**");
+		loader.load();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	double serial_ms = measure(nullptr);
+
+	size_t workers = std::max(1u, std::thread::hardware_concurrency());
+	job::JobManager job_manager{static_cast<int>(workers)};
+	job_manager.start();
+	double parallel_ms = measure(&job_manager);
+	job_manager.stop();
+
+	log::log(MSG(info) << "loading " << dirs * files + 1 << " .nyan files with "
+	                   << dirs * files * objects << " objects");
+	log::log(MSG(info) << "  serial:   " << serial_ms << " ms");
+	log::log(MSG(info) << "  parallel: " << parallel_ms << " ms (" << workers << " workers)");
+}
+
+
+void spawn_benchmark() {
+	const size_t count = 10000;
+
+	auto loop = std::make_shared<openage::event::EventLoop>();
+	auto state = create_test_state(loop);
+	EntityFactory factory;
+
+	// the first spawn resolves the prototype from the nyan database
+	auto start = std::chrono::steady_clock::now();
+	factory.add_game_entity(loop, state, "test.unit.Unit");
+	auto first = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < count; ++i) {
+		factory.add_game_entity(loop, state, "test.unit.Unit");
+	}
+	auto single = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	auto entities = factory.add_game_entities(loop, state, "test.unit.Unit", count);
+	auto batch = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	log::log(MSG(info) << "spawning " << count << " entities");
+	log::log(MSG(info) << "  first spawn: " << first.count() * 1e6 << " us");
+	log::log(MSG(info) << "  single: " << count / single.count() << " entities/s");
+	log::log(MSG(info) << "  batch:  " << count / batch.count() << " entities/s");
+}
+
+} // namespace openage::gamestate::tests
@@ -116,6 +116,29 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 
 	ctx->bind(ev_mouse_lmb, create_entity_action);
 
+	binding_func_t create_group_event{[&](const event_arguments &args,
+	                                      const Controller &controller) {
+		auto mouse_pos = args.mouse.to_phys3(camera);
+		event::EventHandler::param_map::map_t params{
+			{"position", mouse_pos},
+			{"owner", controller.get_controlled()},
+			{"count", size_t{9}},
+		};
+
+		auto event = simulation->get_event_loop()->create_event(
+			"game.spawn_entity",
+			simulation->get_spawner(),
+			simulation->get_game()->get_state(),
+			time_loop->get_clock()->get_time(),
+			params);
+		return event;
+	}};
+
+	binding_action create_group_action{forward_action_t::SEND, create_group_event};
+	Event ev_mouse_lmb_shift{event_class::MOUSE_BUTTON, Qt::MouseButton::LeftButton, Qt::ShiftModifier, QEvent::MouseButtonRelease};
+
+	ctx->bind(ev_mouse_lmb_shift, create_group_action);
+
 	binding_func_t move_entity{[&](const event_arguments &args,
 	                               const Controller &controller) {
 		auto mouse_pos = args.mouse.to_phys3(camera);
@@ -48,6 +48,17 @@ public:
 		return true;
 	}
 
+	/**
+	 * Blocks until this job has finished. If an abortable job is aborted, the
+	 * wait ends as well and get_result() rethrows the abort. If this job
+	 * wrapper has no assigned background job, it returns immediately.
+	 */
+	void wait() const {
+		if (this->state) {
+			this->state->wait();
+		}
+	}
+
 	/**
 	 * Returns this job's result if the background execution was successful. If
 	 * an exception has happened, it will be rethrown. This method must not be
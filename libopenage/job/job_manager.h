@@ -25,6 +25,12 @@ class Worker;
 /**
  * A job manager can be used to execute functions within separate worker
  * threads.
+ *
+ * pxd:
+ * cppclass JobManager:
+ *     JobManager(int number_of_workers) except +
+ *     void start() except +
+ *     void stop() except +
  */
 class JobManager {
 private:
@@ -6,6 +6,7 @@
 #include "job_manager.h"
 
 #include <atomic>
+#include <vector>
 
 namespace openage {
 namespace job {
@@ -90,9 +91,45 @@ void test_simple_job_with_exception() {
 }
 
 
+void test_wait() {
+	JobManager manager{2};
+	manager.start();
+
+	std::vector<Job<int>> jobs;
+	for (int i = 0; i < 100; i++) {
+		jobs.push_back(manager.enqueue<int>([i]() -> int {
+			if (i == 50) {
+				throw "error string";
+			}
+			return i;
+		}));
+	}
+
+	int errors = 0;
+	for (int i = 0; i < 100; i++) {
+		jobs[i].wait();
+		jobs[i].is_finished() or TESTFAIL;
+
+		try {
+			jobs[i].get_result() == i or TESTFAIL;
+		} catch (const char *e) {
+			errors++;
+		}
+	}
+	manager.execute_callbacks();
+	manager.stop();
+
+	errors == 1 or TESTFAIL;
+
+	// waiting on an empty job returns immediately
+	Job<int>{}.wait();
+}
+
+
 void test_job_manager() {
 	test_simple_job();
 	test_simple_job_with_exception();
+	test_wait();
 }
 
 
@@ -3,8 +3,10 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <exception>
 #include <functional>
+#include <mutex>
 
 #include "../util/thread_id.h"
 #include "../error/error.h"
@@ -41,6 +43,12 @@ public:
 	 */
 	std::atomic_bool finished;
 
+	/** Mutex that guards setting the finished flag for waiting threads. */
+	std::mutex finished_mutex;
+
+	/** Notified when the job has finished. */
+	std::condition_variable finished_cond;
+
 	/** The result of the Job's executed function. */
 	T result;
 
@@ -67,14 +75,27 @@ public:
 		try {
 			this->result = this->execute_and_get(should_abort);
 		} catch (JobAbortedException &e) {
+			// wake up waiting threads, they get the abort exception
+			this->exception = std::current_exception();
+			this->finish();
 			return true;
 		} catch (...) {
 			this->exception = std::current_exception();
 		}
-		this->finished.store(true);
+		this->finish();
 		return false;
 	}
 
+	/**
+	 * Blocks the calling thread until the job has finished or was aborted.
+	 */
+	void wait() {
+		std::unique_lock<std::mutex> lock{this->finished_mutex};
+		this->finished_cond.wait(lock, [this]() {
+			return this->finished.load();
+		});
+	}
+
 	/**
 	 * Called when the job was finished.
 	 * This is the result notification for the place where the job was constructed.
@@ -98,6 +119,17 @@ public:
 	}
 
 protected:
+	/**
+	 * Marks the job as finished and wakes up all threads waiting for it.
+	 */
+	void finish() {
+		{
+			std::lock_guard<std::mutex> lock{this->finished_mutex};
+			this->finished.store(true);
+		}
+		this->finished_cond.notify_all();
+	}
+
 	/**
 	 * Executes the job and returns the result. If an exception is thrown it
 	 * must be passed to the calling function.
@@ -6,6 +6,8 @@
 
 #include <memory>
 
+#include "../trace/trace.h"
+
 
 namespace openage {
 namespace job {
@@ -51,6 +53,8 @@ void Worker::join() {
 
 
 void Worker::execute_job(std::shared_ptr<JobStateBase> &job) {
+	TRACE_ZONE("Worker::execute_job", "job");
+
 	auto should_abort = [this]() {
 		return not this->is_running;
 	};
@@ -65,6 +69,8 @@ void Worker::execute_job(std::shared_ptr<JobStateBase> &job) {
 
 
 void Worker::process() {
+	trace::set_thread_name("job worker");
+
 	// as long as this worker thread is running repeat all steps
 	while (true) {
 		// lock the local thread queue
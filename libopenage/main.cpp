@@ -3,6 +3,7 @@
 #include "main.h"
 
 #include <memory>
+#include <optional>
 
 #include "cvar/cvar.h"
 #include "engine/engine.h"
@@ -27,7 +28,11 @@ int run_game(const main_arguments &args) {
 
 	// TODO: select run_mode by launch argument
 	openage::engine::Engine::mode run_mode = openage::engine::Engine::mode::FULL;
-	openage::engine::Engine engine{run_mode, args.root_path, args.mods};
+	std::optional<util::Path> journal_path;
+	if (args.record_journal) {
+		journal_path = args.journal_path;
+	}
+	openage::engine::Engine engine{run_mode, args.root_path, args.mods, journal_path};
 
 	engine.loop();
 
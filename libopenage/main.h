@@ -28,12 +28,16 @@ namespace openage {
  *     int32_t fps_limit
  *     bool gl_debug
  *     vector[string] mods
+ *     bool record_journal
+ *     Path journal_path
  */
 struct main_arguments {
 	util::Path root_path;
 	int32_t fps_limit;
 	bool gl_debug;
 	std::vector<std::string> mods;
+	bool record_journal;
+	util::Path journal_path;
 };
 
 
@@ -14,6 +14,7 @@
 
 #include <cmath>
 
+#include "../datastructure/object_pool.h"
 #include "../datastructure/pairing_heap.h"
 #include "../log/log.h"
 #include "../terrain/terrain.h"
@@ -75,7 +76,7 @@ Path a_star(coord::phys3 start,
 	nodemap_t visited_tiles;
 
 	// add starting node
-	node_pt start_node = std::make_shared<Node>(start, nullptr, .0f, heuristic(start));
+	node_pt start_node = datastructure::make_pooled<Node>(start, nullptr, .0f, heuristic(start));
 	visited_tiles[start_node->position] = start_node;
 	node_candidates.push(start_node);
 
@@ -3,6 +3,7 @@
 #include <cmath>
 
 #include "path.h"
+#include "../datastructure/object_pool.h"
 #include "../terrain/terrain.h"
 
 namespace openage::path {
@@ -85,11 +86,12 @@ std::vector<node_pt> Node::get_neighbors(const nodemap_t &nodes, float scale) {
 	for (int n = 0; n < 8; ++n) {
 		coord::phys3 n_pos = this->position + (neigh_phys[n] * scale);
 
-		if (nodes.count(n_pos) > 0) {
-			neighbors.push_back( nodes.at(n_pos) );
+		auto it = nodes.find(n_pos);
+		if (it != nodes.end()) {
+			neighbors.push_back(it->second);
 		}
 		else {
-			neighbors.push_back( std::make_shared<Node>(n_pos, this->shared_from_this()) );
+			neighbors.push_back( datastructure::make_pooled<Node>(n_pos, this->shared_from_this()) );
 		}
 	}
 	return neighbors;
@@ -4,11 +4,11 @@
 
 #include <functional>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include "../coord/phys.h"
 #include "../coord/tile.h"
+#include "../datastructure/flat_hash_map.h"
 #include "../datastructure/pairing_heap.h"
 #include "../util/misc.h"
 #include "../util/hash.h"
@@ -39,7 +39,7 @@ using node_pt = std::shared_ptr<Node>;
 /**
  * Type for mapping tiles to nodes.
  */
-using nodemap_t = std::unordered_map<coord::phys3, node_pt>;
+using nodemap_t = datastructure::FlatHashMap<coord::phys3, node_pt>;
 
 
 /**
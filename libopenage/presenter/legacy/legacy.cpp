@@ -505,6 +505,9 @@ void LegacyDisplay::loop() {
 	//
 	//	util::gl_check_error();
 	//
+	//	// read back the frame for screenshots and captures before it is swapped
+	//	this->screenshot_manager.update(this->coord.viewport_size);
+	//
 	//	this->profiler.end_measure("rendering");
 	//
 	//	this->profiler.start_measure("idle", {0.0, 0.0, 1.0});
@@ -2,6 +2,7 @@
 
 #include "presenter.h"
 
+#include <algorithm>
 #include <eigen3/Eigen/Dense>
 #include <iostream>
 #include <string>
@@ -14,6 +15,7 @@
 #include "input/controller/game/controller.h"
 #include "input/input_context.h"
 #include "input/input_manager.h"
+#include "job/job_manager.h"
 #include "log/log.h"
 #include "renderer/camera/camera.h"
 #include "renderer/gui/gui.h"
@@ -21,6 +23,8 @@
 #include "renderer/gui/qml_info.h"
 #include "renderer/render_factory.h"
 #include "renderer/resources/assets/asset_manager.h"
+#include "renderer/resources/assets/cache.h"
+#include "renderer/resources/assets/texture_manager.h"
 #include "renderer/resources/shader_source.h"
 #include "renderer/resources/texture_info.h"
 #include "renderer/stages/camera/manager.h"
@@ -29,7 +33,9 @@
 #include "renderer/stages/terrain/terrain_renderer.h"
 #include "renderer/stages/world/world_renderer.h"
 #include "renderer/window.h"
+#include "screenshot.h"
 #include "time/time_loop.h"
+#include "trace/trace.h"
 #include "util/path.h"
 
 namespace openage::presenter {
@@ -45,6 +51,7 @@ Presenter::Presenter(const util::Path &root_dir,
 
 void Presenter::run() {
 	log::log(INFO << "presenter launching...");
+	trace::set_thread_name("presenter");
 
 	this->init_graphics();
 
@@ -62,6 +69,11 @@ void Presenter::run() {
 	}
 	log::log(MSG(info) << "Draw loop exited");
 
+	// frames that are still read back or encoded are saved before the workers stop
+	this->screenshot_manager->stop_capture();
+	this->screenshot_manager->flush();
+	this->job_manager->stop();
+
 	if (this->simulation) {
 		this->simulation->stop();
 	}
@@ -111,13 +123,35 @@ void Presenter::init_graphics() {
 	auto missing_tex = this->root_dir / "assets" / "test" / "textures" / "test_missing.sprite";
 	this->asset_manager->set_placeholder_animation(missing_tex);
 
+	// the caches are unlimited by default; beyond these budgets, assets that
+	// were not used recently are evicted once per frame
+	this->asset_manager->get_cache()->set_budget(asset_cache_budget);
+	this->asset_manager->get_texture_manager()->set_budget(texture_cache_budget);
+
+	// Palettes for indexed textures are taken from the first modpack that has them.
+	// Player colors start at index 16 of the base palette, like in AoE2.
+	auto converted_dir = this->root_dir / "assets" / "converted";
+	if (converted_dir.is_dir()) {
+		auto modpacks = converted_dir.list();
+		std::sort(modpacks.begin(), modpacks.end());
+		for (auto &modpack : modpacks) {
+			if (modpack == "." or modpack == "..") {
+				continue;
+			}
+			if (this->asset_manager->load_palettes(converted_dir / modpack / "palettes", 16)) {
+				log::log(INFO << "Loaded palettes of modpack " << modpack);
+				break;
+			}
+		}
+	}
+
 	// Skybox
 	this->skybox_renderer = std::make_shared<renderer::skybox::SkyboxRenderer>(
 		this->window,
 		this->renderer,
 		this->root_dir["assets"]["shaders"]);
 	this->skybox_renderer->set_color(1.0f, 0.5f, 0.0f, 1.0f);
-	this->render_passes.push_back(this->skybox_renderer->get_render_pass());
+	this->render_passes.push_back({this->skybox_renderer->get_render_pass(), "Renderer::render(skybox)"});
 
 	// Terrain
 	this->terrain_renderer = std::make_shared<renderer::terrain::TerrainRenderer>(
@@ -127,7 +161,7 @@ void Presenter::init_graphics() {
 		this->root_dir["assets"]["shaders"],
 		this->asset_manager,
 		this->time_loop->get_clock());
-	this->render_passes.push_back(this->terrain_renderer->get_render_pass());
+	this->render_passes.push_back({this->terrain_renderer->get_render_pass(), "Renderer::render(terrain)"});
 
 	// Units/buildings
 	this->world_renderer = std::make_shared<renderer::world::WorldRenderer>(
@@ -137,10 +171,11 @@ void Presenter::init_graphics() {
 		this->root_dir["assets"]["shaders"],
 		this->asset_manager,
 		this->time_loop->get_clock());
-	this->render_passes.push_back(this->world_renderer->get_render_pass());
+	this->render_passes.push_back({this->world_renderer->get_render_pass(), "Renderer::render(world)"});
 
 	this->init_gui();
 	this->init_final_render_pass();
+	this->init_screenshots();
 
 	if (this->simulation) {
 		auto render_factory = std::make_shared<renderer::RenderFactory>(this->terrain_renderer,
@@ -181,7 +216,7 @@ void Presenter::init_gui() {
 	);
 
 	auto gui_pass = this->gui->get_render_pass();
-	this->render_passes.push_back(gui_pass);
+	this->render_passes.push_back({gui_pass, "Renderer::render(gui)"});
 }
 
 void Presenter::init_input() {
@@ -219,6 +254,16 @@ void Presenter::init_input() {
 		this->input_manager->set_gui(this->gui->get_input_handler());
 	}
 
+	// screenshots, same keys as in cfg/keybinds.oac
+	input::Event ev_screenshot{input::event_class::KEYBOARD, Qt::Key_F2, Qt::NoModifier, QEvent::KeyPress};
+	input::Event ev_capture{input::event_class::KEYBOARD, Qt::Key_F2, Qt::ShiftModifier, QEvent::KeyPress};
+	input_ctx->bind(ev_screenshot, {input::input_action_t::CUSTOM, [this](const input::event_arguments &) {
+		this->screenshot_manager->save_screenshot(this->screenshot_manager->window_size);
+	}});
+	input_ctx->bind(ev_capture, {input::input_action_t::CUSTOM, [this](const input::event_arguments &) {
+		this->screenshot_manager->toggle_capture();
+	}});
+
 	// setup camera controls
 	if (this->camera) {
 		auto camera_controller = std::make_shared<input::camera::Controller>();
@@ -236,11 +281,11 @@ void Presenter::init_final_render_pass() {
 		this->renderer,
 		this->root_dir["assets"]["shaders"]);
 	std::vector<std::shared_ptr<renderer::RenderTarget>> targets{};
-	for (auto pass : this->render_passes) {
-		targets.push_back(pass->get_target());
+	for (auto &entry : this->render_passes) {
+		targets.push_back(entry.pass->get_target());
 	}
 	this->screen_renderer->set_render_targets(targets);
-	this->render_passes.push_back(this->screen_renderer->get_render_pass());
+	this->render_passes.push_back({this->screen_renderer->get_render_pass(), "Renderer::render(screen)"});
 
 	// Update final render pass if the textures are reassigned on resize
 	// TODO: This REQUIRES that all other render passes have already been
@@ -249,21 +294,47 @@ void Presenter::init_final_render_pass() {
 		// Acquire the render targets for all previous passes
 		std::vector<std::shared_ptr<renderer::RenderTarget>> targets{};
 		for (size_t i = 0; i < this->render_passes.size() - 1; ++i) {
-			targets.push_back(this->render_passes[i]->get_target());
+			targets.push_back(this->render_passes[i].pass->get_target());
 		}
 		this->screen_renderer->set_render_targets(targets);
 	});
 }
 
+void Presenter::init_screenshots() {
+	// a single worker is enough, frames are dropped if it falls behind
+	this->job_manager = std::make_shared<job::JobManager>(1);
+	this->job_manager->start();
+
+	this->screenshot_manager = std::make_shared<ScreenshotManager>(this->job_manager.get());
+
+	// the framebuffer is scaled by the device pixel ratio, like the display target
+	auto update_size = [this](size_t w, size_t h, double scale) {
+		this->screenshot_manager->window_size = coord::viewport_delta{
+			static_cast<coord::pixel_t>(w * scale),
+			static_cast<coord::pixel_t>(h * scale)};
+	};
+	auto size = this->window->get_size();
+	update_size(size[0], size[1], this->window->get_scale());
+	this->window->add_resize_callback(update_size);
+}
+
 void Presenter::render() {
+	TRACE_ZONE("Presenter::render", "renderer");
+
 	this->camera_manager->update();
 	this->terrain_renderer->update();
 	this->world_renderer->update();
 	this->gui->render();
 
-	for (auto &pass : this->render_passes) {
-		this->renderer->render(pass);
+	for (auto &entry : this->render_passes) {
+		TRACE_ZONE(entry.zone_name, "renderer");
+		this->renderer->render(entry.pass);
 	}
+
+	// read back the frame for screenshots and captures before it is swapped
+	this->screenshot_manager->update(this->screenshot_manager->window_size);
+
+	this->asset_manager->next_frame();
 }
 
 } // namespace openage::presenter
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -13,6 +14,8 @@ class GuiApplication;
 
 namespace openage {
 
+class ScreenshotManager;
+
 namespace gamestate {
 class GameSimulation;
 }
@@ -21,6 +24,10 @@ namespace input {
 class InputManager;
 }
 
+namespace job {
+class JobManager;
+}
+
 namespace time {
 class TimeLoop;
 }
@@ -134,11 +141,26 @@ protected:
 
 	// void init_audio();
 
+	/**
+	 * Initialize screenshots and frame captures.
+	 */
+	void init_screenshots();
+
 	/**
 	 * Render all configured render passes in sequence.
 	 */
 	void render();
 
+	/**
+	 * Memory budget of the asset description cache (in bytes).
+	 */
+	static constexpr size_t asset_cache_budget = 64 * 1024 * 1024;
+
+	/**
+	 * Memory budget of the texture cache (in bytes).
+	 */
+	static constexpr size_t texture_cache_budget = 1024 * 1024 * 1024;
+
 	// TODO: remove and move into our config/settings system
 	util::Path root_dir;
 
@@ -198,10 +220,29 @@ protected:
 	 */
 	std::shared_ptr<renderer::resources::AssetManager> asset_manager;
 
+	/**
+	 * Job manager whose workers encode screenshots and captured frames.
+	 */
+	std::shared_ptr<job::JobManager> job_manager;
+
+	/**
+	 * Saves screenshots and captures frames of the window.
+	 */
+	std::shared_ptr<ScreenshotManager> screenshot_manager;
+
+	/**
+	 * Render pass with the name of its trace zone.
+	 */
+	struct render_pass_entry {
+		std::shared_ptr<renderer::RenderPass> pass;
+		/// Name of the zone that traces the pass, must be a string literal.
+		const char *zone_name;
+	};
+
 	/**
 	 * Render passes in the openage renderer.
 	 */
-	std::vector<std::shared_ptr<renderer::RenderPass>> render_passes;
+	std::vector<render_pass_entry> render_passes;
 
 	/**
 	 * Game simulation.
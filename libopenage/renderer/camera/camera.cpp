@@ -219,6 +219,13 @@ const Eigen::Matrix4f &Camera::get_projection_matrix() {
 	return this->proj;
 }
 
+Frustum2d Camera::get_frustum_2d() {
+	return Frustum2d{this->viewport_size,
+	                 this->get_view_matrix(),
+	                 this->get_projection_matrix(),
+	                 this->zoom};
+}
+
 const util::Vector2s &Camera::get_viewport_size() const {
 	return this->viewport_size;
 }
@@ -10,6 +10,7 @@
 
 #include "coord/pixel.h"
 #include "coord/scene.h"
+#include "renderer/camera/frustum_2d.h"
 #include "util/vector.h"
 
 namespace openage::renderer {
@@ -159,6 +160,13 @@ public:
       */
 	const Eigen::Matrix4f &get_projection_matrix();
 
+	/**
+     * Get the frustum of the current camera view for culling sprites.
+     *
+     * @return Frustum for 2D sprites.
+     */
+	Frustum2d get_frustum_2d();
+
 	/**
      * Get the size of the camera viewport.
      *
@@ -0,0 +1,45 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "frustum_2d.h"
+
+#include <cmath>
+
+
+namespace openage::renderer::camera {
+
+Frustum2d::Frustum2d(const util::Vector2s &viewport_size,
+                     const Eigen::Matrix4f &view_matrix,
+                     const Eigen::Matrix4f &projection_matrix,
+                     float zoom) {
+	this->update(viewport_size, view_matrix, projection_matrix, zoom);
+}
+
+void Frustum2d::update(const util::Vector2s &viewport_size,
+                       const Eigen::Matrix4f &view_matrix,
+                       const Eigen::Matrix4f &projection_matrix,
+                       float zoom) {
+	this->view_proj = projection_matrix * view_matrix;
+
+	// clip space spans 2.0 units across the viewport and sprites are
+	// scaled inversely to the zoom level (see WorldObject::update_uniforms())
+	this->pixel_size = Eigen::Vector2f{
+		2.0f / (viewport_size[0] * zoom),
+		2.0f / (viewport_size[1] * zoom),
+	};
+}
+
+bool Frustum2d::is_visible(const Eigen::Vector3f &scene_pos,
+                           float scalefactor,
+                           const Eigen::Vector2f &bounds) const {
+	// the projection is orthographic, so w is always 1.0
+	Eigen::Vector4f clip_pos = this->view_proj * scene_pos.homogeneous();
+
+	// extend the viewport by the sprite size around the projected position
+	float x_limit = 1.0f + bounds[0] * scalefactor * this->pixel_size[0];
+	float y_limit = 1.0f + bounds[1] * scalefactor * this->pixel_size[1];
+
+	return std::abs(clip_pos[0]) <= x_limit
+	       and std::abs(clip_pos[1]) <= y_limit;
+}
+
+} // namespace openage::renderer::camera
@@ -0,0 +1,73 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <eigen3/Eigen/Dense>
+
+#include "util/vector.h"
+
+
+namespace openage::renderer::camera {
+
+/**
+ * Frustum for culling sprites that are drawn at a position in the 3D scene.
+ *
+ * Sprites are quads that are placed in clip space around the projected
+ * position of their object. An object is visible if its sprite overlaps
+ * the viewport. Works with the orthographic projection of \p Camera.
+ */
+class Frustum2d {
+public:
+	/**
+	 * Create a new frustum.
+	 *
+	 * @param viewport_size Size of the camera viewport (width x height).
+	 * @param view_matrix View matrix of the camera.
+	 * @param projection_matrix Projection matrix of the camera.
+	 * @param zoom Zoom level of the camera.
+	 */
+	Frustum2d(const util::Vector2s &viewport_size,
+	          const Eigen::Matrix4f &view_matrix,
+	          const Eigen::Matrix4f &projection_matrix,
+	          float zoom);
+
+	/**
+	 * Update the frustum with new camera parameters.
+	 *
+	 * @param viewport_size Size of the camera viewport (width x height).
+	 * @param view_matrix View matrix of the camera.
+	 * @param projection_matrix Projection matrix of the camera.
+	 * @param zoom Zoom level of the camera.
+	 */
+	void update(const util::Vector2s &viewport_size,
+	            const Eigen::Matrix4f &view_matrix,
+	            const Eigen::Matrix4f &projection_matrix,
+	            float zoom);
+
+	/**
+	 * Check whether a sprite is inside the frustum.
+	 *
+	 * @param scene_pos Position of the object in the scene.
+	 * @param scalefactor Factor by which the sprite is scaled down at default zoom.
+	 * @param bounds Maximum distance (in pixels) from the object position to the
+	 *               edges of the sprite (x, y).
+	 *
+	 * @return true if the sprite is (partially) visible, else false.
+	 */
+	bool is_visible(const Eigen::Vector3f &scene_pos,
+	                float scalefactor,
+	                const Eigen::Vector2f &bounds) const;
+
+private:
+	/**
+	 * Combined projection and view matrix of the camera.
+	 */
+	Eigen::Matrix4f view_proj;
+
+	/**
+	 * Size of one sprite pixel in clip space at a scalefactor of 1.0 (x, y).
+	 */
+	Eigen::Vector2f pixel_size;
+};
+
+} // namespace openage::renderer::camera
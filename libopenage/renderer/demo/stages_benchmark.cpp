@@ -0,0 +1,191 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "stages_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "coord/phys.h"
+#include "log/log.h"
+#include "log/message.h"
+#include "renderer/camera/camera.h"
+#include "renderer/null/render_stats.h"
+#include "renderer/null/renderer.h"
+#include "renderer/null/window.h"
+#include "renderer/render_factory.h"
+#include "renderer/renderer.h"
+#include "renderer/resources/assets/asset_manager.h"
+#include "renderer/stages/screen/screen_renderer.h"
+#include "renderer/stages/skybox/skybox_renderer.h"
+#include "renderer/stages/terrain/terrain_render_entity.h"
+#include "renderer/stages/terrain/terrain_renderer.h"
+#include "renderer/stages/world/world_render_entity.h"
+#include "renderer/stages/world/world_renderer.h"
+#include "time/clock.h"
+#include "util/path.h"
+#include "util/vector.h"
+
+
+namespace openage::renderer::tests {
+
+void renderer_stages_benchmark(const util::Path &path,
+                               size_t entity_count,
+                               size_t frame_count) {
+	auto window = std::make_shared<null::NullWindow>(1920, 1080);
+	auto renderer = std::dynamic_pointer_cast<null::NullRenderer>(window->make_renderer());
+
+	auto clock = std::make_shared<time::Clock>();
+	auto camera = std::make_shared<renderer::camera::Camera>(renderer, window->get_size());
+
+	auto asset_manager = std::make_shared<renderer::resources::AssetManager>(
+		renderer,
+		path["assets"]["test"]);
+
+	// same stage setup as in the renderer demos
+	auto shaderdir = path["assets"]["shaders"];
+	auto skybox_renderer = std::make_shared<renderer::skybox::SkyboxRenderer>(
+		window,
+		renderer,
+		shaderdir);
+	skybox_renderer->set_color(1.0f, 0.5f, 0.0f, 1.0f);
+
+	auto terrain_renderer = std::make_shared<renderer::terrain::TerrainRenderer>(
+		window,
+		renderer,
+		camera,
+		shaderdir,
+		asset_manager,
+		clock);
+
+	auto world_renderer = std::make_shared<renderer::world::WorldRenderer>(
+		window,
+		renderer,
+		camera,
+		shaderdir,
+		asset_manager,
+		clock);
+
+	std::vector<std::shared_ptr<RenderPass>> render_passes{
+		skybox_renderer->get_render_pass(),
+		terrain_renderer->get_render_pass(),
+		world_renderer->get_render_pass(),
+	};
+
+	auto screen_renderer = std::make_shared<renderer::screen::ScreenRenderer>(
+		window,
+		renderer,
+		shaderdir);
+	std::vector<std::shared_ptr<renderer::RenderTarget>> targets{};
+	for (auto &pass : render_passes) {
+		targets.push_back(pass->get_target());
+	}
+	screen_renderer->set_render_targets(targets);
+	render_passes.push_back(screen_renderer->get_render_pass());
+
+	// populate the scene
+	auto render_factory = std::make_shared<RenderFactory>(terrain_renderer, world_renderer);
+
+	auto terrain = render_factory->add_terrain_render_entity();
+	auto terrain_size = util::Vector2s{10, 10};
+	std::vector<float> height_map(terrain_size[0] * terrain_size[1], 0.0f);
+	terrain->update(terrain_size, height_map, "./textures/test_terrain.terrain");
+
+	// world entities are placed on a square grid
+	size_t grid_width = std::max<size_t>(1, std::ceil(std::sqrt(entity_count)));
+	std::vector<std::shared_ptr<world::WorldRenderEntity>> entities;
+	entities.reserve(entity_count);
+	for (size_t i = 0; i < entity_count; ++i) {
+		auto entity = render_factory->add_world_render_entity();
+		entity->update(i,
+		               coord::phys3(i % grid_width, i / grid_width, 0.0f),
+		               "./textures/test_gaben.sprite");
+		entities.push_back(entity);
+	}
+
+	// look at the center of the map, zoomed out so that the whole map is visible
+	auto center = coord::phys3(grid_width / 2.0f, grid_width / 2.0f, 0.0f);
+	camera->look_at_coord(center.to_scene3());
+	camera->set_zoom(std::max(1.0f, grid_width / 12.0f));
+
+	// the first frame creates the renderables and loads the assets
+	world_renderer->update();
+	terrain_renderer->update();
+	for (auto &pass : render_passes) {
+		renderer->render(pass);
+	}
+	asset_manager->next_frame();
+
+	using clock_t = std::chrono::steady_clock;
+	using ms_t = std::chrono::duration<double, std::milli>;
+
+	if (frame_count == 0) {
+		log::log(MSG(warn) << "Render stage benchmark: no frames measured.");
+		return;
+	}
+
+	log::log(MSG(info) << "Render stage benchmark: "
+	                   << entity_count << " world entities, "
+	                   << frame_count << " frames");
+
+	auto measure = [&](const char *view_name) {
+		double total_ms = 0.0;
+		double min_ms = std::numeric_limits<double>::max();
+		double max_ms = 0.0;
+		size_t total_draw_calls = 0;
+		size_t total_uniform_uploads = 0;
+		size_t total_visible = 0;
+
+		for (size_t frame = 0; frame < frame_count; ++frame) {
+			renderer->reset_stats();
+
+			// move every tenth entity so that the update path is part of the measurement
+			for (size_t i = frame % 10; i < entities.size(); i += 10) {
+				entities[i]->update(i,
+				                    coord::phys3(i % grid_width, i / grid_width, frame % 2),
+				                    "./textures/test_gaben.sprite");
+			}
+
+			auto start = clock_t::now();
+
+			terrain_renderer->update();
+			world_renderer->update();
+			for (auto &pass : render_passes) {
+				renderer->render(pass);
+			}
+			asset_manager->next_frame();
+
+			double frame_ms = ms_t(clock_t::now() - start).count();
+			total_ms += frame_ms;
+			min_ms = std::min(min_ms, frame_ms);
+			max_ms = std::max(max_ms, frame_ms);
+
+			auto &stats = renderer->get_stats();
+			total_draw_calls += stats.draw_calls;
+			total_uniform_uploads += stats.uniform_uploads;
+			total_visible += world_renderer->get_visible_count();
+		}
+
+		log::log(MSG(info) << "  " << view_name << " (zoom " << camera->get_zoom() << "): "
+		                   << total_visible / frame_count << " visible world entities");
+		log::log(MSG(info) << "    CPU time per frame: "
+		                   << total_ms / frame_count << " ms avg, "
+		                   << min_ms << " ms min, "
+		                   << max_ms << " ms max");
+		log::log(MSG(info) << "    draw calls per frame: "
+		                   << total_draw_calls / frame_count);
+		log::log(MSG(info) << "    uniform uploads per frame: "
+		                   << total_uniform_uploads / frame_count);
+	};
+
+	measure("whole map");
+
+	// most of the map is outside of the camera view
+	camera->set_zoom(0.5f);
+	measure("zoomed in");
+}
+
+} // namespace openage::renderer::tests
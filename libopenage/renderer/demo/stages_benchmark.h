@@ -0,0 +1,36 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+
+#include "../../util/compiler.h"
+// pxd: from libopenage.util.path cimport Path
+
+
+namespace openage {
+namespace util {
+class Path;
+} // namespace util
+
+namespace renderer::tests {
+
+/**
+ * Measure the CPU time of the render stages.
+ *
+ * Drives the skybox, terrain, world and screen stages with the null renderer,
+ * i.e. without a graphics context, and logs the per-frame CPU time
+ * and the number of draw calls. The scene is measured once with the whole
+ * map in view and once zoomed in, where most entities are culled.
+ *
+ * @param path Path to the openage root (must contain the "assets" folder).
+ * @param entity_count Number of world render entities in the scene.
+ * @param frame_count Number of measured frames.
+ */
+// pxd: void renderer_stages_benchmark(Path path, size_t entity_count, size_t frame_count) except +
+OAAPI void renderer_stages_benchmark(const util::Path &path,
+                                     size_t entity_count = 10000,
+                                     size_t frame_count = 100);
+
+} // namespace renderer::tests
+} // namespace openage
@@ -0,0 +1,54 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "geometry.h"
+
+#include <algorithm>
+
+#include "error/error.h"
+#include "log/message.h"
+#include "renderer/null/render_stats.h"
+#include "renderer/resources/mesh_data.h"
+
+
+namespace openage::renderer::null {
+
+NullGeometry::NullGeometry(const std::shared_ptr<render_stats> &stats) :
+	Geometry{geometry_t::bufferless_quad},
+	stats{stats},
+	verts{std::nullopt} {
+}
+
+NullGeometry::NullGeometry(const std::shared_ptr<render_stats> &stats,
+                           const resources::MeshData &mesh) :
+	Geometry{geometry_t::mesh},
+	stats{stats},
+	verts{mesh.get_data()} {
+	size_t size = mesh.get_data().size();
+	if (mesh.get_ids()) {
+		size += mesh.get_ids()->size();
+	}
+
+	this->stats->buffer_uploads += 1;
+	this->stats->upload_bytes += size;
+}
+
+void NullGeometry::update_verts_offset(std::vector<uint8_t> const &verts, size_t offset) {
+	if (this->get_type() != geometry_t::mesh) {
+		throw Error(MSG(err) << "Cannot update vertex data for non-mesh NullGeometry.");
+	}
+
+	if (offset + verts.size() > this->verts->size()) {
+		throw Error(MSG(err) << "Size mismatch between old and new vertex data for NullGeometry.");
+	}
+
+	std::copy(verts.begin(), verts.end(), this->verts->begin() + offset);
+
+	this->stats->buffer_uploads += 1;
+	this->stats->upload_bytes += verts.size();
+}
+
+const std::optional<std::vector<uint8_t>> &NullGeometry::get_verts() const {
+	return this->verts;
+}
+
+} // namespace openage::renderer::null
@@ -0,0 +1,52 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "renderer/geometry.h"
+
+
+namespace openage::renderer {
+namespace resources {
+class MeshData;
+} // namespace resources
+
+namespace null {
+
+struct render_stats;
+
+/**
+ * Geometry that keeps its vertex data in main memory.
+ */
+class NullGeometry final : public Geometry {
+public:
+	/// Initialize a bufferless quad geometry.
+	NullGeometry(const std::shared_ptr<render_stats> &stats);
+
+	/// Initialize a meshed geometry with the vertices of the given mesh.
+	NullGeometry(const std::shared_ptr<render_stats> &stats,
+	             const resources::MeshData &mesh);
+
+	void update_verts_offset(std::vector<uint8_t> const &verts, size_t offset) override;
+
+	/**
+	 * Get the vertex data of the geometry.
+	 *
+	 * @return Vertex data or \p std::nullopt for bufferless quads.
+	 */
+	const std::optional<std::vector<uint8_t>> &get_verts() const;
+
+private:
+	/// Operation counters of the renderer.
+	std::shared_ptr<render_stats> stats;
+
+	/// Vertex data of meshed geometries.
+	std::optional<std::vector<uint8_t>> verts;
+};
+
+} // namespace null
+} // namespace openage::renderer
@@ -0,0 +1,17 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "render_pass.h"
+
+
+namespace openage::renderer::null {
+
+NullRenderPass::NullRenderPass(std::vector<Renderable> renderables,
+                               const std::shared_ptr<RenderTarget> &target) :
+	RenderPass{std::move(renderables), target} {
+}
+
+const std::vector<Renderable> &NullRenderPass::get_renderables() const {
+	return this->renderables;
+}
+
+} // namespace openage::renderer::null
@@ -0,0 +1,29 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "renderer/renderer.h"
+
+
+namespace openage::renderer::null {
+
+/**
+ * Render pass of the null renderer.
+ */
+class NullRenderPass final : public RenderPass {
+public:
+	NullRenderPass(std::vector<Renderable> renderables,
+	               const std::shared_ptr<RenderTarget> &target);
+
+	/**
+	 * Get the renderables of the pass.
+	 *
+	 * @return Renderables in the order they are processed.
+	 */
+	const std::vector<Renderable> &get_renderables() const;
+};
+
+} // namespace openage::renderer::null
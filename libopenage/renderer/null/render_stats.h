@@ -0,0 +1,57 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+namespace openage::renderer {
+class Geometry;
+class RenderTarget;
+class ShaderProgram;
+
+namespace null {
+
+/**
+ * Draw call that was issued to the null renderer.
+ */
+struct draw_call {
+	/// Shader program used for drawing.
+	const ShaderProgram *program;
+	/// Drawn geometry.
+	const Geometry *geometry;
+	/// Target that the pass renders into.
+	const RenderTarget *target;
+	/// Number of uniform values that were uploaded before the draw call.
+	size_t uniform_count;
+};
+
+/**
+ * Counters for the operations that the null renderer has processed.
+ */
+struct render_stats {
+	/// Number of executed render passes.
+	size_t passes = 0;
+	/// Number of draw calls.
+	size_t draw_calls = 0;
+	/// Number of uniform values set on uniform inputs.
+	size_t uniform_updates = 0;
+	/// Number of uniform values that were uploaded while rendering.
+	size_t uniform_uploads = 0;
+	/// Number of texture uploads (including texture creation).
+	size_t texture_uploads = 0;
+	/// Number of buffer uploads (vertex and uniform buffers).
+	size_t buffer_uploads = 0;
+	/// Total size of the uploaded textures and buffers (in bytes).
+	size_t upload_bytes = 0;
+
+	/**
+	 * Draw calls in the order they were issued. Only filled if
+	 * recording is enabled in the renderer.
+	 */
+	std::vector<draw_call> calls;
+};
+
+} // namespace null
+} // namespace openage::renderer
@@ -0,0 +1,18 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "render_target.h"
+
+#include "renderer/texture.h"
+
+
+namespace openage::renderer::null {
+
+NullRenderTarget::NullRenderTarget(const std::vector<std::shared_ptr<Texture2d>> &textures) :
+	textures{textures} {
+}
+
+std::vector<std::shared_ptr<Texture2d>> NullRenderTarget::get_texture_targets() {
+	return this->textures;
+}
+
+} // namespace openage::renderer::null
@@ -0,0 +1,35 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "renderer/renderer.h"
+
+
+namespace openage::renderer {
+class Texture2d;
+
+namespace null {
+
+/**
+ * Render target of the null renderer. Either the display or a set of textures.
+ */
+class NullRenderTarget final : public RenderTarget {
+public:
+	/// Construct a render target pointed at the (virtual) display.
+	NullRenderTarget() = default;
+
+	/// Construct a render target pointing at the given textures.
+	NullRenderTarget(const std::vector<std::shared_ptr<Texture2d>> &textures);
+
+	std::vector<std::shared_ptr<Texture2d>> get_texture_targets() override;
+
+private:
+	/// Target textures. Empty for the display target.
+	std::vector<std::shared_ptr<Texture2d>> textures;
+};
+
+} // namespace null
+} // namespace openage::renderer
@@ -0,0 +1,129 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "renderer.h"
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+#include "renderer/null/geometry.h"
+#include "renderer/null/render_pass.h"
+#include "renderer/null/render_stats.h"
+#include "renderer/null/render_target.h"
+#include "renderer/null/shader_program.h"
+#include "renderer/null/texture.h"
+#include "renderer/null/uniform_buffer.h"
+#include "renderer/null/uniform_input.h"
+#include "renderer/resources/buffer_info.h"
+#include "renderer/resources/texture_data.h"
+#include "renderer/resources/texture_info.h"
+
+
+namespace openage::renderer::null {
+
+NullRenderer::NullRenderer(const util::Vector2s &viewport_size,
+                           bool record_calls) :
+	stats{std::make_shared<render_stats>()},
+	record_calls{record_calls},
+	viewport_size{viewport_size},
+	display{std::make_shared<NullRenderTarget>()} {
+	log::log(MSG(info) << "Created null renderer");
+}
+
+std::shared_ptr<Texture2d> NullRenderer::add_texture(const resources::Texture2dData &data) {
+	return std::make_shared<NullTexture2d>(this->stats, data);
+}
+
+std::shared_ptr<Texture2d> NullRenderer::add_texture(const resources::Texture2dInfo &info) {
+	return std::make_shared<NullTexture2d>(this->stats, info);
+}
+
+std::shared_ptr<ShaderProgram> NullRenderer::add_shader(std::vector<resources::ShaderSource> const &srcs) {
+	return std::make_shared<NullShaderProgram>(this->stats, srcs);
+}
+
+std::shared_ptr<Geometry> NullRenderer::add_mesh_geometry(resources::MeshData const &mesh) {
+	return std::make_shared<NullGeometry>(this->stats, mesh);
+}
+
+std::shared_ptr<Geometry> NullRenderer::add_bufferless_quad() {
+	return std::make_shared<NullGeometry>(this->stats);
+}
+
+std::shared_ptr<RenderPass> NullRenderer::add_render_pass(std::vector<Renderable> renderables,
+                                                          const std::shared_ptr<RenderTarget> &target) {
+	return std::make_shared<NullRenderPass>(std::move(renderables), target);
+}
+
+std::shared_ptr<RenderTarget> NullRenderer::create_texture_target(std::vector<std::shared_ptr<Texture2d>> const &textures) {
+	return std::make_shared<NullRenderTarget>(textures);
+}
+
+std::shared_ptr<RenderTarget> NullRenderer::get_display_target() {
+	return this->display;
+}
+
+std::shared_ptr<UniformBuffer> NullRenderer::add_uniform_buffer(resources::UniformBufferInfo const &info) {
+	return std::make_shared<NullUniformBuffer>(this->stats, info);
+}
+
+std::shared_ptr<UniformBuffer> NullRenderer::add_uniform_buffer(std::shared_ptr<ShaderProgram> const & /* prog */,
+                                                                std::string const &block_name) {
+	// the null shader program does not know the layout of uniform blocks
+	throw Error(MSG(err) << "Creating uniform buffer for block " << block_name
+	                     << " from a shader is not supported by the null renderer. "
+	                     << "Use a uniform buffer definition instead.");
+}
+
+resources::Texture2dData NullRenderer::display_into_data() {
+	resources::Texture2dInfo tex_info(this->viewport_size[0],
+	                                  this->viewport_size[1],
+	                                  resources::pixel_format::rgba8);
+	std::vector<uint8_t> data(tex_info.get_data_size(), 0);
+
+	return resources::Texture2dData{tex_info, std::move(data)};
+}
+
+void NullRenderer::resize_display_target(size_t width, size_t height) {
+	this->viewport_size = {width, height};
+}
+
+void NullRenderer::check_error() {
+	// there is no graphics API that could report errors
+}
+
+void NullRenderer::render(const std::shared_ptr<RenderPass> &pass) {
+	auto null_pass = std::dynamic_pointer_cast<NullRenderPass>(pass);
+	auto target = pass->get_target().get();
+
+	for (auto const &obj : null_pass->get_renderables()) {
+		auto in = std::dynamic_pointer_cast<NullUniformInput>(obj.uniform);
+		auto program = std::static_pointer_cast<NullShaderProgram>(in->get_program());
+
+		size_t uniform_count = program->update_uniforms(in);
+
+		if (obj.geometry != nullptr) {
+			this->stats->draw_calls += 1;
+
+			if (this->record_calls) {
+				this->stats->calls.push_back(draw_call{
+					program.get(),
+					obj.geometry.get(),
+					target,
+					uniform_count,
+				});
+			}
+		}
+	}
+
+	this->stats->passes += 1;
+}
+
+const render_stats &NullRenderer::get_stats() const {
+	return *this->stats;
+}
+
+void NullRenderer::reset_stats() {
+	*this->stats = render_stats{};
+}
+
+} // namespace openage::renderer::null
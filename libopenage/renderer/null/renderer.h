@@ -0,0 +1,90 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "renderer/renderer.h"
+#include "util/vector.h"
+
+
+namespace openage::renderer::null {
+
+struct render_stats;
+class NullRenderTarget;
+
+/**
+ * Renderer that does not use a graphics API.
+ *
+ * Textures, buffers and uniform values are kept in main memory and render passes
+ * are only processed on the CPU, so that the render stages can be run (and profiled)
+ * without a GPU or a graphics context. Draw calls, uniform updates and uploads
+ * are counted in the renderer's statistics.
+ */
+class NullRenderer final : public Renderer {
+public:
+	/**
+	 * Create a new null renderer.
+	 *
+	 * @param viewport_size Size of the (virtual) display.
+	 * @param record_calls If true, every draw call is recorded in the
+	 *                     statistics, not just counted.
+	 */
+	NullRenderer(const util::Vector2s &viewport_size,
+	             bool record_calls = false);
+
+	std::shared_ptr<Texture2d> add_texture(resources::Texture2dData const &) override;
+	std::shared_ptr<Texture2d> add_texture(resources::Texture2dInfo const &) override;
+
+	std::shared_ptr<ShaderProgram> add_shader(std::vector<resources::ShaderSource> const &) override;
+
+	std::shared_ptr<Geometry> add_mesh_geometry(resources::MeshData const &) override;
+	std::shared_ptr<Geometry> add_bufferless_quad() override;
+
+	std::shared_ptr<RenderPass> add_render_pass(std::vector<Renderable>, const std::shared_ptr<RenderTarget> &) override;
+
+	std::shared_ptr<RenderTarget> create_texture_target(std::vector<std::shared_ptr<Texture2d>> const &) override;
+
+	std::shared_ptr<RenderTarget> get_display_target() override;
+
+	std::shared_ptr<UniformBuffer> add_uniform_buffer(resources::UniformBufferInfo const &) override;
+	std::shared_ptr<UniformBuffer> add_uniform_buffer(std::shared_ptr<ShaderProgram> const &,
+	                                                  std::string const &) override;
+
+	resources::Texture2dData display_into_data() override;
+
+	void resize_display_target(size_t width, size_t height);
+
+	void check_error() override;
+
+	void render(const std::shared_ptr<RenderPass> &) override;
+
+	/**
+	 * Get the operations that were processed since the last reset.
+	 *
+	 * @return Renderer statistics.
+	 */
+	const render_stats &get_stats() const;
+
+	/**
+	 * Reset the statistics, e.g. at the start of a frame.
+	 */
+	void reset_stats();
+
+private:
+	/// Operation counters shared with the created resources.
+	std::shared_ptr<render_stats> stats;
+
+	/// Whether draw calls are recorded.
+	bool record_calls;
+
+	/// Size of the display.
+	util::Vector2s viewport_size;
+
+	/// The (virtual) display as a render target.
+	std::shared_ptr<NullRenderTarget> display;
+};
+
+} // namespace openage::renderer::null
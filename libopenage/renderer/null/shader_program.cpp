@@ -0,0 +1,279 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "shader_program.h"
+
+#include <cstring>
+#include <regex>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+#include "renderer/null/render_stats.h"
+#include "renderer/null/uniform_input.h"
+#include "renderer/resources/shader_source.h"
+
+
+namespace openage::renderer::null {
+
+namespace {
+
+/**
+ * Declaration of a plain uniform, e.g. "uniform vec2 scale;" or "uniform vec4 colors[8];".
+ */
+const std::regex uniform_regex{R"(\buniform\s+(\w+)\s+(\w+)\s*(\[[^\]]*\])?\s*;)"};
+
+/**
+ * Declaration of a uniform block, e.g. "layout (std140) uniform camera {".
+ */
+const std::regex uniform_block_regex{R"(\buniform\s+(\w+)\s*\{)"};
+
+/**
+ * Declaration of a vertex attribute, e.g. "layout(location=0) in vec2 position;".
+ */
+const std::regex attrib_regex{R"(layout\s*\(\s*location\s*=\s*(\d+)\s*\)\s*in\s+(\w+)\s+(\w+)\s*;)"};
+
+/**
+ * Get the size of a uniform value of the given GLSL type.
+ *
+ * @param type GLSL type name.
+ *
+ * @return Size in bytes or 0 if the type is not supported.
+ */
+size_t glsl_type_size(const std::string &type) {
+	static const std::unordered_map<std::string, size_t> sizes{
+		{"int", 4},
+		{"uint", 4},
+		{"float", 4},
+		{"double", 8},
+		{"bool", 1},
+		{"vec2", 8},
+		{"vec3", 12},
+		{"vec4", 16},
+		{"ivec2", 8},
+		{"ivec3", 12},
+		{"ivec4", 16},
+		{"uvec2", 8},
+		{"uvec3", 12},
+		{"uvec4", 16},
+		{"mat4", 64},
+		{"sampler2D", sizeof(const Texture2d *)},
+	};
+
+	auto size = sizes.find(type);
+	if (size == std::end(sizes)) {
+		return 0;
+	}
+	return size->second;
+}
+
+} // namespace
+
+
+NullShaderProgram::NullShaderProgram(const std::shared_ptr<render_stats> &stats,
+                                     const std::vector<resources::ShaderSource> &srcs) :
+	stats{stats},
+	uniform_data_size{0} {
+	for (auto const &src : srcs) {
+		if (src.get_lang() != resources::shader_lang_t::glsl) [[unlikely]] {
+			throw Error(MSG(err) << "Null renderer only supports GLSL shader sources.");
+		}
+
+		auto const &code = src.get_source();
+
+		for (auto it = std::sregex_iterator(code.begin(), code.end(), uniform_regex);
+		     it != std::sregex_iterator();
+		     ++it) {
+			auto name = (*it)[2].str();
+			if (this->uniform_ids.count(name) == 1) {
+				// declared in more than one shader stage
+				continue;
+			}
+
+			auto type = (*it)[1].str();
+			size_t size = glsl_type_size(type);
+			size_t offset = (this->uniform_data_size + 3) & ~size_t{3};
+			this->uniform_data_size = offset + size;
+
+			this->uniform_ids.emplace(name, this->uniforms.size());
+			this->uniforms.push_back(null_uniform{type, offset, size});
+		}
+
+		for (auto it = std::sregex_iterator(code.begin(), code.end(), uniform_block_regex);
+		     it != std::sregex_iterator();
+		     ++it) {
+			this->uniform_blocks.insert((*it)[1].str());
+		}
+
+		if (src.get_stage() == resources::shader_stage_t::vertex) {
+			for (auto it = std::sregex_iterator(code.begin(), code.end(), attrib_regex);
+			     it != std::sregex_iterator();
+			     ++it) {
+				size_t location = std::stoul((*it)[1].str());
+				auto type = (*it)[2].str();
+				if (type == "float") {
+					this->attribs[location] = resources::vertex_input_t::F32;
+				}
+				else if (type == "vec2") {
+					this->attribs[location] = resources::vertex_input_t::V2F32;
+				}
+				else if (type == "vec3") {
+					this->attribs[location] = resources::vertex_input_t::V3F32;
+				}
+				else if (type == "mat3") {
+					this->attribs[location] = resources::vertex_input_t::M3F32;
+				}
+			}
+		}
+	}
+
+	this->uploaded_data.resize(this->uniform_data_size, 0);
+	this->uploaded_mask.resize(this->uniforms.size(), false);
+
+	log::log(MSG(dbg) << "Created null shader program with "
+	                  << this->uniforms.size() << " uniforms and "
+	                  << this->uniform_blocks.size() << " uniform blocks");
+}
+
+bool NullShaderProgram::has_uniform(const char *unif) {
+	return this->uniform_ids.count(unif) == 1;
+}
+
+uniform_id_t NullShaderProgram::get_uniform_id(const char *unif) {
+	auto id = this->uniform_ids.find(unif);
+	ENSURE(id != std::end(this->uniform_ids),
+	       "Tried to get uniform " << unif << " that does not exist in the shader program.");
+
+	return id->second;
+}
+
+void NullShaderProgram::bind_uniform_buffer(const char *block_name,
+                                            std::shared_ptr<UniformBuffer> const & /* buffer */) {
+	ENSURE(this->uniform_blocks.count(block_name) == 1,
+	       "Tried to set binding point for uniform block " << block_name << " that does not exist in the shader program.");
+}
+
+std::map<size_t, resources::vertex_input_t> NullShaderProgram::vertex_attributes() const {
+	return this->attribs;
+}
+
+size_t NullShaderProgram::update_uniforms(std::shared_ptr<NullUniformInput> const &unif_in) {
+	ENSURE(unif_in->get_program() == this->shared_from_this(), "Uniform input passed to different shader than it was created with.");
+
+	size_t count = 0;
+	uint8_t const *data = unif_in->update_data.data();
+	for (auto const id : unif_in->update_ids) {
+		auto const &unif = this->uniforms[id];
+		uint8_t const *ptr = data + unif.offset;
+
+		// textures are always bound, like in the OpenGL renderer
+		uint8_t *uploaded = this->uploaded_data.data() + unif.offset;
+		if (unif.type != "sampler2D") {
+			if (this->uploaded_mask[id] and std::memcmp(uploaded, ptr, unif.size) == 0) {
+				continue;
+			}
+			std::memcpy(uploaded, ptr, unif.size);
+			this->uploaded_mask[id] = true;
+		}
+
+		count += 1;
+	}
+	this->stats->uniform_uploads += count;
+
+	return count;
+}
+
+std::shared_ptr<UniformInput> NullShaderProgram::new_unif_in() {
+	return std::make_shared<NullUniformInput>(this->shared_from_this(),
+	                                          this->uniforms.size(),
+	                                          this->uniform_data_size);
+}
+
+void NullShaderProgram::set_unif(std::shared_ptr<UniformInput> const &in,
+                                 uniform_id_t id,
+                                 void const *val,
+                                 const char *type) {
+	auto unif_in = std::static_pointer_cast<NullUniformInput>(in);
+
+	ENSURE(id < this->uniforms.size(),
+	       "Tried to set uniform with ID " << id << " that does not exist in the shader program.");
+
+	auto const &uniform = this->uniforms[id];
+	ENSURE(uniform.type == type,
+	       "Tried to set uniform with ID " << id << " to a value of the wrong type.");
+
+	std::memcpy(unif_in->update_data.data() + uniform.offset, val, uniform.size);
+	if (not unif_in->update_mask[id]) [[unlikely]] {
+		unif_in->update_mask[id] = true;
+		unif_in->update_ids.push_back(id);
+	}
+
+	this->stats->uniform_updates += 1;
+}
+
+void NullShaderProgram::set_i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, int32_t val) {
+	this->set_unif(in, id, &val, "int");
+}
+
+void NullShaderProgram::set_u32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, uint32_t val) {
+	this->set_unif(in, id, &val, "uint");
+}
+
+void NullShaderProgram::set_f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, float val) {
+	this->set_unif(in, id, &val, "float");
+}
+
+void NullShaderProgram::set_f64(std::shared_ptr<UniformInput> const &in, uniform_id_t id, double val) {
+	this->set_unif(in, id, &val, "double");
+}
+
+void NullShaderProgram::set_bool(std::shared_ptr<UniformInput> const &in, uniform_id_t id, bool val) {
+	this->set_unif(in, id, &val, "bool");
+}
+
+void NullShaderProgram::set_v2f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector2f const &val) {
+	this->set_unif(in, id, val.data(), "vec2");
+}
+
+void NullShaderProgram::set_v3f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector3f const &val) {
+	this->set_unif(in, id, val.data(), "vec3");
+}
+
+void NullShaderProgram::set_v4f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector4f const &val) {
+	this->set_unif(in, id, val.data(), "vec4");
+}
+
+void NullShaderProgram::set_v2i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector2i const &val) {
+	this->set_unif(in, id, val.data(), "ivec2");
+}
+
+void NullShaderProgram::set_v3i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector3i const &val) {
+	this->set_unif(in, id, val.data(), "ivec3");
+}
+
+void NullShaderProgram::set_v4i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector4i const &val) {
+	this->set_unif(in, id, val.data(), "ivec4");
+}
+
+void NullShaderProgram::set_v2ui32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector2<uint32_t> const &val) {
+	this->set_unif(in, id, val.data(), "uvec2");
+}
+
+void NullShaderProgram::set_v3ui32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector3<uint32_t> const &val) {
+	this->set_unif(in, id, val.data(), "uvec3");
+}
+
+void NullShaderProgram::set_v4ui32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector4<uint32_t> const &val) {
+	this->set_unif(in, id, val.data(), "uvec4");
+}
+
+void NullShaderProgram::set_m4f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Matrix4f const &val) {
+	this->set_unif(in, id, val.data(), "mat4");
+}
+
+void NullShaderProgram::set_tex(std::shared_ptr<UniformInput> const &in, uniform_id_t id, std::shared_ptr<Texture2d> const &val) {
+	// the texture object takes the place of a GPU texture handle
+	const Texture2d *handle = val.get();
+	this->set_unif(in, id, &handle, "sampler2D");
+}
+
+} // namespace openage::renderer::null
@@ -0,0 +1,133 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "renderer/shader_program.h"
+
+
+namespace openage::renderer {
+namespace resources {
+class ShaderSource;
+} // namespace resources
+
+namespace null {
+
+struct render_stats;
+class NullUniformInput;
+
+/**
+ * Shader program of the null renderer. Nothing is compiled, but the GLSL sources
+ * are scanned for uniform declarations, so that uniform updates are
+ * validated the same way as in the OpenGL renderer.
+ */
+class NullShaderProgram final : public ShaderProgram {
+public:
+	/**
+	 * Create a new shader program.
+	 *
+	 * @param stats Operation counters of the renderer.
+	 * @param srcs Shader sources.
+	 */
+	NullShaderProgram(const std::shared_ptr<render_stats> &stats,
+	                  const std::vector<resources::ShaderSource> &srcs);
+
+	bool has_uniform(const char *unif) override;
+
+	uniform_id_t get_uniform_id(const char *unif) override;
+
+	void bind_uniform_buffer(const char *block_name,
+	                         std::shared_ptr<UniformBuffer> const &) override;
+
+	std::map<size_t, resources::vertex_input_t> vertex_attributes() const override;
+
+	/**
+	 * "Upload" the stored uniform values of a uniform input. Like in the OpenGL
+	 * renderer, values that did not change since the last upload are skipped.
+	 *
+	 * @param unif_in Uniform input created by this shader program.
+	 *
+	 * @return Number of uploaded uniform values.
+	 */
+	size_t update_uniforms(std::shared_ptr<NullUniformInput> const &unif_in);
+
+protected:
+	std::shared_ptr<UniformInput> new_unif_in() override;
+	void set_i32(std::shared_ptr<UniformInput> const &, uniform_id_t, int32_t) override;
+	void set_u32(std::shared_ptr<UniformInput> const &, uniform_id_t, uint32_t) override;
+	void set_f32(std::shared_ptr<UniformInput> const &, uniform_id_t, float) override;
+	void set_f64(std::shared_ptr<UniformInput> const &, uniform_id_t, double) override;
+	void set_bool(std::shared_ptr<UniformInput> const &, uniform_id_t, bool) override;
+	void set_v2f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2f const &) override;
+	void set_v3f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3f const &) override;
+	void set_v4f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4f const &) override;
+	void set_v2i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2i const &) override;
+	void set_v3i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3i const &) override;
+	void set_v4i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4i const &) override;
+	void set_v2ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2<uint32_t> const &) override;
+	void set_v3ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3<uint32_t> const &) override;
+	void set_v4ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4<uint32_t> const &) override;
+	void set_m4f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Matrix4f const &) override;
+	void set_tex(std::shared_ptr<UniformInput> const &, uniform_id_t, std::shared_ptr<Texture2d> const &) override;
+
+private:
+	/**
+	 * Uniform declared in the shader sources.
+	 */
+	struct null_uniform {
+		/// GLSL type name.
+		std::string type;
+		/// Offset of the value in the packed uniform data.
+		size_t offset;
+		/// Size of the value (in bytes).
+		size_t size;
+	};
+
+	/**
+	 * Store a uniform value in a uniform input.
+	 *
+	 * @param in Uniform input.
+	 * @param id ID of the uniform.
+	 * @param val Pointer to the value.
+	 * @param type GLSL type name of the value.
+	 */
+	void set_unif(std::shared_ptr<UniformInput> const &in,
+	              uniform_id_t id,
+	              void const *val,
+	              const char *type);
+
+	/// Operation counters of the renderer.
+	std::shared_ptr<render_stats> stats;
+
+	/// Uniforms declared in the sources, indexed by uniform ID.
+	std::vector<null_uniform> uniforms;
+
+	/// Maps uniform names to their IDs.
+	std::unordered_map<std::string, uniform_id_t> uniform_ids;
+
+	/// Size of the packed uniform values of all uniforms.
+	size_t uniform_data_size;
+
+	/// Uniform values that were last "uploaded".
+	std::vector<uint8_t> uploaded_data;
+
+	/// Flags for every uniform that indicate whether \p uploaded_data
+	/// contains the current value of the uniform.
+	std::vector<bool> uploaded_mask;
+
+	/// Uniform blocks declared in the sources.
+	std::unordered_set<std::string> uniform_blocks;
+
+	/// Vertex attributes declared in the vertex shader.
+	std::map<size_t, resources::vertex_input_t> attribs;
+};
+
+} // namespace null
+} // namespace openage::renderer
@@ -0,0 +1,108 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <eigen3/Eigen/Dense>
+
+#include "error/error.h"
+#include "testing/testing.h"
+#include "util/vector.h"
+
+#include "renderer/null/render_stats.h"
+#include "renderer/null/renderer.h"
+#include "renderer/renderer.h"
+#include "renderer/resources/shader_source.h"
+#include "renderer/shader_program.h"
+#include "renderer/uniform_input.h"
+
+
+namespace openage::renderer::null::tests {
+
+void uniform_upload() {
+	NullRenderer renderer{util::Vector2s{64, 64}};
+
+	auto vert_src = resources::ShaderSource(
+		resources::shader_lang_t::glsl,
+		resources::shader_stage_t::vertex,
+		R"(#version 330
+layout(location=0) in vec2 position;
+uniform vec2 offset;
+uniform float depth;
+void main() { gl_Position = vec4(position + offset, depth, 1.0); }
+)");
+	auto frag_src = resources::ShaderSource(
+		resources::shader_lang_t::glsl,
+		resources::shader_stage_t::fragment,
+		R"(#version 330
+uniform vec4 color;
+uniform bool highlight;
+out vec4 col;
+void main() { col = highlight ? vec4(1.0) : color; }
+)");
+
+	auto shader = renderer.add_shader({vert_src, frag_src});
+
+	// IDs are stable and unique
+	auto offset_id = shader->get_uniform_id("offset");
+	auto color_id = shader->get_uniform_id("color");
+	auto highlight_id = shader->get_uniform_id("highlight");
+	TESTEQUALS(shader->get_uniform_id("offset"), offset_id);
+	(offset_id != color_id and color_id != highlight_id) or TESTFAIL;
+	TESTTHROWS(shader->get_uniform_id("missing"));
+
+	// names and IDs can be mixed
+	auto first = shader->new_uniform_input(
+		"depth",
+		0.5f,
+		color_id,
+		Eigen::Vector4f{1.0f, 0.0f, 0.0f, 1.0f},
+		highlight_id,
+		false);
+	first->update(offset_id, Eigen::Vector2f{0.0f, 0.0f});
+	TESTTHROWS(first->update(offset_id, 1.0f));
+
+	auto second = shader->new_uniform_input(
+		"depth",
+		0.5f,
+		"color",
+		Eigen::Vector4f{0.0f, 1.0f, 0.0f, 1.0f},
+		"highlight",
+		false,
+		"offset",
+		Eigen::Vector2f{1.0f, 0.0f});
+
+	auto pass = renderer.add_render_pass(
+		{Renderable{first, renderer.add_bufferless_quad()},
+	     Renderable{second, renderer.add_bufferless_quad()}},
+		renderer.get_display_target());
+
+	// first frame: everything is uploaded once, then only the values
+	// that differ from the previous draw
+	renderer.reset_stats();
+	renderer.render(pass);
+	TESTEQUALS(renderer.get_stats().draw_calls, 2);
+	TESTEQUALS(renderer.get_stats().uniform_uploads, 4 + 2);
+
+	// second frame: the program still has the values of the second draw
+	renderer.reset_stats();
+	renderer.render(pass);
+	TESTEQUALS(renderer.get_stats().uniform_uploads, 2 + 2);
+
+	// after syncing the inputs, only the first draw differs from the
+	// previously uploaded values
+	second->update(color_id, Eigen::Vector4f{1.0f, 0.0f, 0.0f, 1.0f});
+	second->update(offset_id, Eigen::Vector2f{0.0f, 0.0f});
+	renderer.reset_stats();
+	renderer.render(pass);
+	TESTEQUALS(renderer.get_stats().uniform_uploads, 2);
+
+	// nothing has to be uploaded anymore
+	renderer.reset_stats();
+	renderer.render(pass);
+	TESTEQUALS(renderer.get_stats().uniform_uploads, 0);
+	TESTEQUALS(renderer.get_stats().draw_calls, 2);
+}
+
+} // namespace openage::renderer::null::tests
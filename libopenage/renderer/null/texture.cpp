@@ -0,0 +1,48 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "texture.h"
+
+#include <cstring>
+
+#include "error/error.h"
+#include "log/message.h"
+#include "renderer/null/render_stats.h"
+#include "renderer/resources/texture_info.h"
+
+
+namespace openage::renderer::null {
+
+NullTexture2d::NullTexture2d(const std::shared_ptr<render_stats> &stats,
+                             const resources::Texture2dData &data) :
+	Texture2d{data.get_info()},
+	stats{stats},
+	data{} {
+	this->upload(data);
+}
+
+NullTexture2d::NullTexture2d(const std::shared_ptr<render_stats> &stats,
+                             const resources::Texture2dInfo &info) :
+	Texture2d{info},
+	stats{stats},
+	data(info.get_data_size(), 0) {
+}
+
+resources::Texture2dData NullTexture2d::into_data() {
+	auto data = this->data;
+	return resources::Texture2dData{this->info, std::move(data)};
+}
+
+void NullTexture2d::upload(resources::Texture2dData const &data) {
+	if (this->info != data.get_info()) {
+		throw Error(MSG(err) << "Tried to upload texture data of different format into an existing texture.");
+	}
+
+	size_t size = this->info.get_data_size();
+	this->data.resize(size);
+	std::memcpy(this->data.data(), data.get_data(), size);
+
+	this->stats->texture_uploads += 1;
+	this->stats->upload_bytes += size;
+}
+
+} // namespace openage::renderer::null
@@ -0,0 +1,42 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "renderer/resources/texture_data.h"
+#include "renderer/texture.h"
+
+
+namespace openage::renderer::null {
+
+struct render_stats;
+
+/**
+ * Texture that keeps its pixel data in main memory.
+ */
+class NullTexture2d final : public Texture2d {
+public:
+	/// Constructs a texture and fills it with the given data.
+	NullTexture2d(const std::shared_ptr<render_stats> &stats,
+	              const resources::Texture2dData &data);
+
+	/// Constructs an empty texture with the given parameters.
+	NullTexture2d(const std::shared_ptr<render_stats> &stats,
+	              const resources::Texture2dInfo &info);
+
+	resources::Texture2dData into_data() override;
+
+	void upload(resources::Texture2dData const &) override;
+
+private:
+	/// Operation counters of the renderer.
+	std::shared_ptr<render_stats> stats;
+
+	/// Pixel data of the texture.
+	std::vector<uint8_t> data;
+};
+
+} // namespace openage::renderer::null
@@ -0,0 +1,142 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "uniform_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "error/error.h"
+#include "log/message.h"
+#include "renderer/null/render_stats.h"
+#include "renderer/null/uniform_input.h"
+
+
+namespace openage::renderer::null {
+
+NullUniformBuffer::NullUniformBuffer(const std::shared_ptr<render_stats> &stats,
+                                     const resources::UniformBufferInfo &info) :
+	stats{stats},
+	uniforms{},
+	data(info.get_size(), 0) {
+	size_t offset = 0;
+	for (auto const &input : info.get_inputs()) {
+		size_t size = resources::UniformBufferInfo::get_size(input, info.get_layout());
+		this->uniforms.emplace(input.name, in_block_uniform{input.type, offset, size});
+		offset += size;
+	}
+}
+
+void NullUniformBuffer::update_uniforms(std::shared_ptr<UniformBufferInput> const &unif_in) {
+	auto null_unif_in = std::dynamic_pointer_cast<NullUniformBufferInput>(unif_in);
+	ENSURE(null_unif_in->get_buffer() == this->shared_from_this(), "Uniform input passed to different buffer than it was created with.");
+
+	uint8_t const *data = null_unif_in->update_data.data();
+	for (auto const &pair : null_unif_in->update_offs) {
+		auto const &unif_def = this->uniforms.at(pair.first);
+
+		// values are stored without std140 padding in the input, so this may
+		// copy bytes of the next value into the padding (which is never read)
+		size_t size = std::min(unif_def.size, null_unif_in->update_data.size() - pair.second);
+		std::memcpy(this->data.data() + unif_def.offset, data + pair.second, size);
+
+		this->stats->upload_bytes += size;
+	}
+
+	this->stats->buffer_uploads += 1;
+}
+
+bool NullUniformBuffer::has_uniform(const char *unif) {
+	return this->uniforms.count(unif) != 0;
+}
+
+const std::vector<uint8_t> &NullUniformBuffer::get_data() const {
+	return this->data;
+}
+
+std::shared_ptr<UniformBufferInput> NullUniformBuffer::new_unif_in() {
+	return std::make_shared<NullUniformBufferInput>(this->shared_from_this());
+}
+
+void NullUniformBuffer::set_unif(std::shared_ptr<UniformBufferInput> const &in,
+                                 const char *unif,
+                                 void const *val,
+                                 size_t size,
+                                 resources::ubo_input_t type) {
+	auto unif_in = std::dynamic_pointer_cast<NullUniformBufferInput>(in);
+
+	auto uniform = this->uniforms.find(unif);
+	ENSURE(uniform != std::end(this->uniforms),
+	       "Tried to set uniform " << unif << " that does not exist in the uniform buffer.");
+
+	ENSURE(type == uniform->second.type,
+	       "Tried to set uniform " << unif << " to a value of the wrong type.");
+
+	store_uniform(unif_in->update_offs, unif_in->update_data, unif, val, size);
+	this->stats->uniform_updates += 1;
+}
+
+void NullUniformBuffer::set_i32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, int32_t val) {
+	this->set_unif(in, unif, &val, sizeof(val), resources::ubo_input_t::I32);
+}
+
+void NullUniformBuffer::set_u32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, uint32_t val) {
+	this->set_unif(in, unif, &val, sizeof(val), resources::ubo_input_t::U32);
+}
+
+void NullUniformBuffer::set_f32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, float val) {
+	this->set_unif(in, unif, &val, sizeof(val), resources::ubo_input_t::F32);
+}
+
+void NullUniformBuffer::set_f64(std::shared_ptr<UniformBufferInput> const &in, const char *unif, double val) {
+	this->set_unif(in, unif, &val, sizeof(val), resources::ubo_input_t::F64);
+}
+
+void NullUniformBuffer::set_bool(std::shared_ptr<UniformBufferInput> const &in, const char *unif, bool val) {
+	this->set_unif(in, unif, &val, sizeof(val), resources::ubo_input_t::BOOL);
+}
+
+void NullUniformBuffer::set_v2f32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector2f const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V2F32);
+}
+
+void NullUniformBuffer::set_v3f32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector3f const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V3F32);
+}
+
+void NullUniformBuffer::set_v4f32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector4f const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V4F32);
+}
+
+void NullUniformBuffer::set_v2i32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector2i const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V2I32);
+}
+
+void NullUniformBuffer::set_v3i32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector3i const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V3I32);
+}
+
+void NullUniformBuffer::set_v4i32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector4i const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V4I32);
+}
+
+void NullUniformBuffer::set_v2ui32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector2<uint32_t> const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V2U32);
+}
+
+void NullUniformBuffer::set_v3ui32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector3<uint32_t> const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V3U32);
+}
+
+void NullUniformBuffer::set_v4ui32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Vector4<uint32_t> const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::V4U32);
+}
+
+void NullUniformBuffer::set_m4f32(std::shared_ptr<UniformBufferInput> const &in, const char *unif, Eigen::Matrix4f const &val) {
+	this->set_unif(in, unif, val.data(), sizeof(val), resources::ubo_input_t::M4F32);
+}
+
+void NullUniformBuffer::set_tex(std::shared_ptr<UniformBufferInput> const & /* in */, const char *unif, std::shared_ptr<Texture2d> const & /* val */) {
+	throw Error(MSG(err) << "Tried to set texture uniform " << unif << " in a uniform buffer.");
+}
+
+} // namespace openage::renderer::null
@@ -0,0 +1,102 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "renderer/resources/buffer_info.h"
+#include "renderer/uniform_buffer.h"
+
+
+namespace openage::renderer::null {
+
+struct render_stats;
+
+/**
+ * Uniform buffer of the null renderer that keeps its data in main memory.
+ */
+class NullUniformBuffer final : public UniformBuffer {
+public:
+	/**
+	 * Create a new uniform buffer.
+	 *
+	 * @param stats Operation counters of the renderer.
+	 * @param info Layout definition of the buffer.
+	 */
+	NullUniformBuffer(const std::shared_ptr<render_stats> &stats,
+	                  const resources::UniformBufferInfo &info);
+
+	void update_uniforms(std::shared_ptr<UniformBufferInput> const &unif_in) override;
+
+	bool has_uniform(const char *unif) override;
+
+	/**
+	 * Get the current content of the buffer.
+	 *
+	 * @return Buffer data in std140 layout.
+	 */
+	const std::vector<uint8_t> &get_data() const;
+
+protected:
+	std::shared_ptr<UniformBufferInput> new_unif_in() override;
+	void set_i32(std::shared_ptr<UniformBufferInput> const &, const char *, int32_t) override;
+	void set_u32(std::shared_ptr<UniformBufferInput> const &, const char *, uint32_t) override;
+	void set_f32(std::shared_ptr<UniformBufferInput> const &, const char *, float) override;
+	void set_f64(std::shared_ptr<UniformBufferInput> const &, const char *, double) override;
+	void set_bool(std::shared_ptr<UniformBufferInput> const &, const char *, bool) override;
+	void set_v2f32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector2f const &) override;
+	void set_v3f32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector3f const &) override;
+	void set_v4f32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector4f const &) override;
+	void set_v2i32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector2i const &) override;
+	void set_v3i32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector3i const &) override;
+	void set_v4i32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector4i const &) override;
+	void set_v2ui32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector2<uint32_t> const &) override;
+	void set_v3ui32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector3<uint32_t> const &) override;
+	void set_v4ui32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Vector4<uint32_t> const &) override;
+	void set_m4f32(std::shared_ptr<UniformBufferInput> const &, const char *, Eigen::Matrix4f const &) override;
+	void set_tex(std::shared_ptr<UniformBufferInput> const &, const char *, std::shared_ptr<Texture2d> const &) override;
+
+private:
+	/**
+	 * Position of a uniform inside the buffer.
+	 */
+	struct in_block_uniform {
+		/// Type of the uniform.
+		resources::ubo_input_t type;
+		/// Offset from the start of the buffer (in bytes).
+		size_t offset;
+		/// Size of the uniform including padding (in bytes).
+		size_t size;
+	};
+
+	/**
+	 * Store a uniform value in a uniform buffer input.
+	 *
+	 * @param in Uniform buffer input.
+	 * @param unif Name of the uniform.
+	 * @param val Pointer to the value.
+	 * @param size Size of the value (in bytes).
+	 * @param type Type of the value.
+	 */
+	void set_unif(std::shared_ptr<UniformBufferInput> const &in,
+	              const char *unif,
+	              void const *val,
+	              size_t size,
+	              resources::ubo_input_t type);
+
+	/// Operation counters of the renderer.
+	std::shared_ptr<render_stats> stats;
+
+	/// Uniforms in the buffer.
+	std::unordered_map<std::string, in_block_uniform> uniforms;
+
+	/// Buffer data.
+	std::vector<uint8_t> data;
+};
+
+} // namespace openage::renderer::null
@@ -0,0 +1,40 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "uniform_input.h"
+
+#include <cstring>
+
+
+namespace openage::renderer::null {
+
+NullUniformInput::NullUniformInput(std::shared_ptr<ShaderProgram> const &prog,
+                                   size_t uniform_count,
+                                   size_t data_size) :
+	UniformInput{prog},
+	update_ids{},
+	update_mask(uniform_count, false),
+	update_data(data_size, 0) {}
+
+NullUniformBufferInput::NullUniformBufferInput(std::shared_ptr<UniformBuffer> const &buffer) :
+	UniformBufferInput{buffer} {}
+
+void store_uniform(std::unordered_map<std::string, size_t> &offs,
+                   std::vector<uint8_t> &data,
+                   const char *unif,
+                   const void *val,
+                   size_t size) {
+	auto update_off = offs.find(unif);
+	if (update_off != std::end(offs)) [[likely]] {
+		// already wrote to this uniform since last upload
+		std::memcpy(data.data() + update_off->second, val, size);
+	}
+	else {
+		// first write since last upload, extend the buffer
+		size_t prev_size = data.size();
+		data.resize(prev_size + size);
+		std::memcpy(data.data() + prev_size, val, size);
+		offs.emplace(unif, prev_size);
+	}
+}
+
+} // namespace openage::renderer::null
@@ -0,0 +1,90 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "renderer/uniform_input.h"
+
+
+namespace openage::renderer {
+class ShaderProgram;
+class UniformBuffer;
+
+namespace null {
+
+/**
+ * Uniform valuations of the null renderer.
+ *
+ * Like in the OpenGL renderer, updates are stored lazily and only
+ * "uploaded" when the renderable is processed by a render pass.
+ */
+class NullUniformInput final : public UniformInput {
+public:
+	/**
+	 * Create a new uniform input.
+	 *
+	 * @param prog Shader program the input belongs to.
+	 * @param uniform_count Number of uniforms in the program.
+	 * @param data_size Size of the packed uniform data of the program.
+	 */
+	NullUniformInput(std::shared_ptr<ShaderProgram> const &prog,
+	                 size_t uniform_count,
+	                 size_t data_size);
+
+	/**
+	 * IDs of the uniforms that have been set, in the order they were first set.
+	 */
+	std::vector<uniform_id_t> update_ids;
+
+	/**
+	 * Flags for every uniform of the program that indicate whether
+	 * the uniform is in \p update_ids.
+	 */
+	std::vector<bool> update_mask;
+
+	/**
+	 * Packed uniform values at the offsets determined by the shader program.
+	 */
+	std::vector<uint8_t> update_data;
+};
+
+/**
+ * Uniform buffer valuations of the null renderer.
+ */
+class NullUniformBufferInput final : public UniformBufferInput {
+public:
+	NullUniformBufferInput(std::shared_ptr<UniformBuffer> const &buffer);
+
+	/**
+	 * Maps the uniform names to the byte offsets of their
+	 * values in \p update_data.
+	 */
+	std::unordered_map<std::string, size_t> update_offs;
+
+	/**
+	 * Buffer containing untyped uniform update data.
+	 */
+	std::vector<uint8_t> update_data;
+};
+
+/**
+ * Store a uniform value in an update buffer.
+ *
+ * @param offs Byte offsets of the stored values.
+ * @param data Buffer of the stored values.
+ * @param unif Name of the uniform.
+ * @param val Pointer to the value.
+ * @param size Size of the value (in bytes).
+ */
+void store_uniform(std::unordered_map<std::string, size_t> &offs,
+                   std::vector<uint8_t> &data,
+                   const char *unif,
+                   const void *val,
+                   size_t size);
+
+} // namespace null
+} // namespace openage::renderer
@@ -0,0 +1,38 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "window.h"
+
+#include "log/log.h"
+#include "log/message.h"
+#include "renderer/null/renderer.h"
+
+
+namespace openage::renderer::null {
+
+NullWindow::NullWindow(size_t width, size_t height, bool record_calls) :
+	Window{width, height},
+	record_calls{record_calls} {
+	log::log(MSG(info) << "Created headless window.");
+}
+
+void NullWindow::set_size(size_t width, size_t height) {
+	this->size = {width, height};
+
+	for (auto &cb : this->on_resize) {
+		cb(width, height, this->scale_dpr);
+	}
+}
+
+void NullWindow::update() {
+	// there are no window events
+}
+
+std::shared_ptr<Renderer> NullWindow::make_renderer() {
+	auto renderer = std::make_shared<NullRenderer>(this->get_size(), this->record_calls);
+	this->add_resize_callback([renderer](size_t w, size_t h, double /*scale*/) {
+		renderer->resize_display_target(w, h);
+	});
+	return renderer;
+}
+
+} // namespace openage::renderer::null
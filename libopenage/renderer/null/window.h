@@ -0,0 +1,39 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <memory>
+
+#include "renderer/window.h"
+
+
+namespace openage::renderer::null {
+
+/**
+ * Window without a display surface. Useful to run the render stages headless,
+ * e.g. for benchmarks on machines without a GPU.
+ */
+class NullWindow final : public Window {
+public:
+	/**
+	 * Create a new headless window.
+	 *
+	 * @param width Width in pixels.
+	 * @param height Height in pixels.
+	 * @param record_calls If true, renderers created by this window record every draw call.
+	 */
+	NullWindow(size_t width, size_t height, bool record_calls = false);
+	~NullWindow() = default;
+
+	void set_size(size_t width, size_t height) override;
+
+	void update() override;
+
+	std::shared_ptr<Renderer> make_renderer() override;
+
+private:
+	/// Whether created renderers record draw calls.
+	bool record_calls;
+};
+
+} // namespace openage::renderer::null
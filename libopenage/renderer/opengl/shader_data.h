@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <unordered_map>
 
@@ -19,6 +20,17 @@ struct GlUniform {
 	 * NOT the same as the uniform index.
      */
 	GLuint location;
+
+	/**
+	 * Offset of the uniform value in the packed uniform data
+	 * of uniform inputs and the program's uploaded values.
+	 */
+	size_t offset;
+
+	/**
+	 * Size of the uniform value in bytes.
+	 */
+	size_t size;
 };
 
 /**
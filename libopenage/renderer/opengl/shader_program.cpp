@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <unordered_set>
 
 #include "datastructure/constexpr_map.h"
@@ -64,6 +65,7 @@ GlShaderProgram::GlShaderProgram(const std::shared_ptr<GlContext> &context,
                                  const std::vector<resources::ShaderSource> &srcs) :
 	GlSimpleObject(context,
                    [](GLuint handle) { glDeleteProgram(handle); }),
+	uniform_data_size{0},
 	validated(false) {
 	const gl_context_capabilities &caps = context->get_capabilities();
 
@@ -200,23 +202,39 @@ GlShaderProgram::GlShaderProgram(const std::shared_ptr<GlContext> &context,
 
 		GLuint loc = glGetUniformLocation(handle, name.data());
 
-		this->uniforms.insert(std::make_pair(
-			name.data(),
-			GlUniform{
-				type,
-				loc}));
+		// uniforms of unsupported types get no space in the packed data
+		// and cannot be set
+		size_t size = 0;
+		if (GL_SHADER_TYPE_SIZE.contains(type)) {
+			size = GL_SHADER_TYPE_SIZE.get(type);
+		}
+
+		// assign the next ID and a 4 byte aligned offset in the packed uniform data
+		uniform_id_t id = this->uniforms.size();
+		size_t offset = (this->uniform_data_size + 3) & ~size_t{3};
+		this->uniform_data_size = offset + size;
+
+		this->uniforms.push_back(GlUniform{
+			type,
+			loc,
+			offset,
+			size});
+		this->uniform_ids.insert(std::make_pair(name.data(), id));
 
 		if (type == GL_SAMPLER_2D) {
 			ENSURE(tex_unit < caps.max_texture_slots,
 			       "Tried to create an OpenGL shader that uses more texture sampler uniforms "
 			           << "than there are texture unit slots (" << caps.max_texture_slots << " available).");
 
-			this->texunits_per_unifs.insert(std::make_pair(name.data(), tex_unit));
+			this->texunits_per_unifs.insert(std::make_pair(id, tex_unit));
 
 			tex_unit += 1;
 		}
 	}
 
+	this->uploaded_data.resize(this->uniform_data_size, 0);
+	this->uploaded_mask.resize(this->uniforms.size(), false);
+
 	// Extract vertex attribute descriptions.
 	for (GLuint i_attrib = 0; i_attrib < attrib_count; ++i_attrib) {
 		GLint size;
@@ -257,9 +275,10 @@ GlShaderProgram::GlShaderProgram(const std::shared_ptr<GlContext> &context,
 
 	if (!this->uniforms.empty()) {
 		log::log(MSG(dbg) << "Uniforms: ");
-		for (auto const &pair : this->uniforms) {
-			log::log(MSG(dbg) << "(" << pair.second.location << ") " << pair.first << ": "
-			                  << GLSL_TYPE_NAME.get(pair.second.type));
+		for (auto const &pair : this->uniform_ids) {
+			auto const &unif = this->uniforms[pair.second];
+			log::log(MSG(dbg) << "(" << unif.location << ") " << pair.first << ": "
+			                  << GLSL_TYPE_NAME.get(unif.type));
 		}
 	}
 
@@ -330,11 +349,22 @@ void GlShaderProgram::update_uniforms(std::shared_ptr<GlUniformInput> const &uni
 	}
 
 	uint8_t const *data = unif_in->update_data.data();
-	for (auto const &pair : unif_in->update_offs) {
-		uint8_t const *ptr = data + pair.second;
-		const auto &unif = this->uniforms.at(pair.first);
+	for (auto const id : unif_in->update_ids) {
+		const auto &unif = this->uniforms[id];
+		uint8_t const *ptr = data + unif.offset;
 		auto loc = unif.location;
 
+		// Skip values that the program already has. Textures are always bound
+		// because their handles may have been reused after deletion.
+		uint8_t *uploaded = this->uploaded_data.data() + unif.offset;
+		if (unif.type != GL_SAMPLER_2D) {
+			if (this->uploaded_mask[id] and std::memcmp(uploaded, ptr, unif.size) == 0) {
+				continue;
+			}
+			std::memcpy(uploaded, ptr, unif.size);
+			this->uploaded_mask[id] = true;
+		}
+
 		switch (unif.type) {
 		case GL_INT:
 			glUniform1i(loc, *reinterpret_cast<const GLint *>(ptr));
@@ -386,7 +416,7 @@ void GlShaderProgram::update_uniforms(std::shared_ptr<GlUniformInput> const &uni
 			glUniformMatrix4fv(loc, 1, GLboolean(false), reinterpret_cast<const float *>(ptr));
 			break;
 		case GL_SAMPLER_2D: {
-			GLuint tex_unit = this->texunits_per_unifs.at(pair.first);
+			GLuint tex_unit = this->texunits_per_unifs.at(id);
 			GLuint tex = *reinterpret_cast<const GLuint *>(ptr);
 			glActiveTexture(GL_TEXTURE0 + tex_unit);
 			glBindTexture(GL_TEXTURE_2D, tex);
@@ -416,13 +446,23 @@ std::map<size_t, resources::vertex_input_t> GlShaderProgram::vertex_attributes()
 }
 
 std::shared_ptr<UniformInput> GlShaderProgram::new_unif_in() {
-	auto in = std::make_shared<GlUniformInput>(this->shared_from_this());
+	auto in = std::make_shared<GlUniformInput>(this->shared_from_this(),
+	                                           this->uniforms.size(),
+	                                           this->uniform_data_size);
 
 	return in;
 }
 
 bool GlShaderProgram::has_uniform(const char *name) {
-	return this->uniforms.count(name) == 1;
+	return this->uniform_ids.count(name) == 1;
+}
+
+uniform_id_t GlShaderProgram::get_uniform_id(const char *name) {
+	auto id = this->uniform_ids.find(name);
+	ENSURE(id != std::end(this->uniform_ids),
+	       "Tried to get uniform " << name << " that does not exist in the shader program.");
+
+	return id->second;
 }
 
 void GlShaderProgram::bind_uniform_buffer(const char *block_name, std::shared_ptr<UniformBuffer> const &buffer) {
@@ -438,101 +478,94 @@ void GlShaderProgram::bind_uniform_buffer(const char *block_name, std::shared_pt
 	glUniformBlockBinding(*this->handle, block.index, block.binding_point);
 }
 
-void GlShaderProgram::set_unif(std::shared_ptr<UniformInput> const &in, const char *unif, void const *val, GLenum type) {
-	auto unif_in = std::dynamic_pointer_cast<GlUniformInput>(in);
+void GlShaderProgram::set_unif(std::shared_ptr<UniformInput> const &in, uniform_id_t id, void const *val, GLenum type) {
+	auto unif_in = std::static_pointer_cast<GlUniformInput>(in);
 
-	auto uniform = this->uniforms.find(unif);
-	ENSURE(uniform != std::end(this->uniforms),
-	       "Tried to set uniform " << unif << " that does not exist in the shader program.");
+	ENSURE(id < this->uniforms.size(),
+	       "Tried to set uniform with ID " << id << " that does not exist in the shader program.");
 
-	auto const &unif_data = uniform->second;
+	auto const &unif_data = this->uniforms[id];
 
 	ENSURE(type == unif_data.type,
-	       "Tried to set uniform " << unif << " to a value of the wrong type.");
+	       "Tried to set uniform with ID " << id << " to a value of the wrong type.");
+	ENSURE(unif_data.size > 0,
+	       "Tried to set uniform with ID " << id << " that has an unsupported type.");
 
-	size_t size = GL_SHADER_TYPE_SIZE.get(unif_data.type);
+	// store the value at the uniform's fixed position in the packed data
+	memcpy(unif_in->update_data.data() + unif_data.offset, val, unif_data.size);
 
-	auto update_off = unif_in->update_offs.find(unif);
-	if (update_off != std::end(unif_in->update_offs)) [[likely]] { // always used after the uniform value is written once
-		// already wrote to this uniform since last upload
-		size_t off = update_off->second;
-		memcpy(unif_in->update_data.data() + off, val, size);
-	}
-	else {
-		// first time writing to this uniform since last upload, so
-		// extend the buffer before storing the uniform value
-		size_t prev_size = unif_in->update_data.size();
-		unif_in->update_data.resize(prev_size + size);
-		memcpy(unif_in->update_data.data() + prev_size, val, size);
-		unif_in->update_offs.emplace(unif, prev_size);
+	if (not unif_in->update_mask[id]) [[unlikely]] {
+		// first time writing to this uniform
+		unif_in->update_mask[id] = true;
+		unif_in->update_ids.push_back(id);
 	}
 }
 
-void GlShaderProgram::set_i32(std::shared_ptr<UniformInput> const &in, const char *unif, int32_t val) {
-	this->set_unif(in, unif, &val, GL_INT);
+void GlShaderProgram::set_i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, int32_t val) {
+	this->set_unif(in, id, &val, GL_INT);
 }
 
-void GlShaderProgram::set_u32(std::shared_ptr<UniformInput> const &in, const char *unif, uint32_t val) {
-	this->set_unif(in, unif, &val, GL_UNSIGNED_INT);
+void GlShaderProgram::set_u32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, uint32_t val) {
+	this->set_unif(in, id, &val, GL_UNSIGNED_INT);
 }
 
-void GlShaderProgram::set_f32(std::shared_ptr<UniformInput> const &in, const char *unif, float val) {
-	this->set_unif(in, unif, &val, GL_FLOAT);
+void GlShaderProgram::set_f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, float val) {
+	this->set_unif(in, id, &val, GL_FLOAT);
 }
 
-void GlShaderProgram::set_f64(std::shared_ptr<UniformInput> const &in, const char *unif, double val) {
+void GlShaderProgram::set_f64(std::shared_ptr<UniformInput> const &in, uniform_id_t id, double val) {
 	// TODO requires extension
-	this->set_unif(in, unif, &val, GL_DOUBLE);
+	this->set_unif(in, id, &val, GL_DOUBLE);
 }
 
-void GlShaderProgram::set_bool(std::shared_ptr<UniformInput> const &in, const char *unif, bool val) {
-	this->set_unif(in, unif, &val, GL_BOOL);
+void GlShaderProgram::set_bool(std::shared_ptr<UniformInput> const &in, uniform_id_t id, bool val) {
+	this->set_unif(in, id, &val, GL_BOOL);
 }
 
-void GlShaderProgram::set_v2f32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector2f const &val) {
-	this->set_unif(in, unif, &val, GL_FLOAT_VEC2);
+void GlShaderProgram::set_v2f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector2f const &val) {
+	this->set_unif(in, id, &val, GL_FLOAT_VEC2);
 }
 
-void GlShaderProgram::set_v3f32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector3f const &val) {
-	this->set_unif(in, unif, &val, GL_FLOAT_VEC3);
+void GlShaderProgram::set_v3f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector3f const &val) {
+	this->set_unif(in, id, &val, GL_FLOAT_VEC3);
 }
 
-void GlShaderProgram::set_v4f32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector4f const &val) {
-	this->set_unif(in, unif, &val, GL_FLOAT_VEC4);
+void GlShaderProgram::set_v4f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector4f const &val) {
+	this->set_unif(in, id, &val, GL_FLOAT_VEC4);
 }
 
-void GlShaderProgram::set_v2i32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector2i const &val) {
-	this->set_unif(in, unif, &val, GL_INT_VEC2);
+void GlShaderProgram::set_v2i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector2i const &val) {
+	this->set_unif(in, id, &val, GL_INT_VEC2);
 }
 
-void GlShaderProgram::set_v3i32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector3i const &val) {
-	this->set_unif(in, unif, &val, GL_INT_VEC3);
+void GlShaderProgram::set_v3i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector3i const &val) {
+	this->set_unif(in, id, &val, GL_INT_VEC3);
 }
 
-void GlShaderProgram::set_v4i32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector4i const &val) {
-	this->set_unif(in, unif, &val, GL_INT_VEC4);
+void GlShaderProgram::set_v4i32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector4i const &val) {
+	this->set_unif(in, id, &val, GL_INT_VEC4);
 }
 
-void GlShaderProgram::set_v2ui32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector2<uint32_t> const &val) {
-	this->set_unif(in, unif, &val, GL_UNSIGNED_INT_VEC2);
+void GlShaderProgram::set_v2ui32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector2<uint32_t> const &val) {
+	this->set_unif(in, id, &val, GL_UNSIGNED_INT_VEC2);
 }
 
-void GlShaderProgram::set_v3ui32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector3<uint32_t> const &val) {
-	this->set_unif(in, unif, &val, GL_UNSIGNED_INT_VEC3);
+void GlShaderProgram::set_v3ui32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector3<uint32_t> const &val) {
+	this->set_unif(in, id, &val, GL_UNSIGNED_INT_VEC3);
 }
 
-void GlShaderProgram::set_v4ui32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Vector4<uint32_t> const &val) {
-	this->set_unif(in, unif, &val, GL_UNSIGNED_INT_VEC4);
+void GlShaderProgram::set_v4ui32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Vector4<uint32_t> const &val) {
+	this->set_unif(in, id, &val, GL_UNSIGNED_INT_VEC4);
 }
 
-void GlShaderProgram::set_m4f32(std::shared_ptr<UniformInput> const &in, const char *unif, Eigen::Matrix4f const &val) {
-	this->set_unif(in, unif, val.data(), GL_FLOAT_MAT4);
+void GlShaderProgram::set_m4f32(std::shared_ptr<UniformInput> const &in, uniform_id_t id, Eigen::Matrix4f const &val) {
+	this->set_unif(in, id, val.data(), GL_FLOAT_MAT4);
 }
 
-void GlShaderProgram::set_tex(std::shared_ptr<UniformInput> const &in, const char *unif, std::shared_ptr<Texture2d> const &val) {
+void GlShaderProgram::set_tex(std::shared_ptr<UniformInput> const &in, uniform_id_t id, std::shared_ptr<Texture2d> const &val) {
 	auto tex = std::dynamic_pointer_cast<GlTexture2d>(val);
 	GLuint handle = tex->get_handle();
-	this->set_unif(in, unif, &handle, GL_SAMPLER_2D);
+	this->set_unif(in, id, &handle, GL_SAMPLER_2D);
 }
 
 } // namespace openage::renderer::opengl
@@ -66,6 +66,8 @@ public:
 
 	bool has_uniform(const char *) override;
 
+	uniform_id_t get_uniform_id(const char *) override;
+
 	/**
      * Binds a uniform block in the shader program to the same binding point as
      * the given uniform buffer.
@@ -80,29 +82,43 @@ public:
 
 protected:
 	std::shared_ptr<UniformInput> new_unif_in() override;
-	void set_i32(std::shared_ptr<UniformInput> const &, const char *, int32_t) override;
-	void set_u32(std::shared_ptr<UniformInput> const &, const char *, uint32_t) override;
-	void set_f32(std::shared_ptr<UniformInput> const &, const char *, float) override;
-	void set_f64(std::shared_ptr<UniformInput> const &, const char *, double) override;
-	void set_bool(std::shared_ptr<UniformInput> const &, const char *, bool) override;
-	void set_v2f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector2f const &) override;
-	void set_v3f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector3f const &) override;
-	void set_v4f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector4f const &) override;
-	void set_v2i32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector2i const &) override;
-	void set_v3i32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector3i const &) override;
-	void set_v4i32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector4i const &) override;
-	void set_v2ui32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector2<uint32_t> const &) override;
-	void set_v3ui32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector3<uint32_t> const &) override;
-	void set_v4ui32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector4<uint32_t> const &) override;
-	void set_m4f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Matrix4f const &) override;
-	void set_tex(std::shared_ptr<UniformInput> const &, const char *, std::shared_ptr<Texture2d> const &) override;
+	void set_i32(std::shared_ptr<UniformInput> const &, uniform_id_t, int32_t) override;
+	void set_u32(std::shared_ptr<UniformInput> const &, uniform_id_t, uint32_t) override;
+	void set_f32(std::shared_ptr<UniformInput> const &, uniform_id_t, float) override;
+	void set_f64(std::shared_ptr<UniformInput> const &, uniform_id_t, double) override;
+	void set_bool(std::shared_ptr<UniformInput> const &, uniform_id_t, bool) override;
+	void set_v2f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2f const &) override;
+	void set_v3f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3f const &) override;
+	void set_v4f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4f const &) override;
+	void set_v2i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2i const &) override;
+	void set_v3i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3i const &) override;
+	void set_v4i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4i const &) override;
+	void set_v2ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2<uint32_t> const &) override;
+	void set_v3ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3<uint32_t> const &) override;
+	void set_v4ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4<uint32_t> const &) override;
+	void set_m4f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Matrix4f const &) override;
+	void set_tex(std::shared_ptr<UniformInput> const &, uniform_id_t, std::shared_ptr<Texture2d> const &) override;
 
 private:
-	void set_unif(std::shared_ptr<UniformInput> const &, const char *, void const *, GLenum);
+	void set_unif(std::shared_ptr<UniformInput> const &, uniform_id_t, void const *, GLenum);
 
-	/// Maps uniform names to their descriptions. Contains only
+	/// Uniform descriptions, indexed by uniform ID. Contains only
 	/// uniforms in the default block, i.e. not within named blocks.
-	std::unordered_map<std::string, GlUniform> uniforms;
+	std::vector<GlUniform> uniforms;
+
+	/// Maps uniform names to their IDs.
+	std::unordered_map<std::string, uniform_id_t> uniform_ids;
+
+	/// Size of the packed uniform values of all uniforms.
+	size_t uniform_data_size;
+
+	/// Uniform values that were last uploaded to the program, using the same
+	/// packing as uniform inputs. Used to skip uploads of unchanged values.
+	std::vector<uint8_t> uploaded_data;
+
+	/// Flags for every uniform that indicate whether \p uploaded_data
+	/// contains the current value of the uniform.
+	std::vector<bool> uploaded_mask;
 
 	/// Maps uniform block names to their descriptions.
 	std::unordered_map<std::string, GlUniformBlock> uniform_blocks;
@@ -110,8 +126,8 @@ private:
 	/// Maps per-vertex attribute names to their descriptions.
 	std::unordered_map<std::string, GlVertexAttrib> attribs;
 
-	/// Maps sampler uniform names to their assigned texture units.
-	std::unordered_map<std::string, GLuint> texunits_per_unifs;
+	/// Maps sampler uniform IDs to their assigned texture units.
+	std::unordered_map<uniform_id_t, GLuint> texunits_per_unifs;
 	/// Maps texture units to the texture handles that are currently bound to them.
 	std::unordered_map<GLuint, GLuint> textures_per_texunits;
 
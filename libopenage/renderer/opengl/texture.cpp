@@ -38,16 +38,30 @@ GlTexture2d::GlTexture2d(const std::shared_ptr<GlContext> &context,
 
 	glPixelStorei(GL_UNPACK_ALIGNMENT, this->info.get_row_alignment());
 
-	glTexImage2D(
-		GL_TEXTURE_2D,
-		0,
-		std::get<0>(fmt_in_out),
-		size.first,
-		size.second,
-		0,
-		std::get<1>(fmt_in_out),
-		std::get<2>(fmt_in_out),
-		data.get_data());
+	if (resources::is_compressed(this->info.get_format())) {
+		// upload the compressed blocks as they are
+		glCompressedTexImage2D(
+			GL_TEXTURE_2D,
+			0,
+			std::get<0>(fmt_in_out),
+			size.first,
+			size.second,
+			0,
+			this->info.get_data_size(),
+			data.get_data());
+	}
+	else {
+		glTexImage2D(
+			GL_TEXTURE_2D,
+			0,
+			std::get<0>(fmt_in_out),
+			size.first,
+			size.second,
+			0,
+			std::get<1>(fmt_in_out),
+			std::get<2>(fmt_in_out),
+			data.get_data());
+	}
 
 	// drawing settings
 	// TODO these are outdated, use sampler settings
@@ -99,7 +113,12 @@ resources::Texture2dData GlTexture2d::into_data() {
 	glPixelStorei(GL_PACK_ALIGNMENT, this->info.get_row_alignment());
 	glBindTexture(GL_TEXTURE_2D, *this->handle);
 	// TODO use a Pixel Buffer Object instead
-	glGetTexImage(GL_TEXTURE_2D, 0, std::get<1>(fmt_in_out), std::get<2>(fmt_in_out), data.data());
+	if (resources::is_compressed(this->info.get_format())) {
+		glGetCompressedTexImage(GL_TEXTURE_2D, 0, data.data());
+	}
+	else {
+		glGetTexImage(GL_TEXTURE_2D, 0, std::get<1>(fmt_in_out), std::get<2>(fmt_in_out), data.data());
+	}
 
 	return resources::Texture2dData(resources::Texture2dInfo(this->info), std::move(data));
 }
@@ -114,7 +133,12 @@ void GlTexture2d::upload(resources::Texture2dData const &data) {
 	auto size = this->info.get_size();
 	auto fmt_in_out = GL_PIXEL_FORMAT.get(this->info.get_format());
 
-	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.first, size.second, std::get<1>(fmt_in_out), std::get<2>(fmt_in_out), data.get_data());
+	if (resources::is_compressed(this->info.get_format())) {
+		glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.first, size.second, std::get<0>(fmt_in_out), this->info.get_data_size(), data.get_data());
+	}
+	else {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.first, size.second, std::get<1>(fmt_in_out), std::get<2>(fmt_in_out), data.get_data());
+	}
 }
 
 } // namespace opengl
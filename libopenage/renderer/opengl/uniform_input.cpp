@@ -4,8 +4,13 @@
 
 namespace openage::renderer::opengl {
 
-GlUniformInput::GlUniformInput(std::shared_ptr<ShaderProgram> const &prog) :
-	UniformInput{prog} {}
+GlUniformInput::GlUniformInput(std::shared_ptr<ShaderProgram> const &prog,
+                               size_t uniform_count,
+                               size_t data_size) :
+	UniformInput{prog},
+	update_ids{},
+	update_mask(uniform_count, false),
+	update_data(data_size, 0) {}
 
 GlUniformBufferInput::GlUniformBufferInput(std::shared_ptr<UniformBuffer> const &buffer) :
 	UniformBufferInput{buffer} {}
@@ -24,20 +24,37 @@ class GlShaderProgram;
  */
 class GlUniformInput final : public UniformInput {
 public:
-	GlUniformInput(std::shared_ptr<ShaderProgram> const &);
+	/**
+	 * Create a new uniform input.
+	 *
+	 * @param prog Shader program the input belongs to.
+	 * @param uniform_count Number of uniforms in the program.
+	 * @param data_size Size of the packed uniform data of the program.
+	 */
+	GlUniformInput(std::shared_ptr<ShaderProgram> const &prog,
+	               size_t uniform_count,
+	               size_t data_size);
 
 	/**
      * We store uniform updates lazily. They are only actually uploaded to GPU
 	 * when a draw call is made.
      *
-     * \p update_offs maps the uniform names to where their
-	 * value is in \p update_data in terms of a byte-wise offset. This is only a partial
-	 * valuation, so not all uniforms have to be present here.
+     * \p update_ids contains the IDs of the uniforms that have been set, in the
+	 * order they were first set. This is only a partial valuation, so not all
+	 * uniforms have to be present here.
      */
-	std::unordered_map<std::string, size_t> update_offs;
+	std::vector<uniform_id_t> update_ids;
 
 	/**
-     * Buffer containing untyped uniform update data.
+	 * Flags for every uniform of the program that indicate whether
+	 * the uniform is in \p update_ids.
+	 */
+	std::vector<bool> update_mask;
+
+	/**
+     * Packed uniform values. Every uniform has a fixed offset in this buffer
+	 * that is determined by the shader program, so the values for one draw call
+	 * are stored in one contiguous block.
      */
 	std::vector<uint8_t> update_data;
 };
@@ -2,6 +2,12 @@
 
 #include "animation_info.h"
 
+#include <algorithm>
+#include <cstdlib>
+
+#include "renderer/resources/texture_info.h"
+#include "renderer/resources/texture_subinfo.h"
+
 namespace openage::renderer::resources {
 
 Animation2dInfo::Animation2dInfo(const float scalefactor,
@@ -9,7 +15,23 @@ Animation2dInfo::Animation2dInfo(const float scalefactor,
                                  std::vector<LayerInfo> &layers) :
 	scalefactor{scalefactor},
 	texture_infos{textures},
-	layers{layers} {}
+	layers{layers} {
+	// all frames are subtextures of the animation's textures
+	for (auto &texture : this->texture_infos) {
+		for (size_t i = 0; i < texture->get_subtex_count(); ++i) {
+			auto &subtex = texture->get_subtex_info(i);
+			auto &size = subtex.get_size();
+			auto &anchor = subtex.get_anchor_params();
+
+			// anchor params are (w - 2 * cx, -h + 2 * cy), so this is the
+			// larger of the distances from the anchor to both edges
+			this->max_bounds[0] = std::max(this->max_bounds[0],
+			                               (std::abs(anchor[0]) + size[0]) / 2.0f);
+			this->max_bounds[1] = std::max(this->max_bounds[1],
+			                               (std::abs(anchor[1]) + size[1]) / 2.0f);
+		}
+	}
+}
 
 float Animation2dInfo::get_scalefactor() const {
 	return this->scalefactor;
@@ -31,4 +53,8 @@ const LayerInfo &Animation2dInfo::get_layer(size_t idx) const {
 	return this->layers.at(idx);
 }
 
+const Eigen::Vector2f &Animation2dInfo::get_max_bounds() const {
+	return this->max_bounds;
+}
+
 } // namespace openage::renderer::resources
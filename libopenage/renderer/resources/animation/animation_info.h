@@ -6,6 +6,8 @@
 #include <memory>
 #include <vector>
 
+#include <eigen3/Eigen/Dense>
+
 #include "renderer/resources/animation/layer_info.h"
 
 
@@ -79,6 +81,15 @@ public:
 	 */
 	const LayerInfo &get_layer(size_t idx) const;
 
+	/**
+	 * Get the maximum distance from the anchor to the edges of any frame
+	 * of the animation. Can be used as the bounds of the animation's
+	 * sprites for culling.
+	 *
+	 * @return Maximum distance in pixels (x, y), not scaled.
+	 */
+	const Eigen::Vector2f &get_max_bounds() const;
+
 private:
 	/**
 	 * Scaling factor of the animation across all layers at default zoom level.
@@ -94,6 +105,11 @@ private:
 	 * Layer information.
 	 */
 	std::vector<LayerInfo> layers;
+
+	/**
+	 * Maximum distance from the anchor to the frame edges in pixels.
+	 */
+	Eigen::Vector2f max_bounds = Eigen::Vector2f::Zero();
 };
 
 } // namespace openage::renderer::resources
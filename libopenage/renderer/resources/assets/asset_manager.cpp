@@ -6,10 +6,12 @@
 #include "log/log.h"
 #include "log/message.h"
 
+#include "renderer/renderer.h"
 #include "renderer/resources/animation/animation_info.h"
 #include "renderer/resources/assets/cache.h"
 #include "renderer/resources/assets/texture_manager.h"
 #include "renderer/resources/palette_info.h"
+#include "renderer/resources/palette_lookup.h"
 #include "renderer/resources/parser/parse_blendmask.h"
 #include "renderer/resources/parser/parse_blendtable.h"
 #include "renderer/resources/parser/parse_palette.h"
@@ -19,17 +21,44 @@
 #include "renderer/resources/terrain/blendpattern_info.h"
 #include "renderer/resources/terrain/blendtable_info.h"
 #include "renderer/resources/terrain/terrain_info.h"
+#include "renderer/resources/texture_data.h"
 #include "renderer/resources/texture_info.h"
+#include "renderer/texture.h"
 
 
 namespace openage::renderer::resources {
 
+namespace {
+
+/**
+ * Load the textures used by a placeholder asset and pin them in the
+ * texture manager, so that they are never evicted.
+ */
+template <typename T>
+void pin_textures(const T &info, TextureManager &texture_manager) {
+	for (size_t i = 0; i < info.get_texture_count(); ++i) {
+		auto &tex_info = info.get_texture(i);
+		if (not tex_info->get_image_path()) {
+			continue;
+		}
+
+		auto &path = tex_info->get_image_path().value();
+		texture_manager.add(path);
+		texture_manager.set_pinned(path);
+	}
+}
+
+} // namespace
+
+
 AssetManager::AssetManager(const std::shared_ptr<Renderer> &renderer,
                            const util::Path &asset_base_dir) :
 	renderer{renderer},
 	cache{std::make_shared<AssetCache>()},
 	texture_manager{std::make_shared<TextureManager>(renderer)},
-	asset_base_dir{asset_base_dir} {
+	palette_lut{nullptr},
+	asset_base_dir{asset_base_dir},
+	resolved_paths{} {
 }
 
 const std::shared_ptr<Animation2dInfo> &AssetManager::request_animation(const util::Path &path) {
@@ -38,6 +67,9 @@ const std::shared_ptr<Animation2dInfo> &AssetManager::request_animation(const ut
 		if (not this->cache->check_animation_cache(path)) {
 			// create if not loaded
 			info = std::make_shared<Animation2dInfo>(parser::parse_sprite_file(path, this->cache));
+			for (size_t i = 0; i < info->get_texture_count(); ++i) {
+				this->check_palettes(*info->get_texture(i));
+			}
 			this->cache->add_animation(path, info);
 		}
 	}
@@ -148,6 +180,7 @@ const std::shared_ptr<Texture2dInfo> &AssetManager::request_texture(const util::
 		if (not this->cache->check_texture_cache(path)) {
 			// create if not loaded
 			info = std::make_shared<Texture2dInfo>(parser::parse_texture_file(path));
+			this->check_palettes(*info);
 			this->cache->add_texture(path, info);
 		}
 	}
@@ -168,6 +201,15 @@ const std::shared_ptr<Animation2dInfo> &AssetManager::request_animation(const st
 	return this->request_animation(this->asset_base_dir / rel_path);
 }
 
+const std::shared_ptr<Animation2dInfo> &AssetManager::request_animation(const util::Symbol &rel_path) {
+	auto resolved = this->resolved_paths.find(rel_path);
+	if (resolved == this->resolved_paths.end()) {
+		resolved = this->resolved_paths.emplace(rel_path, this->asset_base_dir / rel_path.str()).first;
+	}
+
+	return this->request_animation(resolved->second);
+}
+
 const std::shared_ptr<BlendPatternInfo> &AssetManager::request_blpattern(const std::string &rel_path) {
 	return this->request_blpattern(this->asset_base_dir / rel_path);
 }
@@ -193,6 +235,7 @@ void AssetManager::set_placeholder_animation(const util::Path &path) {
 		path,
 		std::make_shared<Animation2dInfo>(
 			parser::parse_sprite_file(path, this->cache)));
+	pin_textures(*this->placeholder_animation->second, *this->texture_manager);
 }
 
 void AssetManager::set_placeholder_blpattern(const util::Path &path) {
@@ -200,6 +243,7 @@ void AssetManager::set_placeholder_blpattern(const util::Path &path) {
 		path,
 		std::make_shared<BlendPatternInfo>(
 			parser::parse_blendmask_file(path, this->cache)));
+	pin_textures(*this->placeholder_blpattern->second, *this->texture_manager);
 }
 
 void AssetManager::set_placeholder_bltable(const util::Path &path) {
@@ -221,6 +265,7 @@ void AssetManager::set_placeholder_terrain(const util::Path &path) {
 		path,
 		std::make_shared<TerrainInfo>(
 			parser::parse_terrain_file(path, this->cache)));
+	pin_textures(*this->placeholder_terrain->second, *this->texture_manager);
 }
 
 void AssetManager::set_placeholder_texture(const util::Path &path) {
@@ -228,6 +273,12 @@ void AssetManager::set_placeholder_texture(const util::Path &path) {
 		path,
 		std::make_shared<Texture2dInfo>(
 			parser::parse_texture_file(path)));
+
+	auto &tex_path = this->placeholder_texture->second->get_image_path();
+	if (tex_path) {
+		this->texture_manager->add(tex_path.value());
+		this->texture_manager->set_pinned(tex_path.value());
+	}
 }
 
 const AssetManager::placeholder_anim_t &AssetManager::get_placeholder_animation() {
@@ -258,4 +309,61 @@ const std::shared_ptr<TextureManager> &AssetManager::get_texture_manager() {
 	return this->texture_manager;
 }
 
+const std::shared_ptr<AssetCache> &AssetManager::get_cache() {
+	return this->cache;
+}
+
+void AssetManager::set_palettes(const util::Path &palette_path,
+                                const std::vector<util::Path> &player_palette_paths,
+                                size_t player_color_start) {
+	auto &palette = this->request_palette(palette_path);
+
+	std::vector<PaletteInfo> player_palettes;
+	for (auto &path : player_palette_paths) {
+		player_palettes.push_back(*this->request_palette(path));
+	}
+
+	auto lut = create_palette_lut(*palette, player_palettes, player_color_start);
+	this->palette_lut = this->renderer->add_texture(lut);
+
+	log::log(MSG(dbg) << "Created palette lookup table with "
+	                  << player_palettes.size() << " player palettes");
+}
+
+bool AssetManager::load_palettes(const util::Path &palette_dir,
+                                 size_t player_color_start) {
+	auto palette_path = palette_dir / "base.opal";
+	if (not palette_path.is_file()) {
+		return false;
+	}
+
+	std::vector<util::Path> player_palette_paths;
+	while (true) {
+		auto path = palette_dir / ("player" + std::to_string(player_palette_paths.size() + 1) + ".opal");
+		if (not path.is_file()) {
+			break;
+		}
+		player_palette_paths.push_back(path);
+	}
+
+	this->set_palettes(palette_path, player_palette_paths, player_color_start);
+	return true;
+}
+
+const std::shared_ptr<Texture2d> &AssetManager::get_palette_lut() {
+	return this->palette_lut;
+}
+
+void AssetManager::check_palettes(const Texture2dInfo &info) const {
+	// without the lookup table, only the raw indices could be drawn
+	if (info.get_format() == pixel_format::r8 and this->palette_lut == nullptr) {
+		throw Error{MSG(err) << "Indexed (r8) textures can not be loaded before the palettes are set."};
+	}
+}
+
+void AssetManager::next_frame() {
+	this->cache->next_frame();
+	this->texture_manager->next_frame();
+}
+
 } // namespace openage::renderer::resources
@@ -5,13 +5,17 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "util/path.h"
+#include "util/symbol.h"
 
 
 namespace openage::renderer {
 class Renderer;
+class Texture2d;
 
 namespace resources {
 class AssetCache;
@@ -36,7 +40,8 @@ class Texture2dInfo;
 class AssetManager {
 public:
 	/**
-     * Create a new asset manager.
+     * Create a new asset manager. The caches have no memory budget,
+     * see \p get_cache() and \p get_texture_manager() for setting one.
      *
      * @param renderer The openage renderer instance.
      * @param asset_base_dir Base path for all assets.
@@ -87,6 +92,19 @@ public:
 	const std::shared_ptr<TerrainInfo> &request_terrain(const std::string &rel_path);
 	const std::shared_ptr<Texture2dInfo> &request_texture(const std::string &rel_path);
 
+	/**
+     * Get the corresponding asset for an interned path string relative to the
+     * asset base directory.
+     *
+     * The path is only joined with the asset base directory on the first
+     * request of the symbol.
+     *
+     * @param path Relative path to the asset resource (from the asset base dir).
+     *
+     * @return Texture resource at the given path.
+     */
+	const std::shared_ptr<Animation2dInfo> &request_animation(const util::Symbol &rel_path);
+
 	using placeholder_anim_t = std::optional<std::pair<util::Path, std::shared_ptr<Animation2dInfo>>>;
 	using placeholder_blpattern_t = std::optional<std::pair<util::Path, std::shared_ptr<BlendPatternInfo>>>;
 	using placeholder_bltable_t = std::optional<std::pair<util::Path, std::shared_ptr<BlendTableInfo>>>;
@@ -126,7 +144,64 @@ public:
       */
 	const std::shared_ptr<TextureManager> &get_texture_manager();
 
+	/**
+      * Get the cache for accessing the loaded asset descriptions.
+      *
+      * @return Asset cache.
+      */
+	const std::shared_ptr<AssetCache> &get_cache();
+
+	/**
+      * Create the palette lookup table that is used to resolve the colors
+      * of indexed (\p pixel_format::r8) textures in the shaders.
+      *
+      * @param palette_path Path to the base palette.
+      * @param player_palette_paths Paths to the player color palettes. Player \p n
+      *                             uses row \p n + 1 of the lookup table.
+      * @param player_color_start Index of the first player color in the base palette.
+      */
+	void set_palettes(const util::Path &palette_path,
+	                  const std::vector<util::Path> &player_palette_paths = {},
+	                  size_t player_color_start = 0);
+
+	/**
+      * Create the palette lookup table from the palettes in a directory. The base
+      * palette is \p base.opal and the player color palettes are \p player1.opal,
+      * \p player2.opal, etc.
+      *
+      * @param palette_dir Directory with the palette definition files.
+      * @param player_color_start Index of the first player color in the base palette.
+      *
+      * @return true if the directory contains a base palette, else false.
+      */
+	bool load_palettes(const util::Path &palette_dir,
+	                   size_t player_color_start = 0);
+
+	/**
+      * Get the palette lookup table for indexed textures.
+      *
+      * @return Lookup table texture or \p nullptr if no palettes were set.
+      */
+	const std::shared_ptr<Texture2d> &get_palette_lut();
+
+	/**
+      * Advance the asset caches to the next frame. Evicts assets that were
+      * not used recently if the caches exceed their memory budgets.
+      *
+      * Should be called once per frame after rendering.
+      */
+	void next_frame();
+
 private:
+	/**
+     * Check that a texture can be drawn with the loaded palettes.
+     *
+     * @param info Texture information.
+     *
+     * @throw Error if the texture is indexed, but no palettes were set.
+     */
+	void check_palettes(const Texture2dInfo &info) const;
+
 	/**
      * openage renderer.
      */
@@ -143,6 +218,11 @@ private:
      */
 	std::shared_ptr<TextureManager> texture_manager;
 
+	/**
+     * Palette lookup table for indexed textures.
+     */
+	std::shared_ptr<Texture2d> palette_lut;
+
 	/**
      * Base path for all assets.
      *
@@ -150,6 +230,11 @@ private:
      */
 	util::Path asset_base_dir;
 
+	/**
+     * Paths of interned relative path strings, joined with the asset base directory.
+     */
+	std::unordered_map<util::Symbol, util::Path> resolved_paths;
+
 	/**
      * Placeholder assets that can be used if a resource is not found.
      */
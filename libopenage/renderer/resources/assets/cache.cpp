@@ -2,139 +2,331 @@
 
 #include "cache.h"
 
+#include "renderer/resources/animation/angle_info.h"
+#include "renderer/resources/animation/animation_info.h"
+#include "renderer/resources/animation/frame_info.h"
+#include "renderer/resources/animation/layer_info.h"
+#include "renderer/resources/palette_info.h"
+#include "renderer/resources/terrain/blendpattern_info.h"
+#include "renderer/resources/terrain/blendtable_info.h"
+#include "renderer/resources/terrain/terrain_info.h"
+#include "renderer/resources/texture_info.h"
 #include "util/path.h"
 
 
 namespace openage::renderer::resources {
 
+namespace {
+
+/**
+ * Create a callback that removes an asset from its cache if it
+ * is not referenced anywhere else.
+ */
+template <typename T>
+CacheTracker::release_func_t make_release(std::unordered_map<std::string, std::shared_ptr<T>> &cache,
+                                          const std::string &flat_path) {
+	return [&cache, flat_path]() {
+		auto it = cache.find(flat_path);
+		if (it == cache.end()) {
+			return true;
+		}
+
+		// still referenced by another asset or a renderer object
+		if (it->second.use_count() > 1) {
+			return false;
+		}
+
+		cache.erase(it);
+		return true;
+	};
+}
+
+/**
+ * Estimate the memory used by an asset description (in bytes).
+ *
+ * Referenced assets (e.g. texture infos of an animation) are tracked
+ * separately and therefore only count as pointers.
+ */
+size_t estimate_size(const Animation2dInfo &info) {
+	size_t size = sizeof(Animation2dInfo);
+	size += info.get_texture_count() * sizeof(std::shared_ptr<Texture2dInfo>);
+	for (size_t i = 0; i < info.get_layer_count(); ++i) {
+		auto &layer = info.get_layer(i);
+		size += sizeof(LayerInfo);
+		for (size_t j = 0; j < layer.get_angle_count(); ++j) {
+			auto &angle = layer.get_angle(j);
+			size += sizeof(AngleInfo) + sizeof(std::shared_ptr<AngleInfo>);
+			size += angle->get_frame_count() * (sizeof(FrameInfo) + sizeof(std::shared_ptr<FrameInfo>));
+		}
+	}
+	return size;
+}
+
+size_t estimate_size(const BlendPatternInfo &info) {
+	size_t size = sizeof(BlendPatternInfo);
+	size += info.get_texture_count() * sizeof(std::shared_ptr<Texture2dInfo>);
+	size += info.get_mask_count() * sizeof(blending_mask);
+	return size;
+}
+
+size_t estimate_size(const BlendTableInfo &info) {
+	size_t size = sizeof(BlendTableInfo);
+	size += info.get_table().size() * sizeof(size_t);
+	return size;
+}
+
+size_t estimate_size(PaletteInfo &info) {
+	size_t size = sizeof(PaletteInfo);
+	size += info.get_colors().size() * sizeof(Eigen::Vector4f);
+	return size;
+}
+
+size_t estimate_size(const TerrainInfo &info) {
+	size_t size = sizeof(TerrainInfo);
+	size += info.get_texture_count() * sizeof(std::shared_ptr<Texture2dInfo>);
+	size += info.get_layer_count() * sizeof(TerrainLayerInfo);
+	return size;
+}
+
+size_t estimate_size(const Texture2dInfo &info) {
+	size_t size = sizeof(Texture2dInfo);
+	size += info.get_subtex_count() * sizeof(Texture2dSubInfo);
+	return size;
+}
+
+/**
+ * Prefixes for the tracker keys, so that assets of different types
+ * with the same path do not collide.
+ */
+const std::string animation_key = "anim:";
+const std::string blpattern_key = "blpattern:";
+const std::string bltable_key = "bltable:";
+const std::string palette_key = "palette:";
+const std::string terrain_key = "terrain:";
+const std::string texture_key = "texture:";
+
+} // namespace
+
+
+AssetCache::AssetCache(size_t budget) :
+	tracker{budget} {
+}
+
 const std::shared_ptr<Animation2dInfo> &AssetCache::get_animation(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
+	this->tracker.touch(animation_key + flat_path);
 	return this->loaded_animations.at(flat_path);
 }
 
 
 const std::shared_ptr<BlendPatternInfo> &AssetCache::get_blpattern(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
+	this->tracker.touch(blpattern_key + flat_path);
 	return this->loaded_blpatterns.at(flat_path);
 }
 
 
 const std::shared_ptr<BlendTableInfo> &AssetCache::get_bltable(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
+	this->tracker.touch(bltable_key + flat_path);
 	return this->loaded_bltables.at(flat_path);
 }
 
 
 const std::shared_ptr<PaletteInfo> &AssetCache::get_palette(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
+	this->tracker.touch(palette_key + flat_path);
 	return this->loaded_palettes.at(flat_path);
 }
 
 
 const std::shared_ptr<TerrainInfo> &AssetCache::get_terrain(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
+	this->tracker.touch(terrain_key + flat_path);
 	return this->loaded_terrains.at(flat_path);
 }
 
 
 const std::shared_ptr<Texture2dInfo> &AssetCache::get_texture(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
+	this->tracker.touch(texture_key + flat_path);
 	return this->loaded_textures.at(flat_path);
 }
 
 
 void AssetCache::add_animation(const util::Path &path, const std::shared_ptr<Animation2dInfo> info) {
 	auto flat_path = path.resolve_native_path();
-	this->loaded_animations.insert({flat_path, info});
+	this->loaded_animations.insert_or_assign(flat_path, info);
+	this->tracker.add(animation_key + flat_path,
+	                  estimate_size(*info),
+	                  make_release(this->loaded_animations, flat_path));
+	this->tracker.evict();
 }
 
-
 void AssetCache::add_blpattern(const util::Path &path, const std::shared_ptr<BlendPatternInfo> info) {
 	auto flat_path = path.resolve_native_path();
-	this->loaded_blpatterns.insert({flat_path, info});
+	this->loaded_blpatterns.insert_or_assign(flat_path, info);
+	this->tracker.add(blpattern_key + flat_path,
+	                  estimate_size(*info),
+	                  make_release(this->loaded_blpatterns, flat_path));
+	this->tracker.evict();
 }
 
-
 void AssetCache::add_bltable(const util::Path &path, const std::shared_ptr<BlendTableInfo> info) {
 	auto flat_path = path.resolve_native_path();
-	this->loaded_bltables.insert({flat_path, info});
+	this->loaded_bltables.insert_or_assign(flat_path, info);
+	this->tracker.add(bltable_key + flat_path,
+	                  estimate_size(*info),
+	                  make_release(this->loaded_bltables, flat_path));
+	this->tracker.evict();
 }
 
-
 void AssetCache::add_palette(const util::Path &path, const std::shared_ptr<PaletteInfo> info) {
 	auto flat_path = path.resolve_native_path();
-	this->loaded_palettes.insert({flat_path, info});
+	this->loaded_palettes.insert_or_assign(flat_path, info);
+	this->tracker.add(palette_key + flat_path,
+	                  estimate_size(*info),
+	                  make_release(this->loaded_palettes, flat_path));
+	this->tracker.evict();
 }
 
-
 void AssetCache::add_terrain(const util::Path &path, const std::shared_ptr<TerrainInfo> info) {
 	auto flat_path = path.resolve_native_path();
-	this->loaded_terrains.insert({flat_path, info});
+	this->loaded_terrains.insert_or_assign(flat_path, info);
+	this->tracker.add(terrain_key + flat_path,
+	                  estimate_size(*info),
+	                  make_release(this->loaded_terrains, flat_path));
+	this->tracker.evict();
 }
 
 void AssetCache::add_texture(const util::Path &path, const std::shared_ptr<Texture2dInfo> info) {
 	auto flat_path = path.resolve_native_path();
-	this->loaded_textures.insert({flat_path, info});
+	this->loaded_textures.insert_or_assign(flat_path, info);
+	this->tracker.add(texture_key + flat_path,
+	                  estimate_size(*info),
+	                  make_release(this->loaded_textures, flat_path));
+	this->tracker.evict();
 }
 
 void AssetCache::remove_animation(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
 	this->loaded_animations.erase(flat_path);
+	this->tracker.remove(animation_key + flat_path);
 }
 
 void AssetCache::remove_blpattern(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
 	this->loaded_blpatterns.erase(flat_path);
+	this->tracker.remove(blpattern_key + flat_path);
 }
 
 void AssetCache::remove_bltable(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
 	this->loaded_bltables.erase(flat_path);
+	this->tracker.remove(bltable_key + flat_path);
 }
 
 void AssetCache::remove_palette(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
 	this->loaded_palettes.erase(flat_path);
+	this->tracker.remove(palette_key + flat_path);
 }
 
 void AssetCache::remove_terrain(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
 	this->loaded_terrains.erase(flat_path);
+	this->tracker.remove(terrain_key + flat_path);
 }
 
 void AssetCache::remove_texture(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
 	this->loaded_textures.erase(flat_path);
+	this->tracker.remove(texture_key + flat_path);
 }
 
 bool AssetCache::check_animation_cache(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
-	return this->loaded_animations.contains(flat_path);
+	bool cached = this->loaded_animations.contains(flat_path);
+	if (cached) {
+		this->tracker.record_hit();
+	}
+	else {
+		this->tracker.record_miss();
+	}
+	return cached;
 }
 
 bool AssetCache::check_blpattern_cache(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
-	return this->loaded_blpatterns.contains(flat_path);
+	bool cached = this->loaded_blpatterns.contains(flat_path);
+	if (cached) {
+		this->tracker.record_hit();
+	}
+	else {
+		this->tracker.record_miss();
+	}
+	return cached;
 }
 
 bool AssetCache::check_bltable_cache(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
-	return this->loaded_bltables.contains(flat_path);
+	bool cached = this->loaded_bltables.contains(flat_path);
+	if (cached) {
+		this->tracker.record_hit();
+	}
+	else {
+		this->tracker.record_miss();
+	}
+	return cached;
 }
 
 bool AssetCache::check_palette_cache(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
-	return this->loaded_palettes.contains(flat_path);
+	bool cached = this->loaded_palettes.contains(flat_path);
+	if (cached) {
+		this->tracker.record_hit();
+	}
+	else {
+		this->tracker.record_miss();
+	}
+	return cached;
 }
 
 bool AssetCache::check_terrain_cache(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
-	return this->loaded_terrains.contains(flat_path);
+	bool cached = this->loaded_terrains.contains(flat_path);
+	if (cached) {
+		this->tracker.record_hit();
+	}
+	else {
+		this->tracker.record_miss();
+	}
+	return cached;
 }
 
 bool AssetCache::check_texture_cache(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
-	return this->loaded_textures.contains(flat_path);
+	bool cached = this->loaded_textures.contains(flat_path);
+	if (cached) {
+		this->tracker.record_hit();
+	}
+	else {
+		this->tracker.record_miss();
+	}
+	return cached;
+}
+
+void AssetCache::set_budget(size_t budget) {
+	this->tracker.set_budget(budget);
+}
+
+void AssetCache::next_frame() {
+	this->tracker.next_frame();
+	this->tracker.evict();
+}
+
+const cache_stats &AssetCache::get_stats() const {
+	return this->tracker.get_stats();
 }
 
 } // namespace openage::renderer::resources
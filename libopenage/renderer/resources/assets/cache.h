@@ -6,6 +6,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "renderer/resources/assets/cache_tracker.h"
+
 
 namespace openage {
 namespace util {
@@ -25,15 +27,27 @@ class Texture2dInfo;
  *
  * Using the asset manager allows quick access to already loaded assets and avoids
  * creating unnecessary duplicates.
+ *
+ * The memory used by the cache can be limited by a budget. If the budget is exceeded,
+ * least recently used assets that are not referenced anymore are evicted.
  */
 class AssetCache {
 public:
 	/**
      * Create a new asset cache.
+     *
+     * @param budget Memory budget for cached assets (in bytes). 0 means unlimited.
      */
-	AssetCache() = default;
+	AssetCache(size_t budget = 0);
 	~AssetCache() = default;
 
+	/**
+     * Prevent copy or assignment because the release functions of the
+     * cache tracker reference the maps of this cache.
+     */
+	AssetCache(const AssetCache &) = delete;
+	AssetCache &operator=(const AssetCache &) = delete;
+
 	/**
      * Get the corresponding asset for the specified path.
      *
@@ -90,6 +104,26 @@ public:
 	bool check_terrain_cache(const util::Path &path);
 	bool check_texture_cache(const util::Path &path);
 
+	/**
+     * Set the memory budget for cached assets.
+     *
+     * @param budget Memory budget (in bytes). 0 means unlimited.
+     */
+	void set_budget(size_t budget);
+
+	/**
+     * Advance to the next frame and evict assets if the memory budget
+     * is exceeded.
+     */
+	void next_frame();
+
+	/**
+     * Get statistics about cache usage.
+     *
+     * @return Cache statistics.
+     */
+	const cache_stats &get_stats() const;
+
 private:
 	using anim_cache_t = std::unordered_map<std::string, std::shared_ptr<Animation2dInfo>>;
 	using blpattern_cache_t = std::unordered_map<std::string, std::shared_ptr<BlendPatternInfo>>;
@@ -127,6 +161,11 @@ private:
      * Cache of already loaded textures.
      */
 	texture_cache_t loaded_textures;
+
+	/**
+     * Tracks memory usage and last use of all cached assets.
+     */
+	CacheTracker tracker;
 };
 
 } // namespace renderer::resources
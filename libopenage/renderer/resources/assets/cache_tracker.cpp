@@ -0,0 +1,148 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "cache_tracker.h"
+
+
+namespace openage::renderer::resources {
+
+CacheTracker::CacheTracker(size_t budget) :
+	budget{budget},
+	frame{0},
+	lru{},
+	entries{},
+	stats{} {
+}
+
+void CacheTracker::set_budget(size_t budget) {
+	this->budget = budget;
+}
+
+size_t CacheTracker::get_budget() const {
+	return this->budget;
+}
+
+void CacheTracker::add(const std::string &key,
+                       size_t size,
+                       const release_func_t &release) {
+	auto it = this->entries.find(key);
+	if (it != this->entries.end()) {
+		// replace the existing entry, but keep its pin state
+		auto &ent = *it->second;
+		this->stats.bytes -= ent.size;
+		this->stats.bytes += size;
+		ent.size = size;
+		ent.last_used = this->frame;
+		ent.release = release;
+		this->lru.splice(this->lru.begin(), this->lru, it->second);
+		return;
+	}
+
+	this->lru.push_front(entry{key, size, this->frame, false, release});
+	this->entries.insert({key, this->lru.begin()});
+
+	this->stats.bytes += size;
+	this->stats.entries += 1;
+}
+
+void CacheTracker::remove(const std::string &key) {
+	auto it = this->entries.find(key);
+	if (it == this->entries.end()) {
+		return;
+	}
+
+	this->stats.bytes -= it->second->size;
+	this->stats.entries -= 1;
+
+	this->lru.erase(it->second);
+	this->entries.erase(it);
+}
+
+void CacheTracker::touch(const std::string &key) {
+	auto it = this->entries.find(key);
+	if (it == this->entries.end()) {
+		return;
+	}
+
+	it->second->last_used = this->frame;
+	this->lru.splice(this->lru.begin(), this->lru, it->second);
+}
+
+void CacheTracker::set_pinned(const std::string &key, bool pinned) {
+	auto it = this->entries.find(key);
+	if (it == this->entries.end()) {
+		return;
+	}
+
+	it->second->pinned = pinned;
+}
+
+bool CacheTracker::contains(const std::string &key) const {
+	return this->entries.contains(key);
+}
+
+void CacheTracker::record_hit() {
+	this->stats.hits += 1;
+}
+
+void CacheTracker::record_miss() {
+	this->stats.misses += 1;
+}
+
+void CacheTracker::next_frame() {
+	this->frame += 1;
+}
+
+size_t CacheTracker::get_frame() const {
+	return this->frame;
+}
+
+size_t CacheTracker::evict() {
+	if (this->budget == 0) {
+		// unlimited
+		return 0;
+	}
+
+	size_t evicted = 0;
+
+	// walk from the least recently used entry to the most recently used one
+	auto it = this->lru.end();
+	while (this->stats.bytes > this->budget and it != this->lru.begin()) {
+		--it;
+
+		if (it->last_used == this->frame) {
+			// all remaining entries were used in this frame
+			break;
+		}
+
+		if (it->pinned) {
+			continue;
+		}
+
+		if (not it->release()) {
+			// still referenced by someone else
+			continue;
+		}
+
+		this->stats.bytes -= it->size;
+		this->stats.entries -= 1;
+		this->stats.evictions += 1;
+		evicted += 1;
+
+		this->entries.erase(it->key);
+		it = this->lru.erase(it);
+	}
+
+	return evicted;
+}
+
+const cache_stats &CacheTracker::get_stats() const {
+	return this->stats;
+}
+
+void CacheTracker::reset_stats() {
+	this->stats.hits = 0;
+	this->stats.misses = 0;
+	this->stats.evictions = 0;
+}
+
+} // namespace openage::renderer::resources
@@ -0,0 +1,205 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+
+namespace openage::renderer::resources {
+
+/**
+ * Statistics about the usage of a resource cache.
+ */
+struct cache_stats {
+	/// Number of requests that could be served from the cache.
+	size_t hits = 0;
+	/// Number of requests that required loading the resource.
+	size_t misses = 0;
+	/// Number of entries that were evicted to stay within the memory budget.
+	size_t evictions = 0;
+	/// Sum of the (estimated) sizes of all cached entries (in bytes).
+	size_t bytes = 0;
+	/// Number of cached entries.
+	size_t entries = 0;
+};
+
+
+/**
+ * Keeps track of the memory used by the entries of a resource cache and
+ * decides which entries should be evicted when a memory budget is exceeded.
+ *
+ * The tracker does not store the cached resources itself. Instead, the owning
+ * cache registers its entries with a size and a callback that releases
+ * the resource. Entries are ordered by their last use (LRU). Eviction only
+ * considers entries that were not used in the current frame and that
+ * are not pinned.
+ */
+class CacheTracker {
+public:
+	/**
+	 * Callback that removes an entry from the owning cache.
+	 *
+	 * @return true if the entry was removed, false if the entry is still
+	 *         in use and must be kept.
+	 */
+	using release_func_t = std::function<bool()>;
+
+	/**
+	 * Create a new cache tracker.
+	 *
+	 * @param budget Memory budget in bytes. 0 means unlimited.
+	 */
+	CacheTracker(size_t budget = 0);
+	~CacheTracker() = default;
+
+	/**
+	 * Set the memory budget. Entries are evicted on the next call to
+	 * \p evict() if the new budget is exceeded.
+	 *
+	 * @param budget Memory budget in bytes. 0 means unlimited.
+	 */
+	void set_budget(size_t budget);
+
+	/**
+	 * Get the memory budget.
+	 *
+	 * @return Memory budget in bytes. 0 means unlimited.
+	 */
+	size_t get_budget() const;
+
+	/**
+	 * Register a new entry. The entry counts as used in the current frame.
+	 * Overwrites the size and release callback if the key is already tracked.
+	 *
+	 * @param key Unique key of the entry.
+	 * @param size Size of the entry (in bytes).
+	 * @param release Callback that removes the entry from the owning cache.
+	 */
+	void add(const std::string &key,
+	         size_t size,
+	         const release_func_t &release);
+
+	/**
+	 * Stop tracking an entry. This does not call the release callback.
+	 *
+	 * @param key Key of the entry.
+	 */
+	void remove(const std::string &key);
+
+	/**
+	 * Mark an entry as used in the current frame.
+	 *
+	 * @param key Key of the entry.
+	 */
+	void touch(const std::string &key);
+
+	/**
+	 * Pin or unpin an entry. Pinned entries are never evicted.
+	 *
+	 * @param key Key of the entry.
+	 * @param pinned true to pin the entry, false to unpin it.
+	 */
+	void set_pinned(const std::string &key, bool pinned);
+
+	/**
+	 * Check if an entry is tracked.
+	 *
+	 * @param key Key of the entry.
+	 *
+	 * @return true if the entry is tracked, else false.
+	 */
+	bool contains(const std::string &key) const;
+
+	/**
+	 * Count a cache hit in the statistics.
+	 */
+	void record_hit();
+
+	/**
+	 * Count a cache miss in the statistics.
+	 */
+	void record_miss();
+
+	/**
+	 * Advance to the next frame. Entries used in the previous frame become
+	 * candidates for eviction.
+	 */
+	void next_frame();
+
+	/**
+	 * Get the current frame number.
+	 *
+	 * @return Frame number.
+	 */
+	size_t get_frame() const;
+
+	/**
+	 * Evict least recently used entries until the memory used by the cache
+	 * is within the budget or no more entries can be evicted.
+	 *
+	 * @return Number of evicted entries.
+	 */
+	size_t evict();
+
+	/**
+	 * Get the cache statistics.
+	 *
+	 * @return Cache statistics.
+	 */
+	const cache_stats &get_stats() const;
+
+	/**
+	 * Reset the hit, miss and eviction counters.
+	 */
+	void reset_stats();
+
+private:
+	/**
+	 * Bookkeeping information of a cached entry.
+	 */
+	struct entry {
+		/// Key of the entry in the owning cache.
+		std::string key;
+		/// Size of the entry (in bytes).
+		size_t size;
+		/// Frame in which the entry was last used.
+		size_t last_used;
+		/// Whether the entry may be evicted.
+		bool pinned;
+		/// Removes the entry from the owning cache.
+		release_func_t release;
+	};
+
+	using lru_list_t = std::list<entry>;
+
+	/**
+	 * Memory budget in bytes. 0 means unlimited.
+	 */
+	size_t budget;
+
+	/**
+	 * Current frame number.
+	 */
+	size_t frame;
+
+	/**
+	 * Tracked entries. The most recently used entry is at the front.
+	 */
+	lru_list_t lru;
+
+	/**
+	 * Lookup of entries in the LRU list by key.
+	 */
+	std::unordered_map<std::string, lru_list_t::iterator> entries;
+
+	/**
+	 * Usage statistics.
+	 */
+	cache_stats stats;
+};
+
+} // namespace openage::renderer::resources
@@ -0,0 +1,195 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "error/error.h"
+#include "testing/temp_dir.h"
+#include "testing/testing.h"
+#include "util/path.h"
+#include "util/vector.h"
+
+#include "renderer/null/renderer.h"
+#include "renderer/resources/assets/asset_manager.h"
+#include "renderer/resources/assets/cache_tracker.h"
+#include "renderer/resources/assets/texture_manager.h"
+#include "renderer/resources/texture_data.h"
+#include "renderer/resources/texture_info.h"
+#include "renderer/texture.h"
+
+
+namespace openage::renderer::resources::tests {
+
+void cache_tracker() {
+	CacheTracker tracker{250};
+	std::vector<std::string> released;
+
+	auto release = [&](const std::string &key) {
+		return [&released, key]() {
+			released.push_back(key);
+			return true;
+		};
+	};
+
+	tracker.add("a", 100, release("a"));
+	tracker.add("b", 100, release("b"));
+	tracker.add("c", 100, release("c"));
+
+	// everything was used in the current frame
+	TESTEQUALS(tracker.evict(), 0);
+	TESTEQUALS(tracker.get_stats().bytes, 300);
+	TESTEQUALS(tracker.get_stats().entries, 3);
+
+	// "a" is the least recently used entry after this
+	tracker.next_frame();
+	tracker.touch("c");
+	tracker.touch("b");
+
+	TESTEQUALS(tracker.evict(), 1);
+	TESTEQUALS(released.size(), 1);
+	TESTEQUALS(released[0], "a");
+	(not tracker.contains("a")) or TESTFAIL;
+	TESTEQUALS(tracker.get_stats().bytes, 200);
+	TESTEQUALS(tracker.get_stats().evictions, 1);
+
+	// pinned entries are never evicted
+	tracker.set_pinned("c", true);
+	tracker.set_budget(50);
+	tracker.next_frame();
+	TESTEQUALS(tracker.evict(), 1);
+	TESTEQUALS(released[1], "b");
+	tracker.contains("c") or TESTFAIL;
+
+	// entries that are still in use are skipped
+	tracker.set_pinned("c", false);
+	tracker.add("d", 100, []() { return false; });
+	tracker.next_frame();
+	TESTEQUALS(tracker.evict(), 1);
+	TESTEQUALS(released[2], "c");
+	tracker.contains("d") or TESTFAIL;
+	TESTEQUALS(tracker.get_stats().bytes, 100);
+
+	// unlimited budget
+	tracker.set_budget(0);
+	tracker.add("e", 1000, release("e"));
+	tracker.next_frame();
+	TESTEQUALS(tracker.evict(), 0);
+
+	tracker.remove("e");
+	TESTEQUALS(tracker.get_stats().bytes, 100);
+	TESTEQUALS(tracker.get_stats().entries, 1);
+}
+
+
+void texture_manager() {
+	testing::TempDir tmpdir{"texcache"};
+	auto root = tmpdir.get_path();
+	std::vector<util::Path> paths;
+	for (size_t i = 0; i < 4; ++i) {
+		auto path = root / ("tex_" + std::to_string(i) + ".png");
+		path.touch();
+		paths.push_back(path);
+	}
+
+	auto renderer = std::make_shared<null::NullRenderer>(util::Vector2s{64, 64});
+
+	// 64x64 RGBA textures use 16 KiB each
+	const size_t tex_size = 64 * 64 * 4;
+	TextureManager manager{renderer, 3 * tex_size};
+
+	for (auto &path : paths) {
+		manager.add(path, renderer->add_texture(resources::Texture2dInfo{64, 64, resources::pixel_format::rgba8}));
+	}
+
+	// textures added in the current frame are never evicted
+	TESTEQUALS(manager.get_stats().entries, 4);
+	TESTEQUALS(manager.get_stats().bytes, 4 * tex_size);
+
+	// only textures 1, 2 and 3 are requested in the next frame
+	manager.next_frame();
+	TESTEQUALS(manager.get_stats().evictions, 1);
+	TESTEQUALS(manager.get_stats().bytes, 3 * tex_size);
+
+	manager.request(paths[1]);
+	manager.request(paths[2]);
+	manager.request(paths[3]);
+	TESTEQUALS(manager.get_stats().hits, 3);
+	TESTEQUALS(manager.get_stats().misses, 0);
+
+	// textures that are still referenced outside of the cache are kept
+	auto held = manager.request(paths[1]);
+	manager.set_pinned(paths[2]);
+	manager.set_budget(tex_size);
+	manager.next_frame();
+	TESTEQUALS(manager.get_stats().entries, 2);
+	TESTEQUALS(manager.get_stats().evictions, 2);
+
+	held.reset();
+	manager.set_pinned(paths[2], false);
+	manager.next_frame();
+	TESTEQUALS(manager.get_stats().entries, 1);
+	TESTEQUALS(manager.get_stats().bytes, tex_size);
+}
+
+
+void indexed_textures() {
+	testing::TempDir tmpdir{"palettes"};
+	auto root = tmpdir.get_path();
+
+	auto write = [](const util::Path &path, const std::string &content) {
+		auto file = path.open_w();
+		file.write(content);
+		file.close();
+	};
+
+	write(root / "unit.texture",
+	      "version 1\n"
+	      "imagefile \"unit.ctex\"\n"
+	      "size 4 4\n"
+	      "pxformat r8\n"
+	      "subtex 0 0 4 4 2 2\n");
+
+	auto renderer = std::make_shared<null::NullRenderer>(util::Vector2s{64, 64});
+	AssetManager manager{renderer, root};
+
+	// without palettes, only the raw indices could be drawn
+	TESTTHROWS(manager.request_texture(root / "unit.texture"));
+	TESTEQUALS(manager.load_palettes(root / "palettes"), false);
+	(manager.get_palette_lut() == nullptr) or TESTFAIL;
+
+	(root / "palettes").mkdirs();
+	write(root / "palettes" / "base.opal",
+	      "version 1\n"
+	      "entries 3\n"
+	      "colours [\n"
+	      "0 0 0 0\n"
+	      "255 255 255 255\n"
+	      "200 0 0 255\n"
+	      "]\n");
+	for (auto name : {"player1.opal", "player2.opal"}) {
+		write(root / "palettes" / name,
+		      "version 1\n"
+		      "entries 1\n"
+		      "colours [\n"
+		      "0 0 200 255\n"
+		      "]\n");
+	}
+
+	// one row for the base palette and one for each player
+	TESTEQUALS(manager.load_palettes(root / "palettes", 2), true);
+	(manager.get_palette_lut() != nullptr) or TESTFAIL;
+	TESTEQUALS(manager.get_palette_lut()->get_info().get_size().second, 3);
+
+	auto &info = manager.request_texture(root / "unit.texture");
+	(info->get_format() == pixel_format::r8) or TESTFAIL;
+}
+
+
+void asset_cache() {
+	cache_tracker();
+	texture_manager();
+	indexed_textures();
+}
+
+} // namespace openage::renderer::resources::tests
@@ -4,22 +4,32 @@
 
 #include "renderer/renderer.h"
 #include "renderer/resources/texture_data.h"
+#include "renderer/texture.h"
 
 
 namespace openage::renderer::resources {
 
-TextureManager::TextureManager(const std::shared_ptr<Renderer> &renderer) :
+TextureManager::TextureManager(const std::shared_ptr<Renderer> &renderer,
+                               size_t budget) :
 	renderer{renderer},
-	loaded{} {
+	loaded{},
+	tracker{budget} {
 }
 
 const std::shared_ptr<Texture2d> &TextureManager::request(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
-	if (not this->loaded.contains(flat_path)) {
-		// create if not loaded
-		auto tex_data = resources::Texture2dData(path);
-		this->loaded.insert({flat_path, this->renderer->add_texture(tex_data)});
+	auto cached = this->loaded.find(flat_path);
+	if (cached != this->loaded.end()) {
+		this->tracker.record_hit();
+		this->tracker.touch(flat_path);
+		return cached->second;
 	}
+
+	// create if not loaded
+	this->tracker.record_miss();
+	auto tex_data = resources::Texture2dData(path);
+	this->insert(flat_path, this->renderer->add_texture(tex_data));
+
 	return this->loaded.at(flat_path);
 }
 
@@ -28,19 +38,20 @@ void TextureManager::add(const util::Path &path) {
 	if (not this->loaded.contains(flat_path)) {
 		// create if not loaded
 		auto tex_data = resources::Texture2dData(path);
-		this->loaded.insert({flat_path, this->renderer->add_texture(tex_data)});
+		this->insert(flat_path, this->renderer->add_texture(tex_data));
 	}
 }
 
 void TextureManager::add(const util::Path &path,
                          const std::shared_ptr<Texture2d> &texture) {
 	auto flat_path = path.resolve_native_path();
-	this->loaded.insert({flat_path, texture});
+	this->insert(flat_path, texture);
 }
 
 void TextureManager::remove(const util::Path &path) {
 	auto flat_path = path.resolve_native_path();
 	this->loaded.erase(flat_path);
+	this->tracker.remove(flat_path);
 }
 
 void TextureManager::set_placeholder(const util::Path &path) {
@@ -52,4 +63,48 @@ const TextureManager::placeholder_t &TextureManager::get_placeholder() const {
 	return this->placeholder;
 }
 
+void TextureManager::set_pinned(const util::Path &path, bool pinned) {
+	auto flat_path = path.resolve_native_path();
+	this->tracker.set_pinned(flat_path, pinned);
+}
+
+void TextureManager::set_budget(size_t budget) {
+	this->tracker.set_budget(budget);
+}
+
+void TextureManager::next_frame() {
+	this->tracker.next_frame();
+	this->tracker.evict();
+}
+
+const cache_stats &TextureManager::get_stats() const {
+	return this->tracker.get_stats();
+}
+
+void TextureManager::insert(const std::string &flat_path,
+                            const std::shared_ptr<Texture2d> &texture) {
+	this->loaded.insert_or_assign(flat_path, texture);
+
+	auto release = [this, flat_path]() {
+		auto it = this->loaded.find(flat_path);
+		if (it == this->loaded.end()) {
+			return true;
+		}
+
+		// the texture is still used outside of the cache,
+		// so evicting it would not free any memory
+		if (it->second.use_count() > 1) {
+			return false;
+		}
+
+		this->loaded.erase(it);
+		return true;
+	};
+	this->tracker.add(flat_path, texture->get_info().get_data_size(), release);
+
+	// textures requested in this frame are never evicted here, so
+	// references handed out in this frame stay valid
+	this->tracker.evict();
+}
+
 } // namespace openage::renderer::resources
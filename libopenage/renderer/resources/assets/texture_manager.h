@@ -5,9 +5,10 @@
 #include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
 #include <utility>
 
+#include "datastructure/flat_hash_map.h"
+#include "renderer/resources/assets/cache_tracker.h"
 #include "util/path.h"
 
 
@@ -29,8 +30,10 @@ public:
      * Create a new texture manager.
      *
      * @param renderer The openage renderer instance.
+     * @param budget Memory budget for cached textures (in bytes). 0 means unlimited.
      */
-	TextureManager(const std::shared_ptr<Renderer> &renderer);
+	TextureManager(const std::shared_ptr<Renderer> &renderer,
+	               size_t budget = 0);
 	~TextureManager() = default;
 
 	/**
@@ -93,19 +96,67 @@ public:
      */
 	const placeholder_t &get_placeholder() const;
 
+	/**
+     * Pin or unpin a cached texture. Pinned textures are never evicted.
+     *
+     * @param path Path to the texture resource.
+     * @param pinned true to pin the texture, false to unpin it.
+     */
+	void set_pinned(const util::Path &path, bool pinned = true);
+
+	/**
+     * Set the memory budget for cached textures. If the budget is exceeded,
+     * least recently used textures that were not requested in the current
+     * frame are evicted.
+     *
+     * @param budget Memory budget (in bytes). 0 means unlimited.
+     */
+	void set_budget(size_t budget);
+
+	/**
+     * Advance to the next frame and evict textures if the memory budget
+     * is exceeded.
+     *
+     * Should be called once per frame after all textures for the frame
+     * have been requested.
+     */
+	void next_frame();
+
+	/**
+     * Get statistics about cache usage.
+     *
+     * @return Cache statistics.
+     */
+	const cache_stats &get_stats() const;
+
 private:
+	/**
+     * Insert a texture into the cache and account for its size.
+     *
+     * @param flat_path Resolved path of the texture resource.
+     * @param texture Texture object.
+     */
+	void insert(const std::string &flat_path,
+	            const std::shared_ptr<Texture2d> &texture);
+
 	/**
      * openage renderer.
      */
 	std::shared_ptr<Renderer> renderer;
 
-	using texture_cache_t = std::unordered_map<std::string, std::shared_ptr<Texture2d>>;
+	// node map, because request() returns references to the cached textures
+	using texture_cache_t = datastructure::NodeHashMap<std::string, std::shared_ptr<Texture2d>>;
 
 	/**
      * Cache of already created textures.
      */
 	texture_cache_t loaded;
 
+	/**
+     * Tracks memory usage and last use of the cached textures.
+     */
+	CacheTracker tracker;
+
 	/**
      * Placeholder texture to use if a texture could not be loaded.
      */
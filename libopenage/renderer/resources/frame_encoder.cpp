@@ -0,0 +1,150 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "frame_encoder.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include <png.h>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+#include "renderer/resources/texture_data.h"
+
+
+namespace openage::renderer::resources {
+
+namespace {
+
+/**
+ * Check that texture data can be encoded.
+ */
+void check_rgba(const Texture2dData &data) {
+	if (data.get_info().get_format() != pixel_format::rgba8) {
+		throw Error(MSG(err) << "Only RGBA textures can be encoded as frames.");
+	}
+}
+
+/**
+ * Store the libpng error message and return to the setjmp point.
+ * The error pointer of the write struct is the message string.
+ */
+void png_error_fn(png_structp png_ptr, png_const_charp message) {
+	auto error = static_cast<std::string *>(png_get_error_ptr(png_ptr));
+	*error = message;
+	png_longjmp(png_ptr, 1);
+}
+
+void png_warning_fn(png_structp /* png_ptr */, png_const_charp message) {
+	log::log(MSG(warn) << "libpng warning: " << message);
+}
+
+/**
+ * Append encoded data to the output buffer.
+ * The io pointer of the write struct is the output buffer.
+ */
+void png_write_fn(png_structp png_ptr, png_bytep data, png_size_t length) {
+	auto out = static_cast<std::vector<uint8_t> *>(png_get_io_ptr(png_ptr));
+	out->insert(out->end(), data, data + length);
+}
+
+void png_flush_fn(png_structp /* png_ptr */) {}
+
+} // namespace
+
+
+std::vector<uint8_t> encode_png(const Texture2dData &data,
+                                bool flip_y,
+                                int compression_level) {
+	check_rgba(data);
+
+	auto [width, height] = data.get_info().get_size();
+	size_t row_size = data.get_info().get_row_size();
+	const uint8_t *pixels = data.get_data();
+
+	std::vector<uint8_t> out;
+	std::string error;
+
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING,
+	                                              &error,
+	                                              png_error_fn,
+	                                              png_warning_fn);
+	if (png_ptr == nullptr) {
+		throw Error(MSG(err) << "Could not create the PNG write struct.");
+	}
+
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	if (info_ptr == nullptr) {
+		png_destroy_write_struct(&png_ptr, nullptr);
+		throw Error(MSG(err) << "Could not create the PNG info struct.");
+	}
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		throw Error(MSG(err) << "Encoding PNG failed: " << error);
+	}
+
+	png_set_write_fn(png_ptr, &out, png_write_fn, png_flush_fn);
+	png_set_IHDR(png_ptr, info_ptr, width, height, 8, PNG_COLOR_TYPE_RGB,
+	             PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+	             PNG_FILTER_TYPE_DEFAULT);
+	png_set_compression_level(png_ptr, compression_level);
+	png_write_info(png_ptr, info_ptr);
+
+	// the alpha channel is stripped while writing the rows
+	png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
+
+	// flipping is done by the row order, so the pixels are not copied
+	for (int32_t y = 0; y < height; ++y) {
+		int32_t row = flip_y ? height - 1 - y : y;
+		png_write_row(png_ptr, pixels + row * row_size);
+	}
+
+	png_write_end(png_ptr, nullptr);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+
+	return out;
+}
+
+
+Texture2dData decode_png(const std::vector<uint8_t> &png) {
+	png_image image{};
+	image.version = PNG_IMAGE_VERSION;
+
+	if (not png_image_begin_read_from_memory(&image, png.data(), png.size())) {
+		throw Error(MSG(err) << "Decoding PNG failed: " << image.message);
+	}
+
+	image.format = PNG_FORMAT_RGBA;
+
+	Texture2dInfo info{image.width, image.height, pixel_format::rgba8};
+	std::vector<uint8_t> pixels(info.get_data_size());
+
+	if (not png_image_finish_read(&image, nullptr, pixels.data(), info.get_row_size(), nullptr)) {
+		png_image_free(&image);
+		throw Error(MSG(err) << "Decoding PNG failed: " << image.message);
+	}
+
+	return Texture2dData{info, std::move(pixels)};
+}
+
+
+void write_raw_frame(std::ostream &out,
+                     const Texture2dData &data,
+                     bool flip_y) {
+	check_rgba(data);
+
+	auto [width, height] = data.get_info().get_size();
+	size_t row_size = data.get_info().get_row_size();
+	size_t pixel_row_size = width * 4;
+	const uint8_t *pixels = data.get_data();
+
+	for (int32_t y = 0; y < height; ++y) {
+		int32_t row = flip_y ? height - 1 - y : y;
+		out.write(reinterpret_cast<const char *>(pixels + row * row_size), pixel_row_size);
+	}
+}
+
+} // namespace openage::renderer::resources
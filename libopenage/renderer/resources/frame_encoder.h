@@ -0,0 +1,55 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+
+namespace openage::renderer::resources {
+class Texture2dData;
+
+/**
+ * Default zlib compression level of encoded PNGs.
+ * Screenshots favour encoding speed over file size.
+ */
+constexpr int PNG_DEFAULT_COMPRESSION = 3;
+
+/**
+ * Encode RGBA texture data as RGB PNG image. The alpha channel is dropped.
+ *
+ * @param data Texture data in \p pixel_format::rgba8 format.
+ * @param flip_y If true, the rows are stored bottom-up, e.g. for pixels read back from OpenGL.
+ * @param compression_level zlib compression level from 0 (none) to 9 (best).
+ *
+ * @return Contents of the PNG file.
+ */
+std::vector<uint8_t> encode_png(const Texture2dData &data,
+                                bool flip_y = false,
+                                int compression_level = PNG_DEFAULT_COMPRESSION);
+
+/**
+ * Decode a PNG image into RGBA texture data.
+ *
+ * This is mostly useful for testing encoded screenshots.
+ *
+ * @param png Contents of the PNG file.
+ *
+ * @return Texture data in \p pixel_format::rgba8 format.
+ */
+Texture2dData decode_png(const std::vector<uint8_t> &png);
+
+/**
+ * Write the pixels of RGBA texture data as one frame of a raw RGBA frame sequence.
+ * Rows are written top-down without any padding or header.
+ *
+ * @param out Output stream.
+ * @param data Texture data in \p pixel_format::rgba8 format.
+ * @param flip_y If true, the rows of \p data are stored bottom-up and are flipped while writing.
+ */
+void write_raw_frame(std::ostream &out,
+                     const Texture2dData &data,
+                     bool flip_y = false);
+
+} // namespace openage::renderer::resources
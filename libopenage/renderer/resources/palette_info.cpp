@@ -17,11 +17,11 @@ PaletteInfo::PaletteInfo(const std::vector<uint8_t> &colors) :
 PaletteInfo::PaletteInfo(const std::vector<Eigen::Vector4f> &colors) :
 	colors{colors} {}
 
-Eigen::Vector4f PaletteInfo::get_color(size_t idx) {
+Eigen::Vector4f PaletteInfo::get_color(size_t idx) const {
 	return this->colors[idx];
 }
 
-const std::vector<Eigen::Vector4f> PaletteInfo::get_colors() {
+const std::vector<Eigen::Vector4f> PaletteInfo::get_colors() const {
 	return this->colors;
 }
 
@@ -38,14 +38,14 @@ public:
      *
      * @return Normalized RGBA color vector.
      */
-	Eigen::Vector4f get_color(size_t idx);
+	Eigen::Vector4f get_color(size_t idx) const;
 
 	/**
      * Get the colors of the palette.
      *
      * @return List of normalized RGBA colors.
      */
-	const std::vector<Eigen::Vector4f> get_colors();
+	const std::vector<Eigen::Vector4f> get_colors() const;
 
 private:
 	/**
@@ -0,0 +1,249 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "palette_lookup.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <unordered_map>
+
+#include "error/error.h"
+#include "log/message.h"
+#include "renderer/resources/palette_info.h"
+#include "renderer/resources/texture_data.h"
+#include "renderer/resources/texture_info.h"
+#include "renderer/resources/texture_subinfo.h"
+
+
+namespace openage::renderer::resources {
+
+namespace {
+
+using color_t = std::array<uint8_t, 4>;
+
+/**
+ * Convert the normalized colors of a palette back to RGBA bytes.
+ *
+ * Palette colors are normalized by 256 when they are parsed, so this
+ * is the exact inverse for every value in [0, 255].
+ */
+std::vector<color_t> palette_bytes(const PaletteInfo &palette) {
+	std::vector<color_t> result;
+	for (auto &color : palette.get_colors()) {
+		color_t bytes;
+		for (size_t ch = 0; ch < 4; ++ch) {
+			auto value = std::lround(color[ch] * 256.0f);
+			bytes[ch] = static_cast<uint8_t>(std::clamp<long>(value, 0, 255));
+		}
+		result.push_back(bytes);
+	}
+
+	if (result.size() > PALETTE_LUT_WIDTH) {
+		throw Error(MSG(err) << "Palette has " << result.size() << " colors, "
+		                     << "but indexed textures support at most " << PALETTE_LUT_WIDTH << ".");
+	}
+
+	return result;
+}
+
+/**
+ * Pack a color into a single integer for hashing.
+ */
+uint32_t pack(const color_t &color) {
+	return static_cast<uint32_t>(color[0])
+	       | (static_cast<uint32_t>(color[1]) << 8)
+	       | (static_cast<uint32_t>(color[2]) << 16)
+	       | (static_cast<uint32_t>(color[3]) << 24);
+}
+
+/**
+ * Find the index of the palette color closest to the given color.
+ */
+uint8_t nearest_index(const std::vector<color_t> &colors, const color_t &color) {
+	size_t best = 0;
+	int best_dist = std::numeric_limits<int>::max();
+	for (size_t i = 0; i < colors.size(); ++i) {
+		int dist = 0;
+		for (size_t ch = 0; ch < 4; ++ch) {
+			int diff = static_cast<int>(colors[i][ch]) - color[ch];
+			dist += diff * diff;
+		}
+
+		if (dist < best_dist) {
+			best = i;
+			best_dist = dist;
+		}
+	}
+
+	return static_cast<uint8_t>(best);
+}
+
+/**
+ * Copy the subtexture information of a texture.
+ */
+std::vector<Texture2dSubInfo> copy_subtextures(const Texture2dInfo &info) {
+	std::vector<Texture2dSubInfo> subtextures;
+	for (size_t i = 0; i < info.get_subtex_count(); ++i) {
+		subtextures.push_back(info.get_subtex_info(i));
+	}
+	return subtextures;
+}
+
+} // namespace
+
+
+Texture2dData index_texture(const Texture2dData &data, const PaletteInfo &palette) {
+	auto &info = data.get_info();
+	if (info.get_format() != pixel_format::rgba8) {
+		throw Error(MSG(err) << "Only RGBA8 textures can be converted to palette indices.");
+	}
+
+	auto colors = palette_bytes(palette);
+	if (colors.empty()) {
+		throw Error(MSG(err) << "Cannot convert texture to palette indices: palette is empty.");
+	}
+
+	// exact matches; the first occurrence of a color wins
+	std::unordered_map<uint32_t, uint8_t> lookup;
+	for (size_t i = 0; i < colors.size(); ++i) {
+		lookup.try_emplace(pack(colors[i]), static_cast<uint8_t>(i));
+	}
+
+	auto size = info.get_size();
+	size_t width = size.first;
+	size_t height = size.second;
+
+	Texture2dInfo out_info{width, height, pixel_format::r8, info.get_image_path(), 1, copy_subtextures(info)};
+	std::vector<uint8_t> out(out_info.get_data_size());
+
+	size_t in_row = info.get_row_size();
+	size_t out_row = out_info.get_row_size();
+	for (size_t y = 0; y < height; ++y) {
+		const uint8_t *src = data.get_data() + y * in_row;
+		for (size_t x = 0; x < width; ++x) {
+			color_t color{src[x * 4], src[x * 4 + 1], src[x * 4 + 2], src[x * 4 + 3]};
+
+			auto key = pack(color);
+			auto match = lookup.find(key);
+			if (match == lookup.end()) {
+				// remember the result, sprites usually reuse few colors
+				match = lookup.emplace(key, nearest_index(colors, color)).first;
+			}
+
+			out[y * out_row + x] = match->second;
+		}
+	}
+
+	return Texture2dData{out_info, std::move(out)};
+}
+
+
+Texture2dData create_palette_lut(const PaletteInfo &palette,
+                                 const std::vector<PaletteInfo> &player_palettes,
+                                 size_t player_color_start) {
+	auto base = palette_bytes(palette);
+
+	size_t rows = player_palettes.size() + 1;
+	Texture2dInfo info{PALETTE_LUT_WIDTH, rows, pixel_format::rgba8, std::nullopt, 4};
+	std::vector<uint8_t> out(info.get_data_size(), 0);
+
+	size_t row_size = info.get_row_size();
+	for (size_t row = 0; row < rows; ++row) {
+		auto row_colors = base;
+		if (row > 0) {
+			auto player_colors = palette_bytes(player_palettes[row - 1]);
+			if (player_color_start + player_colors.size() > PALETTE_LUT_WIDTH) {
+				throw Error(MSG(err) << "Player colors of player " << row
+				                     << " do not fit into the palette lookup table.");
+			}
+
+			row_colors.resize(std::max(row_colors.size(), player_color_start + player_colors.size()));
+			std::copy(player_colors.begin(), player_colors.end(), row_colors.begin() + player_color_start);
+		}
+
+		uint8_t *dst = out.data() + row * row_size;
+		for (size_t i = 0; i < row_colors.size(); ++i) {
+			std::copy(row_colors[i].begin(), row_colors[i].end(), dst + i * 4);
+		}
+	}
+
+	return Texture2dData{info, std::move(out)};
+}
+
+
+Texture2dData apply_palette(const Texture2dData &data, const Texture2dData &lut, size_t row) {
+	auto &info = data.get_info();
+	if (info.get_format() != pixel_format::r8) {
+		throw Error(MSG(err) << "Only R8 textures contain palette indices.");
+	}
+
+	auto &lut_info = lut.get_info();
+	if (lut_info.get_format() != pixel_format::rgba8
+	    or static_cast<size_t>(lut_info.get_size().first) != PALETTE_LUT_WIDTH) {
+		throw Error(MSG(err) << "Texture is not a palette lookup table.");
+	}
+	if (row >= static_cast<size_t>(lut_info.get_size().second)) {
+		throw Error(MSG(err) << "Palette lookup table has no row " << row << ".");
+	}
+
+	auto size = info.get_size();
+	size_t width = size.first;
+	size_t height = size.second;
+
+	Texture2dInfo out_info{width, height, pixel_format::rgba8, info.get_image_path(), 4, copy_subtextures(info)};
+	std::vector<uint8_t> out(out_info.get_data_size());
+
+	const uint8_t *colors = lut.get_data() + row * lut_info.get_row_size();
+	size_t in_row = info.get_row_size();
+	size_t out_row = out_info.get_row_size();
+	for (size_t y = 0; y < height; ++y) {
+		const uint8_t *src = data.get_data() + y * in_row;
+		uint8_t *dst = out.data() + y * out_row;
+		for (size_t x = 0; x < width; ++x) {
+			std::copy_n(colors + src[x] * 4, 4, dst + x * 4);
+		}
+	}
+
+	return Texture2dData{out_info, std::move(out)};
+}
+
+
+double palette_memory_report::get_ratio() const {
+	size_t indexed_total = this->indexed_bytes + this->lut_bytes;
+	if (indexed_total == 0) {
+		return 1.0;
+	}
+	return static_cast<double>(this->rgba_bytes) / indexed_total;
+}
+
+
+palette_memory_report compare_palette_memory(const std::vector<Texture2dInfo> &textures,
+                                             const Texture2dInfo &lut) {
+	palette_memory_report report{textures.size(), 0, 0, lut.get_data_size()};
+
+	for (auto &info : textures) {
+		auto size = info.get_size();
+		size_t width = size.first;
+		size_t height = size.second;
+
+		report.rgba_bytes += Texture2dInfo{width, height, pixel_format::rgba8, std::nullopt, 4}.get_data_size();
+		report.indexed_bytes += Texture2dInfo{width, height, pixel_format::r8, std::nullopt, 1}.get_data_size();
+	}
+
+	return report;
+}
+
+
+std::ostream &operator<<(std::ostream &os, const palette_memory_report &report) {
+	os << report.textures << " textures: "
+	   << "RGBA " << report.rgba_bytes << " bytes, "
+	   << "indexed " << report.indexed_bytes << " bytes + "
+	   << report.lut_bytes << " bytes lookup table "
+	   << "(" << report.get_ratio() << "x smaller)";
+	return os;
+}
+
+} // namespace openage::renderer::resources
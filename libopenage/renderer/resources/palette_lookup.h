@@ -0,0 +1,101 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+
+namespace openage::renderer::resources {
+class PaletteInfo;
+class Texture2dData;
+class Texture2dInfo;
+
+/**
+ * Width of palette lookup tables (in pixels). Every possible
+ * index value of a \p pixel_format::r8 texture has its own column.
+ */
+constexpr size_t PALETTE_LUT_WIDTH = 256;
+
+/**
+ * Convert RGBA texture data into palette indices.
+ *
+ * Colors that are in the palette are mapped to their exact index. Other colors
+ * are mapped to the index of the nearest palette color (by euclidean
+ * distance in RGBA space).
+ *
+ * @param data Texture data in \p pixel_format::rgba8 format.
+ * @param palette Palette with at most \p PALETTE_LUT_WIDTH colors.
+ *
+ * @return Texture data in \p pixel_format::r8 format. The subtexture information is kept.
+ */
+Texture2dData index_texture(const Texture2dData &data, const PaletteInfo &palette);
+
+/**
+ * Create the palette lookup table used by the shaders to resolve the
+ * colors of indexed textures.
+ *
+ * The table has a row of \p PALETTE_LUT_WIDTH RGBA colors for every player. Row 0 contains
+ * the unmodified base palette. In row \p n (n > 0), the player color range of the
+ * base palette, i.e. the entries starting at \p player_color_start, is replaced
+ * by the colors of \p player_palettes[n - 1].
+ *
+ * @param palette Base palette with at most \p PALETTE_LUT_WIDTH colors.
+ * @param player_palettes Player color palettes.
+ * @param player_color_start Index of the first player color in the base palette.
+ *
+ * @return Lookup table texture data in \p pixel_format::rgba8 format.
+ */
+Texture2dData create_palette_lut(const PaletteInfo &palette,
+                                 const std::vector<PaletteInfo> &player_palettes = {},
+                                 size_t player_color_start = 0);
+
+/**
+ * Resolve the colors of an indexed texture on the CPU. This does the same lookup
+ * as the shaders and is mostly useful for testing and tools.
+ *
+ * @param data Texture data in \p pixel_format::r8 format.
+ * @param lut Palette lookup table created by \p create_palette_lut().
+ * @param row Row of the lookup table that is used, i.e. the player.
+ *
+ * @return Texture data in \p pixel_format::rgba8 format. The subtexture information is kept.
+ */
+Texture2dData apply_palette(const Texture2dData &data, const Texture2dData &lut, size_t row = 0);
+
+/**
+ * GPU memory required for a set of sprite textures stored as RGBA
+ * compared to storing them as palette indices.
+ */
+struct palette_memory_report {
+	/// Number of compared textures.
+	size_t textures;
+	/// Size of the textures in RGBA format (in bytes).
+	size_t rgba_bytes;
+	/// Size of the textures in indexed format (in bytes).
+	size_t indexed_bytes;
+	/// Size of the shared palette lookup table (in bytes).
+	size_t lut_bytes;
+
+	/**
+	 * Get the memory saving factor of the indexed textures.
+	 *
+	 * @return Ratio between RGBA size and indexed size including the lookup table.
+	 */
+	double get_ratio() const;
+};
+
+/**
+ * Compare the memory usage of the RGBA and the indexed texture path.
+ *
+ * @param textures Information about the sprite textures. Only the dimensions are used.
+ * @param lut Information about the palette lookup table.
+ *
+ * @return Memory report.
+ */
+palette_memory_report compare_palette_memory(const std::vector<Texture2dInfo> &textures,
+                                             const Texture2dInfo &lut);
+
+std::ostream &operator<<(std::ostream &os, const palette_memory_report &report);
+
+} // namespace openage::renderer::resources
@@ -66,8 +66,8 @@ BlendPatternInfo parse_blendmask_file(const util::Path &file,
 		                     << "' failed. Reason: File not found");
 	}
 
-	auto content = file.open();
-	auto lines = content.get_lines();
+	auto content = file.open_r().map();
+	auto lines = util::split_view(content.view(), '\n');
 
 	float scalefactor = 1.0;
 	std::vector<TextureData> textures;
@@ -99,7 +99,8 @@ BlendPatternInfo parse_blendmask_file(const util::Path &file,
 		if (line.empty() || line.substr(0, 1) == "#") {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		auto parts = util::split_view(line, ' ');
+		std::vector<std::string> args{parts.begin(), parts.end()};
 
 		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
 		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
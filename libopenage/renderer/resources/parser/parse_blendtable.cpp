@@ -75,8 +75,8 @@ BlendTableInfo parse_blendtable_file(const util::Path &file,
 		                     << "' failed. Reason: File not found");
 	}
 
-	auto content = file.open();
-	auto lines = content.get_lines();
+	auto content = file.open_r().map();
+	auto lines = util::split_view(content.view(), '\n');
 
 	std::vector<size_t> blendtable;
 	std::vector<PatternData> patterns;
@@ -105,7 +105,8 @@ BlendTableInfo parse_blendtable_file(const util::Path &file,
 		if (line.empty() || line.substr(0, 1) == "#") {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		auto parts = util::split_view(line, ' ');
+		std::vector<std::string> args{parts.begin(), parts.end()};
 
 		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
 		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
@@ -119,7 +120,7 @@ BlendTableInfo parse_blendtable_file(const util::Path &file,
 			// read all lines of the matrix
 			// TODO: better parsing for matrix values
 			std::vector<std::string> mat_lines{};
-			mat_lines.push_back(line);
+			mat_lines.emplace_back(line);
 
 			while (not line.starts_with("]")) {
 				i += 1;
@@ -130,7 +131,7 @@ BlendTableInfo parse_blendtable_file(const util::Path &file,
 					                     << args[0] << " is malformed");
 				}
 				line = lines[i];
-				mat_lines.push_back(line);
+				mat_lines.emplace_back(line);
 			}
 
 			keywordfuncs[args[0]](mat_lines);
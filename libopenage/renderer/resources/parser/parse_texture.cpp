@@ -42,6 +42,22 @@ static constexpr size_t guess_row_alignment(size_t width) {
 	return 4;
 }
 
+/**
+ * Check that an attribute has enough arguments before they are accessed.
+ *
+ * @param args Arguments from the line with the attribute.
+ *             The first argument is expected to be the attribute keyword.
+ * @param count Number of expected arguments, including the keyword.
+ *
+ * @throw Error if there are fewer arguments.
+ */
+static void check_arg_count(const std::vector<std::string> &args, size_t count) {
+	if (args.size() < count) [[unlikely]] {
+		throw Error(MSG(err) << "Attribute '" << args[0] << "' requires "
+		                     << count - 1 << " arguments, but has " << args.size() - 1);
+	}
+}
+
 /**
  * Parse the imagefile attribute.
  *
@@ -55,6 +71,8 @@ std::string parse_imagefile(const std::vector<std::string> &args) {
 	// space. While the space char is not allowed because of nyan naming requirements,
 	// it should result in an error if wrongly used here.
 
+	check_arg_count(args, 2);
+
 	// Call substr() to get rid of the quotes
 	return args[1].substr(1, args[1].size() - 2);
 }
@@ -68,6 +86,8 @@ std::string parse_imagefile(const std::vector<std::string> &args) {
  * @return Struct containing the attribute data.
  */
 SizeData parse_size(const std::vector<std::string> &args) {
+	check_arg_count(args, 3);
+
 	SizeData size;
 
 	size.width = std::stoul(args[1]);
@@ -85,14 +105,31 @@ SizeData parse_size(const std::vector<std::string> &args) {
  * @return Struct containing the attribute data.
  */
 PixelFormatData parse_pxformat(const std::vector<std::string> &args) {
+	check_arg_count(args, 2);
+
 	PixelFormatData pxformat;
 
-	// Only accepted format
-	pxformat.format = pixel_format::rgba8;
+	// Accepted formats
+	static const std::unordered_map<std::string, pixel_format> formats{
+		{"r8", pixel_format::r8},
+		{"rgba8", pixel_format::rgba8},
+		{"bc1", pixel_format::bc1},
+		{"bc3", pixel_format::bc3},
+	};
+
+	auto format = formats.find(args[1]);
+	if (format == formats.end()) [[unlikely]] {
+		throw Error(MSG(err) << "Pixel format " << args[1] << " is not supported");
+	}
+	pxformat.format = format->second;
 
 	// Optional arguments
 	auto keywordfuncs = std::unordered_map<std::string, std::function<void(std::vector<std::string>)>>{
 		std::make_pair("cbits", [&](std::vector<std::string> keywordargs) {
+			if (keywordargs.size() < 2) [[unlikely]] {
+				throw Error(MSG(err) << "Keyword argument 'cbits' of 'pxformat' attribute has no value");
+			}
+
 			if (keywordargs[1] == "True") {
 				pxformat.cbits = true;
 			}
@@ -106,9 +143,9 @@ PixelFormatData parse_pxformat(const std::vector<std::string> &args) {
 		std::vector<std::string> keywordargs{util::split(args[i], '=')};
 
 		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(keywordargs[0])) [[unlikely]] {
+		if (keywordargs.empty() or not keywordfuncs.contains(keywordargs[0])) [[unlikely]] {
 			throw Error(MSG(err) << "Keyword argument "
-			                     << keywordargs[0]
+			                     << args[i]
 			                     << " of 'pxformat' attribute is not defined");
 		}
 
@@ -127,6 +164,8 @@ PixelFormatData parse_pxformat(const std::vector<std::string> &args) {
  * @return Struct containing the attribute data.
  */
 SubtextureData parse_subtex(const std::vector<std::string> &args) {
+	check_arg_count(args, 7);
+
 	SubtextureData subtex;
 
 	subtex.xpos = std::stoi(args[1]);
@@ -146,8 +185,8 @@ Texture2dInfo parse_texture_file(const util::Path &file) {
 		                     << "' failed. Reason: File not found");
 	}
 
-	auto content = file.open();
-	auto lines = content.get_lines();
+	auto content = file.open_r().map();
+	auto lines = util::split_view(content.view(), '\n');
 
 	std::string imagefile;
 	SizeData size;
@@ -156,6 +195,7 @@ Texture2dInfo parse_texture_file(const util::Path &file) {
 
 	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
 		std::make_pair("version", [&](const std::vector<std::string> &args) {
+			check_arg_count(args, 2);
 			size_t version_no = parse_version(args);
 
 			if (version_no != 1) {
@@ -183,7 +223,8 @@ Texture2dInfo parse_texture_file(const util::Path &file) {
 		if (line.empty() || line.substr(0, 1) == "#") {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		auto parts = util::split_view(line, ' ');
+		std::vector<std::string> args{parts.begin(), parts.end()};
 
 		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
 		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
@@ -210,7 +251,10 @@ Texture2dInfo parse_texture_file(const util::Path &file) {
 
 	auto imagepath = file.get_parent() / imagefile;
 
-	auto align = guess_row_alignment(size.width);
+	// rows of compressed blocks and palette indices are not padded
+	auto align = (is_compressed(pxformat.format) or pxformat.format == pixel_format::r8)
+	                 ? 1
+	                 : guess_row_alignment(size.width);
 	return Texture2dInfo(size.width, size.height, pxformat.format, imagepath, align, std::move(subinfos));
 }
 
@@ -0,0 +1,450 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <eigen3/Eigen/Dense>
+
+#include "log/log.h"
+#include "log/message.h"
+#include "testing/temp_dir.h"
+#include "testing/testing.h"
+#include "util/path.h"
+
+#include "renderer/resources/frame_encoder.h"
+#include "renderer/resources/palette_info.h"
+#include "renderer/resources/palette_lookup.h"
+#include "renderer/resources/parser/parse_texture.h"
+#include "renderer/resources/texture_bundle.h"
+#include "renderer/resources/texture_compression.h"
+#include "renderer/resources/texture_data.h"
+#include "renderer/resources/texture_info.h"
+
+
+namespace openage::renderer::resources::tests {
+
+/**
+ * Create RGBA texture data from a pixel generator function.
+ */
+template <typename F>
+Texture2dData make_rgba_texture(size_t width, size_t height, F &&pixel_at) {
+	std::vector<uint8_t> pixels(width * height * 4);
+	for (size_t y = 0; y < height; ++y) {
+		for (size_t x = 0; x < width; ++x) {
+			auto pixel = pixel_at(x, y);
+			std::copy(pixel.begin(), pixel.end(), pixels.begin() + (y * width + x) * 4);
+		}
+	}
+
+	return Texture2dData{Texture2dInfo{width, height, pixel_format::rgba8, std::nullopt, 4},
+	                     std::move(pixels)};
+}
+
+/**
+ * Get the largest difference of a color channel between two RGBA textures.
+ */
+int max_channel_error(const Texture2dData &a, const Texture2dData &b, size_t channel) {
+	auto size = a.get_info().get_size();
+	size_t pixels = size.first * size.second;
+
+	int max_err = 0;
+	for (size_t i = 0; i < pixels; ++i) {
+		int err = std::abs(a.get_data()[i * 4 + channel] - b.get_data()[i * 4 + channel]);
+		max_err = std::max(max_err, err);
+	}
+	return max_err;
+}
+
+
+void texture_compression_sizes() {
+	Texture2dInfo bc1{10, 6, pixel_format::bc1};
+	TESTEQUALS(bc1.get_row_size(), 3 * 8);
+	TESTEQUALS(bc1.get_data_size(), 2 * 3 * 8);
+
+	Texture2dInfo bc3{64, 64, pixel_format::bc3};
+	TESTEQUALS(bc3.get_row_size(), 16 * 16);
+	TESTEQUALS(bc3.get_data_size(), 16 * 16 * 16);
+
+	is_compressed(pixel_format::bc1) or TESTFAIL;
+	(not is_compressed(pixel_format::rgba8)) or TESTFAIL;
+}
+
+
+void texture_compression_roundtrip() {
+	// colors that are exactly representable in RGB565
+	const std::array<uint8_t, 4> red{255, 0, 0, 255};
+	const std::array<uint8_t, 4> blue{0, 0, 255, 255};
+	const std::array<uint8_t, 4> grey{132, 130, 132, 255};
+	const std::array<uint8_t, 4> clear{0, 0, 0, 0};
+
+	// solid blocks with a size that is not a multiple of the block size
+	auto solid = make_rgba_texture(10, 7, [&](size_t x, size_t y) {
+		if (x < 4) {
+			return (y < 4) ? red : blue;
+		}
+		return (x < 8) ? grey : red;
+	});
+
+	for (auto fmt : {pixel_format::bc1, pixel_format::bc3}) {
+		auto compressed = compress_texture(solid, fmt);
+		(compressed.get_info().get_format() == fmt) or TESTFAIL;
+		TESTEQUALS(compressed.get_info().get_data_size(), 3 * 2 * block_size(fmt));
+
+		auto decoded = decompress_texture(compressed);
+		(decoded.get_info().get_format() == pixel_format::rgba8) or TESTFAIL;
+		for (size_t ch = 0; ch < 4; ++ch) {
+			TESTEQUALS(max_channel_error(solid, decoded, ch), 0);
+		}
+	}
+
+	// transparency: BC1 only keeps 1 bit alpha, BC3 interpolates
+	auto masked = make_rgba_texture(8, 8, [&](size_t x, size_t y) {
+		if ((x + y) % 3 == 0) {
+			return clear;
+		}
+		return grey;
+	});
+
+	auto bc1 = decompress_texture(compress_texture(masked, pixel_format::bc1));
+	TESTEQUALS(max_channel_error(masked, bc1, 3), 0);
+
+	auto bc3 = decompress_texture(compress_texture(masked, pixel_format::bc3));
+	TESTEQUALS(max_channel_error(masked, bc3, 3), 0);
+
+	// smooth gradients are approximated within a small error
+	auto gradient = make_rgba_texture(32, 32, [](size_t x, size_t y) {
+		return std::array<uint8_t, 4>{
+			static_cast<uint8_t>(x * 8),
+			static_cast<uint8_t>(y * 8),
+			static_cast<uint8_t>(128),
+			static_cast<uint8_t>(255 - x * 4)};
+	});
+
+	auto bc3_grad = decompress_texture(compress_texture(gradient, pixel_format::bc3));
+	for (size_t ch = 0; ch < 4; ++ch) {
+		(max_channel_error(gradient, bc3_grad, ch) <= 16) or TESTFAILMSG("channel " << ch << " error too large");
+	}
+
+	// uncompressed input is required
+	auto compressed = compress_texture(solid, pixel_format::bc1);
+	TESTTHROWS(compress_texture(compressed, pixel_format::bc3));
+	TESTTHROWS(compress_texture(solid, pixel_format::rgba8));
+}
+
+
+void texture_bundle_roundtrip() {
+	testing::TempDir tmpdir{"texbundle"};
+	auto root = tmpdir.get_path();
+	auto path = root / "test.ctex";
+
+	auto image = make_rgba_texture(16, 12, [](size_t x, size_t y) {
+		return std::array<uint8_t, 4>{
+			static_cast<uint8_t>(x * 16),
+			static_cast<uint8_t>(y * 16),
+			0,
+			255};
+	});
+	auto compressed = compress_texture(image, pixel_format::bc3);
+
+	write_texture_bundle(path, compressed);
+	is_texture_bundle(path) or TESTFAIL;
+
+	auto loaded = read_texture_bundle(path);
+	auto &info = loaded.get_info();
+	(info.get_format() == pixel_format::bc3) or TESTFAIL;
+	TESTEQUALS(info.get_size().first, 16);
+	TESTEQUALS(info.get_size().second, 12);
+	TESTEQUALS(info.get_subtex_count(), 1);
+	TESTEQUALS(info.get_data_size(), compressed.get_info().get_data_size());
+	TESTEQUALS(std::memcmp(loaded.get_data(), compressed.get_data(), info.get_data_size()), 0);
+
+	// the header is stored in little endian byte order
+	auto raw = path.open_r().read();
+	TESTEQUALS(raw.substr(0, 4), "OATX");
+	TESTEQUALS(static_cast<uint8_t>(raw[8]), 16);
+	TESTEQUALS(static_cast<uint8_t>(raw[12]), 12);
+
+	// pixel formats are stored with fixed IDs, bc3 is 8
+	TESTEQUALS(static_cast<uint8_t>(raw[6]), 8);
+	TESTEQUALS(static_cast<uint8_t>(raw[7]), 0);
+
+	// unknown format IDs are rejected
+	auto unknown = root / "unknown.ctex";
+	raw[6] = 42;
+	auto unknown_file = unknown.open_w();
+	unknown_file.write(raw);
+	unknown_file.close();
+	TESTTHROWS(read_texture_bundle(unknown));
+
+	// loading through the generic constructor must not decode the data
+	Texture2dData from_path{path};
+	(from_path.get_info().get_format() == pixel_format::bc3) or TESTFAIL;
+
+	// the bundle must match the texture info that references it
+	Texture2dInfo matching{16, 12, pixel_format::bc3, path, info.get_row_alignment()};
+	TESTEQUALS(Texture2dData{matching}.get_info().get_data_size(), info.get_data_size());
+	Texture2dInfo wrong_size{16, 16, pixel_format::bc3, path, info.get_row_alignment()};
+	TESTTHROWS(Texture2dData{wrong_size});
+	Texture2dInfo wrong_format{16, 12, pixel_format::bc1, path, info.get_row_alignment()};
+	TESTTHROWS(Texture2dData{wrong_format});
+}
+
+
+void texture_file_malformed() {
+	testing::TempDir tmpdir{"texfile"};
+	auto root = tmpdir.get_path();
+
+	auto parse = [&root](const std::string &content) {
+		auto path = root / "test.texture";
+		auto file = path.open_w();
+		file.write(content);
+		file.close();
+		return parser::parse_texture_file(path);
+	};
+
+	const std::string valid = "version 1\n"
+	                          "imagefile \"test.png\"\n"
+	                          "size 4 4\n"
+	                          "pxformat rgba8\n"
+	                          "subtex 0 0 4 4 2 2\n";
+	TESTEQUALS(parse(valid).get_subtex_count(), 1);
+
+	// attributes with missing arguments are errors
+	TESTTHROWS(parse("version\n"));
+	TESTTHROWS(parse("imagefile\n"));
+	TESTTHROWS(parse("size 4\n"));
+	TESTTHROWS(parse("pxformat\n"));
+	TESTTHROWS(parse("pxformat rgba8 cbits\n"));
+	TESTTHROWS(parse("subtex 0 0 4 4 2\n"));
+}
+
+
+void palette_lookup() {
+	// palette with 4 colors, index 2 and 3 are player colors
+	PaletteInfo palette{std::vector<uint8_t>{
+		0, 0, 0, 0,
+		255, 255, 255, 255,
+		200, 0, 0, 255,
+		100, 0, 0, 255,
+	}};
+	PaletteInfo blue{std::vector<uint8_t>{
+		0, 0, 200, 255,
+		0, 0, 100, 255,
+	}};
+
+	const std::array<uint8_t, 4> clear{0, 0, 0, 0};
+	const std::array<uint8_t, 4> white{255, 255, 255, 255};
+	const std::array<uint8_t, 4> red{200, 0, 0, 255};
+	const std::array<uint8_t, 4> dark_red{100, 0, 0, 255};
+	const std::array<uint8_t, 4> almost_white{250, 251, 255, 255};
+
+	auto image = make_rgba_texture(5, 3, [&](size_t x, size_t y) {
+		if (y == 2) {
+			return almost_white;
+		}
+		switch (x) {
+		case 0:
+			return clear;
+		case 1:
+			return white;
+		case 2:
+			return red;
+		default:
+			return dark_red;
+		}
+	});
+
+	// conversion to indices
+	auto indexed = index_texture(image, palette);
+	auto &info = indexed.get_info();
+	(info.get_format() == pixel_format::r8) or TESTFAIL;
+	TESTEQUALS(info.get_row_size(), 5);
+	TESTEQUALS(info.get_data_size(), 5 * 3);
+
+	const std::array<uint8_t, 5> row_indices{0, 1, 2, 3, 3};
+	for (size_t y = 0; y < 2; ++y) {
+		for (size_t x = 0; x < 5; ++x) {
+			TESTEQUALS(static_cast<int>(indexed.get_data()[y * 5 + x]), row_indices[x]);
+		}
+	}
+	// colors that are not in the palette use the nearest color
+	TESTEQUALS(static_cast<int>(indexed.get_data()[2 * 5]), 1);
+
+	// lookup table generation
+	auto lut = create_palette_lut(palette, {blue}, 2);
+	auto &lut_info = lut.get_info();
+	TESTEQUALS(lut_info.get_size().first, PALETTE_LUT_WIDTH);
+	TESTEQUALS(lut_info.get_size().second, 2);
+
+	const uint8_t *row0 = lut.get_data();
+	const uint8_t *row1 = lut.get_data() + lut_info.get_row_size();
+	TESTEQUALS(static_cast<int>(row0[2 * 4]), 200);
+	TESTEQUALS(static_cast<int>(row1[2 * 4]), 0);
+	TESTEQUALS(static_cast<int>(row1[2 * 4 + 2]), 200);
+	TESTEQUALS(static_cast<int>(row1[3 * 4 + 2]), 100);
+	TESTEQUALS(std::memcmp(row0, row1, 2 * 4), 0);
+
+	// unused entries are transparent
+	TESTEQUALS(static_cast<int>(row0[255 * 4 + 3]), 0);
+
+	// resolving the base palette restores the original image
+	auto resolved = apply_palette(indexed, lut, 0);
+	TESTEQUALS(std::memcmp(resolved.get_data(), image.get_data(), 5 * 4 * 2), 0);
+
+	// resolving the player palette recolors the player color pixels only
+	auto recolored = apply_palette(indexed, lut, 1);
+	const uint8_t *pixels = recolored.get_data();
+	TESTEQUALS(static_cast<int>(pixels[1 * 4]), 255);
+	TESTEQUALS(static_cast<int>(pixels[2 * 4 + 2]), 200);
+	TESTEQUALS(static_cast<int>(pixels[3 * 4 + 2]), 100);
+
+	TESTTHROWS(apply_palette(indexed, lut, 2));
+	TESTTHROWS(apply_palette(image, lut, 0));
+	TESTTHROWS(index_texture(indexed, palette));
+	TESTTHROWS(create_palette_lut(palette, {blue}, 255));
+
+	// memory report
+	std::vector<Texture2dInfo> sprites{
+		Texture2dInfo{512, 512, pixel_format::rgba8},
+		Texture2dInfo{1024, 256, pixel_format::rgba8},
+	};
+	auto report = compare_palette_memory(sprites, lut_info);
+	TESTEQUALS(report.textures, 2);
+	TESTEQUALS(report.rgba_bytes, 2 * 512 * 512 * 4);
+	TESTEQUALS(report.indexed_bytes, 2 * 512 * 512);
+	TESTEQUALS(report.lut_bytes, 2 * 256 * 4);
+	(report.get_ratio() > 3.9) or TESTFAIL;
+
+	std::stringstream str;
+	str << report;
+	(not str.str().empty()) or TESTFAIL;
+}
+
+
+void texture_compression() {
+	texture_compression_sizes();
+	texture_compression_roundtrip();
+	texture_bundle_roundtrip();
+	texture_file_malformed();
+}
+
+
+void frame_encoder() {
+	// odd sizes, so that rows have to be padded for the 4-byte alignment of RGB data
+	size_t width = 37;
+	size_t height = 23;
+	auto frame = make_rgba_texture(width, height, [](size_t x, size_t y) {
+		return std::array<uint8_t, 4>{
+			static_cast<uint8_t>(x * 7),
+			static_cast<uint8_t>(y * 11),
+			static_cast<uint8_t>(x ^ y),
+			static_cast<uint8_t>(x + y)};
+	});
+
+	// the alpha channel is dropped, the colors are lossless
+	auto png = encode_png(frame);
+	auto decoded = decode_png(png);
+	TESTEQUALS(decoded.get_info().get_size().first, 37);
+	TESTEQUALS(decoded.get_info().get_size().second, 23);
+	for (size_t channel = 0; channel < 3; ++channel) {
+		TESTEQUALS(max_channel_error(frame, decoded, channel), 0);
+	}
+	for (size_t i = 0; i < width * height; ++i) {
+		TESTEQUALS(static_cast<int>(decoded.get_data()[i * 4 + 3]), 255);
+	}
+
+	// flipping is done while encoding
+	auto flipped = decode_png(encode_png(frame, true));
+	auto frame_flipped = frame.flip_y();
+	for (size_t channel = 0; channel < 3; ++channel) {
+		TESTEQUALS(max_channel_error(frame_flipped, flipped, channel), 0);
+	}
+
+	// the compression level only changes the size
+	auto fast = decode_png(encode_png(frame, false, 0));
+	TESTEQUALS(max_channel_error(frame, fast, 0), 0);
+
+	// raw frames are written top-down without padding
+	std::ostringstream raw;
+	write_raw_frame(raw, frame, true);
+	std::string raw_data = raw.str();
+	TESTEQUALS(raw_data.size(), width * height * 4);
+	(std::memcmp(raw_data.data(),
+	             frame.get_data() + (height - 1) * frame.get_info().get_row_size(),
+	             width * 4)
+	 == 0)
+		or TESTFAIL;
+	(std::memcmp(raw_data.data() + (height - 1) * width * 4, frame.get_data(), width * 4) == 0) or TESTFAIL;
+
+	// only RGBA data can be encoded
+	Texture2dData rgb{Texture2dInfo{4, 4, pixel_format::rgb8}, std::vector<uint8_t>(4 * 4 * 3)};
+	TESTTHROWS(encode_png(rgb));
+	TESTTHROWS(write_raw_frame(raw, rgb));
+
+	std::vector<uint8_t> garbage(64, 42);
+	TESTTHROWS(decode_png(garbage));
+}
+
+
+void frame_encoder_benchmark() {
+	const size_t width = 1920;
+	const size_t height = 1080;
+	const size_t frames = 10;
+	using clock = std::chrono::steady_clock;
+
+	// smooth gradients with some noise, similar to a rendered frame
+	uint32_t seed = 1;
+	auto frame = make_rgba_texture(width, height, [&seed](size_t x, size_t y) {
+		seed = seed * 1103515245 + 12345;
+		uint8_t noise = (seed >> 16) & 0x7;
+		return std::array<uint8_t, 4>{
+			static_cast<uint8_t>(x / 8 + noise),
+			static_cast<uint8_t>(y / 5 + noise),
+			static_cast<uint8_t>((x + y) / 12),
+			255};
+	});
+
+	auto measure = [&](auto encode) {
+		size_t bytes = 0;
+		auto start = clock::now();
+		for (size_t i = 0; i < frames; ++i) {
+			bytes = encode();
+		}
+		double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count() / frames;
+		return std::make_pair(ms, bytes);
+	};
+
+	log::log(MSG(info) << frames << " frames of " << width << "x" << height << ", time per frame:");
+
+	// what the renderer did before: flip into a copy, then encode
+	auto [copy_ms, copy_bytes] = measure([&frame]() {
+		auto flipped = frame.flip_y();
+		return encode_png(flipped).size();
+	});
+	log::log(MSG(info) << "  flip copy + PNG:  " << copy_ms << " ms, " << copy_bytes << " bytes");
+
+	for (int level : {1, PNG_DEFAULT_COMPRESSION, 6}) {
+		auto [ms, bytes] = measure([&frame, level]() {
+			return encode_png(frame, true, level).size();
+		});
+		log::log(MSG(info) << "  PNG level " << level << ":      " << ms << " ms, " << bytes << " bytes");
+	}
+
+	auto [raw_ms, raw_bytes] = measure([&frame]() {
+		std::ostringstream out;
+		write_raw_frame(out, frame, true);
+		return out.str().size();
+	});
+	log::log(MSG(info) << "  raw frame:        " << raw_ms << " ms, " << raw_bytes << " bytes");
+}
+
+} // namespace openage::renderer::resources::tests
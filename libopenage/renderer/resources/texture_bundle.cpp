@@ -0,0 +1,230 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "texture_bundle.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+#include "renderer/resources/palette_info.h"
+#include "renderer/resources/palette_lookup.h"
+#include "renderer/resources/parser/parse_palette.h"
+#include "renderer/resources/texture_compression.h"
+#include "renderer/resources/texture_data.h"
+#include "renderer/resources/texture_subinfo.h"
+#include "util/file.h"
+#include "util/path.h"
+
+
+namespace openage::renderer::resources {
+
+namespace {
+
+template <typename T>
+void put_le(std::string &out, T value) {
+	for (size_t i = 0; i < sizeof(T); i++) {
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+	}
+}
+
+
+template <typename T>
+T get_le(const uint8_t *data) {
+	T value = 0;
+	for (size_t i = 0; i < sizeof(T); i++) {
+		value |= static_cast<T>(data[i]) << (8 * i);
+	}
+	return value;
+}
+
+
+/**
+ * Get the ID that a pixel format is stored as in texture bundles.
+ * The IDs are part of the file format, so they must never change.
+ *
+ * @param fmt Pixel format.
+ *
+ * @return File ID of the format.
+ */
+uint16_t format_to_bundle_id(pixel_format fmt) {
+	switch (fmt) {
+	case pixel_format::r16ui:
+		return 0;
+	case pixel_format::r32ui:
+		return 1;
+	case pixel_format::rgb8:
+		return 2;
+	case pixel_format::bgr8:
+		return 3;
+	case pixel_format::depth24:
+		return 4;
+	case pixel_format::rgba8:
+		return 5;
+	case pixel_format::rgba8ui:
+		return 6;
+	case pixel_format::bc1:
+		return 7;
+	case pixel_format::bc3:
+		return 8;
+	case pixel_format::r8:
+		return 9;
+	default:
+		throw Error(MSG(err) << "Pixel format can not be stored in a texture bundle.");
+	}
+}
+
+
+/**
+ * Get the pixel format for an ID from a texture bundle.
+ *
+ * @param id File ID of the format.
+ *
+ * @return Pixel format, or \p std::nullopt if the ID is unknown.
+ */
+std::optional<pixel_format> format_from_bundle_id(uint16_t id) {
+	switch (id) {
+	case 0:
+		return pixel_format::r16ui;
+	case 1:
+		return pixel_format::r32ui;
+	case 2:
+		return pixel_format::rgb8;
+	case 3:
+		return pixel_format::bgr8;
+	case 4:
+		return pixel_format::depth24;
+	case 5:
+		return pixel_format::rgba8;
+	case 6:
+		return pixel_format::rgba8ui;
+	case 7:
+		return pixel_format::bc1;
+	case 8:
+		return pixel_format::bc3;
+	case 9:
+		return pixel_format::r8;
+	default:
+		return std::nullopt;
+	}
+}
+
+} // namespace
+
+
+bool is_texture_bundle(const util::Path &path) {
+	return path.get_suffix() == TEXTURE_BUNDLE_SUFFIX;
+}
+
+void write_texture_bundle(const util::Path &path, const Texture2dData &data) {
+	auto &info = data.get_info();
+	auto size = info.get_size();
+
+	texture_bundle_header header{
+		TEXTURE_BUNDLE_MAGIC,
+		TEXTURE_BUNDLE_VERSION,
+		format_to_bundle_id(info.get_format()),
+		static_cast<uint32_t>(size.first),
+		static_cast<uint32_t>(size.second),
+		static_cast<uint32_t>(info.get_row_alignment()),
+		0,
+		info.get_data_size(),
+	};
+
+	std::string out;
+	out.reserve(TEXTURE_BUNDLE_HEADER_SIZE + header.data_size);
+	put_le(out, header.magic);
+	put_le(out, header.version);
+	put_le(out, header.format);
+	put_le(out, header.width);
+	put_le(out, header.height);
+	put_le(out, header.row_alignment);
+	put_le(out, header.reserved);
+	put_le(out, header.data_size);
+	out.append(reinterpret_cast<const char *>(data.get_data()), header.data_size);
+
+	auto file = path.open_w();
+	file.write(out);
+	file.close();
+
+	log::log(MSG(dbg) << "Texture bundle has been written to " << path);
+}
+
+Texture2dData read_texture_bundle(const util::Path &path) {
+	auto file = path.open_r();
+
+	uint8_t raw[TEXTURE_BUNDLE_HEADER_SIZE];
+	if (file.read_to(raw, sizeof(raw)) != sizeof(raw)) {
+		throw Error(MSG(err) << "Texture bundle " << path << " is truncated.");
+	}
+
+	texture_bundle_header header{
+		get_le<uint32_t>(raw),
+		get_le<uint16_t>(raw + 4),
+		get_le<uint16_t>(raw + 6),
+		get_le<uint32_t>(raw + 8),
+		get_le<uint32_t>(raw + 12),
+		get_le<uint32_t>(raw + 16),
+		get_le<uint32_t>(raw + 20),
+		get_le<uint64_t>(raw + 24),
+	};
+
+	if (header.magic != TEXTURE_BUNDLE_MAGIC) {
+		throw Error(MSG(err) << "File " << path << " is not a texture bundle.");
+	}
+	if (header.version != TEXTURE_BUNDLE_VERSION) {
+		throw Error(MSG(err) << "Texture bundle " << path << " has unsupported version " << header.version);
+	}
+
+	auto format = format_from_bundle_id(header.format);
+	if (not format) {
+		throw Error(MSG(err) << "Texture bundle " << path << " has unknown pixel format " << header.format);
+	}
+
+	auto fmt = *format;
+	size_t w = header.width;
+	size_t h = header.height;
+
+	// we don't have a texture description file.
+	// use the whole image as one texture then.
+	std::vector<Texture2dSubInfo> subtextures;
+	subtextures.emplace_back(0, 0, w, h, w / 2, h / 2, w, h);
+
+	Texture2dInfo info{w, h, fmt, path, header.row_alignment, std::move(subtextures)};
+	if (info.get_data_size() != header.data_size) {
+		throw Error(MSG(err) << "Texture bundle " << path << " has an invalid data size.");
+	}
+
+	// read the pixels straight into the texture buffer
+	std::vector<uint8_t> data(header.data_size);
+	if (file.read_to(data.data(), header.data_size) != header.data_size) {
+		throw Error(MSG(err) << "Texture bundle " << path << " is truncated.");
+	}
+	file.close();
+
+	log::log(MSG(dbg) << "Texture bundle has been loaded from " << path);
+
+	return Texture2dData{info, std::move(data)};
+}
+
+void encode_texture_bundle(const util::Path &image_path,
+                           const util::Path &bundle_path,
+                           bool use_alpha) {
+	Texture2dData image{image_path};
+	auto fmt = use_alpha ? pixel_format::bc3 : pixel_format::bc1;
+
+	write_texture_bundle(bundle_path, compress_texture(image, fmt));
+}
+
+void encode_indexed_texture_bundle(const util::Path &image_path,
+                                   const util::Path &palette_path,
+                                   const util::Path &bundle_path) {
+	Texture2dData image{image_path};
+	auto palette = parser::parse_palette_file(palette_path);
+
+	write_texture_bundle(bundle_path, index_texture(image, palette));
+}
+
+} // namespace openage::renderer::resources
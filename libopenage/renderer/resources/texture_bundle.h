@@ -0,0 +1,131 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// pxd: from libcpp cimport bool as cppbool
+#include "renderer/resources/texture_info.h"
+#include "util/compiler.h"
+
+// pxd: from libopenage.util.path cimport Path
+
+
+namespace openage {
+namespace util {
+class Path;
+}
+
+namespace renderer::resources {
+class Texture2dData;
+
+/**
+ * File suffix of texture bundles.
+ */
+constexpr const char *TEXTURE_BUNDLE_SUFFIX = ".ctex";
+
+/**
+ * Magic bytes at the start of texture bundle files.
+ */
+constexpr uint32_t TEXTURE_BUNDLE_MAGIC = 0x5854414f; // "OATX"
+
+/**
+ * Version of the texture bundle format.
+ */
+constexpr uint16_t TEXTURE_BUNDLE_VERSION = 1;
+
+/**
+ * Size of the texture bundle header in the file (in bytes).
+ */
+constexpr size_t TEXTURE_BUNDLE_HEADER_SIZE = 32;
+
+/**
+ * Header of a texture bundle file.
+ *
+ * The header is followed by \p data_size bytes of pixel data in the given format.
+ * For block-compressed formats, blocks are stored in row-major order, so the
+ * data can be uploaded to the GPU without any further processing.
+ *
+ * The fields are stored in the order of declaration without padding.
+ * All values are stored in little endian byte order.
+ */
+struct texture_bundle_header {
+	/// Always \p TEXTURE_BUNDLE_MAGIC.
+	uint32_t magic;
+	/// Format version.
+	uint16_t version;
+	/// ID of the pixel format. The IDs are fixed, independent of the
+	/// order of \p pixel_format: r16ui = 0, r32ui = 1, rgb8 = 2, bgr8 = 3,
+	/// depth24 = 4, rgba8 = 5, rgba8ui = 6, bc1 = 7, bc3 = 8, r8 = 9.
+	uint16_t format;
+	/// Width of the texture (in pixels).
+	uint32_t width;
+	/// Height of the texture (in pixels).
+	uint32_t height;
+	/// Byte alignment of rows.
+	uint32_t row_alignment;
+	/// Reserved for future use, always 0.
+	uint32_t reserved;
+	/// Size of the pixel data (in bytes).
+	uint64_t data_size;
+};
+
+/**
+ * Check if a path points to a texture bundle.
+ *
+ * @param path Path to a texture resource.
+ *
+ * @return true if the path has the texture bundle suffix, else false.
+ */
+bool is_texture_bundle(const util::Path &path);
+
+/**
+ * Write texture data into a texture bundle file.
+ *
+ * @param path Output path.
+ * @param data Texture data.
+ */
+void write_texture_bundle(const util::Path &path, const Texture2dData &data);
+
+/**
+ * Load texture data from a texture bundle file. The pixel data is read
+ * directly into the data buffer without decoding.
+ *
+ * @param path Path to the texture bundle.
+ *
+ * @return Texture data. The whole texture is used as a single subtexture.
+ */
+Texture2dData read_texture_bundle(const util::Path &path);
+
+/**
+ * Offline encoder stage for texture bundles: Load an image, encode it in
+ * the target format and store it as a texture bundle.
+ *
+ * @param image_path Path to the source image (e.g. PNG).
+ * @param bundle_path Output path of the texture bundle.
+ * @param use_alpha If true, the image is encoded with full alpha (BC3), else with
+ *                  1 bit alpha (BC1).
+ */
+// pxd: void encode_texture_bundle(Path image_path, Path bundle_path, cppbool use_alpha) except +
+OAAPI void encode_texture_bundle(const util::Path &image_path,
+                                 const util::Path &bundle_path,
+                                 bool use_alpha = true);
+
+/**
+ * Offline encoder stage for indexed texture bundles: Load an image, convert
+ * its colors to indices of a palette and store it as a texture bundle
+ * in \p pixel_format::r8 format.
+ *
+ * @param image_path Path to the source image (e.g. PNG).
+ * @param palette_path Path to the palette definition file (.opal).
+ * @param bundle_path Output path of the texture bundle.
+ */
+// pxd: void encode_indexed_texture_bundle(Path image_path, Path palette_path, Path bundle_path) except +
+OAAPI void encode_indexed_texture_bundle(const util::Path &image_path,
+                                         const util::Path &palette_path,
+                                         const util::Path &bundle_path);
+
+} // namespace renderer::resources
+} // namespace openage
@@ -0,0 +1,397 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "texture_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "error/error.h"
+#include "log/message.h"
+#include "renderer/resources/texture_data.h"
+
+
+namespace openage::renderer::resources {
+
+namespace {
+
+/**
+ * RGBA pixels of a 4x4 block in row-major order.
+ */
+using block_pixels_t = std::array<std::array<uint8_t, 4>, 16>;
+
+/**
+ * Alpha values below this threshold are treated as transparent in BC1.
+ */
+constexpr uint8_t BC1_ALPHA_THRESHOLD = 128;
+
+
+/**
+ * Pack an RGB color into the RGB565 format.
+ */
+uint16_t pack_565(uint8_t r, uint8_t g, uint8_t b) {
+	return static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+/**
+ * Unpack an RGB565 color to RGB888 by replicating the high bits.
+ */
+std::array<uint8_t, 4> unpack_565(uint16_t c) {
+	uint8_t r = (c >> 11) & 0x1f;
+	uint8_t g = (c >> 5) & 0x3f;
+	uint8_t b = c & 0x1f;
+
+	return {
+		static_cast<uint8_t>((r << 3) | (r >> 2)),
+		static_cast<uint8_t>((g << 2) | (g >> 4)),
+		static_cast<uint8_t>((b << 3) | (b >> 2)),
+		255,
+	};
+}
+
+/**
+ * Fetch the pixels of the block at (bx, by). Pixels outside the
+ * texture are clamped to the border.
+ */
+block_pixels_t fetch_block(const uint8_t *src,
+                           size_t row_size,
+                           size_t width,
+                           size_t height,
+                           size_t bx,
+                           size_t by) {
+	block_pixels_t block;
+	for (size_t y = 0; y < COMPRESSED_BLOCK_DIM; ++y) {
+		size_t py = std::min(by * COMPRESSED_BLOCK_DIM + y, height - 1);
+		for (size_t x = 0; x < COMPRESSED_BLOCK_DIM; ++x) {
+			size_t px = std::min(bx * COMPRESSED_BLOCK_DIM + x, width - 1);
+			const uint8_t *pixel = src + py * row_size + px * 4;
+			std::copy(pixel, pixel + 4, block[y * COMPRESSED_BLOCK_DIM + x].begin());
+		}
+	}
+	return block;
+}
+
+/**
+ * Squared distance between two RGB colors.
+ */
+int color_distance(const std::array<uint8_t, 4> &a, const std::array<uint8_t, 4> &b) {
+	int dr = a[0] - b[0];
+	int dg = a[1] - b[1];
+	int db = a[2] - b[2];
+	return dr * dr + dg * dg + db * db;
+}
+
+/**
+ * Create the color palette of a BC1 color block from its endpoints.
+ */
+std::array<std::array<uint8_t, 4>, 4> color_palette(uint16_t c0, uint16_t c1, bool four_colors) {
+	std::array<std::array<uint8_t, 4>, 4> palette;
+	palette[0] = unpack_565(c0);
+	palette[1] = unpack_565(c1);
+
+	for (size_t ch = 0; ch < 3; ++ch) {
+		if (four_colors) {
+			palette[2][ch] = static_cast<uint8_t>((2 * palette[0][ch] + palette[1][ch]) / 3);
+			palette[3][ch] = static_cast<uint8_t>((palette[0][ch] + 2 * palette[1][ch]) / 3);
+		}
+		else {
+			palette[2][ch] = static_cast<uint8_t>((palette[0][ch] + palette[1][ch]) / 2);
+			palette[3][ch] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = four_colors ? 255 : 0;
+
+	return palette;
+}
+
+/**
+ * Encode the color part of a block (8 bytes).
+ *
+ * The endpoints are the extremes of the bounding box of the block colors.
+ *
+ * @param block Pixels of the block.
+ * @param allow_alpha If true, transparent pixels are encoded using
+ *                    the 3-color mode of BC1.
+ * @param out Output buffer.
+ */
+void encode_color_block(const block_pixels_t &block, bool allow_alpha, uint8_t *out) {
+	std::array<uint8_t, 4> min_col{255, 255, 255, 255};
+	std::array<uint8_t, 4> max_col{0, 0, 0, 0};
+	bool has_transparent = false;
+
+	for (auto &pixel : block) {
+		if (allow_alpha and pixel[3] < BC1_ALPHA_THRESHOLD) {
+			has_transparent = true;
+			continue;
+		}
+		for (size_t ch = 0; ch < 3; ++ch) {
+			min_col[ch] = std::min(min_col[ch], pixel[ch]);
+			max_col[ch] = std::max(max_col[ch], pixel[ch]);
+		}
+	}
+
+	if (min_col[0] > max_col[0]) {
+		// fully transparent block
+		min_col = {0, 0, 0, 0};
+		max_col = {0, 0, 0, 0};
+	}
+
+	uint16_t c0 = pack_565(max_col[0], max_col[1], max_col[2]);
+	uint16_t c1 = pack_565(min_col[0], min_col[1], min_col[2]);
+
+	// the endpoint order selects the block mode:
+	// c0 > c1 is the 4-color mode, c0 <= c1 is the 3-color mode with transparency
+	bool four_colors = not has_transparent;
+	if (four_colors) {
+		if (c0 < c1) {
+			std::swap(c0, c1);
+		}
+		else if (c0 == c1) {
+			// single color block, all indices are 0
+			four_colors = (c0 != 0);
+			if (four_colors) {
+				c1 = c0 - 1;
+			}
+		}
+	}
+	else if (c0 > c1) {
+		std::swap(c0, c1);
+	}
+
+	auto palette = color_palette(c0, c1, c0 > c1);
+
+	uint32_t indices = 0;
+	for (size_t i = 0; i < block.size(); ++i) {
+		uint32_t index = 0;
+		if (has_transparent and block[i][3] < BC1_ALPHA_THRESHOLD) {
+			index = 3;
+		}
+		else {
+			int best = color_distance(block[i], palette[0]);
+			size_t palette_size = (c0 > c1) ? 4 : 3;
+			for (size_t j = 1; j < palette_size; ++j) {
+				int dist = color_distance(block[i], palette[j]);
+				if (dist < best) {
+					best = dist;
+					index = j;
+				}
+			}
+		}
+		indices |= index << (2 * i);
+	}
+
+	out[0] = c0 & 0xff;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 0xff;
+	out[3] = c1 >> 8;
+	out[4] = indices & 0xff;
+	out[5] = (indices >> 8) & 0xff;
+	out[6] = (indices >> 16) & 0xff;
+	out[7] = (indices >> 24) & 0xff;
+}
+
+/**
+ * Decode the color part of a block (8 bytes).
+ *
+ * @param in Compressed block.
+ * @param force_four_colors Always use the 4-color mode (BC3).
+ * @param block Output pixels.
+ */
+void decode_color_block(const uint8_t *in, bool force_four_colors, block_pixels_t &block) {
+	uint16_t c0 = in[0] | (in[1] << 8);
+	uint16_t c1 = in[2] | (in[3] << 8);
+	uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+
+	auto palette = color_palette(c0, c1, force_four_colors or c0 > c1);
+
+	for (size_t i = 0; i < block.size(); ++i) {
+		block[i] = palette[(indices >> (2 * i)) & 0x3];
+	}
+}
+
+/**
+ * Create the alpha palette of a BC3 alpha block from its endpoints.
+ */
+std::array<uint8_t, 8> alpha_palette(uint8_t a0, uint8_t a1) {
+	std::array<uint8_t, 8> palette;
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1) {
+		for (size_t i = 1; i < 7; ++i) {
+			palette[i + 1] = static_cast<uint8_t>(((7 - i) * a0 + i * a1) / 7);
+		}
+	}
+	else {
+		for (size_t i = 1; i < 5; ++i) {
+			palette[i + 1] = static_cast<uint8_t>(((5 - i) * a0 + i * a1) / 5);
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	return palette;
+}
+
+/**
+ * Encode the alpha part of a BC3 block (8 bytes).
+ */
+void encode_alpha_block(const block_pixels_t &block, uint8_t *out) {
+	uint8_t a_min = 255;
+	uint8_t a_max = 0;
+	for (auto &pixel : block) {
+		a_min = std::min(a_min, pixel[3]);
+		a_max = std::max(a_max, pixel[3]);
+	}
+
+	uint64_t indices = 0;
+	if (a_max != a_min) {
+		// 8-alpha mode
+		auto palette = alpha_palette(a_max, a_min);
+		for (size_t i = 0; i < block.size(); ++i) {
+			uint64_t index = 0;
+			int best = 256;
+			for (size_t j = 0; j < palette.size(); ++j) {
+				int dist = std::abs(block[i][3] - palette[j]);
+				if (dist < best) {
+					best = dist;
+					index = j;
+				}
+			}
+			indices |= index << (3 * i);
+		}
+	}
+
+	out[0] = a_max;
+	out[1] = a_min;
+	for (size_t i = 0; i < 6; ++i) {
+		out[2 + i] = (indices >> (8 * i)) & 0xff;
+	}
+}
+
+/**
+ * Decode the alpha part of a BC3 block (8 bytes).
+ */
+void decode_alpha_block(const uint8_t *in, block_pixels_t &block) {
+	auto palette = alpha_palette(in[0], in[1]);
+
+	uint64_t indices = 0;
+	for (size_t i = 0; i < 6; ++i) {
+		indices |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+	}
+
+	for (size_t i = 0; i < block.size(); ++i) {
+		block[i][3] = palette[(indices >> (3 * i)) & 0x7];
+	}
+}
+
+} // namespace
+
+
+Texture2dData compress_texture(const Texture2dData &data, pixel_format fmt) {
+	auto &info = data.get_info();
+	if (info.get_format() != pixel_format::rgba8) {
+		throw Error(MSG(err) << "Only RGBA8 textures can be compressed.");
+	}
+	if (not is_compressed(fmt)) {
+		throw Error(MSG(err) << "Target format for texture compression is not block-compressed.");
+	}
+
+	auto size = info.get_size();
+	size_t width = size.first;
+	size_t height = size.second;
+
+	std::vector<Texture2dSubInfo> subtextures;
+	for (size_t i = 0; i < info.get_subtex_count(); ++i) {
+		subtextures.push_back(info.get_subtex_info(i));
+	}
+	Texture2dInfo out_info{width, height, fmt, info.get_image_path(), 1, std::move(subtextures)};
+
+	std::vector<uint8_t> out(out_info.get_data_size());
+
+	size_t blocks_x = (width + COMPRESSED_BLOCK_DIM - 1) / COMPRESSED_BLOCK_DIM;
+	size_t blocks_y = (height + COMPRESSED_BLOCK_DIM - 1) / COMPRESSED_BLOCK_DIM;
+	size_t blk_size = block_size(fmt);
+
+	uint8_t *dst = out.data();
+	for (size_t by = 0; by < blocks_y; ++by) {
+		for (size_t bx = 0; bx < blocks_x; ++bx) {
+			auto block = fetch_block(data.get_data(), info.get_row_size(), width, height, bx, by);
+
+			if (fmt == pixel_format::bc3) {
+				encode_alpha_block(block, dst);
+				encode_color_block(block, false, dst + 8);
+			}
+			else {
+				encode_color_block(block, true, dst);
+			}
+
+			dst += blk_size;
+		}
+	}
+
+	return Texture2dData{out_info, std::move(out)};
+}
+
+
+Texture2dData decompress_texture(const Texture2dData &data) {
+	auto &info = data.get_info();
+	auto fmt = info.get_format();
+	if (not is_compressed(fmt)) {
+		throw Error(MSG(err) << "Texture data is not block-compressed.");
+	}
+
+	auto size = info.get_size();
+	size_t width = size.first;
+	size_t height = size.second;
+
+	std::vector<Texture2dSubInfo> subtextures;
+	for (size_t i = 0; i < info.get_subtex_count(); ++i) {
+		subtextures.push_back(info.get_subtex_info(i));
+	}
+	Texture2dInfo out_info{width, height, pixel_format::rgba8, info.get_image_path(), 4, std::move(subtextures)};
+
+	std::vector<uint8_t> out(out_info.get_data_size());
+	size_t row_size = out_info.get_row_size();
+
+	size_t blocks_x = (width + COMPRESSED_BLOCK_DIM - 1) / COMPRESSED_BLOCK_DIM;
+	size_t blocks_y = (height + COMPRESSED_BLOCK_DIM - 1) / COMPRESSED_BLOCK_DIM;
+	size_t blk_size = block_size(fmt);
+
+	const uint8_t *src = data.get_data();
+	block_pixels_t block;
+	for (size_t by = 0; by < blocks_y; ++by) {
+		for (size_t bx = 0; bx < blocks_x; ++bx) {
+			if (fmt == pixel_format::bc3) {
+				decode_color_block(src + 8, true, block);
+				decode_alpha_block(src, block);
+			}
+			else {
+				decode_color_block(src, false, block);
+			}
+
+			// write back the pixels that are inside the texture
+			for (size_t y = 0; y < COMPRESSED_BLOCK_DIM; ++y) {
+				size_t py = by * COMPRESSED_BLOCK_DIM + y;
+				if (py >= height) {
+					break;
+				}
+				for (size_t x = 0; x < COMPRESSED_BLOCK_DIM; ++x) {
+					size_t px = bx * COMPRESSED_BLOCK_DIM + x;
+					if (px >= width) {
+						break;
+					}
+					auto &pixel = block[y * COMPRESSED_BLOCK_DIM + x];
+					std::copy(pixel.begin(), pixel.end(), out.data() + py * row_size + px * 4);
+				}
+			}
+
+			src += blk_size;
+		}
+	}
+
+	return Texture2dData{out_info, std::move(out)};
+}
+
+} // namespace openage::renderer::resources
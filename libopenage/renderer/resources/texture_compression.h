@@ -0,0 +1,36 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include "renderer/resources/texture_info.h"
+
+
+namespace openage::renderer::resources {
+class Texture2dData;
+
+/**
+ * Encode uncompressed RGBA texture data into a block-compressed format.
+ *
+ * Blocks at the right and bottom borders of textures whose size is not a multiple
+ * of 4 are padded by repeating the last column/row.
+ *
+ * @param data Texture data in \p pixel_format::rgba8 format.
+ * @param fmt Block-compressed target format (\p pixel_format::bc1 or \p pixel_format::bc3).
+ *
+ * @return Compressed texture data. The subtexture information is kept.
+ */
+Texture2dData compress_texture(const Texture2dData &data, pixel_format fmt);
+
+/**
+ * Decode block-compressed texture data into uncompressed RGBA pixels.
+ *
+ * This is mostly useful for testing and for tools, as block-compressed textures
+ * are usually uploaded to the GPU directly.
+ *
+ * @param data Texture data in a block-compressed format.
+ *
+ * @return Texture data in \p pixel_format::rgba8 format. The subtexture information is kept.
+ */
+Texture2dData decompress_texture(const Texture2dData &data);
+
+} // namespace openage::renderer::resources
@@ -11,6 +11,7 @@
 
 #include "error/error.h"
 #include "log/log.h"
+#include "renderer/resources/texture_bundle.h"
 #include "renderer/resources/texture_info.h"
 #include "renderer/resources/texture_subinfo.h"
 #include "util/path.h"
@@ -58,6 +59,12 @@ static constexpr size_t guess_row_alignment(size_t width, pixel_format fmt, size
 }
 
 Texture2dData::Texture2dData(const util::Path &path) {
+	if (is_texture_bundle(path)) {
+		// pre-encoded pixel data that can be used without decoding
+		*this = read_texture_bundle(path);
+		return;
+	}
+
 	std::string native_path = path.resolve_native_path();
 
 	// TODO: use QImageIOHandler to directly create the correct surface format.
@@ -107,6 +114,22 @@ Texture2dData::Texture2dData(const util::Path &path) {
 
 Texture2dData::Texture2dData(Texture2dInfo const &info) :
 	info{info} {
+	if (is_texture_bundle(info.get_image_path().value())) {
+		auto bundle = read_texture_bundle(info.get_image_path().value());
+
+		// the data is uploaded with the layout of the texture info
+		auto &bundle_info = bundle.get_info();
+		if (bundle_info.get_format() != info.get_format()
+		    or bundle_info.get_size() != info.get_size()
+		    or bundle_info.get_data_size() != info.get_data_size()) {
+			throw Error(MSG(err) << "Texture bundle " << info.get_image_path().value()
+			                     << " does not match the format, size or data size of its texture info.");
+		}
+
+		this->data = std::move(bundle.data);
+		return;
+	}
+
 	std::string native_path = info.get_image_path().value().resolve_native_path();
 
 	// TODO: use QImageIOHandler to directly create the correct surface format.
@@ -126,6 +149,10 @@ Texture2dData::Texture2dData(Texture2dInfo const &info, std::vector<uint8_t> &&d
 	info(info), data(std::move(data)) {}
 
 Texture2dData Texture2dData::flip_y() {
+	if (is_compressed(this->info.get_format())) {
+		throw Error(MSG(err) << "Flipping block-compressed textures is not supported.");
+	}
+
 	size_t row_size = this->info.get_row_size();
 	size_t height = this->info.get_size().second;
 
@@ -26,7 +26,8 @@ public:
 	/// Create a texture from an image file.
 	/// @param path Path to the image file.
 	///
-	/// Uses QImage internally.
+	/// Uses QImage internally. Texture bundles (see texture_bundle.h) are
+	/// loaded without decoding.
 	Texture2dData(const util::Path &path);
 
 	/// Create a texture from info.
@@ -40,6 +41,7 @@ public:
 
 	/// Flips the texture along the Y-axis and returns the flipped data with the same info.
 	/// Sometimes necessary when converting between storage modes.
+	/// Not supported for block-compressed formats.
 	Texture2dData flip_y();
 
 	/// Returns the information describing this texture data.
@@ -47,6 +47,12 @@ size_t Texture2dInfo::get_row_alignment() const {
 }
 
 size_t Texture2dInfo::get_row_size() const {
+	if (is_compressed(this->format)) {
+		// rows of blocks are never padded
+		size_t blocks_per_row = (this->w + COMPRESSED_BLOCK_DIM - 1) / COMPRESSED_BLOCK_DIM;
+		return blocks_per_row * block_size(this->format);
+	}
+
 	size_t px_size = pixel_size(this->format);
 	size_t row_size = this->w * px_size;
 
@@ -60,6 +66,11 @@ size_t Texture2dInfo::get_row_size() const {
 }
 
 size_t Texture2dInfo::get_data_size() const {
+	if (is_compressed(this->format)) {
+		size_t block_rows = (this->h + COMPRESSED_BLOCK_DIM - 1) / COMPRESSED_BLOCK_DIM;
+		return this->get_row_size() * block_rows;
+	}
+
 	return this->get_row_size() * this->h;
 }
 
@@ -34,6 +34,12 @@ enum class pixel_format {
 	rgba8,
 	/// 32 bits per pixel, unsigned integer, alpha channel, RGBA order
 	rgba8ui,
+	/// 4 bits per pixel, block-compressed RGB with 1 bit alpha (BC1/DXT1)
+	bc1,
+	/// 8 bits per pixel, block-compressed RGBA (BC3/DXT5)
+	bc3,
+	/// 8 bits per pixel, float, single channel (e.g. palette indices)
+	r8,
 };
 
 /**
@@ -51,11 +57,44 @@ constexpr size_t pixel_size(pixel_format fmt) {
 		std::make_pair(pixel_format::bgr8, 3),
 		std::make_pair(pixel_format::rgba8, 4),
 		std::make_pair(pixel_format::rgba8ui, 4),
-		std::make_pair(pixel_format::depth24, 3));
+		std::make_pair(pixel_format::depth24, 3),
+		std::make_pair(pixel_format::r8, 1));
 
 	return pix_size.get(fmt);
 }
 
+/**
+ * Check whether the specified format stores pixels in compressed blocks
+ * instead of individual pixels.
+ *
+ * @param fmt Pixel format enum value.
+ *
+ * @return true if the format is block-compressed, else false.
+ */
+constexpr bool is_compressed(pixel_format fmt) {
+	return fmt == pixel_format::bc1 or fmt == pixel_format::bc3;
+}
+
+/**
+ * Width and height of a block in block-compressed formats (in pixels).
+ */
+constexpr size_t COMPRESSED_BLOCK_DIM = 4;
+
+/**
+ * Get the size in bytes of a single 4x4 pixel block of the specified
+ * block-compressed format.
+ *
+ * @param fmt Block-compressed pixel format enum value.
+ *
+ * @return Size of a single block (in bytes).
+ */
+constexpr size_t block_size(pixel_format fmt) {
+	constexpr auto blk_size = datastructure::create_const_map<pixel_format, size_t>(
+		std::make_pair(pixel_format::bc1, 8),
+		std::make_pair(pixel_format::bc3, 16));
+	return blk_size.get(fmt);
+}
+
 /**
  * Information about a 2D texture surface, without actual texture data.
  * The class supports subtextures, so that one big texture ("texture atlas")
@@ -125,6 +164,8 @@ public:
 	 * Get the size of a single row in bytes, including possible
 	 * padding at its end.
 	 *
+	 * For block-compressed formats, this is the size of a row of blocks.
+	 *
 	 * @return Row size (in bytes).
 	 */
 	size_t get_row_size() const;
@@ -133,6 +174,9 @@ public:
 	 * Get the size in bytes of the raw pixel data. It is equal to
 	 * \p get_row_size() * \p get_size().second .
 	 *
+	 * For block-compressed formats, it is equal to \p get_row_size()
+	 * multiplied by the number of block rows.
+	 *
 	 * @return Size of the raw pixel data (in bytes).
 	 */
 	size_t get_data_size() const;
@@ -33,6 +33,19 @@ public:
 	 */
 	virtual bool has_uniform(const char *unif) = 0;
 
+	/**
+	 * Get the ID of a uniform variable in the shader program. Resolve the IDs of
+	 * frequently updated uniforms once and use them in \p UniformInput::update()
+	 * to avoid looking up the uniform name on every update.
+	 *
+	 * Throws if the uniform does not exist.
+	 *
+	 * @param unif Name of the uniform.
+	 *
+	 * @return ID of the uniform.
+	 */
+	virtual uniform_id_t get_uniform_id(const char *unif) = 0;
+
 	/**
      * Binds a uniform block in the shader program to the same binding point as
      * the given uniform buffer.
@@ -83,22 +96,22 @@ protected:
 	/**
 	 * Set a uniform input variable in the actual shader program.
 	 */
-	virtual void set_i32(std::shared_ptr<UniformInput> const &, const char *, int32_t) = 0;
-	virtual void set_u32(std::shared_ptr<UniformInput> const &, const char *, uint32_t) = 0;
-	virtual void set_f32(std::shared_ptr<UniformInput> const &, const char *, float) = 0;
-	virtual void set_f64(std::shared_ptr<UniformInput> const &, const char *, double) = 0;
-	virtual void set_bool(std::shared_ptr<UniformInput> const &, const char *, bool) = 0;
-	virtual void set_v2f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector2f const &) = 0;
-	virtual void set_v3f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector3f const &) = 0;
-	virtual void set_v4f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector4f const &) = 0;
-	virtual void set_v2i32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector2i const &) = 0;
-	virtual void set_v3i32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector3i const &) = 0;
-	virtual void set_v4i32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector4i const &) = 0;
-	virtual void set_v2ui32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector2<uint32_t> const &) = 0;
-	virtual void set_v3ui32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector3<uint32_t> const &) = 0;
-	virtual void set_v4ui32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Vector4<uint32_t> const &) = 0;
-	virtual void set_m4f32(std::shared_ptr<UniformInput> const &, const char *, Eigen::Matrix4f const &) = 0;
-	virtual void set_tex(std::shared_ptr<UniformInput> const &, const char *, std::shared_ptr<Texture2d> const &) = 0;
+	virtual void set_i32(std::shared_ptr<UniformInput> const &, uniform_id_t, int32_t) = 0;
+	virtual void set_u32(std::shared_ptr<UniformInput> const &, uniform_id_t, uint32_t) = 0;
+	virtual void set_f32(std::shared_ptr<UniformInput> const &, uniform_id_t, float) = 0;
+	virtual void set_f64(std::shared_ptr<UniformInput> const &, uniform_id_t, double) = 0;
+	virtual void set_bool(std::shared_ptr<UniformInput> const &, uniform_id_t, bool) = 0;
+	virtual void set_v2f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2f const &) = 0;
+	virtual void set_v3f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3f const &) = 0;
+	virtual void set_v4f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4f const &) = 0;
+	virtual void set_v2i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2i const &) = 0;
+	virtual void set_v3i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3i const &) = 0;
+	virtual void set_v4i32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4i const &) = 0;
+	virtual void set_v2ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector2<uint32_t> const &) = 0;
+	virtual void set_v3ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector3<uint32_t> const &) = 0;
+	virtual void set_v4ui32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Vector4<uint32_t> const &) = 0;
+	virtual void set_m4f32(std::shared_ptr<UniformInput> const &, uniform_id_t, Eigen::Matrix4f const &) = 0;
+	virtual void set_tex(std::shared_ptr<UniformInput> const &, uniform_id_t, std::shared_ptr<Texture2d> const &) = 0;
 };
 
 } // namespace renderer
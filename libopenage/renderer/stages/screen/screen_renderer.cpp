@@ -2,7 +2,6 @@
 
 #include "screen_renderer.h"
 
-#include "renderer/opengl/context.h"
 #include "renderer/renderer.h"
 #include "renderer/resources/mesh_data.h"
 #include "renderer/resources/shader_source.h"
@@ -21,7 +20,7 @@ ScreenRenderer::ScreenRenderer(const std::shared_ptr<Window> & /* window */,
 	renderer{renderer},
 	render_targets{},
 	pass_outputs{} {
-	renderer::opengl::GlContext::check_error();
+	this->renderer->check_error();
 
 	this->initialize_render_pass(shaderdir);
 }
@@ -2,7 +2,6 @@
 
 #include "skybox_renderer.h"
 
-#include "renderer/opengl/context.h"
 #include "renderer/renderer.h"
 #include "renderer/resources/mesh_data.h"
 #include "renderer/resources/shader_source.h"
@@ -20,7 +19,7 @@ SkyboxRenderer::SkyboxRenderer(const std::shared_ptr<Window> &window,
 	renderer{renderer},
 	bg_color{0.0, 0.0, 0.0, 1.0} // black
 {
-	renderer::opengl::GlContext::check_error();
+	this->renderer->check_error();
 
 	auto size = window->get_size();
 	this->initialize_render_pass(size[0], size[1], shaderdir);
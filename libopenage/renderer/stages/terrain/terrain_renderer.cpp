@@ -3,7 +3,6 @@
 #include "terrain_renderer.h"
 
 #include "renderer/camera/camera.h"
-#include "renderer/opengl/context.h"
 #include "renderer/renderer.h"
 #include "renderer/resources/shader_source.h"
 #include "renderer/resources/texture_info.h"
@@ -27,7 +26,7 @@ TerrainRenderer::TerrainRenderer(const std::shared_ptr<Window> &window,
 	render_entity{nullptr},
 	model{std::make_shared<TerrainRenderModel>(asset_manager)},
 	clock{clock} {
-	renderer::opengl::GlContext::check_error();
+	this->renderer->check_error();
 
 	auto size = window->get_size();
 	this->initialize_render_pass(size[0], size[1], shaderdir);
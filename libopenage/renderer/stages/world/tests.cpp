@@ -0,0 +1,337 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <eigen3/Eigen/Dense>
+
+#include "coord/phys.h"
+#include "coord/scene.h"
+#include "curve/continuous.h"
+#include "curve/discrete.h"
+#include "curve/segmented.h"
+#include "log/log.h"
+#include "log/message.h"
+#include "testing/testing.h"
+#include "time/time.h"
+#include "util/symbol.h"
+#include "util/vector.h"
+
+#include "renderer/camera/camera.h"
+#include "renderer/camera/frustum_2d.h"
+#include "renderer/null/renderer.h"
+#include "renderer/resources/animation/animation_info.h"
+#include "renderer/resources/animation/layer_info.h"
+#include "renderer/resources/texture_info.h"
+#include "renderer/resources/texture_subinfo.h"
+#include "renderer/stages/world/world_render_entity.h"
+
+
+namespace openage::renderer::world::tests {
+
+/**
+ * Render side curves that are updated from a world render entity.
+ */
+struct render_curves {
+	curve::Continuous<coord::scene3> position{nullptr, 0, "", nullptr, coord::scene3{0, 0, 0}};
+	curve::Segmented<coord::phys_angle_t> angle{nullptr, 0, "", nullptr, 0};
+	curve::Discrete<util::Symbol> animation{nullptr, 0};
+
+	/**
+	 * Apply all pending keyframes of a render entity.
+	 *
+	 * @return Number of applied keyframes.
+	 */
+	size_t fetch(WorldRenderEntity &entity) {
+		size_t count = 0;
+		world_delta delta;
+		while (entity.fetch_delta(delta)) {
+			switch (delta.curve) {
+			case world_delta::curve_t::POSITION:
+				apply_delta(this->position, delta.replace, delta.time, delta.position);
+				break;
+			case world_delta::curve_t::ANGLE:
+				apply_delta(this->angle, delta.replace, delta.time, delta.angle);
+				break;
+			case world_delta::curve_t::ANIMATION:
+				apply_delta(this->animation, delta.replace, delta.time, delta.animation);
+				break;
+			default:
+				break;
+			}
+			count += 1;
+		}
+		return count;
+	}
+};
+
+
+/**
+ * Render entity as it was before the delta channel was introduced: the gamestate
+ * curves are copied into the entity under a mutex and copied again by the renderer.
+ */
+struct locked_render_entity {
+	std::mutex mutex;
+	bool changed = false;
+	time::time_t last_update = 0;
+	curve::Continuous<coord::scene3> position{nullptr, 0, "", nullptr, coord::scene3{0, 0, 0}};
+	curve::Segmented<coord::phys_angle_t> angle{nullptr, 0, "", nullptr, 0};
+	curve::Discrete<util::Symbol> animation{nullptr, 0};
+
+	void update(const curve::Continuous<coord::phys3> &pos,
+	            const curve::Segmented<coord::phys_angle_t> &ang,
+	            const util::Symbol &anim,
+	            const time::time_t &time) {
+		std::unique_lock lock{this->mutex};
+		this->position.sync(pos,
+		                    std::function<coord::scene3(const coord::phys3 &)>([](const coord::phys3 &p) {
+								return p.to_scene3();
+							}),
+		                    this->last_update);
+		this->angle.sync(ang, this->last_update);
+		this->animation.set_last(time, anim);
+		this->changed = true;
+		this->last_update = time;
+	}
+
+	void fetch(render_curves &curves, const time::time_t &last_fetch) {
+		std::unique_lock lock{this->mutex};
+		if (not this->changed) {
+			return;
+		}
+		curves.position.sync(this->position, last_fetch);
+		curves.angle.sync(this->angle, last_fetch);
+		curves.animation.sync(this->animation, last_fetch);
+		this->changed = false;
+	}
+};
+
+
+void render_entity_deltas() {
+	curve::Continuous<coord::phys3> position{nullptr, 0, "", nullptr, coord::phys3{0, 0, 0}};
+	curve::Segmented<coord::phys_angle_t> angle{nullptr, 0, "", nullptr, 0};
+	util::Symbol idle{"test/idle.sprite"};
+	util::Symbol move{"test/move.sprite"};
+
+	WorldRenderEntity entity;
+	render_curves curves;
+
+	// nothing has been sent yet
+	TESTEQUALS(curves.fetch(entity), 0);
+
+	// move along a path that lies in the future
+	position.set_last(0, coord::phys3{1, 1, 0});
+	position.set_last(10, coord::phys3{5, 1, 0});
+	position.set_last(20, coord::phys3{5, 7, 0});
+	angle.set_last(0, 90);
+	angle.set_last(10, 180);
+	entity.update(42, position, angle, move, 0);
+
+	TESTEQUALS(entity.get_id(), 42);
+	TESTEQUALS(entity.get_owner(), 0);
+	(curves.fetch(entity) > 0) or TESTFAIL;
+	for (time::time_t t : {0, 10, 20, 30}) {
+		(curves.position.get(t) == position.get(t).to_scene3()) or TESTFAIL;
+		TESTEQUALS(curves.angle.get(t), angle.get(t));
+	}
+	(curves.animation.get(5) == move) or TESTFAIL;
+
+	// the path is changed at t = 5 and the unit stops at t = 15
+	position.set_last(5, position.get(5));
+	position.set_last(15, coord::phys3{9, 1, 0});
+	angle.set_last(5, 45);
+	entity.update(42, position, angle, move, 5);
+	entity.update(42, position, angle, idle, 15);
+
+	// both updates arrive in one fetch
+	curves.fetch(entity);
+	for (time::time_t t : {5, 10, 15, 20, 30}) {
+		(curves.position.get(t) == position.get(t).to_scene3()) or TESTFAIL;
+		TESTEQUALS(curves.angle.get(t), angle.get(t));
+	}
+	(curves.animation.get(10) == move) or TESTFAIL;
+	(curves.animation.get(20) == idle) or TESTFAIL;
+
+	// keyframes before the update time are kept
+	TESTEQUALS(curves.angle.get(2), angle.get(2));
+
+	// everything has been fetched
+	TESTEQUALS(curves.fetch(entity), 0);
+
+	// the owner selects the palette row of the renderer
+	entity.set_owner(3);
+	TESTEQUALS(entity.get_owner(), 3);
+}
+
+
+void frustum_culling() {
+	// sprite bounds are the largest distance from the anchor to a frame edge
+	std::vector<resources::Texture2dSubInfo> subtextures{
+		resources::Texture2dSubInfo{0, 0, 64, 64, 10, 60, 128, 64},
+		resources::Texture2dSubInfo{64, 0, 32, 48, 16, 24, 128, 64},
+	};
+	std::vector<std::shared_ptr<resources::Texture2dInfo>> textures{
+		std::make_shared<resources::Texture2dInfo>(128,
+		                                           64,
+		                                           resources::pixel_format::rgba8,
+		                                           std::nullopt,
+		                                           1,
+		                                           std::move(subtextures)),
+	};
+	std::vector<resources::LayerInfo> layers;
+	resources::Animation2dInfo animation{1.0f, textures, layers};
+	TESTEQUALS(animation.get_max_bounds()[0], 54.0f);
+	TESTEQUALS(animation.get_max_bounds()[1], 60.0f);
+
+	util::Vector2s viewport{800, 600};
+	auto renderer = std::make_shared<null::NullRenderer>(viewport);
+	camera::Camera camera{renderer, viewport};
+	camera.look_at_scene(Eigen::Vector3f{0.0f, 0.0f, 0.0f});
+
+	// at zoom 1.0, the viewport is about 8.2 units wide in the scene
+	Eigen::Vector3f right = Eigen::Vector3f{1.0f, 0.0f, -1.0f}.normalized();
+	Eigen::Vector2f no_bounds{0.0f, 0.0f};
+	Eigen::Vector2f sprite_bounds{50.0f, 50.0f};
+
+	auto frustum = camera.get_frustum_2d();
+	frustum.is_visible(Eigen::Vector3f{0.0f, 0.0f, 0.0f}, 1.0f, no_bounds) or TESTFAIL;
+	frustum.is_visible(right * 3.5f, 1.0f, no_bounds) or TESTFAIL;
+	(not frustum.is_visible(right * 4.5f, 1.0f, no_bounds)) or TESTFAIL;
+	(not frustum.is_visible(Eigen::Vector3f{100.0f, 0.0f, -100.0f}, 1.0f, sprite_bounds)) or TESTFAIL;
+
+	// sprites that extend into the viewport are visible
+	frustum.is_visible(right * 4.5f, 1.0f, sprite_bounds) or TESTFAIL;
+	(not frustum.is_visible(right * 4.5f, 0.5f, sprite_bounds)) or TESTFAIL;
+
+	// zooming out brings the object into view
+	camera.set_zoom(2.0f);
+	frustum = camera.get_frustum_2d();
+	frustum.is_visible(right * 4.5f, 1.0f, no_bounds) or TESTFAIL;
+	(not frustum.is_visible(right * 9.0f, 1.0f, no_bounds)) or TESTFAIL;
+
+	// moving the camera moves the frustum
+	camera.look_at_scene(right * 9.0f);
+	frustum = camera.get_frustum_2d();
+	frustum.is_visible(right * 9.0f, 1.0f, no_bounds) or TESTFAIL;
+	(not frustum.is_visible(Eigen::Vector3f{0.0f, 0.0f, 0.0f}, 1.0f, no_bounds)) or TESTFAIL;
+}
+
+
+void update_benchmark() {
+	const size_t unit_count = 20000;
+	const size_t tick_count = 50;
+	const time::time_t tick_length = 1;
+
+	util::Symbol animation{"test/move.sprite"};
+
+	// gamestate curves of all units
+	std::vector<std::unique_ptr<curve::Continuous<coord::phys3>>> positions;
+	std::vector<std::unique_ptr<curve::Segmented<coord::phys_angle_t>>> angles;
+	for (size_t i = 0; i < unit_count; ++i) {
+		positions.push_back(std::make_unique<curve::Continuous<coord::phys3>>(
+			nullptr, 0, "", nullptr, coord::phys3{0, 0, 0}));
+		angles.push_back(std::make_unique<curve::Segmented<coord::phys_angle_t>>(
+			nullptr, 0, "", nullptr, 0));
+	}
+
+	// every tick, every unit gets a new waypoint in the future
+	auto move_units = [&](size_t tick) {
+		time::time_t now = tick_length * static_cast<int>(tick);
+		for (size_t i = 0; i < unit_count; ++i) {
+			auto &position = *positions[i];
+			position.set_last(now, position.get(now));
+			position.set_last(now + tick_length * 4,
+			                  coord::phys3{static_cast<double>(tick), static_cast<double>(i % 100), 0});
+			angles[i]->set_last(now, static_cast<int>((tick * 45) % 360));
+		}
+		return now;
+	};
+
+	size_t received = 0;
+
+	std::vector<std::unique_ptr<WorldRenderEntity>> entities;
+	std::vector<render_curves> delta_curves(unit_count);
+	for (size_t i = 0; i < unit_count; ++i) {
+		entities.push_back(std::make_unique<WorldRenderEntity>());
+	}
+
+	std::chrono::duration<double> delta_update{0};
+	std::chrono::duration<double> delta_fetch{0};
+	for (size_t tick = 0; tick < tick_count; ++tick) {
+		auto now = move_units(tick);
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < unit_count; ++i) {
+			entities[i]->update(i, *positions[i], *angles[i], animation, now);
+		}
+		auto mid = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < unit_count; ++i) {
+			received += delta_curves[i].fetch(*entities[i]);
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		delta_update += mid - start;
+		delta_fetch += end - mid;
+	}
+
+	// reset the gamestate for the second run
+	positions.clear();
+	angles.clear();
+	for (size_t i = 0; i < unit_count; ++i) {
+		positions.push_back(std::make_unique<curve::Continuous<coord::phys3>>(
+			nullptr, 0, "", nullptr, coord::phys3{0, 0, 0}));
+		angles.push_back(std::make_unique<curve::Segmented<coord::phys_angle_t>>(
+			nullptr, 0, "", nullptr, 0));
+	}
+
+	std::vector<std::unique_ptr<locked_render_entity>> locked_entities;
+	std::vector<render_curves> locked_curves(unit_count);
+	for (size_t i = 0; i < unit_count; ++i) {
+		locked_entities.push_back(std::make_unique<locked_render_entity>());
+	}
+
+	std::chrono::duration<double> locked_update{0};
+	std::chrono::duration<double> locked_fetch{0};
+	time::time_t last_fetch = 0;
+	for (size_t tick = 0; tick < tick_count; ++tick) {
+		auto now = move_units(tick);
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < unit_count; ++i) {
+			locked_entities[i]->update(*positions[i], *angles[i], animation, now);
+		}
+		auto mid = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < unit_count; ++i) {
+			locked_entities[i]->fetch(locked_curves[i], last_fetch);
+		}
+		auto end = std::chrono::steady_clock::now();
+		last_fetch = now;
+
+		locked_update += mid - start;
+		locked_fetch += end - mid;
+	}
+
+	// both channels must produce the same render state
+	time::time_t end_time = tick_length * static_cast<int>(tick_count + 4);
+	for (size_t i = 0; i < unit_count; i += 997) {
+		(delta_curves[i].position.get(end_time) == locked_curves[i].position.get(end_time)) or TESTFAIL;
+	}
+
+	auto updates = static_cast<double>(unit_count * tick_count);
+	log::log(MSG(info) << unit_count << " moving units, " << tick_count << " ticks, "
+	                   << received / (unit_count * tick_count) << " keyframes per update");
+	log::log(MSG(info) << "  curve sync under mutex: "
+	                   << locked_update.count() * 1e9 / updates << " ns per update, "
+	                   << locked_fetch.count() * 1e9 / updates << " ns per fetch, "
+	                   << updates / (locked_update + locked_fetch).count() << " updates/s");
+	log::log(MSG(info) << "  lock-free delta channel: "
+	                   << delta_update.count() * 1e9 / updates << " ns per update, "
+	                   << delta_fetch.count() * 1e9 / updates << " ns per fetch, "
+	                   << updates / (delta_update + delta_fetch).count() << " updates/s");
+}
+
+} // namespace openage::renderer::world::tests
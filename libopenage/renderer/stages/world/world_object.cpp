@@ -4,13 +4,13 @@
 
 #include <array>
 #include <cstddef>
-#include <functional>
 #include <optional>
 #include <utility>
 
 #include <eigen3/Eigen/Dense>
 
 #include "renderer/camera/camera.h"
+#include "renderer/camera/frustum_2d.h"
 #include "renderer/definitions.h"
 #include "renderer/resources/animation/angle_info.h"
 #include "renderer/resources/animation/animation_info.h"
@@ -22,14 +22,31 @@
 #include "renderer/resources/mesh_data.h"
 #include "renderer/resources/texture_info.h"
 #include "renderer/resources/texture_subinfo.h"
+#include "renderer/shader_program.h"
 #include "renderer/stages/world/world_render_entity.h"
+#include "renderer/texture.h"
 #include "renderer/uniform_input.h"
 #include "util/fixed_point.h"
+#include "util/symbol.h"
 #include "util/vector.h"
 
 
 namespace openage::renderer::world {
 
+WorldObject::uniform_ids WorldObject::get_uniform_ids(const std::shared_ptr<ShaderProgram> &program) {
+	return uniform_ids{
+		program->get_uniform_id("obj_world_position"),
+		program->get_uniform_id("flip_x"),
+		program->get_uniform_id("tex"),
+		program->get_uniform_id("indexed"),
+		program->get_uniform_id("palette"),
+		program->get_uniform_id("palette_row"),
+		program->get_uniform_id("tile_params"),
+		program->get_uniform_id("scale"),
+		program->get_uniform_id("anchor_offset"),
+	};
+}
+
 WorldObject::WorldObject(const std::shared_ptr<renderer::resources::AssetManager> &asset_manager) :
 	require_renderable{true},
 	changed{false},
@@ -37,11 +54,15 @@ WorldObject::WorldObject(const std::shared_ptr<renderer::resources::AssetManager
 	asset_manager{asset_manager},
 	render_entity{nullptr},
 	ref_id{0},
+	owner_id{0},
 	position{nullptr, 0, "", nullptr, SCENE_ORIGIN},
 	angle{nullptr, 0, "", nullptr, 0},
 	animation_info{nullptr, 0},
 	uniforms{nullptr},
-	last_update{0.0} {
+	unif_ids{},
+	texture{nullptr},
+	palette_row{0},
+	update_time{0.0} {
 }
 
 void WorldObject::set_render_entity(const std::shared_ptr<WorldRenderEntity> &entity) {
@@ -53,44 +74,63 @@ void WorldObject::set_camera(const std::shared_ptr<renderer::camera::Camera> &ca
 	this->camera = camera;
 }
 
-void WorldObject::fetch_updates(const time::time_t &time) {
-	if (not this->render_entity->is_changed()) {
+void WorldObject::fetch_updates(const time::time_t & /* time */) {
+	// Apply the keyframes that the gamestate has sent since the last call
+	bool received = false;
+	world_delta delta;
+	while (this->render_entity->fetch_delta(delta)) {
+		received = true;
+		switch (delta.curve) {
+		case world_delta::curve_t::POSITION:
+			apply_delta(this->position, delta.replace, delta.time, delta.position);
+			break;
+		case world_delta::curve_t::ANGLE:
+			apply_delta(this->angle, delta.replace, delta.time, delta.angle);
+			break;
+		case world_delta::curve_t::ANIMATION:
+			apply_delta(this->animation_info, delta.replace, delta.time, this->resolve_animation(delta.animation));
+			this->update_time = delta.time;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (not received) {
 		// exit early because there is nothing to do
 		return;
 	}
-	// Get data from render entity
+
 	this->ref_id = this->render_entity->get_id();
-	this->position.sync(this->render_entity->get_position());
-	this->animation_info.sync(this->render_entity->get_animation_path(),
-	                          std::function<std::shared_ptr<renderer::resources::Animation2dInfo>(const std::string &)>(
-								  [&](const std::string &path) {
-									  if (path.empty()) {
-										  auto placeholder = this->asset_manager->get_placeholder_animation();
-										  if (placeholder) {
-											  return (*placeholder).second;
-										  }
-										  return std::shared_ptr<renderer::resources::Animation2dInfo>{nullptr};
-									  }
-									  return this->asset_manager->request_animation(path);
-								  }),
-	                          this->last_update);
-	this->angle.sync(this->render_entity->get_angle(), this->last_update);
+	this->owner_id = this->render_entity->get_owner();
 
 	// Set self to changed so that world renderer can update the renderable
 	this->changed = true;
-	this->render_entity->clear_changed_flag();
-	this->last_update = time;
+}
+
+bool WorldObject::is_visible(const camera::Frustum2d &frustum,
+                             const time::time_t &time) {
+	auto animation_info = this->animation_info.get(time);
+	if (animation_info == nullptr) [[unlikely]] {
+		return false;
+	}
+
+	auto current_pos = this->position.get(time);
+	return frustum.is_visible(current_pos.to_world_space(),
+	                          animation_info->get_scalefactor(),
+	                          animation_info->get_max_bounds());
 }
 
 void WorldObject::update_uniforms(const time::time_t &time) {
-	// TODO: Only update uniforms that changed since last update
+	// Uniforms are set by their pre-resolved IDs. Values that did not change
+	// since the last draw are not uploaded again by the renderer.
 	if (this->uniforms == nullptr) [[unlikely]] {
 		return;
 	}
 
 	// Object world position
 	auto current_pos = this->position.get(time);
-	this->uniforms->update("obj_world_position", current_pos.to_world_space());
+	this->uniforms->update(this->unif_ids.obj_world_position, current_pos.to_world_space());
 
 	// Direction angle the object is facing towards currently
 	auto angle_degrees = this->angle.get(time).to_float();
@@ -102,10 +142,10 @@ void WorldObject::update_uniforms(const time::time_t &time) {
 
 	// Flip subtexture horizontally if angle is mirrored
 	if (angle->is_mirrored()) {
-		this->uniforms->update("flip_x", true);
+		this->uniforms->update(this->unif_ids.flip_x, true);
 	}
 	else {
-		this->uniforms->update("flip_x", false);
+		this->uniforms->update(this->unif_ids.flip_x, false);
 	}
 
 	// Current frame index considering current time
@@ -115,7 +155,7 @@ void WorldObject::update_uniforms(const time::time_t &time) {
 	case renderer::resources::display_mode::LOOP: {
 		// ONCE and LOOP are animated based on time
 		auto &timing = layer.get_frame_timing();
-		frame_idx = timing->get_frame(time, this->render_entity->get_update_time());
+		frame_idx = timing->get_frame(time, this->update_time);
 	} break;
 	case renderer::resources::display_mode::OFF:
 	default:
@@ -132,11 +172,37 @@ void WorldObject::update_uniforms(const time::time_t &time) {
 	auto &tex_info = animation_info->get_texture(tex_idx);
 	auto &tex_manager = this->asset_manager->get_texture_manager();
 	auto &texture = tex_manager->request(tex_info->get_image_path().value());
-	this->uniforms->update("tex", texture);
+	if (texture != this->texture) {
+		this->texture = texture;
+		this->uniforms->update(this->unif_ids.tex, texture);
+
+		// Indexed textures are colored with the palette lookup table.
+		// The asset manager only loads them if the lookup table exists.
+		bool indexed = tex_info->get_format() == renderer::resources::pixel_format::r8;
+		this->uniforms->update(this->unif_ids.indexed, indexed);
+		if (indexed) {
+			this->uniforms->update(this->unif_ids.palette, this->asset_manager->get_palette_lut());
+		}
+	}
+
+	// The player colors are taken from the owner's row of the lookup table.
+	// Row 0 has the base palette, which is used for owners without a palette.
+	if (tex_info->get_format() == renderer::resources::pixel_format::r8) {
+		auto &lut = this->asset_manager->get_palette_lut();
+		int palette_row = 0;
+		if (this->owner_id < static_cast<uint64_t>(lut->get_info().get_size().second)) {
+			palette_row = static_cast<int>(this->owner_id);
+		}
+
+		if (palette_row != this->palette_row) {
+			this->uniforms->update(this->unif_ids.palette_row, palette_row);
+			this->palette_row = palette_row;
+		}
+	}
 
 	// Subtexture coordinates.inside texture
 	auto coords = tex_info->get_subtex_info(subtex_idx).get_tile_params();
-	this->uniforms->update("tile_params", coords);
+	this->uniforms->update(this->unif_ids.tile_params, coords);
 
 	// scale and keep width x height ratio of texture
 	// when the viewport size changes
@@ -148,14 +214,14 @@ void WorldObject::update_uniforms(const time::time_t &time) {
 	auto scale_vec = Eigen::Vector2f{
 		scale * (static_cast<float>(subtex_size[0]) / screen_size[0]),
 		scale * (static_cast<float>(subtex_size[1]) / screen_size[1])};
-	this->uniforms->update("scale", scale_vec);
+	this->uniforms->update(this->unif_ids.scale, scale_vec);
 
 	// Move subtexture in scene so that its anchor point is at the object's position
 	auto anchor = tex_info->get_subtex_info(subtex_idx).get_anchor_params();
 	auto anchor_offset = Eigen::Vector2f{
 		scale * (static_cast<float>(anchor[0]) / screen_size[0]),
 		scale * (static_cast<float>(anchor[1]) / screen_size[1])};
-	this->uniforms->update("anchor_offset", anchor_offset);
+	this->uniforms->update(this->unif_ids.anchor_offset, anchor_offset);
 }
 
 uint32_t WorldObject::get_id() {
@@ -182,8 +248,26 @@ void WorldObject::clear_changed_flag() {
 	this->changed = false;
 }
 
-void WorldObject::set_uniforms(const std::shared_ptr<renderer::UniformInput> &uniforms) {
+std::shared_ptr<renderer::resources::Animation2dInfo> WorldObject::resolve_animation(const util::Symbol &path) {
+	if (path.empty()) {
+		auto placeholder = this->asset_manager->get_placeholder_animation();
+		if (placeholder) {
+			return (*placeholder).second;
+		}
+		return nullptr;
+	}
+	return this->asset_manager->request_animation(path);
+}
+
+void WorldObject::set_uniforms(const std::shared_ptr<renderer::UniformInput> &uniforms,
+                               const uniform_ids &ids) {
 	this->uniforms = uniforms;
+	this->unif_ids = ids;
+
+	// the texture is not set in the new uniforms yet,
+	// the palette row is initialized with 0 by the world renderer
+	this->texture = nullptr;
+	this->palette_row = 0;
 }
 
 } // namespace openage::renderer::world
@@ -12,15 +12,19 @@
 #include "curve/discrete.h"
 #include "curve/segmented.h"
 #include "renderer/resources/mesh_data.h"
+#include "renderer/uniform_input.h"
 #include "time/time.h"
+#include "util/symbol.h"
 
 
 namespace openage::renderer {
-class UniformInput;
+class ShaderProgram;
+class Texture2d;
 
 namespace camera {
 class Camera;
-}
+class Frustum2d;
+} // namespace camera
 
 namespace resources {
 class AssetManager;
@@ -32,6 +36,31 @@ class WorldRenderEntity;
 
 class WorldObject {
 public:
+	/**
+	 * IDs of the shader uniforms that are updated every frame.
+	 */
+	struct uniform_ids {
+		uniform_id_t obj_world_position;
+		uniform_id_t flip_x;
+		uniform_id_t tex;
+		uniform_id_t indexed;
+		uniform_id_t palette;
+		uniform_id_t palette_row;
+		uniform_id_t tile_params;
+		uniform_id_t scale;
+		uniform_id_t anchor_offset;
+	};
+
+	/**
+	 * Resolve the IDs of the uniforms that are updated every frame.
+	 * Should be called once per shader program.
+	 *
+	 * @param program Shader program of the world renderables.
+	 *
+	 * @return Uniform IDs.
+	 */
+	static uniform_ids get_uniform_ids(const std::shared_ptr<ShaderProgram> &program);
+
 	WorldObject(const std::shared_ptr<renderer::resources::AssetManager> &asset_manager);
 	~WorldObject() = default;
 
@@ -52,10 +81,25 @@ public:
 	/**
      * Fetch updates from the render entity.
      *
+     * Applies the keyframes that the gamestate has sent since the last call.
+     *
      * @param time Current simulation time.
      */
 	void fetch_updates(const time::time_t &time = 0.0);
 
+	/**
+	 * Check whether the object is inside the camera frustum.
+	 *
+	 * Objects without an animation are never visible.
+	 *
+	 * @param frustum Frustum of the current camera view.
+	 * @param time Current simulation time.
+	 *
+	 * @return true if the object is (partially) visible, else false.
+	 */
+	bool is_visible(const camera::Frustum2d &frustum,
+	                const time::time_t &time = 0.0);
+
 	/**
      * Update the uniforms of the renderable associated with this object.
      *
@@ -111,11 +155,22 @@ public:
      * when calling \p update().
      *
      * @param uniforms Uniform inputs of this object's renderable.
+     * @param ids IDs of the updated uniforms in the shader program of \p uniforms.
      */
-	void set_uniforms(const std::shared_ptr<renderer::UniformInput> &uniforms);
+	void set_uniforms(const std::shared_ptr<renderer::UniformInput> &uniforms,
+	                  const uniform_ids &ids);
 
 private:
 	/**
+	 * Get the animation for an animation path.
+	 *
+	 * @param path Path to the animation definition. If empty, the placeholder animation is used.
+	 *
+	 * @return Animation information.
+	 */
+	std::shared_ptr<renderer::resources::Animation2dInfo> resolve_animation(const util::Symbol &path);
+
+	/**
      * Stores whether a new renderable for this object needs to be created
      * for the render pass.
      */
@@ -147,6 +202,12 @@ private:
 	 */
 	uint32_t ref_id;
 
+	/**
+	 * Player ID of the owner. Selects the row of the palette lookup table
+	 * that indexed textures are colored with.
+	 */
+	uint64_t owner_id;
+
 	/**
 	 * Position of the object.
 	 */
@@ -168,9 +229,26 @@ private:
 	std::shared_ptr<renderer::UniformInput> uniforms;
 
 	/**
-	 * Time of the last update call.
+	 * IDs of the uniforms in \p uniforms that are updated every frame.
+	 */
+	uniform_ids unif_ids;
+
+	/**
+	 * Texture that is currently set in \p uniforms. The texture dependent
+	 * uniforms are only updated when the texture changes.
+	 */
+	std::shared_ptr<renderer::Texture2d> texture;
+
+	/**
+	 * Palette row that is currently set in \p uniforms.
+	 */
+	int palette_row;
+
+	/**
+	 * Time of the last animation update from the gamestate.
+	 * Animation frames are timed relative to it.
 	 */
-	time::time_t last_update;
+	time::time_t update_time;
 };
 } // namespace world
 } // namespace openage::renderer
@@ -2,42 +2,45 @@
 
 #include "world_render_entity.h"
 
-#include <functional>
-#include <mutex>
-
 #include "renderer/definitions.h"
 
 
 namespace openage::renderer::world {
 
 WorldRenderEntity::WorldRenderEntity() :
-	changed{false},
 	ref_id{0},
-	position{nullptr, 0, "", nullptr, SCENE_ORIGIN},
-	angle{nullptr, 0, "", nullptr, 0},
-	animation_path{nullptr, 0},
+	owner_id{0},
+	deltas{},
 	last_update{0.0} {
 }
 
 void WorldRenderEntity::update(const uint32_t ref_id,
                                const curve::Continuous<coord::phys3> &position,
                                const curve::Segmented<coord::phys_angle_t> &angle,
-                               const std::string animation_path,
+                               const util::Symbol &animation_path,
                                const time::time_t time) {
-	std::unique_lock lock{this->mutex};
-
-	this->ref_id = ref_id;
-	std::function<coord::scene3(const coord::phys3 &)> to_scene3 = [](const coord::phys3 &pos) {
-		return pos.to_scene3();
-	};
-	this->position.sync(position,
-	                    std::function<coord::scene3(const coord::phys3 &)>([](const coord::phys3 &pos) {
-							return pos.to_scene3();
-						}),
-	                    this->last_update);
-	this->angle.sync(angle, this->last_update);
-	this->animation_path.set_last(time, animation_path);
-	this->changed = true;
+	this->ref_id.store(ref_id, std::memory_order_relaxed);
+
+	// only send the keyframes that the previous update did not cover
+	this->push_keyframes(position,
+	                     world_delta::curve_t::POSITION,
+	                     this->last_update,
+	                     [](world_delta &delta, const coord::phys3 &pos) {
+							 delta.position = pos.to_scene3();
+						 });
+	this->push_keyframes(angle,
+	                     world_delta::curve_t::ANGLE,
+	                     this->last_update,
+	                     [](world_delta &delta, const coord::phys_angle_t &angle) {
+							 delta.angle = angle;
+						 });
+
+	world_delta animation;
+	animation.curve = world_delta::curve_t::ANIMATION;
+	animation.time = time;
+	animation.animation = animation_path;
+	this->deltas.push(std::move(animation));
+
 	this->last_update = time;
 }
 
@@ -45,55 +48,61 @@ void WorldRenderEntity::update(const uint32_t ref_id,
                                const coord::phys3 position,
                                const std::string animation_path,
                                const time::time_t time) {
-	std::unique_lock lock{this->mutex};
-
-	this->ref_id = ref_id;
-	this->position.set_last(time, position.to_scene3());
-	this->animation_path.set_last(time, animation_path);
-	this->changed = true;
-	this->last_update = time;
-}
-
-uint32_t WorldRenderEntity::get_id() {
-	std::shared_lock lock{this->mutex};
+	this->ref_id.store(ref_id, std::memory_order_relaxed);
 
-	return this->ref_id;
-}
+	world_delta pos;
+	pos.curve = world_delta::curve_t::POSITION;
+	pos.time = time;
+	pos.position = position.to_scene3();
+	this->deltas.push(std::move(pos));
 
-const curve::Continuous<coord::scene3> &WorldRenderEntity::get_position() {
-	std::shared_lock lock{this->mutex};
+	world_delta animation;
+	animation.curve = world_delta::curve_t::ANIMATION;
+	animation.time = time;
+	animation.animation = util::Symbol{animation_path};
+	this->deltas.push(std::move(animation));
 
-	return this->position;
+	this->last_update = time;
 }
 
-const curve::Segmented<coord::phys_angle_t> &WorldRenderEntity::get_angle() {
-	std::shared_lock lock{this->mutex};
-
-	return this->angle;
+uint32_t WorldRenderEntity::get_id() {
+	return this->ref_id.load(std::memory_order_relaxed);
 }
 
-const curve::Discrete<std::string> &WorldRenderEntity::get_animation_path() {
-	std::shared_lock lock{this->mutex};
-
-	return this->animation_path;
+void WorldRenderEntity::set_owner(const uint64_t owner_id) {
+	this->owner_id.store(owner_id, std::memory_order_relaxed);
 }
 
-time::time_t WorldRenderEntity::get_update_time() {
-	std::shared_lock lock{this->mutex};
-
-	return this->last_update;
+uint64_t WorldRenderEntity::get_owner() {
+	return this->owner_id.load(std::memory_order_relaxed);
 }
 
-bool WorldRenderEntity::is_changed() {
-	std::shared_lock lock{this->mutex};
-
-	return this->changed;
+bool WorldRenderEntity::fetch_delta(world_delta &delta) {
+	return this->deltas.try_pop(delta);
 }
 
-void WorldRenderEntity::clear_changed_flag() {
-	std::unique_lock lock{this->mutex};
-
-	this->changed = false;
+template <typename T, typename F>
+void WorldRenderEntity::push_keyframes(const curve::BaseCurve<T> &curve,
+                                       world_delta::curve_t type,
+                                       const time::time_t &start,
+                                       F set_value) {
+	// the value at the start replaces everything the renderer has after it
+	world_delta first;
+	first.curve = type;
+	first.time = start;
+	set_value(first, curve.get(start));
+	this->deltas.push(std::move(first));
+
+	const auto &container = curve.get_container();
+	auto it = container.last(start);
+	for (++it; it != container.end(); ++it) {
+		world_delta delta;
+		delta.curve = type;
+		delta.replace = false;
+		delta.time = it->time;
+		set_value(delta, it->value);
+		this->deltas.push(std::move(delta));
+	}
 }
 
 } // namespace openage::renderer::world
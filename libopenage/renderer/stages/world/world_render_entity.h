@@ -2,23 +2,75 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
-#include <list>
-#include <shared_mutex>
 #include <string>
 
 #include <eigen3/Eigen/Dense>
 
 #include "coord/phys.h"
 #include "coord/scene.h"
+#include "curve/base_curve.h"
 #include "curve/continuous.h"
-#include "curve/discrete.h"
 #include "curve/segmented.h"
+#include "datastructure/chunked_spsc_queue.h"
 #include "time/time.h"
+#include "util/symbol.h"
 
 
 namespace openage::renderer::world {
 
+/**
+ * Keyframe that is sent from the gamestate to the renderer.
+ */
+struct world_delta {
+	/**
+	 * Curve that the keyframe belongs to.
+	 */
+	enum class curve_t : uint8_t {
+		POSITION,
+		ANGLE,
+		ANIMATION,
+	};
+
+	/// Curve that the keyframe belongs to.
+	curve_t curve = curve_t::POSITION;
+	/// If true, the keyframe replaces all keyframes at and after its time.
+	/// Otherwise, it is appended to the keyframes of the same update.
+	bool replace = true;
+	/// Time of the keyframe.
+	time::time_t time = 0;
+	/// Value for \p POSITION keyframes.
+	coord::scene3 position{0, 0, 0};
+	/// Value for \p ANGLE keyframes.
+	coord::phys_angle_t angle = 0;
+	/// Value for \p ANIMATION keyframes.
+	util::Symbol animation;
+};
+
+
+/**
+ * Insert a keyframe received from a \p world_delta into a curve.
+ *
+ * @param curve Curve that is updated.
+ * @param replace Whether the keyframe replaces all later keyframes.
+ * @param time Time of the keyframe.
+ * @param value Value of the keyframe.
+ */
+template <typename T>
+void apply_delta(curve::BaseCurve<T> &curve,
+                 bool replace,
+                 const time::time_t &time,
+                 const T &value) {
+	if (replace) {
+		curve.set_last(time, value);
+	}
+	else {
+		curve.set_insert(time, value);
+	}
+}
+
+
 class WorldRenderEntity {
 public:
 	WorldRenderEntity();
@@ -27,6 +79,9 @@ public:
 	/**
 	 * Update the render entity with information from the gamestate.
 	 *
+	 * Must only be called from one thread at a time. The keyframes of the curves
+	 * from the previous update time onwards are passed on to the renderer.
+	 *
 	 * @param ref_id Game entity ID.
 	 * @param position Position of the game entity inside the game world.
      * @param angle Angle of the game entity inside the game world.
@@ -36,7 +91,7 @@ public:
 	void update(const uint32_t ref_id,
 	            const curve::Continuous<coord::phys3> &position,
 	            const curve::Segmented<coord::phys_angle_t> &angle,
-	            const std::string animation_path,
+	            const util::Symbol &animation_path,
 	            const time::time_t time = 0.0);
 
 	/**
@@ -62,82 +117,64 @@ public:
 	uint32_t get_id();
 
 	/**
-	 * Get the position of the entity inside the game world.
+	 * Set the player that owns the game entity. Selects the player
+	 * colors of indexed textures.
 	 *
-	 * @return Position curve of the entity.
+	 * @param owner_id Player ID of the owner.
 	 */
-	const curve::Continuous<coord::scene3> &get_position();
-
-	/**
-     * Get the angle of the entity inside the game world.
-     *
-     * @return Angle curve of the entity.
-     */
-	const curve::Segmented<coord::phys_angle_t> &get_angle();
-
-	/**
-     * Get the animation definition path.
-     *
-     * @return Path to the animation definition file.
-     */
-	const curve::Discrete<std::string> &get_animation_path();
+	void set_owner(const uint64_t owner_id);
 
 	/**
-	 * Get the time of the last update.
+	 * Get the player that owns the game entity.
 	 *
-	 * @return Time of last update.
+	 * @return Player ID of the owner.
 	 */
-	time::time_t get_update_time();
+	uint64_t get_owner();
 
 	/**
-	 * Check whether the render entity has received new updates from the
-	 * gamestate.
+	 * Get the next keyframe sent by the gamestate.
 	 *
-	 * @return true if updates have been received, else false.
-	 */
-	bool is_changed();
-
-	/**
-	 * Clear the update flag by setting it to false.
+	 * Does not lock. Must only be called from the render thread.
+	 *
+	 * @param delta Receives the keyframe.
+	 *
+	 * @return true if there was a keyframe, false if all keyframes have been fetched.
 	 */
-	void clear_changed_flag();
+	bool fetch_delta(world_delta &delta);
 
 private:
 	/**
-	 * Flag for determining if the render entity has been updated by the
-	 * corresponding gamestate entity. Set to true every time \p update()
-	 * is called.
+	 * Send the keyframes of a gamestate curve from \p start onwards.
+	 *
+	 * @param curve Gamestate curve.
+	 * @param type Curve type of the keyframes.
+	 * @param start Time of the first keyframe.
+	 * @param set_value Function that stores a value of the curve in a delta.
 	 */
-	bool changed;
+	template <typename T, typename F>
+	void push_keyframes(const curve::BaseCurve<T> &curve,
+	                    world_delta::curve_t type,
+	                    const time::time_t &start,
+	                    F set_value);
 
 	/**
 	 * ID of the game entity in the gamestate.
 	 */
-	uint32_t ref_id;
+	std::atomic<uint32_t> ref_id;
 
 	/**
-	 * Position inside the game world.
+	 * Player ID of the owner of the game entity.
 	 */
-	curve::Continuous<coord::scene3> position;
-
-	/**
-     * Angle of the entity inside the game world.
-     */
-	curve::Segmented<coord::phys_angle_t> angle;
+	std::atomic<uint64_t> owner_id;
 
 	/**
-	 * Path to the animation definition file.
+	 * Keyframes that have not been fetched by the renderer yet.
 	 */
-	curve::Discrete<std::string> animation_path;
+	datastructure::ChunkedSPSCQueue<world_delta> deltas;
 
 	/**
-	 * Time of the last update call.
+	 * Time of the last update call. Only accessed by the gamestate.
 	 */
 	time::time_t last_update;
-
-	/**
-	 * Mutex for protecting threaded access.
-	 */
-	std::shared_mutex mutex;
 };
 } // namespace openage::renderer::world
@@ -3,7 +3,8 @@
 #include "world_renderer.h"
 
 #include "renderer/camera/camera.h"
-#include "renderer/opengl/context.h"
+#include "renderer/camera/frustum_2d.h"
+#include "renderer/renderer.h"
 #include "renderer/resources/assets/asset_manager.h"
 #include "renderer/resources/shader_source.h"
 #include "renderer/resources/texture_info.h"
@@ -26,9 +27,11 @@ WorldRenderer::WorldRenderer(const std::shared_ptr<Window> &window,
 	camera{camera},
 	asset_manager{asset_manager},
 	render_objects{},
+	renderables{},
+	visible_objects{},
 	clock{clock},
 	default_geometry{this->renderer->add_mesh_geometry(WorldObject::get_mesh())} {
-	renderer::opengl::GlContext::check_error();
+	this->renderer->check_error();
 
 	auto size = window->get_size();
 	this->initialize_render_pass(size[0], size[1], shaderdir);
@@ -49,13 +52,27 @@ void WorldRenderer::add_render_entity(const std::shared_ptr<WorldRenderEntity> e
 	world_object->set_render_entity(entity);
 	world_object->set_camera(this->camera);
 	this->render_objects.push_back(world_object);
+	this->renderables.emplace_back();
 }
 
 void WorldRenderer::update() {
 	std::unique_lock lock{this->mutex};
 	auto current_time = this->clock->get_real_time();
-	for (auto &obj : this->render_objects) {
+	auto frustum = this->camera->get_frustum_2d();
+
+	std::vector<size_t> visible;
+	visible.reserve(this->visible_objects.size());
+	for (size_t i = 0; i < this->render_objects.size(); ++i) {
+		auto &obj = this->render_objects[i];
+
+		// updates must always be fetched, even if the object is not drawn
 		obj->fetch_updates(current_time);
+
+		// objects outside the camera view are skipped entirely
+		if (not obj->is_visible(frustum, current_time)) {
+			continue;
+		}
+
 		if (obj->is_changed()) {
 			if (obj->requires_renderable()) {
 				Eigen::Matrix4f model_m = Eigen::Matrix4f::Identity();
@@ -69,26 +86,49 @@ void WorldRenderer::update() {
 					"flip_y",
 					false,
 					"u_id",
-					obj->get_id());
+					obj->get_id(),
+					"indexed",
+					false,
+					"palette_row",
+					0);
 
-				Renderable display_obj{
+				this->renderables[i] = Renderable{
 					transform_unifs,
 					this->default_geometry,
 					true,
 					true,
 				};
-
-				this->render_pass->add_renderables(display_obj);
 				obj->clear_requires_renderable();
 
 				// update remaining uniforms for the object
-				obj->set_uniforms(transform_unifs);
+				obj->set_uniforms(transform_unifs, this->unif_ids);
 			}
 		}
+		if (obj->requires_renderable()) {
+			// nothing to draw yet
+			continue;
+		}
 		obj->update_uniforms(current_time);
+		visible.push_back(i);
+	}
+
+	// only the visible objects are part of the render pass
+	if (visible != this->visible_objects) {
+		std::vector<Renderable> pass_renderables;
+		pass_renderables.reserve(visible.size());
+		for (auto idx : visible) {
+			pass_renderables.push_back(this->renderables[idx]);
+		}
+		this->render_pass->set_renderables(std::move(pass_renderables));
+		this->visible_objects = std::move(visible);
 	}
 }
 
+size_t WorldRenderer::get_visible_count() {
+	std::shared_lock lock{this->mutex};
+	return this->visible_objects.size();
+}
+
 void WorldRenderer::resize(size_t width, size_t height) {
 	this->output_texture = renderer->add_texture(resources::Texture2dInfo(width, height, resources::pixel_format::rgba8));
 	this->depth_texture = renderer->add_texture(resources::Texture2dInfo(width, height, resources::pixel_format::depth24));
@@ -121,6 +161,7 @@ void WorldRenderer::initialize_render_pass(size_t width,
 
 	this->display_shader = this->renderer->add_shader({vert_shader_src, frag_shader_src});
 	this->display_shader->bind_uniform_buffer("camera", this->camera->get_uniform_buffer());
+	this->unif_ids = WorldObject::get_uniform_ids(this->display_shader);
 
 	auto fbo = this->renderer->create_texture_target({this->output_texture, this->depth_texture, this->id_texture});
 	this->render_pass = this->renderer->add_render_pass({}, fbo);
@@ -6,6 +6,8 @@
 #include <shared_mutex>
 #include <vector>
 
+#include "renderer/renderer.h"
+#include "renderer/stages/world/world_object.h"
 #include "util/path.h"
 
 namespace openage {
@@ -32,7 +34,6 @@ class AssetManager;
 
 namespace world {
 class WorldRenderEntity;
-class WorldObject;
 
 /**
  * Renderer for drawing and displaying entities in the game world (units, buildings, etc.)
@@ -63,9 +64,19 @@ public:
 
 	/**
 	 * Update the render entities and render positions.
+	 *
+	 * Objects outside of the camera view are not updated and
+	 * are removed from the render pass.
 	 */
 	void update();
 
+	/**
+	 * Get the number of world objects that were visible in the last update.
+	 *
+	 * @return Number of objects in the render pass.
+	 */
+	size_t get_visible_count();
+
 	/**
 	 * Resize the FBO for the world rendering. This basically updates the output
      * texture size.
@@ -114,11 +125,27 @@ private:
 	 */
 	std::vector<std::shared_ptr<WorldObject>> render_objects;
 
+	/**
+	 * Renderables of the render objects (same order as \p render_objects).
+	 * Empty until an object is visible for the first time.
+	 */
+	std::vector<Renderable> renderables;
+
+	/**
+	 * Indices of the render objects whose renderables are in the render pass.
+	 */
+	std::vector<size_t> visible_objects;
+
 	/**
 	 * Shader for rendering the world objects.
 	 */
 	std::shared_ptr<renderer::ShaderProgram> display_shader;
 
+	/**
+	 * IDs of the uniforms in \p display_shader that world objects update every frame.
+	 */
+	WorldObject::uniform_ids unif_ids;
+
 	/**
 	 * Simulation clock for timing animations.
 	 */
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -17,6 +18,14 @@ class ShaderProgram;
 class Texture2d;
 class UniformBuffer;
 
+/**
+ * ID of a uniform in a shader program.
+ *
+ * IDs are resolved once with \p ShaderProgram::get_uniform_id() and can
+ * then be used to set uniform values without looking up the uniform name.
+ */
+using uniform_id_t = size_t;
+
 class DataInput {
 public:
 	virtual ~DataInput() = default;
@@ -110,6 +119,54 @@ public:
 		this->update(vals...);
 	}
 
+	/**
+	 * Set uniform values by their pre-resolved ID. This skips the name lookup
+	 * and should be preferred for uniforms that are updated every frame.
+	 *
+	 * @param id ID of the uniform (see \p ShaderProgram::get_uniform_id()).
+	 * @param val New uniform value.
+	 */
+	void update(uniform_id_t id, int32_t val);
+	void update(uniform_id_t id, uint32_t val);
+	void update(uniform_id_t id, float val);
+	void update(uniform_id_t id, double val);
+	void update(uniform_id_t id, bool val);
+	void update(uniform_id_t id, Eigen::Vector2f const &val);
+	void update(uniform_id_t id, Eigen::Vector3f const &val);
+	void update(uniform_id_t id, Eigen::Vector4f const &val);
+	void update(uniform_id_t id, Eigen::Vector2i const &val);
+	void update(uniform_id_t id, Eigen::Vector3i const &val);
+	void update(uniform_id_t id, Eigen::Vector4i const &val);
+	void update(uniform_id_t id, Eigen::Vector2<uint32_t> const &val);
+	void update(uniform_id_t id, Eigen::Vector3<uint32_t> const &val);
+	void update(uniform_id_t id, Eigen::Vector4<uint32_t> const &val);
+	void update(uniform_id_t id, std::shared_ptr<Texture2d> const &val);
+	void update(uniform_id_t id, std::shared_ptr<Texture2d> &val);
+	void update(uniform_id_t id, Eigen::Matrix4f const &val);
+
+	/**
+	 * Catch-all template in order to handle unsupported types and avoid infinite recursion.
+	 *
+	 * @param id ID of the uniform.
+	 */
+	template <typename T>
+	void update(uniform_id_t id, T) {
+		throw Error(MSG(err) << "Tried to set uniform with ID " << id
+		                     << " using unsupported type '" << util::typestring<T>() << "'");
+	}
+
+	/**
+	 * Updates multiple uniform values by their IDs, similar to the
+	 * name-based variant.
+	 *
+	 * @param id ID of the uniform.
+	 */
+	template <typename T, typename... Ts>
+	void update(uniform_id_t id, T val, Ts... vals) {
+		this->update(id, val);
+		this->update(vals...);
+	}
+
 	/**
 	 * Get the shader program the uniform input is used for.
 	 *
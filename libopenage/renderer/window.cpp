@@ -57,6 +57,12 @@ const std::shared_ptr<QWindow> &Window::get_qt_window() const {
 }
 
 void Window::close() {
+	if (this->window == nullptr) {
+		// headless windows have no Qt window
+		this->should_be_closed = true;
+		return;
+	}
+
 	this->window->close();
 }
 
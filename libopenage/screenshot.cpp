@@ -1,19 +1,29 @@
-// Copyright 2014-2019 the openage authors. See copying.md for legal info.
+// Copyright 2014-2023 the openage authors. See copying.md for legal info.
 
 #include "screenshot.h"
 
-#include <cmath>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <epoxy/gl.h>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <memory>
-#include <png.h>
+#include <system_error>
+#include <thread>
 
 #include "coord/pixel.h"
+#include "error/error.h"
 #include "job/job_manager.h"
 #include "log/log.h"
+#include "renderer/resources/frame_encoder.h"
+#include "renderer/resources/texture_data.h"
+#include "renderer/resources/texture_info.h"
+#include "trace/trace.h"
 #include "util/strings.h"
 
 namespace openage {
@@ -22,14 +32,19 @@ namespace openage {
 ScreenshotManager::ScreenshotManager(job::JobManager *job_mgr)
 	:
 	count{0},
-	job_manager{job_mgr} {
+	last_time{0},
+	job_manager{job_mgr},
+	in_flight{std::make_shared<std::atomic<size_t>>(0)},
+	capture_frame{0},
+	capture_dropped{0} {
 }
 
 
+// the pixel buffer objects are released together with the GL context
 ScreenshotManager::~ScreenshotManager() {}
 
 
-std::string ScreenshotManager::gen_next_filename() {
+std::string ScreenshotManager::gen_next_filename(const char *suffix) {
 
 	std::time_t t = std::time(NULL);
 
@@ -44,89 +59,240 @@ std::string ScreenshotManager::gen_next_filename() {
 	char timestamp[32];
 	std::strftime(timestamp, 32, "%Y-%m-%d_%H-%M-%S", std::localtime(&t));
 
-	return util::sformat("/tmp/openage_%s_%02d.png", timestamp, this->count);
+	return util::sformat("/tmp/openage_%s_%02d%s", timestamp, this->count, suffix);
 }
 
 
 void ScreenshotManager::save_screenshot(coord::viewport_delta size) {
-	coord::pixel_t width = size.x,
-	               height = size.y;
+	if (not this->read_back(size, this->gen_next_filename(".png"), frame_output::PNG)) {
+		log::log(MSG(warn) << "Too many frames are being saved, skipping screenshot.");
+	}
+}
+
+
+void ScreenshotManager::start_capture(const std::string &directory) {
+	std::error_code err;
+	std::filesystem::create_directories(directory, err);
+	if (err) {
+		log::log(MSG(err) << "Could not create capture directory '" << directory << "': "
+		                  << err.message());
+		return;
+	}
 
-	std::shared_ptr<uint8_t> pxdata(new uint8_t[4*width*height], std::default_delete<uint8_t[]>());
-	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pxdata.get());
+	this->capture_directory = directory;
+	this->capture_frame = 0;
+	this->capture_dropped = 0;
 
-	auto encode_function = [this, pxdata, size] () {
-		return this->encode_png(pxdata, size);
-	};
-	this->job_manager->enqueue<bool>(encode_function);
+	log::log(MSG(info) << "Capturing frames to '" << directory << "'.");
 }
 
 
-bool ScreenshotManager::encode_png(std::shared_ptr<uint8_t> pxdata,
-                                   coord::viewport_delta size) {
-	std::FILE *fout = NULL;
-	coord::pixel_t width = size.x,
-	               height = size.y;
-	auto warn_fn = [] (png_structp /*png_ptr*/, png_const_charp message) {
-		log::log(MSG(err) << "Creating screenshot failed: libpng error: " << message);
-	};
-	auto err_fn = [] (png_structp png_ptr, png_const_charp message) {
-		log::log(MSG(err) << "Creating screenshot failed: libpng error: " << message);
-		longjmp(png_jmpbuf(png_ptr), 1);
-	};
-
-	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING,
-	                                              (png_voidp) NULL,
-	                                              err_fn, warn_fn);
-	if (!png_ptr)
-		return false;
+void ScreenshotManager::stop_capture() {
+	if (not this->capture_directory) {
+		return;
+	}
 
-	png_infop info_ptr = png_create_info_struct(png_ptr);
-	if (!info_ptr) {
-		png_destroy_write_struct(&png_ptr, (png_infopp) NULL);
-		return false;
+	log::log(MSG(info) << "Captured " << this->capture_frame << " frames to '"
+	                   << *this->capture_directory << "', "
+	                   << this->capture_dropped << " frames were dropped.");
+
+	this->capture_directory = std::nullopt;
+}
+
+
+void ScreenshotManager::toggle_capture() {
+	if (this->capture_directory) {
+		this->stop_capture();
+	}
+	else {
+		this->start_capture(this->gen_next_filename("_capture"));
 	}
+}
 
-	if (setjmp(png_jmpbuf(png_ptr))) {
-		std::fclose(fout);
-		png_destroy_write_struct(&png_ptr, &info_ptr);
-		return false;
+
+bool ScreenshotManager::is_capturing() const {
+	return this->capture_directory.has_value();
+}
+
+
+void ScreenshotManager::update(coord::viewport_delta size) {
+	TRACE_ZONE("ScreenshotManager::update", "renderer");
+
+	if (this->capture_directory) {
+		std::string filename = util::sformat("%s/frame_%06zu_%dx%d.rgba",
+		                                     this->capture_directory->c_str(),
+		                                     this->capture_frame,
+		                                     static_cast<int>(size.x),
+		                                     static_cast<int>(size.y));
+
+		if (this->read_back(size, filename, frame_output::RAW)) {
+			this->capture_frame += 1;
+		}
+		else {
+			this->capture_dropped += 1;
+		}
+	}
+
+	this->finish_readbacks();
+
+	// finished jobs keep their frame until their callbacks have run on this thread
+	this->job_manager->execute_callbacks();
+}
+
+
+size_t ScreenshotManager::flush(std::chrono::milliseconds timeout) {
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	while (*this->in_flight > 0 and std::chrono::steady_clock::now() < deadline) {
+		this->finish_readbacks();
+		this->job_manager->execute_callbacks();
+		std::this_thread::sleep_for(std::chrono::milliseconds{1});
+	}
+	this->job_manager->execute_callbacks();
+
+	size_t dropped = *this->in_flight;
+	if (dropped > 0) {
+		log::log(MSG(warn) << dropped << " frames could not be saved in time and were dropped.");
 	}
 
-	std::string filename = this->gen_next_filename();
-	fout = std::fopen(filename.c_str(), "wb");
-	if (fout == NULL) {
-		png_destroy_write_struct(&png_ptr, &info_ptr);
-		log::log(MSG(err) << "Could not open '"<< filename << "': "
-		         << std::string(strerror(errno)));
+	return dropped;
+}
+
+
+bool ScreenshotManager::read_back(coord::viewport_delta size,
+                                  const std::string &filename,
+                                  frame_output output) {
+	if (*this->in_flight >= max_frames_in_flight) {
 		return false;
 	}
 
-	png_init_io(png_ptr, fout);
+	size_t data_size = 4 * size.x * size.y;
 
-	png_set_IHDR(png_ptr, info_ptr, width, height, 8, PNG_COLOR_TYPE_RGB,
-	             PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-	             PNG_FILTER_TYPE_DEFAULT);
+	// reuse a buffer of the same size, the others are from an old window size
+	pixel_buffer buffer{0, data_size};
+	while (not this->free_buffers.empty()) {
+		auto free = this->free_buffers.back();
+		this->free_buffers.pop_back();
 
-	// Put image row pointer into info_ptr so that we can use the high-level
-	// write interface.
-	std::vector<png_bytep> row_ptrs;
+		if (free.size == data_size) {
+			buffer = free;
+			break;
+		}
+		glDeleteBuffers(1, &free.handle);
+	}
 
-	// Invert rows.
-	row_ptrs.reserve(height);
-	for (int i = 1; i <= height; i++) {
-		row_ptrs.push_back(pxdata.get() + (height - i) * 4 * width);
+	if (buffer.handle == 0) {
+		glGenBuffers(1, &buffer.handle);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+		glBufferData(GL_PIXEL_PACK_BUFFER, data_size, nullptr, GL_STREAM_READ);
+	}
+	else {
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
 	}
-	png_set_rows(png_ptr, info_ptr, &row_ptrs[0]);
 
-	//TODO: print ingame message.
-	log::log(MSG(info) << "Saving screenshot to '" << filename << "'.");
+	// read from the window framebuffer, the render passes only bind their draw framebuffer
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
 
-	png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_STRIP_FILLER_AFTER, NULL);
+	// with a pack buffer bound, this only schedules the copy on the GPU
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	this->pending.push_back({buffer, fence, size, filename, output});
+	*this->in_flight += 1;
 
-	std::fclose(fout);
-	png_destroy_write_struct(&png_ptr, &info_ptr);
 	return true;
 }
 
+
+void ScreenshotManager::finish_readbacks() {
+	while (not this->pending.empty()) {
+		auto &front = this->pending.front();
+		auto fence = static_cast<GLsync>(front.fence);
+
+		GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		if (status == GL_TIMEOUT_EXPIRED) {
+			// the readbacks finish in order, so the later ones are not done either
+			return;
+		}
+		glDeleteSync(fence);
+
+		readback done = std::move(front);
+		this->pending.pop_front();
+
+		if (status == GL_WAIT_FAILED) {
+			log::log(MSG(err) << "Reading back the frame for '" << done.filename << "' failed.");
+			this->free_buffers.push_back(done.buffer);
+			*this->in_flight -= 1;
+			continue;
+		}
+
+		// the mapped memory is only valid on this thread, so the pixels are copied out once
+		renderer::resources::Texture2dInfo info{static_cast<size_t>(done.size.x),
+		                                        static_cast<size_t>(done.size.y),
+		                                        renderer::resources::pixel_format::rgba8,
+		                                        std::nullopt,
+		                                        4};
+		std::vector<uint8_t> pixels(done.buffer.size);
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, done.buffer.handle);
+		void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, done.buffer.size, GL_MAP_READ_BIT);
+		if (mapped != nullptr) {
+			std::memcpy(pixels.data(), mapped, done.buffer.size);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		this->free_buffers.push_back(done.buffer);
+
+		if (mapped == nullptr) {
+			log::log(MSG(err) << "Mapping the frame for '" << done.filename << "' failed.");
+			*this->in_flight -= 1;
+			continue;
+		}
+
+		// the rows are bottom-up as read by OpenGL, the encoders flip them while writing
+		auto frame = std::make_shared<renderer::resources::Texture2dData>(info, std::move(pixels));
+		auto in_flight = this->in_flight;
+		auto encode_function = [frame, filename = done.filename, output = done.output, in_flight]() {
+			TRACE_ZONE("ScreenshotManager::encode", "renderer");
+
+			bool success = false;
+			try {
+				std::ofstream out{filename, std::ios::binary};
+				if (not out) {
+					throw Error(MSG(err) << "Could not open '" << filename << "': "
+					                     << std::strerror(errno));
+				}
+
+				if (output == frame_output::PNG) {
+					auto png = renderer::resources::encode_png(*frame, true);
+					out.write(reinterpret_cast<const char *>(png.data()), png.size());
+
+					//TODO: print ingame message.
+					log::log(MSG(info) << "Saved screenshot to '" << filename << "'.");
+				}
+				else {
+					renderer::resources::write_raw_frame(out, *frame, true);
+				}
+
+				success = static_cast<bool>(out);
+			}
+			catch (const Error &err) {
+				log::log(MSG(err) << "Saving frame failed: " << err);
+			}
+			catch (const std::exception &err) {
+				log::log(MSG(err) << "Saving frame failed: " << err.what());
+			}
+			catch (...) {
+				log::log(MSG(err) << "Saving frame failed with an unknown exception.");
+			}
+
+			*in_flight -= 1;
+			return success;
+		};
+		this->job_manager->enqueue<bool>(encode_function);
+	}
+}
+
 } // openage
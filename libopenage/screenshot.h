@@ -2,9 +2,15 @@
 
 #pragma once
 
-#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <ctime>
+#include <deque>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "coord/pixel.h"
 
@@ -15,7 +21,11 @@ class JobManager;
 }
 
 /**
- * Takes screenshots, duh.
+ * Takes screenshots and captures frame sequences, duh.
+ *
+ * The framebuffer is read back into pixel buffer objects without waiting
+ * for the GPU. Once a readback has finished, the frame is encoded on
+ * the job workers: screenshots as PNG, captured frames as raw RGBA.
  *
  * TODO: move into renderer!
  */
@@ -28,20 +38,117 @@ public:
 
 	~ScreenshotManager();
 
-	/** To be called to save a screenshot. */
+	/**
+	 * To be called to save a screenshot. The framebuffer is read back
+	 * asynchronously, the screenshot is saved by one of the next
+	 * \p update() calls.
+	 */
 	void save_screenshot(coord::viewport_delta size);
 
-	/** To be called by the job manager. Returns true on success, false otherwise. */
-	bool encode_png(std::shared_ptr<uint8_t> pxdata,
-	                coord::viewport_delta size);
+	/**
+	 * Start capturing every frame into a raw RGBA frame sequence.
+	 *
+	 * @param directory Directory that the frame files are written to.
+	 *                  It is created if it doesn't exist.
+	 */
+	void start_capture(const std::string &directory);
+
+	/**
+	 * Stop capturing frames. Frames that are already read back are still written.
+	 */
+	void stop_capture();
+
+	/**
+	 * Stop the running capture, or start a new one
+	 * into a directory next to the screenshots.
+	 */
+	void toggle_capture();
+
+	/**
+	 * Check if frames are captured.
+	 *
+	 * @return true if a capture is running, else false.
+	 */
+	bool is_capturing() const;
+
+	/**
+	 * To be called once per frame after rendering, with the GL context current.
+	 * Captures the frame if a capture is running, hands finished
+	 * readbacks to the job workers and cleans up encoded frames.
+	 *
+	 * @param size Size of the framebuffer.
+	 */
+	void update(coord::viewport_delta size);
+
+	/**
+	 * Save the frames that are still read back or encoded, e.g. before
+	 * the job manager is stopped. To be called with the GL context current.
+	 * Frames that are not saved within the timeout are dropped.
+	 *
+	 * @param timeout Maximum time to wait for the frames.
+	 *
+	 * @return Number of dropped frames.
+	 */
+	size_t flush(std::chrono::milliseconds timeout = std::chrono::seconds{5});
 
 	/** size of the game window, in coord_sdl */
 	coord::viewport_delta window_size;
 
+	/**
+	 * Maximum number of frames that are read back or encoded at the same time.
+	 * Captured frames beyond that are dropped.
+	 */
+	static constexpr size_t max_frames_in_flight = 8;
+
 private:
+	/**
+	 * What happens with a frame once it is read back.
+	 */
+	enum class frame_output {
+		PNG,
+		RAW,
+	};
+
+	/**
+	 * Pixel buffer object that a frame is read back into.
+	 */
+	struct pixel_buffer {
+		unsigned int handle;
+		size_t size;
+	};
+
+	/**
+	 * Frame that is being read back.
+	 */
+	struct readback {
+		pixel_buffer buffer;
+		/// GLsync of the readback
+		void *fence;
+		coord::viewport_delta size;
+		std::string filename;
+		frame_output output;
+	};
+
+	/**
+	 * Start reading back the framebuffer.
+	 *
+	 * @return false if too many frames are in flight, else true.
+	 */
+	bool read_back(coord::viewport_delta size,
+	               const std::string &filename,
+	               frame_output output);
+
+	/**
+	 * Hand all finished readbacks to the job workers.
+	 */
+	void finish_readbacks();
 
-	/** to be called to get the next screenshot filename into the array */
-	std::string gen_next_filename();
+	/**
+	 * Get the next unused file name in /tmp.
+	 *
+	 * @param suffix Appended to the name, e.g. ".png".
+	 */
+	std::string gen_next_filename(const char *suffix);
 
 	/** contains the number to be in the next screenshot filename */
 	unsigned count;
@@ -51,6 +158,27 @@ private:
 
 	/** the job manager this screenshot manager uses */
 	job::JobManager *job_manager;
+
+	/** readbacks in the order they were started */
+	std::deque<readback> pending;
+
+	/** pixel buffer objects that can be reused */
+	std::vector<pixel_buffer> free_buffers;
+
+	/**
+	 * Number of frames that are read back or encoded.
+	 * Shared with the encoding jobs, which may outlive the manager.
+	 */
+	std::shared_ptr<std::atomic<size_t>> in_flight;
+
+	/** directory of the running capture */
+	std::optional<std::string> capture_directory;
+
+	/** number of the next captured frame */
+	size_t capture_frame;
+
+	/** number of captured frames that were dropped */
+	size_t capture_dropped;
 };
 
 } // openage
@@ -0,0 +1,54 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "temp_dir.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include "../log/log.h"
+#include "../util/fslike/directory.h"
+#include "testing.h"
+
+namespace openage {
+namespace testing {
+
+
+TempDir::TempDir(const std::string &name) {
+	std::string path_template = "/tmp/openage-" + name + "-XXXXXX";
+	std::vector<char> buf(path_template.begin(), path_template.end());
+	buf.push_back('\0');
+
+	if (mkdtemp(buf.data()) == nullptr) {
+		TESTFAILMSG("could not create temporary directory " << path_template);
+	}
+
+	this->native_path = buf.data();
+}
+
+
+TempDir::~TempDir() {
+	// the destructor may run while a test failure is propagated,
+	// so errors are only logged
+	std::error_code err;
+	std::filesystem::remove_all(this->native_path, err);
+	if (err) {
+		log::log(MSG(warn) << "could not remove temporary directory "
+		                   << this->native_path << ": " << err.message());
+	}
+}
+
+
+const std::string &TempDir::get_native_path() const {
+	return this->native_path;
+}
+
+
+util::Path TempDir::get_path() const {
+	return util::Path{std::make_shared<util::fslike::Directory>(this->native_path)};
+}
+
+
+}} // openage::testing
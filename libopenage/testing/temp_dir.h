@@ -0,0 +1,52 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <string>
+
+#include "../util/path.h"
+
+namespace openage {
+namespace testing {
+
+
+/**
+ * Temporary directory for tests.
+ *
+ * The directory is created in /tmp and removed with all its contents
+ * when the object goes out of scope, so it is also cleaned up
+ * when the test fails.
+ */
+class TempDir {
+public:
+	/**
+	 * Create a new, empty temporary directory.
+	 *
+	 * @param name Part of the directory name, e.g. "pack"
+	 *             for "/tmp/openage-pack-XXXXXX".
+	 */
+	TempDir(const std::string &name);
+	~TempDir();
+
+	TempDir(const TempDir &) = delete;
+	TempDir &operator=(const TempDir &) = delete;
+
+	/**
+	 * Get the native path of the directory.
+	 */
+	const std::string &get_native_path() const;
+
+	/**
+	 * Get the directory as a path on the native filesystem.
+	 */
+	util::Path get_path() const;
+
+private:
+	/**
+	 * Native path of the directory.
+	 */
+	std::string native_path;
+};
+
+
+}} // openage::testing
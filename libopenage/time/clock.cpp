@@ -13,6 +13,10 @@ Clock::Clock() :
 	state{ClockState::INIT},
 	max_tick_time{50},
 	speed{1.0f},
+	mode{ClockMode::REALTIME},
+	virtual_speed{0},
+	mode_start_time{simclock_t::now()},
+	mode_start_sim_time{0},
 	last_check{simclock_t::now()},
 	start_time{simclock_t::now()},
 	sim_time{0},
@@ -25,7 +29,7 @@ ClockState Clock::get_state() {
 }
 
 void Clock::update_time() {
-	if (this->state == ClockState::RUNNING) {
+	if (this->state == ClockState::RUNNING and this->mode == ClockMode::REALTIME) {
 		std::unique_lock lock{this->mutex};
 
 		auto now = simclock_t::now();
@@ -78,12 +82,103 @@ void Clock::set_speed(speed_t speed) {
 	log::log(MSG(info) << "Clock speed set to " << this->speed);
 }
 
+ClockMode Clock::get_mode() {
+	std::shared_lock lock{this->mutex};
+	return this->mode;
+}
+
+void Clock::set_mode(ClockMode mode) {
+	this->update_time();
+
+	std::unique_lock lock{this->mutex};
+	if (this->mode == mode) {
+		return;
+	}
+
+	auto now = simclock_t::now();
+	if (this->mode == ClockMode::VIRTUAL) {
+		log::log(MSG(info) << "Virtual time throughput: "
+		                   << this->calc_throughput(now) << " simulated s per real s");
+	}
+
+	this->mode = mode;
+	this->mode_start_time = now;
+	this->mode_start_sim_time = this->sim_time;
+
+	// don't account for the real time that passed in virtual mode
+	this->last_check = now;
+
+	log::log(MSG(info) << "Clock mode set to "
+	                   << (mode == ClockMode::VIRTUAL ? "virtual" : "real") << " time");
+}
+
+void Clock::set_virtual_speed(speed_t max_speed) {
+	std::unique_lock lock{this->mutex};
+
+	auto now = simclock_t::now();
+	this->virtual_speed = max_speed;
+	this->mode_start_time = now;
+	this->mode_start_sim_time = this->sim_time;
+
+	log::log(MSG(info) << "Virtual clock speed limit set to " << this->virtual_speed);
+}
+
+void Clock::advance_to(const time::time_t &time) {
+	std::unique_lock lock{this->mutex};
+
+	// convert time unit from seconds to milliseconds
+	auto target = time * 1000;
+	if (this->state != ClockState::RUNNING
+	    or this->mode != ClockMode::VIRTUAL
+	    or target <= this->sim_time) {
+		return;
+	}
+
+	if (this->virtual_speed > speed_t::zero()) {
+		// wait until the target time may be reached with the given speed limit
+		double sim_passed = (target - this->mode_start_sim_time).to_double();
+		auto real_passed = std::chrono::duration<double, std::milli>(sim_passed / this->virtual_speed.to_double());
+		auto wait_until = this->mode_start_time + std::chrono::duration_cast<simclock_t::duration>(real_passed);
+
+		lock.unlock();
+		std::this_thread::sleep_until(wait_until);
+		lock.lock();
+
+		// the clock may have been changed while waiting
+		if (this->state != ClockState::RUNNING
+		    or this->mode != ClockMode::VIRTUAL
+		    or target <= this->sim_time) {
+			return;
+		}
+	}
+
+	// virtual time is not affected by the clock speed
+	this->sim_real_time += target - this->sim_time;
+	this->sim_time = target;
+}
+
+double Clock::get_throughput() {
+	std::shared_lock lock{this->mutex};
+	return this->calc_throughput(simclock_t::now());
+}
+
+double Clock::calc_throughput(const timepoint_t &now) const {
+	auto real_passed = std::chrono::duration<double, std::milli>(now - this->mode_start_time).count();
+	if (real_passed <= 0.0) {
+		return 0.0;
+	}
+
+	return (this->sim_time - this->mode_start_sim_time).to_double() / real_passed;
+}
+
 void Clock::start() {
 	std::unique_lock lock{this->mutex};
 
 	auto now = simclock_t::now();
 	this->start_time = now;
 	this->last_check = now;
+	this->mode_start_time = now;
+	this->mode_start_sim_time = this->sim_time;
 	this->state = ClockState::RUNNING;
 }
 
@@ -98,6 +193,11 @@ void Clock::stop() {
 	log::log(MSG(info) << "Clock stopped at "
 	                   << this->sim_time << "ms (simulated) / "
 	                   << this->sim_real_time << "ms (real)");
+
+	if (this->mode == ClockMode::VIRTUAL) {
+		log::log(MSG(info) << "Virtual time throughput: "
+		                   << this->calc_throughput(simclock_t::now()) << " simulated s per real s");
+	}
 }
 
 void Clock::pause() {
@@ -117,7 +217,13 @@ void Clock::resume() {
 	std::unique_lock lock{this->mutex};
 
 	if (this->state == ClockState::PAUSED) [[likely]] {
-		this->last_check = simclock_t::now();
+		auto now = simclock_t::now();
+		this->last_check = now;
+		if (this->mode == ClockMode::VIRTUAL) {
+			// the speed limit should not catch up with the paused time
+			this->mode_start_time = now;
+			this->mode_start_sim_time = this->sim_time;
+		}
 		this->state = ClockState::RUNNING;
 	}
 
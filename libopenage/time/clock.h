@@ -26,11 +26,25 @@ enum class ClockState {
 	RUNNING
 };
 
+/**
+ * Determines how the simulation time of a clock advances.
+ */
+enum class ClockMode {
+	/// Time follows the real time (adjusted by the clock speed).
+	REALTIME,
+	/// Time only advances when it is explicitly moved forward with \p Clock::advance_to().
+	VIRTUAL,
+};
+
 /**
  * Clock for timing simulation events.
  *
  * Time values have a precision of milliseconds which should
  * be accurate enough for all applications.
+ *
+ * In virtual time mode, the clock is decoupled from real time. The simulation
+ * can then jump directly from one event to the next and run as fast as possible,
+ * e.g. for headless batch simulations or fast-forwarding.
  */
 class Clock {
 public:
@@ -83,6 +97,50 @@ public:
      */
 	void set_speed(speed_t speed);
 
+	/**
+	 * Get the mode of the clock.
+	 *
+	 * @return Clock mode.
+	 */
+	ClockMode get_mode();
+
+	/**
+	 * Set the mode of the clock.
+	 *
+	 * Simulation time is updated before changing the mode. Switching to
+	 * real time continues from the current simulation time.
+	 *
+	 * @param mode New clock mode.
+	 */
+	void set_mode(ClockMode mode);
+
+	/**
+	 * Set how many simulated seconds may pass per real second in virtual time mode.
+	 *
+	 * @param max_speed Maximum speed. If 0, the speed is not limited
+	 *                  and time advances as fast as possible.
+	 */
+	void set_virtual_speed(speed_t max_speed);
+
+	/**
+	 * Advance the simulation time to a given point in time. Only has an effect
+	 * if the clock is running in virtual time mode and \p time is in the future.
+	 *
+	 * If a maximum virtual speed is set, this blocks until enough real
+	 * time has passed.
+	 *
+	 * @param time Target simulation time (in seconds).
+	 */
+	void advance_to(const time::time_t &time);
+
+	/**
+	 * Get the throughput of the clock since the last mode change, i.e.
+	 * how many seconds are simulated per second of real time.
+	 *
+	 * @return Simulated seconds per real second.
+	 */
+	double get_throughput();
+
 	/**
 	 * Start the simulation timer.
 	 */
@@ -109,6 +167,17 @@ public:
 
 private:
 	/**
+	 * Calculate the throughput since the last mode change.
+	 *
+	 * The mutex must be held by the caller.
+	 *
+	 * @param now Current point in real time.
+	 *
+	 * @return Simulated seconds per real second.
+	 */
+	double calc_throughput(const timepoint_t &now) const;
+
+	/**
      * Status of the clock (init, running, stopped, ...).
      */
 	ClockState state;
@@ -123,6 +192,26 @@ private:
      */
 	speed_t speed;
 
+	/**
+	 * Determines how simulation time advances.
+	 */
+	ClockMode mode;
+
+	/**
+	 * Maximum speed in virtual time mode. 0 means unlimited.
+	 */
+	speed_t virtual_speed;
+
+	/**
+	 * Point in real time where the clock mode was last changed.
+	 */
+	timepoint_t mode_start_time;
+
+	/**
+	 * Simulation time when the clock mode was last changed (in milliseconds).
+	 */
+	time::time_t mode_start_sim_time;
+
 	/**
      * Last point in time where the clock was updated.
      */
@@ -2,7 +2,9 @@
 
 #include "time_loop.h"
 
+#include <chrono>
 #include <mutex>
+#include <thread>
 
 #include "log/log.h"
 #include "time/clock.h"
@@ -21,6 +23,11 @@ TimeLoop::TimeLoop(const std::shared_ptr<Clock> clock) :
 void TimeLoop::run() {
 	this->start();
 	while (this->running) {
+		if (this->clock->get_mode() == ClockMode::VIRTUAL) {
+			// virtual time is advanced by the simulation
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
 		this->clock->update_time();
 	}
 	log::log(MSG(info) << "Time loop exited");
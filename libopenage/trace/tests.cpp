@@ -0,0 +1,145 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log/log.h"
+#include "log/message.h"
+#include "testing/testing.h"
+
+#include "trace/trace.h"
+
+
+namespace openage::trace::tests {
+
+void trace() {
+	clear();
+
+	// nothing is recorded while tracing is disabled
+	{
+		Zone zone{"disabled", "test"};
+		counter("disabled", 1);
+	}
+	TESTEQUALS(record_count(), 0);
+
+	set_enabled(true);
+	set_thread_name("trace \"test\"\t\x01");
+
+	{
+		Zone outer{"outer", "test"};
+		{
+			Zone inner{"inner", "test"};
+		}
+		counter("queue", 42);
+	}
+	TESTEQUALS(record_count(), 3);
+
+	// a zone that was started while tracing was disabled is not recorded
+	set_enabled(false);
+	{
+		Zone zone{"late", "test"};
+		set_enabled(true);
+	}
+	TESTEQUALS(record_count(), 3);
+
+	// every thread records into its own buffer
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([]() {
+			set_thread_name("worker");
+			for (int j = 0; j < 100; ++j) {
+				Zone zone{"work", "test"};
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	// the records outlive their threads
+	TESTEQUALS(record_count(), 403);
+
+	std::string json = to_json();
+	(json.starts_with("{\"traceEvents\":[")) or TESTFAIL;
+	(json.find("\"name\":\"outer\",\"ph\":\"X\"") != std::string::npos) or TESTFAIL;
+	(json.find("\"cat\":\"test\"") != std::string::npos) or TESTFAIL;
+	(json.find("\"name\":\"queue\",\"ph\":\"C\"") != std::string::npos) or TESTFAIL;
+	(json.find("\"args\":{\"value\":42}") != std::string::npos) or TESTFAIL;
+	(json.find("\"args\":{\"name\":\"trace \\\"test\\\"\\t\\u0001\"}") != std::string::npos) or TESTFAIL;
+	(json.find("\"name\":\"late\"") == std::string::npos) or TESTFAIL;
+	(json.find("\"dropped\":0") != std::string::npos) or TESTFAIL;
+
+	// the outer zone started first, although it is stored after the inner one
+	(json.find("\"ts\":-") == std::string::npos) or TESTFAIL;
+	(json.find(",\"ts\":0.000,\"cat\":\"test\"") != std::string::npos) or TESTFAIL;
+
+	// full buffers overwrite their oldest records
+	set_buffer_size(8);
+	clear();
+	TESTEQUALS(record_count(), 0);
+	for (int i = 0; i < 20; ++i) {
+		Zone zone{"ring", "test"};
+	}
+	TESTEQUALS(record_count(), 8);
+	json = to_json();
+	(json.find("\"dropped\":12") != std::string::npos) or TESTFAIL;
+
+	set_enabled(false);
+	set_buffer_size(default_buffer_size);
+	clear();
+}
+
+
+void trace_benchmark() {
+	const size_t iterations = 10000000;
+	using clock = std::chrono::steady_clock;
+
+	// the loop body has to stay in the loop
+	volatile int64_t sink = 0;
+
+	auto measure = [&](auto body) {
+		auto start = clock::now();
+		for (size_t i = 0; i < iterations; ++i) {
+			body(i);
+		}
+		return std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+	};
+
+	auto plain = [&](size_t i) {
+		sink = sink + static_cast<int64_t>(i);
+	};
+	auto zone = [&](size_t i) {
+		Zone zone{"benchmark", "test"};
+		sink = sink + static_cast<int64_t>(i);
+	};
+	auto counter_value = [&](size_t i) {
+		counter("benchmark", static_cast<int64_t>(i));
+		sink = sink + static_cast<int64_t>(i);
+	};
+
+	clear();
+	set_enabled(false);
+
+	// a compiled-out TRACE_ZONE expands to nothing, so it costs as much as the plain loop
+	double plain_ns = measure(plain);
+	double disabled_zone_ns = measure(zone);
+	double disabled_counter_ns = measure(counter_value);
+
+	set_enabled(true);
+	double enabled_zone_ns = measure(zone);
+	double enabled_counter_ns = measure(counter_value);
+	set_enabled(false);
+	clear();
+
+	log::log(MSG(info) << iterations << " iterations, time per iteration:");
+	log::log(MSG(info) << "  no zone (compiled out): " << plain_ns << " ns");
+	log::log(MSG(info) << "  disabled zone:          " << disabled_zone_ns << " ns");
+	log::log(MSG(info) << "  disabled counter:       " << disabled_counter_ns << " ns");
+	log::log(MSG(info) << "  enabled zone:           " << enabled_zone_ns << " ns");
+	log::log(MSG(info) << "  enabled counter:        " << enabled_counter_ns << " ns");
+}
+
+} // namespace openage::trace::tests
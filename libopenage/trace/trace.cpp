@@ -0,0 +1,286 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "trace.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include "log/log.h"
+#include "log/message.h"
+
+#include "util/file.h"
+#include "util/path.h"
+#include "util/strings.h"
+#include "util/thread_id.h"
+
+
+namespace openage::trace {
+
+namespace detail {
+
+std::atomic<bool> enabled{false};
+
+} // namespace detail
+
+
+namespace {
+
+/**
+ * One zone or counter value.
+ */
+struct record {
+	const char *name;
+	const char *category;
+	/// Start of the zone or time of the counter value.
+	int64_t timestamp;
+	/// Duration of the zone or counter value.
+	int64_t value;
+	/// Chrome trace event phase: 'X' for zones, 'C' for counters.
+	char phase;
+};
+
+/**
+ * Ring buffer of the records of one thread.
+ *
+ * The mutex is only contended while the trace is exported or cleared.
+ */
+struct thread_buffer {
+	size_t tid;
+	std::string name;
+
+	std::mutex mutex;
+	std::vector<record> records;
+	size_t capacity;
+	/// Index of the oldest record once the buffer is full.
+	size_t next = 0;
+	/// Number of overwritten records.
+	size_t dropped = 0;
+
+	void push(const record &rec) {
+		std::unique_lock lock{this->mutex};
+		if (this->records.size() < this->capacity) {
+			this->records.push_back(rec);
+		}
+		else {
+			this->records[this->next] = rec;
+			this->next = (this->next + 1) % this->capacity;
+			this->dropped += 1;
+		}
+	}
+
+	/**
+	 * Copy the records, oldest first.
+	 */
+	std::vector<record> snapshot() {
+		std::unique_lock lock{this->mutex};
+		std::vector<record> ret;
+		ret.reserve(this->records.size());
+		ret.insert(ret.end(), this->records.begin() + this->next, this->records.end());
+		ret.insert(ret.end(), this->records.begin(), this->records.begin() + this->next);
+		return ret;
+	}
+};
+
+/**
+ * Buffers of all threads that have ever recorded something.
+ */
+struct registry_t {
+	std::mutex mutex;
+	std::vector<std::shared_ptr<thread_buffer>> buffers;
+	size_t buffer_size = default_buffer_size;
+};
+
+registry_t &registry() {
+	// leaked on purpose: threads may still record while static objects are destroyed
+	static registry_t *instance = new registry_t;
+	return *instance;
+}
+
+/**
+ * Get the buffer of the current thread, create and register it on first use.
+ */
+thread_buffer &local_buffer() {
+	thread_local std::shared_ptr<thread_buffer> buffer;
+
+	if (not buffer) [[unlikely]] {
+		buffer = std::make_shared<thread_buffer>();
+		buffer->tid = util::get_current_thread_id();
+
+		auto &reg = registry();
+		std::unique_lock lock{reg.mutex};
+		buffer->capacity = reg.buffer_size;
+		reg.buffers.push_back(buffer);
+	}
+
+	return *buffer;
+}
+
+/**
+ * Write nanoseconds as microseconds, the time unit of the trace format.
+ */
+void write_us(std::ostream &out, int64_t ns) {
+	if (ns < 0) {
+		out << '-';
+		ns = -ns;
+	}
+
+	int64_t frac = ns % 1000;
+	out << ns / 1000 << '.'
+	    << static_cast<char>('0' + frac / 100)
+	    << static_cast<char>('0' + frac / 10 % 10)
+	    << static_cast<char>('0' + frac % 10);
+}
+
+} // namespace
+
+
+namespace detail {
+
+void record_zone(const char *name, const char *category, int64_t start, int64_t end) {
+	local_buffer().push({name, category, start, end - start, 'X'});
+}
+
+
+void record_counter(const char *name, int64_t value) {
+	local_buffer().push({name, nullptr, now(), value, 'C'});
+}
+
+} // namespace detail
+
+
+void set_enabled(bool enabled) {
+	detail::enabled.store(enabled, std::memory_order_relaxed);
+
+	log::log(MSG(info) << "Tracing " << (enabled ? "enabled" : "disabled"));
+}
+
+
+void set_buffer_size(size_t size) {
+	auto &reg = registry();
+	std::unique_lock lock{reg.mutex};
+	reg.buffer_size = std::max<size_t>(size, 1);
+}
+
+
+void set_thread_name(const std::string &name) {
+	auto &buffer = local_buffer();
+	std::unique_lock lock{buffer.mutex};
+	buffer.name = name;
+}
+
+
+void clear() {
+	auto &reg = registry();
+	std::unique_lock lock{reg.mutex};
+	for (auto &buffer : reg.buffers) {
+		std::unique_lock buffer_lock{buffer->mutex};
+		buffer->records.clear();
+		buffer->records.shrink_to_fit();
+		buffer->capacity = reg.buffer_size;
+		buffer->next = 0;
+		buffer->dropped = 0;
+	}
+}
+
+
+size_t record_count() {
+	auto &reg = registry();
+	std::unique_lock lock{reg.mutex};
+
+	size_t ret = 0;
+	for (auto &buffer : reg.buffers) {
+		std::unique_lock buffer_lock{buffer->mutex};
+		ret += buffer->records.size();
+	}
+	return ret;
+}
+
+
+void write_chrome_trace(std::ostream &out) {
+	struct thread_records {
+		size_t tid;
+		std::string name;
+		size_t dropped;
+		std::vector<record> records;
+	};
+
+	// copy the records first so that the threads are only blocked briefly
+	std::vector<thread_records> threads;
+	{
+		auto &reg = registry();
+		std::unique_lock lock{reg.mutex};
+		for (auto &buffer : reg.buffers) {
+			auto records = buffer->snapshot();
+			std::unique_lock buffer_lock{buffer->mutex};
+			threads.push_back({buffer->tid, buffer->name, buffer->dropped, std::move(records)});
+		}
+	}
+
+	// timestamps are relative to the oldest record. zones are stored when
+	// they end, so an enclosing zone comes after the zones it contains.
+	int64_t origin = std::numeric_limits<int64_t>::max();
+	size_t dropped = 0;
+	for (const auto &thread : threads) {
+		for (const auto &rec : thread.records) {
+			origin = std::min(origin, rec.timestamp);
+		}
+		dropped += thread.dropped;
+	}
+
+	out << "{\"traceEvents\":[";
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+	    << "\"args\":{\"name\":\"openage\"}}";
+
+	for (const auto &thread : threads) {
+		if (not thread.name.empty()) {
+			out << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.tid
+			    << ",\"args\":{\"name\":";
+			util::json_string(out, thread.name);
+			out << "}}";
+		}
+
+		for (const auto &rec : thread.records) {
+			out << ",{\"name\":";
+			util::json_string(out, rec.name);
+			out << ",\"ph\":\"" << rec.phase << "\",\"pid\":1,\"tid\":" << thread.tid
+			    << ",\"ts\":";
+			write_us(out, rec.timestamp - origin);
+
+			if (rec.phase == 'X') {
+				out << ",\"cat\":";
+				util::json_string(out, rec.category);
+				out << ",\"dur\":";
+				write_us(out, rec.value);
+			}
+			else {
+				out << ",\"args\":{\"value\":" << rec.value << "}";
+			}
+			out << "}";
+		}
+	}
+
+	out << "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":" << dropped << "}}";
+}
+
+
+std::string to_json() {
+	std::ostringstream out;
+	write_chrome_trace(out);
+	return out.str();
+}
+
+
+void save(const util::Path &path) {
+	auto file = path.open_w();
+	file.write(to_json());
+	file.close();
+
+	log::log(MSG(info) << "Trace has been written to " << path);
+}
+
+} // namespace openage::trace
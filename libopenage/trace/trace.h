@@ -0,0 +1,211 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "config.h"
+
+
+namespace openage {
+namespace util {
+class Path;
+}
+
+/**
+ * Low-overhead scoped profiling of all engine threads.
+ *
+ * Every thread records zones (named time spans) and counters into its own
+ * ring buffer. The buffers are collected and exported in the Chrome trace
+ * event format, which can be viewed with chrome://tracing or Perfetto.
+ *
+ * Tracing is disabled at runtime by default. While it is disabled, a zone
+ * only checks \p is_enabled(). If openage is configured without tracing,
+ * the \p TRACE_ZONE and \p TRACE_COUNTER macros expand to nothing.
+ */
+namespace trace {
+
+/**
+ * Default number of records that are kept per thread.
+ * When a buffer is full, its oldest records are overwritten.
+ */
+constexpr size_t default_buffer_size = 1 << 16;
+
+namespace detail {
+
+/**
+ * Runtime switch of the tracing. Use \p is_enabled() and \p set_enabled().
+ */
+extern std::atomic<bool> enabled;
+
+/**
+ * Get the current timestamp of the trace clock.
+ *
+ * @return Nanoseconds of the steady clock.
+ */
+inline int64_t now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+	    .count();
+}
+
+/**
+ * Store a finished zone in the buffer of the current thread.
+ */
+void record_zone(const char *name, const char *category, int64_t start, int64_t end);
+
+/**
+ * Store a counter value in the buffer of the current thread.
+ */
+void record_counter(const char *name, int64_t value);
+
+} // namespace detail
+
+
+/**
+ * Check if tracing is enabled.
+ *
+ * @return true if zones and counters are recorded, else false.
+ */
+inline bool is_enabled() {
+	return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * Enable or disable tracing. Records that have already been collected are kept.
+ *
+ * @param enabled true to enable tracing, false to disable it.
+ */
+void set_enabled(bool enabled);
+
+/**
+ * Set the number of records that are kept per thread.
+ * Only affects buffers of threads that have not recorded anything yet
+ * and buffers that are cleared with \p clear().
+ *
+ * @param size Number of records per thread.
+ */
+void set_buffer_size(size_t size);
+
+/**
+ * Name the current thread in the exported trace.
+ *
+ * @param name Thread name, e.g. "simulation".
+ */
+void set_thread_name(const std::string &name);
+
+/**
+ * Record the value of a counter, e.g. the size of a queue.
+ *
+ * @param name Counter name. Must be a string literal or outlive the trace.
+ * @param value Current value.
+ */
+inline void counter(const char *name, int64_t value) {
+	if (is_enabled()) [[unlikely]] {
+		detail::record_counter(name, value);
+	}
+}
+
+/**
+ * Discard the records of all threads.
+ */
+void clear();
+
+/**
+ * Get the number of records that are currently stored in all buffers.
+ *
+ * @return Number of zones and counter values.
+ */
+size_t record_count();
+
+/**
+ * Write the records of all threads in the Chrome trace event format.
+ *
+ * @param out Output stream.
+ */
+void write_chrome_trace(std::ostream &out);
+
+/**
+ * Get the records of all threads in the Chrome trace event format.
+ *
+ * @return JSON document.
+ */
+std::string to_json();
+
+/**
+ * Write the records of all threads in the Chrome trace event format to a file.
+ *
+ * @param path Output path.
+ */
+void save(const util::Path &path);
+
+
+/**
+ * Measures the time until it goes out of scope.
+ *
+ * The time is only taken if tracing was enabled when the zone was created.
+ * Names are stored as pointers, so they must be string literals or
+ * outlive the trace.
+ */
+class Zone {
+public:
+	/**
+	 * Start a zone.
+	 *
+	 * @param name Name of the zone, e.g. the function name.
+	 * @param category Category of the zone, e.g. the subsystem.
+	 */
+	explicit Zone(const char *name, const char *category = "openage") :
+		name{name},
+		category{category},
+		start{is_enabled() ? detail::now() : -1} {}
+
+	~Zone() {
+		if (this->start >= 0) [[unlikely]] {
+			detail::record_zone(this->name, this->category, this->start, detail::now());
+		}
+	}
+
+	Zone(const Zone &) = delete;
+	Zone &operator=(const Zone &) = delete;
+
+private:
+	const char *name;
+	const char *category;
+
+	/**
+	 * Start timestamp, -1 if tracing was disabled.
+	 */
+	int64_t start;
+};
+
+} // namespace trace
+} // namespace openage
+
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#if WITH_TRACING
+/**
+ * Trace the enclosing scope as zone \p name in \p category.
+ */
+#define TRACE_ZONE(name, category) \
+	::openage::trace::Zone TRACE_CONCAT(trace_zone_, __LINE__) { name, category }
+
+/**
+ * Record the current \p value of the counter \p name.
+ */
+#define TRACE_COUNTER(name, value) \
+	::openage::trace::counter(name, value)
+#else
+#define TRACE_ZONE(name, category) \
+	static_cast<void>(0)
+#define TRACE_COUNTER(name, value) \
+	static_cast<void>(0)
+#endif
@@ -193,7 +193,7 @@ public:
 	LZXDStream &operator =(LZXDStream &&other) = delete;
 
 	/** See the doc for LZXDecompressor::decompress_next_frame in lzxd.h */
-	unsigned decompress_next_frame(unsigned char *output_buf);
+	unsigned decompress_next_frame(unsigned char *output_buf, unsigned max_frame_size);
 private:
 	/**
 	 * Initializes the next block.
@@ -740,7 +740,11 @@ unsigned int LZXDStream::read_data_from_uncompressed_block(unsigned int size) {
 }
 
 
-unsigned LZXDStream::decompress_next_frame(unsigned char *output_buf) {
+unsigned LZXDStream::decompress_next_frame(unsigned char *output_buf, unsigned max_frame_size) {
+	if (max_frame_size == 0 || max_frame_size > LZX_FRAME_SIZE) [[unlikely]] {
+		throw Error(MSG(err) << "invalid maximum frame size: " << max_frame_size);
+	}
+
 	if (this->bits.eof) [[unlikely]] {
 		return 0;
 	}
@@ -784,7 +788,7 @@ unsigned LZXDStream::decompress_next_frame(unsigned char *output_buf) {
 	}
 
 	// decode symbols until we have enough data for the frame.
-	while (frame_size < LZX_FRAME_SIZE) {
+	while (frame_size < max_frame_size) {
 		// initialise next block, if one is needed
 		if (this->block_remaining == 0) [[unlikely]] {
 			if (this->bits.eof) {
@@ -806,7 +810,7 @@ unsigned LZXDStream::decompress_next_frame(unsigned char *output_buf) {
 			symbol_size = this->decode_symbol_from_aligned_block();
 			break;
 		case LZX_BLOCKTYPE_UNCOMPRESSED:
-			symbol_size = this->read_data_from_uncompressed_block(std::min(this->block_remaining, LZX_FRAME_SIZE - frame_size));
+			symbol_size = this->read_data_from_uncompressed_block(std::min(this->block_remaining, max_frame_size - frame_size));
 			break;
 		default:
 			throw Error(MSG(err) << "this->blocktype neither verbatim nor aligned");
@@ -929,8 +933,9 @@ LZXDecompressor::~LZXDecompressor() {
 }
 
 
-unsigned LZXDecompressor::decompress_next_frame(unsigned char *output_buf) {
-	return this->stream->decompress_next_frame(output_buf);
+unsigned LZXDecompressor::decompress_next_frame(unsigned char *output_buf,
+                                                unsigned max_frame_size) {
+	return this->stream->decompress_next_frame(output_buf, max_frame_size);
 }
 
 
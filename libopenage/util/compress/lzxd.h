@@ -68,13 +68,18 @@ public:
 	 * The decoded frame is written to output_buf.
 	 * output_buf must be at least LZX_FRAME_SIZE (32768) bytes in size.
 	 *
+	 * Containers that know the uncompressed size of the stream (like CAB
+	 * data blocks) pass the size of the final frame as max_frame_size,
+	 * so decoding stops at its end instead of looking for more blocks.
+	 *
 	 * Returns 0 in case of EOF, and the size of the frame otherwise.
 	 *
 	 * On error, an exception is thrown. After that, the object shall
 	 * be destroyed; every other operation on it may invoke undefined
 	 * behavior.
 	 */
-	unsigned int decompress_next_frame(unsigned char *output_buf);
+	unsigned int decompress_next_frame(unsigned char *output_buf,
+	                                   unsigned int max_frame_size=LZX_FRAME_SIZE);
 
 private:
 	class LZXDStream *stream;
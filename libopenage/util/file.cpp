@@ -63,6 +63,11 @@ void File::write(const std::string &data) {
 }
 
 
+void File::write_from(const void *buf, size_t size) {
+	this->filelike->write_from(buf, size);
+}
+
+
 bool File::writable() {
 	return this->filelike->writable();
 }
@@ -114,6 +119,11 @@ std::vector<std::string> File::get_lines() {
 }
 
 
+FileBuffer File::map() {
+	return this->filelike->map();
+}
+
+
 std::shared_ptr<filelike::FileLike> File::get_fileobj() const {
 	return this->filelike;
 }
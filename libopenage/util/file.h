@@ -34,6 +34,7 @@ class Path;
  *     File(const string &path, int mode) except +
  *     File(PyObj) except +
  *
+ *     string read() except +
  *     shared_ptr[FileLike] get_fileobj() except +
  */
 class OAAPI File {
@@ -90,6 +91,12 @@ public:
 	size_t read_to(void *buf, ssize_t max=-1);
 	bool readable();
 	void write(const std::string &data);
+
+	/**
+	 * Write size bytes from a buffer to the file.
+	 * Unlike write(), the data doesn't have to be in a string.
+	 */
+	void write_from(const void *buf, size_t size);
 	bool writable();
 	void seek(ssize_t offset, seek_t how=seek_t::SET);
 	bool seekable();
@@ -99,6 +106,12 @@ public:
 	ssize_t size();
 	std::vector<std::string> get_lines();
 
+	/**
+	 * Get the whole contents of the file without copying them,
+	 * if the underlying file-like supports it.
+	 */
+	FileBuffer map();
+
 	std::shared_ptr<filelike::FileLike> get_fileobj() const;
 
 protected:
@@ -0,0 +1,153 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "file_buffer.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "../error/error.h"
+
+
+namespace openage::util {
+
+#ifndef _WIN32
+namespace {
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+class Mapping {
+public:
+	Mapping(const std::string &path) {
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw Error{ERR << "file not found: " << path};
+		}
+
+		struct stat buf;
+		if (fstat(fd, &buf) != 0) {
+			::close(fd);
+			throw Error{ERR << "could not stat file: " << path};
+		}
+		this->size = buf.st_size;
+
+		// empty files can't be mapped
+		if (this->size > 0) {
+			void *mem = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mem == MAP_FAILED) {
+				::close(fd);
+				throw Error{ERR << "could not map file: " << path};
+			}
+			this->data = static_cast<const char *>(mem);
+		}
+
+		// the mapping stays valid after closing the file
+		::close(fd);
+	}
+
+	~Mapping() {
+		if (this->data != nullptr) {
+			munmap(const_cast<char *>(this->data), this->size);
+		}
+	}
+
+	Mapping(const Mapping &) = delete;
+	Mapping &operator=(const Mapping &) = delete;
+
+	/// Start of the file contents.
+	const char *data = nullptr;
+	/// Size of the file contents.
+	size_t size = 0;
+};
+
+} // namespace
+#endif
+
+
+FileBuffer::FileBuffer() :
+	owner{nullptr},
+	ptr{nullptr},
+	length{0} {}
+
+
+FileBuffer::FileBuffer(std::string &&data) {
+	auto contents = std::make_shared<const std::string>(std::move(data));
+	this->ptr = contents->data();
+	this->length = contents->size();
+	this->owner = std::move(contents);
+}
+
+
+FileBuffer::FileBuffer(std::shared_ptr<const void> owner,
+                       const char *data,
+                       size_t size) :
+	owner{std::move(owner)},
+	ptr{data},
+	length{size} {}
+
+
+FileBuffer FileBuffer::map_native(const std::string &path) {
+#ifdef _WIN32
+	std::ifstream file{path, std::ios_base::in | std::ios_base::binary};
+	if (not file.is_open()) {
+		throw Error{ERR << "file not found: " << path};
+	}
+
+	std::string contents{std::istreambuf_iterator<char>(file),
+	                     std::istreambuf_iterator<char>()};
+	return FileBuffer{std::move(contents)};
+#else
+	auto mapping = std::make_shared<const Mapping>(path);
+	return FileBuffer{mapping, mapping->data, mapping->size};
+#endif
+}
+
+
+FileBuffer FileBuffer::slice(size_t offset, size_t size) const {
+	if (offset > this->length or this->length - offset < size) {
+		throw Error{ERR << "slice [" << offset << ", " << offset + size
+		                << ") is outside of the buffer with size " << this->length};
+	}
+	return FileBuffer{this->owner, this->ptr + offset, size};
+}
+
+
+const char *FileBuffer::data() const {
+	return this->ptr;
+}
+
+
+size_t FileBuffer::size() const {
+	return this->length;
+}
+
+
+bool FileBuffer::empty() const {
+	return this->length == 0;
+}
+
+
+std::string_view FileBuffer::view() const {
+	return std::string_view{this->ptr, this->length};
+}
+
+
+std::span<const uint8_t> FileBuffer::bytes() const {
+	return std::span<const uint8_t>{reinterpret_cast<const uint8_t *>(this->ptr), this->length};
+}
+
+
+const std::shared_ptr<const void> &FileBuffer::get_owner() const {
+	return this->owner;
+}
+
+} // namespace openage::util
@@ -0,0 +1,115 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+
+namespace openage::util {
+
+/**
+ * Immutable contents of a file.
+ *
+ * The memory is either a memory-mapped file or a buffer that was read
+ * from the file. It is kept alive by an owner that is shared by all
+ * copies and slices of the buffer, so passing buffers around
+ * never copies the contents.
+ */
+class FileBuffer {
+public:
+	/**
+	 * Create an empty buffer.
+	 */
+	FileBuffer();
+
+	/**
+	 * Create a buffer that owns the given data.
+	 *
+	 * @param data File contents. Moved into the buffer without copying.
+	 */
+	explicit FileBuffer(std::string &&data);
+
+	/**
+	 * Create a buffer for memory that is kept alive by another object.
+	 *
+	 * @param owner Object that keeps the memory alive.
+	 * @param data Start of the memory.
+	 * @param size Size of the memory in bytes.
+	 */
+	FileBuffer(std::shared_ptr<const void> owner,
+	           const char *data,
+	           size_t size);
+
+	/**
+	 * Map a file from the native filesystem into memory.
+	 * On platforms without mmap, the file is read into memory instead.
+	 *
+	 * @param path Native path of the file.
+	 *
+	 * @return Buffer with the file contents.
+	 */
+	static FileBuffer map_native(const std::string &path);
+
+	/**
+	 * Get a part of the buffer that shares the owner of this buffer.
+	 *
+	 * @param offset Start of the part in bytes.
+	 * @param size Size of the part in bytes.
+	 *
+	 * @return Buffer for the part.
+	 */
+	FileBuffer slice(size_t offset, size_t size) const;
+
+	/**
+	 * Get the start of the contents.
+	 */
+	const char *data() const;
+
+	/**
+	 * Get the size of the contents in bytes.
+	 */
+	size_t size() const;
+
+	/**
+	 * Check whether the buffer is empty.
+	 */
+	bool empty() const;
+
+	/**
+	 * Get the contents as text.
+	 */
+	std::string_view view() const;
+
+	/**
+	 * Get the contents as bytes.
+	 */
+	std::span<const uint8_t> bytes() const;
+
+	/**
+	 * Get the object that keeps the contents alive.
+	 */
+	const std::shared_ptr<const void> &get_owner() const;
+
+private:
+	/**
+	 * Object that keeps the contents alive.
+	 */
+	std::shared_ptr<const void> owner;
+
+	/**
+	 * Start of the contents.
+	 */
+	const char *ptr;
+
+	/**
+	 * Size of the contents in bytes.
+	 */
+	size_t length;
+};
+
+} // namespace openage::util
@@ -0,0 +1,134 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "file_buffer.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../log/log.h"
+#include "../testing/temp_dir.h"
+#include "../testing/testing.h"
+#include "file.h"
+#include "filelike/view.h"
+#include "path.h"
+#include "strings.h"
+
+
+namespace openage::util::tests {
+
+void file_buffer() {
+	testing::TempDir tmpdir{"filebuffer"};
+	auto root = tmpdir.get_path();
+	const std::string text = "version 2\ntexture 0 \"unit.texture\"\n";
+
+	// pending writes are visible in the mapping
+	File out = (root / "unit.sprite").open_w();
+	out.write(text);
+	FileBuffer written = out.map();
+	TESTEQUALS(written.view(), text);
+	out.close();
+
+	// the mapping outlives the file
+	FileBuffer buffer = (root / "unit.sprite").open_r().map();
+	TESTEQUALS(buffer.size(), text.size());
+	TESTEQUALS(buffer.view(), text);
+	TESTEQUALS(buffer.bytes()[0], 'v');
+
+	// slices share the memory
+	FileBuffer slice = buffer.slice(8, 1);
+	TESTEQUALS(slice.view(), "2");
+	(slice.data() == buffer.data() + 8) or TESTFAIL;
+	(slice.get_owner() == buffer.get_owner()) or TESTFAIL;
+	TESTTHROWS(buffer.slice(text.size(), 1));
+
+	// views hand out their buffer without copying
+	File view{std::make_shared<filelike::View>(buffer)};
+	(view.map().data() == buffer.data()) or TESTFAIL;
+	TESTEQUALS(view.read(7), "version");
+
+	// other file-likes are read into an owned buffer
+	FileBuffer owned{std::string{text}};
+	TESTEQUALS(owned.view(), text);
+
+	(root / "empty").touch();
+	(root / "empty").open_r().map().empty() or TESTFAIL;
+	FileBuffer{}.empty() or TESTFAIL;
+
+	// split_view splits like split
+	for (auto &str : {"", "a", "a b", " a  b ", "a\n\nb\n"}) {
+		for (char delim : {' ', '\n'}) {
+			auto parts = split(str, delim);
+			auto views = split_view(str, delim);
+			(std::vector<std::string>{views.begin(), views.end()} == parts) or TESTFAIL;
+		}
+	}
+}
+
+
+void file_buffer_benchmark() {
+	testing::TempDir tmpdir{"filebuffer"};
+
+	// sprite definitions with 8 angles and 30 frames each
+	const size_t files = 1000;
+	std::string sprite = "version 2\ntexture 0 \"unit.texture\"\nscalefactor 1.0\nlayer 0 mode=loop position=20\n";
+	for (size_t angle = 0; angle < 8; ++angle) {
+		sprite += "angle " + std::to_string(angle * 45) + " mirror_from=0\n";
+		for (size_t frame = 0; frame < 30; ++frame) {
+			sprite += "frame " + std::to_string(frame) + " " + std::to_string(angle * 45)
+			          + " 0 0 " + std::to_string(angle * 30 + frame) + "\n";
+		}
+	}
+
+	auto root = tmpdir.get_path();
+	std::vector<Path> paths;
+	for (size_t i = 0; i < files; ++i) {
+		Path path = root / ("unit_" + std::to_string(i) + ".sprite");
+		File file = path.open_w();
+		file.write(sprite);
+		file.close();
+		paths.push_back(path);
+	}
+
+	// both variants split every line into arguments, like the parsers do
+	size_t line_args = 0;
+	size_t lines_peak = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (auto &path : paths) {
+		// whole file, copy in the string stream and one string per line
+		auto lines = path.open_r().get_lines();
+		size_t held = 2 * sprite.size() + lines.capacity() * sizeof(std::string);
+		for (auto &line : lines) {
+			held += (line.capacity() > 15) ? line.capacity() + 1 : 0;
+			line_args += split(line, ' ').size();
+		}
+		lines_peak = std::max(lines_peak, held);
+	}
+	auto lines_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	size_t view_args = 0;
+	size_t view_peak = 0;
+	start = std::chrono::steady_clock::now();
+	for (auto &path : paths) {
+		// the file contents are mapped, only the line views are allocated
+		FileBuffer content = path.open_r().map();
+		auto lines = split_view(content.view(), '\n');
+		for (auto &line : lines) {
+			auto parts = split_view(line, ' ');
+			std::vector<std::string> args{parts.begin(), parts.end()};
+			view_args += args.size();
+		}
+		view_peak = std::max(view_peak, lines.capacity() * sizeof(std::string_view));
+	}
+	auto view_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	TESTEQUALS(line_args, view_args);
+
+	log::log(MSG(info) << files << " sprite files with " << sprite.size() << " bytes each");
+	log::log(MSG(info) << "  get_lines(): " << lines_time.count() * 1e3 << " ms, "
+	                   << lines_peak / 1024 << " KiB heap per file");
+	log::log(MSG(info) << "  map():       " << view_time.count() * 1e3 << " ms, "
+	                   << view_peak / 1024 << " KiB heap per file");
+}
+
+} // namespace openage::util::tests
@@ -7,6 +7,17 @@ namespace openage::util::filelike {
 
 FileLike::FileLike() = default;
 
+FileBuffer FileLike::map() {
+	if (this->seekable()) {
+		this->seek(0);
+	}
+	return FileBuffer{this->read()};
+}
+
+void FileLike::write_from(const void *buf, size_t size) {
+	this->write(std::string{static_cast<const char *>(buf), size});
+}
+
 bool FileLike::is_python_native() const noexcept {
 	return false;
 }
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "../compiler.h"
+#include "../file_buffer.h"
 
 namespace openage {
 namespace util {
@@ -77,6 +78,14 @@ public:
 
 	virtual void write(const std::string &data) = 0;
 
+	/**
+	 * Write data from a buffer.
+	 *
+	 * The default implementation copies the data into a string
+	 * for \p write().
+	 */
+	virtual void write_from(const void *buf, size_t size);
+
 	virtual bool writable() = 0;
 
 	virtual void seek(ssize_t offset, seek_t how=seek_t::SET) = 0;
@@ -86,6 +95,15 @@ public:
 	virtual void flush() = 0;
 	virtual ssize_t get_size() = 0;
 
+	/**
+	 * Get the whole contents of the file as an immutable buffer.
+	 *
+	 * File-likes that are backed by memory share it with the buffer.
+	 * The default implementation reads the file into a buffer once,
+	 * which moves the read position to the end of the file.
+	 */
+	virtual FileBuffer map();
+
 	virtual bool is_python_native() const noexcept;
 
 	/** string representation of the filelike */
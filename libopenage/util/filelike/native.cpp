@@ -97,6 +97,11 @@ void Native::write(const std::string &data) {
 }
 
 
+void Native::write_from(const void *buf, size_t size) {
+	this->file.write(static_cast<const char *>(buf), size);
+}
+
+
 bool Native::writable() {
 	return (this->mode == mode_t::W or
 	        this->mode == mode_t::RW);
@@ -159,6 +164,15 @@ ssize_t Native::get_size() {
 }
 
 
+FileBuffer Native::map() {
+	// pending writes have to reach the file before it is mapped
+	if (this->mode != mode_t::R) {
+		this->file.flush();
+	}
+	return FileBuffer::map_native(this->path);
+}
+
+
 std::ostream &Native::repr(std::ostream &stream) {
 	stream << "Native(" << this->path  << ")";
 	return stream;
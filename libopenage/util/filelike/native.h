@@ -28,6 +28,7 @@ public:
 	bool readable() override;
 
 	void write(const std::string &data) override;
+	void write_from(const void *buf, size_t size) override;
 
 	bool writable() override;
 
@@ -38,6 +39,12 @@ public:
 	void flush() override;
 	ssize_t get_size() override;
 
+	/**
+	 * Map the file into memory. Writes to the file after
+	 * mapping it may or may not show up in the buffer.
+	 */
+	FileBuffer map() override;
+
 	std::ostream &repr(std::ostream &) override;
 
 protected:
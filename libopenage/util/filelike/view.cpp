@@ -0,0 +1,121 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "view.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../../error/error.h"
+
+
+namespace openage::util::filelike {
+
+View::View(FileBuffer buffer,
+           const std::string &name)
+	:
+	buffer{std::move(buffer)},
+	pos{0},
+	name{name} {}
+
+
+size_t View::get_read_size(ssize_t max) const {
+	size_t size = this->buffer.size();
+	size_t remaining = size - std::min(this->pos, size);
+	if (max < 0) {
+		return remaining;
+	}
+	return std::min(static_cast<size_t>(max), remaining);
+}
+
+
+std::string View::read(ssize_t max) {
+	size_t count = this->get_read_size(max);
+	std::string ret{this->buffer.data() + this->pos, count};
+	this->pos += count;
+	return ret;
+}
+
+
+size_t View::read_to(void *buf, ssize_t max) {
+	size_t count = this->get_read_size(max);
+	std::memcpy(buf, this->buffer.data() + this->pos, count);
+	this->pos += count;
+	return count;
+}
+
+
+bool View::readable() {
+	return this->buffer.get_owner() != nullptr;
+}
+
+
+void View::write(const std::string &/*data*/) {
+	throw Error{ERR << "can't write to read-only view " << this->name};
+}
+
+
+bool View::writable() {
+	return false;
+}
+
+
+void View::seek(ssize_t offset, seek_t how) {
+	ssize_t base;
+
+	switch (how) {
+	case seek_t::SET:
+		base = 0;
+		break;
+	case seek_t::CUR:
+		base = this->pos;
+		break;
+	case seek_t::END:
+		base = this->buffer.size();
+		break;
+	default:
+		throw Error{ERR << "invalid seek mode"};
+	}
+
+	if (base + offset < 0) {
+		throw Error{ERR << "can't seek before the start of " << this->name};
+	}
+
+	this->pos = base + offset;
+}
+
+
+bool View::seekable() {
+	return true;
+}
+
+
+size_t View::tell() {
+	return this->pos;
+}
+
+
+void View::close() {
+	this->buffer = FileBuffer{};
+	this->pos = 0;
+}
+
+
+void View::flush() {}
+
+
+ssize_t View::get_size() {
+	return this->buffer.size();
+}
+
+
+FileBuffer View::map() {
+	return this->buffer;
+}
+
+
+std::ostream &View::repr(std::ostream &stream) {
+	stream << "View(" << this->name << ")";
+	return stream;
+}
+
+} // openage::util::filelike
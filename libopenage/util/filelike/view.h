@@ -0,0 +1,67 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <string>
+
+#include "../file_buffer.h"
+#include "filelike.h"
+
+
+namespace openage {
+namespace util {
+namespace filelike {
+
+/**
+ * Read-only file-like class that reads from a memory buffer,
+ * e.g. an entry of a memory-mapped asset pack.
+ */
+class View : public FileLike {
+public:
+	/**
+	 * Create a view into a buffer.
+	 *
+	 * @param buffer Contents of the file.
+	 * @param name Name that is shown in the file-like representation.
+	 */
+	View(FileBuffer buffer,
+	     const std::string &name = "");
+	virtual ~View() = default;
+
+	std::string read(ssize_t max) override;
+	size_t read_to(void *buf, ssize_t max) override;
+
+	bool readable() override;
+
+	void write(const std::string &data) override;
+
+	bool writable() override;
+
+	void seek(ssize_t offset, seek_t how=seek_t::SET) override;
+	bool seekable() override;
+	size_t tell() override;
+	void close() override;
+	void flush() override;
+	ssize_t get_size() override;
+
+	/**
+	 * Get the buffer of the view without copying it.
+	 */
+	FileBuffer map() override;
+
+	std::ostream &repr(std::ostream &) override;
+
+protected:
+	/**
+	 * Get the number of bytes that can be read with the given maximum.
+	 */
+	size_t get_read_size(ssize_t max) const;
+
+	FileBuffer buffer;
+
+	size_t pos;
+
+	std::string name;
+};
+
+}}} // openage::util::filelike
@@ -0,0 +1,794 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "cab.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "../../error/error.h"
+#include "../../job/job_manager.h"
+#include "../compress/lzxd.h"
+#include "../file.h"
+#include "../filelike/view.h"
+#include "../path.h"
+#include "../strings.h"
+
+
+namespace openage::util::fslike {
+
+namespace {
+
+uint16_t get_u16(const char *data) {
+	return static_cast<uint16_t>(static_cast<uint8_t>(data[0])
+	                             | (static_cast<uint8_t>(data[1]) << 8));
+}
+
+
+uint32_t get_u32(const char *data) {
+	uint32_t value = 0;
+	for (size_t i = 0; i < 4; i++) {
+		value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+	}
+	return value;
+}
+
+
+std::string join_parts(const Path::parts_t &parts) {
+	std::string ret;
+	for (size_t i = 0; i < parts.size(); i++) {
+		if (i > 0) {
+			ret += '/';
+		}
+		ret += parts[i];
+	}
+	return ret;
+}
+
+
+/**
+ * Throw if the cabinet does not contain length bytes at pos.
+ */
+void require(const FileBuffer &contents, uint64_t pos, uint64_t length, const std::string &path) {
+	if (pos > contents.size() or contents.size() - pos < length) {
+		throw Error{ERR << "cabinet is truncated: " << path};
+	}
+}
+
+
+/**
+ * Convert a DOS date and time to a UNIX timestamp.
+ * CAB files have no timezone information, so UTC is assumed.
+ */
+int dos_timestamp(uint16_t date, uint16_t time) {
+	using namespace std::chrono;
+
+	year_month_day day{
+		year{1980 + (date >> 9)},
+		month{static_cast<unsigned>((date >> 5) & 0x0f)},
+		std::chrono::day{static_cast<unsigned>(date & 0x1f)},
+	};
+
+	auto timestamp = sys_days{day}
+	                 + hours{time >> 11}
+	                 + minutes{(time >> 5) & 0x3f}
+	                 + seconds{(time << 1) & 0x3f};
+
+	return static_cast<int>(duration_cast<seconds>(timestamp.time_since_epoch()).count());
+}
+
+
+/**
+ * Convert a CAB file name to a path with '/' separators.
+ * Like the Python implementation, names are lowercased.
+ *
+ * @param raw Name as stored in the cabinet.
+ * @param utf Whether the name is UTF-8, otherwise it is ISO-8859-1.
+ */
+std::string decode_name(std::string_view raw, bool utf) {
+	std::string ret;
+	ret.reserve(raw.size());
+
+	for (char c : raw) {
+		auto byte = static_cast<uint8_t>(c);
+		if (byte == '\\') {
+			ret += '/';
+		}
+		else if (byte >= 'A' and byte <= 'Z') {
+			ret += static_cast<char>(byte - 'A' + 'a');
+		}
+		else if (byte >= 0x80 and not utf) {
+			ret += static_cast<char>(0xc0 | (byte >> 6));
+			ret += static_cast<char>(0x80 | (byte & 0x3f));
+		}
+		else {
+			ret += c;
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ * Cache key of a block.
+ */
+uint64_t block_key(size_t folder_index, size_t block_index) {
+	return (static_cast<uint64_t>(folder_index) << 32) | block_index;
+}
+
+} // namespace
+
+
+namespace cab {
+
+uint32_t checksum(const char *data, size_t size) {
+	uint32_t result = 0;
+	size_t pos = 0;
+	for (; pos + 4 <= size; pos += 4) {
+		result ^= get_u32(data + pos);
+	}
+
+	uint32_t remainder = 0;
+	for (; pos < size; pos++) {
+		remainder = (remainder << 8) | static_cast<uint8_t>(data[pos]);
+	}
+
+	return result ^ remainder;
+}
+
+} // namespace cab
+
+
+class CAB::Decoder {
+public:
+	/**
+	 * Create a decoder at the start of a folder.
+	 *
+	 * @param archive Cabinet that contains the folder.
+	 * @param folder_index Index of the folder.
+	 */
+	Decoder(const CAB &archive, size_t folder_index) :
+		archive{archive},
+		folder{archive.folders[folder_index]},
+		next_block{0},
+		input_block{0},
+		input_pos{0} {
+		if (this->folder.compression == cab::compression_lzx) {
+			this->lzx = std::make_unique<compress::LZXDecompressor>(
+				[this](unsigned char *buf, size_t size) {
+					return this->read_input(buf, size);
+				},
+				this->folder.window_bits);
+		}
+	}
+
+	Decoder(const Decoder &) = delete;
+	Decoder &operator=(const Decoder &) = delete;
+
+	/**
+	 * Get the index of the block that is decoded next.
+	 */
+	size_t get_next_block() const {
+		return this->next_block;
+	}
+
+	/**
+	 * Decode the next block of the folder.
+	 *
+	 * @return Decompressed data of the block.
+	 */
+	FileBuffer decode_next() {
+		if (this->next_block >= this->folder.blocks.size()) {
+			throw Error{ERR << "read past the end of a folder in cabinet " << this->archive.path};
+		}
+
+		const data_block &block = this->folder.blocks[this->next_block];
+		this->next_block += 1;
+
+		if (not this->lzx) {
+			this->archive.verify_block(block);
+			return this->archive.contents.slice(block.offset, block.size);
+		}
+
+		std::string data(compress::LZX_FRAME_SIZE, '\0');
+		unsigned int size = this->lzx->decompress_next_frame(
+			reinterpret_cast<unsigned char *>(data.data()),
+			block.size);
+
+		if (size != block.size) {
+			throw Error{ERR << "cabinet block decompressed to " << size
+			                << " instead of " << block.size << " bytes: " << this->archive.path};
+		}
+
+		data.resize(size);
+		return FileBuffer{std::move(data)};
+	}
+
+private:
+	/**
+	 * Read callback of the LZX decompressor.
+	 * Concatenates the compressed data of the blocks of the folder.
+	 */
+	size_t read_input(unsigned char *buf, size_t size) {
+		while (this->input_block < this->folder.blocks.size()) {
+			const data_block &block = this->folder.blocks[this->input_block];
+			if (this->input_pos == 0) {
+				this->archive.verify_block(block);
+			}
+
+			if (this->input_pos < block.compressed_size) {
+				size_t amount = std::min<size_t>(size, block.compressed_size - this->input_pos);
+				std::memcpy(buf, this->archive.contents.data() + block.offset + this->input_pos, amount);
+				this->input_pos += amount;
+				return amount;
+			}
+
+			this->input_block += 1;
+			this->input_pos = 0;
+		}
+
+		return 0;
+	}
+
+	const CAB &archive;
+	const CAB::folder &folder;
+
+	/**
+	 * Index of the block that is decoded next.
+	 */
+	size_t next_block;
+
+	/**
+	 * Block and position in the block of the next compressed input.
+	 */
+	size_t input_block;
+	size_t input_pos;
+
+	/**
+	 * Decompressor of LZX folders, null for plain folders.
+	 */
+	std::unique_ptr<compress::LZXDecompressor> lzx;
+};
+
+
+CAB::CAB(const std::string &path,
+         size_t cache_size) :
+	path{path},
+	mtime{0},
+	contents{FileBuffer::map_native(path)},
+	data_reserve{0},
+	cache_size{cache_size},
+	cached_size{0} {
+	struct stat buf;
+	if (stat(path.c_str(), &buf) == 0) {
+#ifdef __APPLE__
+		this->mtime = buf.st_mtimespec.tv_sec;
+#elif defined _WIN32
+		this->mtime = buf.st_mtime;
+#else
+		this->mtime = buf.st_mtim.tv_sec;
+#endif
+	}
+
+	this->read_tables();
+
+	for (size_t i = 0; i < this->folders.size(); i++) {
+		this->folder_states.push_back(std::make_unique<folder_state>());
+	}
+}
+
+
+CAB::~CAB() = default;
+
+
+void CAB::read_tables() {
+	const char *data = this->contents.data();
+
+	require(this->contents, 0, cab::header_size, this->path);
+	if (std::memcmp(data, cab::magic, sizeof(cab::magic)) != 0) {
+		throw Error{ERR << "not a cabinet: " << this->path};
+	}
+
+	uint32_t files_offset = get_u32(data + 16);
+	uint16_t folder_count = get_u16(data + 26);
+	uint16_t file_count = get_u16(data + 28);
+	uint16_t flags = get_u16(data + 30);
+
+	uint64_t pos = cab::header_size;
+	size_t folder_reserve = 0;
+	if (flags & cab::flag_reserve_present) {
+		require(this->contents, pos, cab::header_reserve_size, this->path);
+		uint16_t header_reserve = get_u16(data + pos);
+		folder_reserve = static_cast<uint8_t>(data[pos + 2]);
+		this->data_reserve = static_cast<uint8_t>(data[pos + 3]);
+		pos += cab::header_reserve_size + header_reserve;
+	}
+
+	// names of the previous and next cabinets and their disks
+	auto skip_string = [&]() {
+		require(this->contents, pos, 0, this->path);
+		auto end = static_cast<const char *>(std::memchr(data + pos, '\0', this->contents.size() - pos));
+		if (end == nullptr) {
+			throw Error{ERR << "cabinet is truncated: " << this->path};
+		}
+		pos = end - data + 1;
+	};
+	if (flags & cab::flag_prev_cabinet) {
+		skip_string();
+		skip_string();
+	}
+	if (flags & cab::flag_next_cabinet) {
+		skip_string();
+		skip_string();
+	}
+
+	this->folders.reserve(folder_count);
+	for (size_t i = 0; i < folder_count; i++) {
+		require(this->contents, pos, cab::folder_size + folder_reserve, this->path);
+
+		uint32_t data_offset = get_u32(data + pos);
+		uint16_t block_count = get_u16(data + pos + 4);
+		uint16_t compression = get_u16(data + pos + 6);
+		pos += cab::folder_size + folder_reserve;
+
+		folder &folder = this->folders.emplace_back();
+		folder.compression = compression & 0x000f;
+		folder.window_bits = 0;
+
+		if (folder.compression == cab::compression_lzx) {
+			folder.window_bits = (compression >> 8) & 0x1f;
+			if (folder.window_bits < 15 or folder.window_bits > 21) {
+				throw Error{ERR << "invalid LZX window size " << folder.window_bits
+				                << " in cabinet " << this->path};
+			}
+		}
+		else if (folder.compression != cab::compression_none) {
+			throw Error{ERR << "unsupported compression type " << folder.compression
+			                << " in cabinet " << this->path};
+		}
+
+		this->read_blocks(folder, data_offset, block_count);
+	}
+
+	this->files.reserve(file_count);
+	this->dirs.emplace("", std::vector<Path::part_t>{});
+
+	pos = files_offset;
+	for (size_t i = 0; i < file_count; i++) {
+		require(this->contents, pos, cab::file_size, this->path);
+
+		uint32_t size = get_u32(data + pos);
+		uint32_t offset = get_u32(data + pos + 4);
+		size_t folder_index = get_u16(data + pos + 8);
+		uint16_t date = get_u16(data + pos + 10);
+		uint16_t time = get_u16(data + pos + 12);
+		uint16_t attribs = get_u16(data + pos + 14);
+		pos += cab::file_size;
+
+		uint64_t name_pos = pos;
+		skip_string();
+		std::string name = decode_name(std::string_view{data + name_pos, pos - name_pos - 1},
+		                               attribs & cab::attrib_name_is_utf);
+
+		// files that are continued from or in other cabinets
+		if (folder_index == 0xfffd or folder_index == 0xffff) {
+			folder_index = 0;
+		}
+		else if (folder_index == 0xfffe) {
+			folder_index = this->folders.size() - 1;
+		}
+
+		if (folder_index >= this->folders.size()) {
+			throw Error{ERR << "invalid folder of '" << name << "' in cabinet " << this->path};
+		}
+
+		Path::parts_t parts = util::split(name, '/');
+		for (auto &part : parts) {
+			if (part.empty() or part == "." or part == "..") {
+				throw Error{ERR << "invalid file name in cabinet: " << name};
+			}
+		}
+
+		entry file{folder_index, offset, size, dos_timestamp(date, time)};
+
+		// register the file in all parent directories
+		std::string dir_name;
+		for (size_t p = 0; p < parts.size(); p++) {
+			std::string child_name = (p == 0) ? parts[p] : dir_name + '/' + parts[p];
+			if (p + 1 < parts.size()) {
+				auto [it, inserted] = this->dirs.try_emplace(child_name);
+				if (inserted) {
+					this->dirs[dir_name].push_back(parts[p]);
+				}
+			}
+			else {
+				if (this->dirs.contains(child_name)
+				    or not this->files.emplace(child_name, file).second) {
+					throw Error{ERR << "duplicate file in cabinet: " << name};
+				}
+				this->dirs[dir_name].push_back(parts[p]);
+			}
+			dir_name = std::move(child_name);
+		}
+	}
+}
+
+
+void CAB::read_blocks(folder &folder, uint64_t offset, uint16_t count) {
+	const char *data = this->contents.data();
+
+	folder.blocks.reserve(count);
+	folder.block_offsets.reserve(count + 1);
+
+	uint64_t pos = offset;
+	uint64_t folder_size = 0;
+	for (size_t i = 0; i < count; i++) {
+		require(this->contents, pos, cab::data_size + this->data_reserve, this->path);
+
+		data_block block{
+			0,
+			get_u16(data + pos + 4),
+			get_u16(data + pos + 6),
+			get_u32(data + pos),
+		};
+		pos += cab::data_size + this->data_reserve;
+		require(this->contents, pos, block.compressed_size, this->path);
+		block.offset = pos;
+		pos += block.compressed_size;
+
+		if (block.size == 0 or block.size > compress::LZX_FRAME_SIZE
+		    or (folder.compression == cab::compression_none
+		        and block.size != block.compressed_size)) {
+			throw Error{ERR << "invalid data block in cabinet " << this->path};
+		}
+
+		folder.blocks.push_back(block);
+		folder.block_offsets.push_back(folder_size);
+		folder_size += block.size;
+	}
+
+	folder.block_offsets.push_back(folder_size);
+}
+
+
+void CAB::verify_block(const data_block &block) const {
+	if (block.checksum == 0) {
+		return;
+	}
+
+	const char *data = this->contents.data() + block.offset;
+	uint32_t checksum = (static_cast<uint32_t>(block.size) << 16) | block.compressed_size;
+	checksum ^= cab::checksum(data - this->data_reserve, this->data_reserve);
+	checksum ^= cab::checksum(data, block.compressed_size);
+
+	if (checksum != block.checksum) {
+		throw Error{ERR << "checksum error in data block of cabinet " << this->path};
+	}
+}
+
+
+const CAB::entry &CAB::find_file(const Path::parts_t &parts) const {
+	auto it = this->files.find(join_parts(parts));
+	if (it == this->files.end()) {
+		throw Error{ERR << "file not found in cabinet: " << join_parts(parts)};
+	}
+	return it->second;
+}
+
+
+FileBuffer CAB::find_cached(uint64_t key) {
+	std::lock_guard<std::mutex> lock{this->cache_mutex};
+
+	auto it = this->cache.find(key);
+	if (it == this->cache.end()) {
+		return FileBuffer{};
+	}
+
+	this->cache_order.splice(this->cache_order.begin(), this->cache_order, it->second.order);
+	return it->second.data;
+}
+
+
+void CAB::cache_block(uint64_t key, const FileBuffer &data) {
+	std::lock_guard<std::mutex> lock{this->cache_mutex};
+
+	if (this->cache.contains(key)) {
+		return;
+	}
+
+	this->cache_order.push_front(key);
+	this->cache.emplace(key, cache_entry{data, this->cache_order.begin()});
+	this->cached_size += data.size();
+
+	while (this->cached_size > this->cache_size) {
+		auto evicted = this->cache.find(this->cache_order.back());
+		this->cached_size -= evicted->second.data.size();
+		this->cache.erase(evicted);
+		this->cache_order.pop_back();
+	}
+}
+
+
+FileBuffer CAB::get_block(size_t folder_index, size_t block_index) {
+	const folder &folder = this->folders[folder_index];
+
+	// plain blocks are served from the mapping
+	if (folder.compression == cab::compression_none) {
+		const data_block &block = folder.blocks[block_index];
+		this->verify_block(block);
+		return this->contents.slice(block.offset, block.size);
+	}
+
+	const uint64_t key = block_key(folder_index, block_index);
+	FileBuffer ret = this->find_cached(key);
+	if (not ret.empty()) {
+		return ret;
+	}
+
+	folder_state &state = *this->folder_states[folder_index];
+	std::lock_guard<std::mutex> lock{state.mutex};
+
+	// the block may have been decoded while waiting for the folder
+	ret = this->find_cached(key);
+	if (not ret.empty()) {
+		return ret;
+	}
+
+	try {
+		// LZX can't seek backwards, so the folder is decoded from its start
+		if (not state.decoder or state.decoder->get_next_block() > block_index) {
+			state.decoder = std::make_unique<Decoder>(*this, folder_index);
+		}
+
+		while (state.decoder->get_next_block() <= block_index) {
+			size_t index = state.decoder->get_next_block();
+			ret = state.decoder->decode_next();
+			this->cache_block(block_key(folder_index, index), ret);
+		}
+	}
+	catch (...) {
+		// the decompressor is unusable after errors
+		state.decoder.reset();
+		throw;
+	}
+
+	return ret;
+}
+
+
+FileBuffer CAB::read_file(const entry &file,
+                          const std::string &name,
+                          const std::function<FileBuffer(size_t)> &block_source) const {
+	const std::vector<uint64_t> &offsets = this->folders[file.folder].block_offsets;
+	const uint64_t folder_size = offsets.back();
+
+	if (file.offset > folder_size or folder_size - file.offset < file.size) {
+		throw Error{ERR << "'" << name << "' exceeds its folder in cabinet " << this->path
+		                << ", it may continue in another cabinet"};
+	}
+
+	if (file.size == 0) {
+		return FileBuffer{};
+	}
+
+	const uint64_t end = file.offset + file.size;
+	size_t block = std::upper_bound(offsets.begin(), offsets.end(), file.offset) - offsets.begin() - 1;
+
+	if (end <= offsets[block + 1]) {
+		return block_source(block).slice(file.offset - offsets[block], file.size);
+	}
+
+	std::string ret;
+	ret.reserve(file.size);
+	for (; offsets[block] < end; block++) {
+		FileBuffer data = block_source(block);
+		uint64_t from = std::max(file.offset, offsets[block]) - offsets[block];
+		uint64_t to = std::min(end, offsets[block + 1]) - offsets[block];
+		ret.append(data.data() + from, to - from);
+	}
+
+	return FileBuffer{std::move(ret)};
+}
+
+
+void CAB::extract(const Path &target,
+                  job::JobManager *job_manager) {
+	// create the directories up front, the jobs only write files
+	for (auto &[name, children] : this->dirs) {
+		(target / name).mkdirs();
+	}
+
+	// the files of each folder, in the order of the folder stream
+	std::vector<std::vector<const std::pair<const std::string, entry> *>> folder_files(this->folders.size());
+	for (auto &file : this->files) {
+		folder_files[file.second.folder].push_back(&file);
+	}
+	for (auto &files : folder_files) {
+		std::sort(files.begin(), files.end(), [](auto *a, auto *b) {
+			return a->second.offset < b->second.offset;
+		});
+	}
+
+	auto extract_folder = [&](size_t folder_index) {
+		std::unique_ptr<Decoder> decoder;
+		FileBuffer current;
+
+		auto block_source = [&](size_t block) {
+			// consecutive files may share a block
+			if (decoder and decoder->get_next_block() == block + 1) {
+				return current;
+			}
+
+			if (not decoder or decoder->get_next_block() > block) {
+				decoder = std::make_unique<Decoder>(*this, folder_index);
+			}
+
+			while (decoder->get_next_block() <= block) {
+				current = decoder->decode_next();
+			}
+			return current;
+		};
+
+		for (auto *file : folder_files[folder_index]) {
+			FileBuffer data = this->read_file(file->second, file->first, block_source);
+			File out = (target / file->first).open_w();
+			out.write_from(data.data(), data.size());
+			out.close();
+		}
+	};
+
+	if (job_manager == nullptr) {
+		for (size_t i = 0; i < this->folders.size(); i++) {
+			extract_folder(i);
+		}
+		return;
+	}
+
+	std::vector<job::Job<bool>> jobs;
+	jobs.reserve(this->folders.size());
+	for (size_t i = 0; i < this->folders.size(); i++) {
+		jobs.push_back(job_manager->enqueue<bool>([&extract_folder, i]() {
+			extract_folder(i);
+			return true;
+		}));
+	}
+
+	for (auto &job : jobs) {
+		job.wait();
+	}
+
+	// rethrow errors of the jobs
+	job_manager->execute_callbacks();
+	for (auto &job : jobs) {
+		job.get_result();
+	}
+}
+
+
+size_t CAB::get_folder_count() const {
+	return this->folders.size();
+}
+
+
+size_t CAB::get_cached_size() const {
+	std::lock_guard<std::mutex> lock{this->cache_mutex};
+	return this->cached_size;
+}
+
+
+bool CAB::is_file(const Path::parts_t &parts) {
+	return this->files.contains(join_parts(parts));
+}
+
+
+bool CAB::is_dir(const Path::parts_t &parts) {
+	return this->dirs.contains(join_parts(parts));
+}
+
+
+bool CAB::writable(const Path::parts_t &) {
+	return false;
+}
+
+
+std::vector<Path::part_t> CAB::list(const Path::parts_t &parts) {
+	auto it = this->dirs.find(join_parts(parts));
+	if (it == this->dirs.end()) {
+		throw Error{ERR << "could not list contents of '" << join_parts(parts)
+		                << "' in cabinet"};
+	}
+	return it->second;
+}
+
+
+bool CAB::mkdirs(const Path::parts_t &) {
+	return false;
+}
+
+
+File CAB::open_r(const Path::parts_t &parts) {
+	const entry &file = this->find_file(parts);
+	const std::string name = join_parts(parts);
+
+	FileBuffer data = this->read_file(file, name, [&](size_t block) {
+		return this->get_block(file.folder, block);
+	});
+
+	return File{std::make_shared<filelike::View>(std::move(data), name)};
+}
+
+
+File CAB::open_w(const Path::parts_t &) {
+	throw Error{ERR << "cabinets are read-only"};
+}
+
+
+File CAB::open_rw(const Path::parts_t &) {
+	throw Error{ERR << "cabinets are read-only"};
+}
+
+
+File CAB::open_a(const Path::parts_t &) {
+	throw Error{ERR << "cabinets are read-only"};
+}
+
+
+File CAB::open_ar(const Path::parts_t &) {
+	throw Error{ERR << "cabinets are read-only"};
+}
+
+
+std::string CAB::get_native_path(const Path::parts_t &) {
+	return "";
+}
+
+
+bool CAB::rename(const Path::parts_t &,
+                 const Path::parts_t &) {
+	return false;
+}
+
+
+bool CAB::rmdir(const Path::parts_t &) {
+	return false;
+}
+
+
+bool CAB::touch(const Path::parts_t &) {
+	return false;
+}
+
+
+bool CAB::unlink(const Path::parts_t &) {
+	return false;
+}
+
+
+int CAB::get_mtime(const Path::parts_t &parts) {
+	auto it = this->files.find(join_parts(parts));
+	if (it != this->files.end()) {
+		return it->second.mtime;
+	}
+
+	if (not this->is_dir(parts)) {
+		throw Error{ERR << "can't get mtime"};
+	}
+	return this->mtime;
+}
+
+
+uint64_t CAB::get_filesize(const Path::parts_t &parts) {
+	return this->find_file(parts).size;
+}
+
+
+std::ostream &CAB::repr(std::ostream &stream) {
+	stream << "CAB(" << this->path << ")";
+	return stream;
+}
+
+} // namespace openage::util::fslike
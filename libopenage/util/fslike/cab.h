@@ -0,0 +1,403 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+// pxd: from libcpp.string cimport string
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../file_buffer.h"
+// pxd: from libopenage.util.fslike.fslike cimport FSLike
+#include "fslike.h"
+// pxd: from libopenage.util.path cimport Path
+#include "../path.h"
+
+// pxd: from libopenage.job.job_manager cimport JobManager
+
+
+namespace openage {
+namespace job {
+class JobManager;
+} // namespace job
+
+namespace util {
+namespace fslike {
+
+/**
+ * Layout of Microsoft cabinet (CAB) archives.
+ *
+ * All numbers are stored in little endian.
+ *
+ *   CFHEADER   magic "MSCF", reserved, uint32 cabinet size, reserved,
+ *              uint32 offset of the first CFFILE, reserved,
+ *              uint8 minor version, uint8 major version,
+ *              uint16 folder count, uint16 file count, uint16 flags,
+ *              uint16 set id, uint16 cabinet index
+ *              [uint16 header reserve size, uint8 folder reserve size,
+ *               uint8 data reserve size, header reserve]
+ *              [previous cabinet and disk names]
+ *              [next cabinet and disk names]
+ *   CFFOLDER   uint32 offset of the first CFDATA, uint16 CFDATA count,
+ *              uint16 compression type, folder reserve
+ *   CFFILE     uint32 size, uint32 offset in the folder, uint16 folder index,
+ *              uint16 DOS date, uint16 DOS time, uint16 attributes,
+ *              null-terminated name
+ *   CFDATA     uint32 checksum, uint16 compressed size,
+ *              uint16 uncompressed size, data reserve, compressed data
+ *
+ * A folder is a single compressed stream with the concatenated contents
+ * of its files. Each CFDATA block of an LZX folder decompresses to one
+ * LZX frame.
+ */
+namespace cab {
+
+constexpr char magic[4] = {'M', 'S', 'C', 'F'};
+constexpr size_t header_size = 36;
+constexpr size_t header_reserve_size = 4;
+constexpr size_t folder_size = 8;
+constexpr size_t file_size = 16;
+constexpr size_t data_size = 8;
+
+constexpr uint16_t flag_prev_cabinet = 1 << 0;
+constexpr uint16_t flag_next_cabinet = 1 << 1;
+constexpr uint16_t flag_reserve_present = 1 << 2;
+
+constexpr uint16_t compression_none = 0;
+constexpr uint16_t compression_lzx = 3;
+
+/**
+ * File name is UTF-8 instead of ISO-8859-1.
+ */
+constexpr uint16_t attrib_name_is_utf = 1 << 7;
+
+/**
+ * Default budget for decompressed CFDATA blocks that are kept in memory.
+ */
+constexpr size_t default_cache_size = 64 * 1024 * 1024;
+
+/**
+ * Calculate the CAB checksum of some data.
+ *
+ * The data is XORed as little endian 32-bit numbers; the remaining
+ * 1 to 3 bytes are XORed as a big endian number.
+ * The checksum of a CFDATA block is the checksum of its reserve and its
+ * payload, XORed with the uncompressed size (upper 16 bits) and the
+ * compressed size (lower 16 bits).
+ *
+ * @param data Data to checksum.
+ * @param size Size of the data.
+ *
+ * @return Checksum of the data.
+ */
+uint32_t checksum(const char *data, size_t size);
+
+} // namespace cab
+
+
+/**
+ * Read-only filesystem-like object for a Microsoft cabinet archive.
+ *
+ * The archive is memory-mapped and its folder and file tables are read
+ * when it is opened. Plain folders are served directly from the mapping,
+ * LZX folders are decompressed with \p compress::LZXDecompressor.
+ *
+ * LZX streams can only be decoded from their start. To make random access
+ * cheap, every folder keeps its decoder at its last position, and the
+ * decompressed CFDATA blocks are kept in a least-recently-used cache.
+ * Reading a file before the position of the decoder only decompresses the
+ * folder again if its blocks were evicted from the cache.
+ *
+ * Cabinets that are continued in other cabinets are not supported;
+ * files that span cabinets can't be opened.
+ *
+ * pxd:
+ * cppclass CAB(FSLike):
+ *     CAB(const string &path) except +
+ *
+ *     void extract(const Path &target,
+ *                  JobManager *job_manager) except +
+ *     size_t get_folder_count() except +
+ */
+class CAB : public FSLike {
+public:
+	/**
+	 * Open a cabinet.
+	 *
+	 * @param path Native path of the cabinet file.
+	 * @param cache_size Maximum size of the decompressed blocks that are
+	 *                   kept in memory, in bytes.
+	 */
+	CAB(const std::string &path,
+	    size_t cache_size = cab::default_cache_size);
+
+	~CAB();
+
+	/**
+	 * Extract all files of the cabinet.
+	 *
+	 * The folders are independent streams, so each folder is decompressed
+	 * in its own job. The decompressed blocks bypass the block cache.
+	 * Blocks until all files are written.
+	 *
+	 * @param target Directory the files are extracted to.
+	 * @param job_manager Job manager that decompresses the folders in
+	 *                    parallel. If it is null, the folders are
+	 *                    decompressed one after another.
+	 */
+	void extract(const Path &target,
+	             job::JobManager *job_manager = nullptr);
+
+	/**
+	 * Get the number of folders in the cabinet.
+	 *
+	 * @return Number of folders.
+	 */
+	size_t get_folder_count() const;
+
+	/**
+	 * Get the size of the decompressed blocks in the block cache.
+	 *
+	 * @return Size of the cached blocks in bytes.
+	 */
+	size_t get_cached_size() const;
+
+	bool is_file(const Path::parts_t &parts) override;
+	bool is_dir(const Path::parts_t &parts) override;
+	bool writable(const Path::parts_t &parts) override;
+	std::vector<Path::part_t> list(const Path::parts_t &parts) override;
+	bool mkdirs(const Path::parts_t &parts) override;
+	File open_r(const Path::parts_t &parts) override;
+	File open_w(const Path::parts_t &parts) override;
+	File open_rw(const Path::parts_t &parts) override;
+	File open_a(const Path::parts_t &parts) override;
+	File open_ar(const Path::parts_t &parts) override;
+	std::string get_native_path(const Path::parts_t &parts) override;
+	bool rename(const Path::parts_t &parts,
+	            const Path::parts_t &target_parts) override;
+	bool rmdir(const Path::parts_t &parts) override;
+	bool touch(const Path::parts_t &parts) override;
+	bool unlink(const Path::parts_t &parts) override;
+
+	int get_mtime(const Path::parts_t &parts) override;
+	uint64_t get_filesize(const Path::parts_t &parts) override;
+
+	std::ostream &repr(std::ostream &) override;
+
+private:
+	/**
+	 * Sequential decoder for the blocks of a folder.
+	 */
+	class Decoder;
+
+	/**
+	 * CFDATA block of a folder.
+	 */
+	struct data_block {
+		/// Offset of the compressed data in the cabinet.
+		uint64_t offset;
+		/// Size of the compressed data.
+		uint16_t compressed_size;
+		/// Size of the decompressed data.
+		uint16_t size;
+		/// Checksum of the block, 0 if there is none.
+		uint32_t checksum;
+	};
+
+	/**
+	 * Folder of the cabinet.
+	 */
+	struct folder {
+		/// Compression type from \p cab.
+		uint16_t compression;
+		/// LZX window size.
+		unsigned int window_bits;
+		/// CFDATA blocks of the folder.
+		std::vector<data_block> blocks;
+		/// Offset of each block in the decompressed folder,
+		/// followed by the size of the folder.
+		std::vector<uint64_t> block_offsets;
+	};
+
+	/**
+	 * File in the cabinet.
+	 */
+	struct entry {
+		/// Index of the folder that contains the file.
+		size_t folder;
+		/// Offset of the file in the decompressed folder.
+		uint64_t offset;
+		/// Size of the file.
+		uint64_t size;
+		/// Modification time as UNIX timestamp.
+		int mtime;
+	};
+
+	/**
+	 * Decoder of a folder that is shared by all readers of the folder.
+	 */
+	struct folder_state {
+		/// Serializes decoding the folder.
+		std::mutex mutex;
+		/// Decoder at its last position, null before the first read.
+		std::unique_ptr<Decoder> decoder;
+	};
+
+	/**
+	 * Decompressed block in the block cache.
+	 */
+	struct cache_entry {
+		/// Decompressed data.
+		FileBuffer data;
+		/// Position in the usage order.
+		std::list<uint64_t>::iterator order;
+	};
+
+	/**
+	 * Read the CFHEADER, CFFOLDER and CFFILE tables.
+	 */
+	void read_tables();
+
+	/**
+	 * Read the CFDATA headers of a folder.
+	 *
+	 * @param folder Folder whose blocks are read.
+	 * @param offset Offset of the first CFDATA block in the cabinet.
+	 * @param count Number of CFDATA blocks.
+	 */
+	void read_blocks(folder &folder, uint64_t offset, uint16_t count);
+
+	/**
+	 * Verify the checksum of a CFDATA block.
+	 * Throws if the block is corrupted.
+	 *
+	 * @param block Block that is verified.
+	 */
+	void verify_block(const data_block &block) const;
+
+	/**
+	 * Find a file in the cabinet.
+	 * Throws if the file does not exist.
+	 *
+	 * @param parts Path of the file.
+	 *
+	 * @return File entry.
+	 */
+	const entry &find_file(const Path::parts_t &parts) const;
+
+	/**
+	 * Get a decompressed block through the block cache.
+	 *
+	 * @param folder_index Index of the folder.
+	 * @param block_index Index of the block in the folder.
+	 *
+	 * @return Decompressed data of the block.
+	 */
+	FileBuffer get_block(size_t folder_index, size_t block_index);
+
+	/**
+	 * Look up a block in the block cache and mark it as recently used.
+	 *
+	 * @param key Cache key of the block.
+	 *
+	 * @return Decompressed data of the block, empty if it is not cached.
+	 */
+	FileBuffer find_cached(uint64_t key);
+
+	/**
+	 * Insert a block into the block cache and evict the least
+	 * recently used blocks that exceed the cache size.
+	 *
+	 * @param key Cache key of the block.
+	 * @param data Decompressed data of the block.
+	 */
+	void cache_block(uint64_t key, const FileBuffer &data);
+
+	/**
+	 * Assemble the contents of a file from the blocks of its folder.
+	 * Files that lie in a single block share its memory.
+	 *
+	 * @param file File that is read.
+	 * @param name Name of the file for error messages.
+	 * @param block_source Returns the decompressed data of a block
+	 *                     of the folder of the file.
+	 *
+	 * @return Contents of the file.
+	 */
+	FileBuffer read_file(const entry &file,
+	                     const std::string &name,
+	                     const std::function<FileBuffer(size_t)> &block_source) const;
+
+	/**
+	 * Path of the cabinet file.
+	 */
+	std::string path;
+
+	/**
+	 * Modification time of the cabinet file.
+	 */
+	int mtime;
+
+	/**
+	 * Mapped cabinet file.
+	 */
+	FileBuffer contents;
+
+	/**
+	 * Size of the CFDATA reserve area.
+	 */
+	size_t data_reserve;
+
+	/**
+	 * Folders of the cabinet.
+	 */
+	std::vector<folder> folders;
+
+	/**
+	 * Decoders of the folders, by folder index.
+	 */
+	std::vector<std::unique_ptr<folder_state>> folder_states;
+
+	/**
+	 * Files in the cabinet, by their name.
+	 */
+	std::unordered_map<std::string, entry> files;
+
+	/**
+	 * Directories in the cabinet with their contents, by their name.
+	 */
+	std::unordered_map<std::string, std::vector<Path::part_t>> dirs;
+
+	/**
+	 * Maximum size of the cached blocks.
+	 */
+	size_t cache_size;
+
+	/**
+	 * Size of the cached blocks.
+	 */
+	size_t cached_size;
+
+	/**
+	 * Guards the block cache.
+	 */
+	mutable std::mutex cache_mutex;
+
+	/**
+	 * Cached blocks, keyed by folder index (upper 32 bits)
+	 * and block index (lower 32 bits).
+	 */
+	std::unordered_map<uint64_t, cache_entry> cache;
+
+	/**
+	 * Cache keys, most recently used first.
+	 */
+	std::list<uint64_t> cache_order;
+};
+
+}}} // openage::util::fslike
@@ -0,0 +1,404 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "cab.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "job/job_manager.h"
+#include "log/log.h"
+#include "testing/temp_dir.h"
+#include "testing/testing.h"
+
+#include "../compress/lzxd.h"
+#include "../file.h"
+#include "../path.h"
+
+
+namespace openage::util::fslike::tests {
+
+namespace {
+
+/**
+ * File of a synthetic cabinet.
+ */
+struct cab_file {
+	std::string name;
+	std::string data;
+};
+
+
+/**
+ * Folder of a synthetic cabinet.
+ */
+struct cab_folder {
+	bool lzx;
+	std::vector<cab_file> files;
+};
+
+
+/**
+ * 2015-03-07 12:34:56 UTC in DOS format, as UNIX timestamp.
+ */
+constexpr uint16_t dos_date = ((2015 - 1980) << 9) | (3 << 5) | 7;
+constexpr uint16_t dos_time = (12 << 11) | (34 << 5) | (56 >> 1);
+constexpr int timestamp = 1425731696;
+
+
+void put_u16(std::string &out, uint16_t value) {
+	out.push_back(static_cast<char>(value & 0xff));
+	out.push_back(static_cast<char>(value >> 8));
+}
+
+
+void put_u32(std::string &out, uint32_t value) {
+	put_u16(out, value & 0xffff);
+	put_u16(out, value >> 16);
+}
+
+
+/**
+ * Create file contents that don't compress.
+ */
+std::string noise(size_t size, uint32_t seed) {
+	std::string ret(size, '\0');
+	uint32_t state = seed;
+	for (auto &c : ret) {
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		c = static_cast<char>(state & 0xff);
+	}
+	return ret;
+}
+
+
+/**
+ * Encode data as LZX stream without compressing it.
+ *
+ * There is no LZX compressor, but uncompressed LZX blocks are part of
+ * the format. Each frame is stored in its own uncompressed block, so the
+ * compressed data of each frame can be put into its own CFDATA block.
+ *
+ * @return Compressed data of each frame.
+ */
+std::vector<std::string> lzx_store(const std::string &data) {
+	std::vector<std::string> frames;
+	for (size_t pos = 0; pos < data.size(); pos += compress::LZX_FRAME_SIZE) {
+		uint32_t size = std::min<size_t>(compress::LZX_FRAME_SIZE, data.size() - pos);
+
+		// block type 3 and the 24 bit block size, padded to 32 bits.
+		// the stream starts with a zero bit for "no E8 translation".
+		uint32_t header = (pos == 0) ? ((3u << 28) | (size << 4))
+		                             : ((3u << 29) | (size << 5));
+
+		// the bitstream consists of 16 bit little endian words
+		std::string frame;
+		put_u16(frame, header >> 16);
+		put_u16(frame, header & 0xffff);
+
+		// R0, R1 and R2
+		for (size_t i = 0; i < 3; i++) {
+			put_u32(frame, 1);
+		}
+
+		frame.append(data, pos, size);
+
+		// pad to 16 bits before the next block
+		if (size % 2 != 0) {
+			frame.push_back('\0');
+		}
+
+		frames.push_back(std::move(frame));
+	}
+	return frames;
+}
+
+
+/**
+ * Create a cabinet with the given folders.
+ *
+ * @param folders Folders with their files.
+ * @param reserve Whether the cabinet has reserve areas.
+ *
+ * @return Contents of the cabinet file.
+ */
+std::string make_cabinet(const std::vector<cab_folder> &folders, bool reserve) {
+	const size_t header_reserve = reserve ? 6 : 0;
+	const size_t folder_reserve = reserve ? 2 : 0;
+	const size_t data_reserve = reserve ? 4 : 0;
+
+	size_t file_count = 0;
+	size_t file_table_size = 0;
+	for (auto &folder : folders) {
+		for (auto &file : folder.files) {
+			file_count += 1;
+			file_table_size += cab::file_size + file.name.size() + 1;
+		}
+	}
+
+	const size_t files_offset = cab::header_size
+	                            + (reserve ? cab::header_reserve_size + header_reserve : 0)
+	                            + folders.size() * (cab::folder_size + folder_reserve);
+	const size_t data_offset = files_offset + file_table_size;
+
+	std::string folder_table;
+	std::string file_table;
+	std::string data;
+	for (size_t f = 0; f < folders.size(); f++) {
+		std::string folder_data;
+		for (auto &file : folders[f].files) {
+			put_u32(file_table, file.data.size());
+			put_u32(file_table, folder_data.size());
+			put_u16(file_table, f);
+			put_u16(file_table, dos_date);
+			put_u16(file_table, dos_time);
+			put_u16(file_table, 0);
+			file_table += file.name;
+			file_table.push_back('\0');
+
+			folder_data += file.data;
+		}
+
+		// compressed and uncompressed data of each block
+		std::vector<std::pair<std::string, size_t>> blocks;
+		if (folders[f].lzx) {
+			auto frames = lzx_store(folder_data);
+			for (size_t i = 0; i < frames.size(); i++) {
+				size_t size = std::min<size_t>(compress::LZX_FRAME_SIZE,
+				                               folder_data.size() - i * compress::LZX_FRAME_SIZE);
+				blocks.emplace_back(std::move(frames[i]), size);
+			}
+		}
+		else {
+			for (size_t pos = 0; pos < folder_data.size(); pos += compress::LZX_FRAME_SIZE) {
+				std::string block = folder_data.substr(pos, compress::LZX_FRAME_SIZE);
+				size_t size = block.size();
+				blocks.emplace_back(std::move(block), size);
+			}
+		}
+
+		put_u32(folder_table, data_offset + data.size());
+		put_u16(folder_table, blocks.size());
+		put_u16(folder_table, folders[f].lzx ? (cab::compression_lzx | (16 << 8)) : cab::compression_none);
+		folder_table.append(folder_reserve, 'f');
+
+		for (auto &[payload, size] : blocks) {
+			const std::string block_reserve(data_reserve, 'd');
+			uint32_t checksum = (static_cast<uint32_t>(size) << 16) | payload.size();
+			checksum ^= cab::checksum(block_reserve.data(), block_reserve.size());
+			checksum ^= cab::checksum(payload.data(), payload.size());
+
+			put_u32(data, checksum);
+			put_u16(data, payload.size());
+			put_u16(data, size);
+			data += block_reserve;
+			data += payload;
+		}
+	}
+
+	std::string ret{cab::magic, sizeof(cab::magic)};
+	put_u32(ret, 0);
+	put_u32(ret, data_offset + data.size());
+	put_u32(ret, 0);
+	put_u32(ret, files_offset);
+	put_u32(ret, 0);
+	ret.push_back(3);
+	ret.push_back(1);
+	put_u16(ret, folders.size());
+	put_u16(ret, file_count);
+	put_u16(ret, reserve ? cab::flag_reserve_present : 0);
+	put_u16(ret, 0);
+	put_u16(ret, 0);
+
+	if (reserve) {
+		put_u16(ret, header_reserve);
+		ret.push_back(static_cast<char>(folder_reserve));
+		ret.push_back(static_cast<char>(data_reserve));
+		ret.append(header_reserve, 'h');
+	}
+
+	return ret + folder_table + file_table + data;
+}
+
+
+/**
+ * Write a file with the given contents.
+ */
+void write_file(const Path &path, const std::string &data) {
+	File file = path.open_w();
+	file.write(data);
+	file.close();
+}
+
+
+/**
+ * Get the sorted directory contents.
+ */
+std::vector<Path::part_t> sorted_list(Path path) {
+	auto ret = path.list();
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+} // namespace
+
+
+void cab_archive() {
+	testing::TempDir tmpdir{"cab"};
+	auto tmp = tmpdir.get_path();
+
+	const std::string readme = "openage\n";
+	const std::string unit = noise(100000, 1);
+	const std::string sounds = noise(70001, 2);
+
+	const std::vector<cab_folder> folders{
+		{false, {{"README.TXT", readme}, {"empty.txt", ""}}},
+		{true, {{"Data\\Graphics\\Unit.SLP", unit},
+		        {"Data\\Sounds.drs", sounds},
+		        {"caf\xe9.txt", "latin-1"}}},
+	};
+	const std::string cabinet = make_cabinet(folders, true);
+	write_file(tmp / "test.cab", cabinet);
+
+	auto cab = std::make_shared<CAB>((tmp / "test.cab").resolve_native_path());
+	Path root = cab->root();
+	TESTEQUALS(cab->get_folder_count(), 2);
+
+	// names are lowercased and use '/', ISO-8859-1 names are converted
+	(sorted_list(root) == std::vector<Path::part_t>{"café.txt", "data", "empty.txt", "readme.txt"}) or TESTFAIL;
+	(sorted_list(root / "data") == std::vector<Path::part_t>{"graphics", "sounds.drs"}) or TESTFAIL;
+	(root / "data" / "graphics").is_dir() or TESTFAIL;
+	(not (root / "data" / "graphics").is_file()) or TESTFAIL;
+	(not (root / "missing.txt").exists()) or TESTFAIL;
+
+	// LZX folders are read in any order
+	TESTEQUALS((root / "café.txt").open_r().read(), "latin-1");
+	TESTEQUALS((root / "data" / "graphics" / "unit.slp").open_r().read(), unit);
+	TESTEQUALS((root / "data" / "sounds.drs").open_r().read(), sounds);
+	TESTEQUALS((root / "readme.txt").open_r().read(), readme);
+	TESTEQUALS((root / "empty.txt").open_r().read(), "");
+
+	TESTEQUALS((root / "data" / "sounds.drs").get_filesize(), sounds.size());
+	TESTEQUALS((root / "data" / "sounds.drs").get_mtime(), timestamp);
+
+	// all blocks of the LZX folder are cached now
+	TESTEQUALS(cab->get_cached_size(), unit.size() + sounds.size() + 7);
+
+	// files are seekable views
+	File file = (root / "data" / "sounds.drs").open_r();
+	file.seek(-16, File::seek_t::END);
+	TESTEQUALS(file.read(), sounds.substr(sounds.size() - 16));
+	file.seek(40000);
+	TESTEQUALS(file.read(4), sounds.substr(40000, 4));
+
+	// without a cache, going back decompresses the folder again
+	auto uncached = std::make_shared<CAB>((tmp / "test.cab").resolve_native_path(), 0);
+	TESTEQUALS((uncached->root() / "data" / "sounds.drs").open_r().read(), sounds);
+	TESTEQUALS((uncached->root() / "data" / "graphics" / "unit.slp").open_r().read(), unit);
+	TESTEQUALS(uncached->get_cached_size(), 0);
+
+	// the folders are extracted in parallel
+	job::JobManager job_manager{2};
+	job_manager.start();
+	cab->extract(tmp / "out", &job_manager);
+	job_manager.stop();
+
+	TESTEQUALS((tmp / "out" / "readme.txt").open_r().read(), readme);
+	TESTEQUALS((tmp / "out" / "empty.txt").open_r().read(), "");
+	TESTEQUALS((tmp / "out" / "data" / "graphics" / "unit.slp").open_r().read(), unit);
+	TESTEQUALS((tmp / "out" / "data" / "sounds.drs").open_r().read(), sounds);
+
+	// the cabinet is read-only
+	(not (root / "readme.txt").writable()) or TESTFAIL;
+	TESTTHROWS((root / "new.txt").open_w());
+
+	// corrupted blocks fail their checksum
+	std::string corrupted = cabinet;
+	corrupted[corrupted.size() - 100] ^= 0x01;
+	write_file(tmp / "corrupted.cab", corrupted);
+	auto broken = std::make_shared<CAB>((tmp / "corrupted.cab").resolve_native_path());
+	TESTTHROWS((broken->root() / "data" / "sounds.drs").open_r());
+	TESTEQUALS((broken->root() / "readme.txt").open_r().read(), readme);
+
+	// other files are rejected
+	TESTTHROWS(CAB{(tmp / "out" / "readme.txt").resolve_native_path()});
+	write_file(tmp / "truncated.cab", cabinet.substr(0, 100));
+	TESTTHROWS(CAB{(tmp / "truncated.cab").resolve_native_path()});
+}
+
+
+void cab_benchmark() {
+	testing::TempDir tmpdir{"cab"};
+
+	// 8 LZX folders with 64 files of 64 KiB each
+	const size_t folder_count = 8;
+	const size_t files_per_folder = 64;
+	const size_t file_size = 64 * 1024;
+
+	std::vector<cab_folder> folders;
+	for (size_t f = 0; f < folder_count; f++) {
+		cab_folder &folder = folders.emplace_back(cab_folder{true, {}});
+		for (size_t i = 0; i < files_per_folder; i++) {
+			folder.files.push_back({
+				"folder_" + std::to_string(f) + "\\file_" + std::to_string(i) + ".slp",
+				noise(file_size, f * files_per_folder + i + 1),
+			});
+		}
+	}
+
+	auto tmp = tmpdir.get_path();
+	write_file(tmp / "bench.cab", make_cabinet(folders, false));
+	const std::string cab_path = (tmp / "bench.cab").resolve_native_path();
+
+	const int workers = std::clamp<int>(std::thread::hardware_concurrency(), 2, folder_count);
+	job::JobManager job_manager{workers};
+	job_manager.start();
+
+	auto start = std::chrono::steady_clock::now();
+	CAB{cab_path}.extract(tmp / "serial");
+	auto serial_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	CAB{cab_path}.extract(tmp / "parallel", &job_manager);
+	auto parallel_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	job_manager.stop();
+
+	const std::string last_file = "folder_7/file_63.slp";
+	TESTEQUALS((tmp / "serial" / last_file).open_r().read(), folders[7].files[63].data);
+	TESTEQUALS((tmp / "parallel" / last_file).open_r().read(), folders[7].files[63].data);
+
+	// read the files of a folder backwards, which is the worst case for LZX
+	auto read_backwards = [&](size_t cache_size) {
+		CAB cab{cab_path, cache_size};
+		size_t bytes = 0;
+		for (size_t i = files_per_folder; i-- > 0;) {
+			bytes += cab.open_r({"folder_0", "file_" + std::to_string(i) + ".slp"}).read().size();
+		}
+		return bytes;
+	};
+
+	start = std::chrono::steady_clock::now();
+	size_t uncached_bytes = read_backwards(0);
+	auto uncached_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	size_t cached_bytes = read_backwards(cab::default_cache_size);
+	auto cached_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	TESTEQUALS(uncached_bytes, cached_bytes);
+
+	const double mib = folder_count * files_per_folder * file_size / (1024.0 * 1024.0);
+	log::log(MSG(info) << folder_count << " LZX folders with " << mib << " MiB");
+	log::log(MSG(info) << "  extract: " << serial_time.count() * 1e3 << " ms serial, "
+	                   << parallel_time.count() * 1e3 << " ms with " << workers << " workers");
+	log::log(MSG(info) << "  read a folder backwards: " << uncached_time.count() * 1e3 << " ms without cache, "
+	                   << cached_time.count() * 1e3 << " ms with cache");
+}
+
+} // namespace openage::util::fslike::tests
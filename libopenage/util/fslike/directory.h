@@ -2,12 +2,14 @@
 
 #pragma once
 
-
+// pxd: from libcpp cimport bool
+// pxd: from libcpp.string cimport string
 #include <string>
 #include <sys/stat.h>
 #include <tuple>
 #include <vector>
 
+// pxd: from libopenage.util.fslike.fslike cimport FSLike
 #include "fslike.h"
 
 
@@ -20,6 +22,10 @@ namespace fslike {
  * Filesystem-like object which uses native libc calls.
  * It is used to directly access your real filesystem
  * that the kernel mounted for you.
+ *
+ * pxd:
+ * cppclass Directory(FSLike):
+ *     Directory(string basepath, bool create_if_missing) except +
  */
 class Directory : public FSLike {
 public:
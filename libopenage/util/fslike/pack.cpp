@@ -0,0 +1,456 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+#include <zlib.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "../../error/error.h"
+#include "../file.h"
+#include "../file_buffer.h"
+#include "../filelike/view.h"
+#include "../path.h"
+#include "../strings.h"
+
+
+namespace openage::util::fslike {
+
+namespace {
+
+void put_u32(std::string &out, uint32_t value) {
+	for (size_t i = 0; i < 4; i++) {
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+	}
+}
+
+
+void put_u64(std::string &out, uint64_t value) {
+	for (size_t i = 0; i < 8; i++) {
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+	}
+}
+
+
+uint32_t get_u32(const char *data) {
+	uint32_t value = 0;
+	for (size_t i = 0; i < 4; i++) {
+		value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+	}
+	return value;
+}
+
+
+uint64_t get_u64(const char *data) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < 8; i++) {
+		value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+	}
+	return value;
+}
+
+
+std::string join_parts(const Path::parts_t &parts) {
+	std::string ret;
+	for (size_t i = 0; i < parts.size(); i++) {
+		if (i > 0) {
+			ret += '/';
+		}
+		ret += parts[i];
+	}
+	return ret;
+}
+
+} // namespace
+
+
+Pack::Pack(const std::string &path) :
+	path{path},
+	mtime{0},
+	contents{FileBuffer::map_native(path)} {
+	struct stat buf;
+	if (stat(path.c_str(), &buf) == 0) {
+#ifdef __APPLE__
+		this->mtime = buf.st_mtimespec.tv_sec;
+#elif defined _WIN32
+		this->mtime = buf.st_mtime;
+#else
+		this->mtime = buf.st_mtim.tv_sec;
+#endif
+	}
+
+	this->read_directory();
+}
+
+
+void Pack::read_directory() {
+	const char *data = this->contents.data();
+	const size_t size = this->contents.size();
+
+	if (size < pack::header_size + pack::footer_size
+	    or std::memcmp(data, pack::magic, sizeof(pack::magic)) != 0) {
+		throw Error{ERR << "not an asset pack: " << this->path};
+	}
+
+	uint32_t pack_version = get_u32(data + 4);
+	if (pack_version != pack::version) {
+		throw Error{ERR << "unsupported asset pack version " << pack_version
+		                << ": " << this->path};
+	}
+
+	const char *footer = data + size - pack::footer_size;
+	if (std::memcmp(footer + 16, pack::magic, sizeof(pack::magic)) != 0) {
+		throw Error{ERR << "asset pack is truncated: " << this->path};
+	}
+
+	uint64_t dir_offset = get_u64(footer);
+	uint64_t count = get_u64(footer + 8);
+	const uint64_t dir_end = size - pack::footer_size;
+	if (dir_offset < pack::header_size or dir_offset > dir_end) {
+		throw Error{ERR << "invalid asset pack directory: " << this->path};
+	}
+
+	// the count is checked before anything is allocated for the entries
+	if (count > (dir_end - dir_offset) / pack::directory_entry_size) {
+		throw Error{ERR << "invalid asset pack directory: " << this->path};
+	}
+
+	this->files.reserve(count);
+	this->dirs.emplace("", std::vector<Path::part_t>{});
+
+	uint64_t pos = dir_offset;
+	for (uint64_t i = 0; i < count; i++) {
+		if (dir_end - pos < pack::directory_entry_size) {
+			throw Error{ERR << "invalid asset pack directory: " << this->path};
+		}
+
+		const char *record = data + pos;
+		entry file{
+			get_u64(record),
+			get_u64(record + 8),
+			get_u64(record + 16),
+			get_u32(record + 24),
+		};
+		uint32_t name_length = get_u32(record + 28);
+		pos += pack::directory_entry_size;
+
+		if (dir_end - pos < name_length
+		    or file.offset > dir_offset
+		    or dir_offset - file.offset < file.stored_size) {
+			throw Error{ERR << "invalid asset pack directory: " << this->path};
+		}
+
+		std::string name{data + pos, name_length};
+		pos += name_length;
+
+		// the uncompressed size is checked before anything is allocated for it
+		if (file.flags & pack::flag_compressed) {
+			if (file.size > pack::max_uncompressed_size
+			    or file.size > file.stored_size * pack::max_compression_ratio) {
+				throw Error{ERR << "invalid size of compressed file in asset pack: " << name};
+			}
+		}
+		else if (file.size != file.stored_size) {
+			throw Error{ERR << "invalid size of file in asset pack: " << name};
+		}
+
+		Path::parts_t parts = util::split(name, '/');
+		for (auto &part : parts) {
+			if (part.empty() or part == "." or part == "..") {
+				throw Error{ERR << "invalid file name in asset pack: " << name};
+			}
+		}
+
+		// register the file in all parent directories
+		std::string dir_name;
+		for (size_t p = 0; p < parts.size(); p++) {
+			std::string child_name = (p == 0) ? parts[p] : dir_name + '/' + parts[p];
+			if (p + 1 < parts.size()) {
+				if (this->files.contains(child_name)) {
+					throw Error{ERR << "file used as directory in asset pack: " << name};
+				}
+				auto [it, inserted] = this->dirs.try_emplace(child_name);
+				if (inserted) {
+					this->dirs[dir_name].push_back(parts[p]);
+				}
+			}
+			else {
+				if (this->dirs.contains(child_name)
+				    or not this->files.emplace(child_name, file).second) {
+					throw Error{ERR << "duplicate file in asset pack: " << name};
+				}
+				this->dirs[dir_name].push_back(parts[p]);
+			}
+			dir_name = std::move(child_name);
+		}
+	}
+}
+
+
+const Pack::entry &Pack::find_file(const Path::parts_t &parts) const {
+	auto it = this->files.find(join_parts(parts));
+	if (it == this->files.end()) {
+		throw Error{ERR << "file not found in asset pack: " << join_parts(parts)};
+	}
+	return it->second;
+}
+
+
+bool Pack::is_file(const Path::parts_t &parts) {
+	return this->files.contains(join_parts(parts));
+}
+
+
+bool Pack::is_dir(const Path::parts_t &parts) {
+	return this->dirs.contains(join_parts(parts));
+}
+
+
+bool Pack::writable(const Path::parts_t &) {
+	return false;
+}
+
+
+std::vector<Path::part_t> Pack::list(const Path::parts_t &parts) {
+	auto it = this->dirs.find(join_parts(parts));
+	if (it == this->dirs.end()) {
+		throw Error{ERR << "could not list contents of '" << join_parts(parts)
+		                << "' in asset pack"};
+	}
+	return it->second;
+}
+
+
+bool Pack::mkdirs(const Path::parts_t &) {
+	return false;
+}
+
+
+File Pack::open_r(const Path::parts_t &parts) {
+	const entry &file = this->find_file(parts);
+	FileBuffer data = this->contents.slice(file.offset, file.stored_size);
+
+	if (not (file.flags & pack::flag_compressed)) {
+		return File{std::make_shared<filelike::View>(std::move(data), join_parts(parts))};
+	}
+
+	// read_directory limits the size, but uLongf may be 32 bits wide
+	if (file.size > std::numeric_limits<uLongf>::max()) {
+		throw Error{ERR << "file '" << join_parts(parts)
+		                << "' is too large to decompress in asset pack " << this->path};
+	}
+
+	std::string decompressed(file.size, '\0');
+	uLongf size = static_cast<uLongf>(file.size);
+	int result = uncompress(reinterpret_cast<Bytef *>(decompressed.data()),
+	                        &size,
+	                        reinterpret_cast<const Bytef *>(data.data()),
+	                        data.size());
+	if (result != Z_OK or size != file.size) {
+		throw Error{ERR << "could not decompress '" << join_parts(parts)
+		                << "' in asset pack " << this->path};
+	}
+
+	return File{std::make_shared<filelike::View>(FileBuffer{std::move(decompressed)},
+	                                             join_parts(parts))};
+}
+
+
+File Pack::open_w(const Path::parts_t &) {
+	throw Error{ERR << "asset packs are read-only"};
+}
+
+
+File Pack::open_rw(const Path::parts_t &) {
+	throw Error{ERR << "asset packs are read-only"};
+}
+
+
+File Pack::open_a(const Path::parts_t &) {
+	throw Error{ERR << "asset packs are read-only"};
+}
+
+
+File Pack::open_ar(const Path::parts_t &) {
+	throw Error{ERR << "asset packs are read-only"};
+}
+
+
+std::string Pack::get_native_path(const Path::parts_t &) {
+	return "";
+}
+
+
+bool Pack::rename(const Path::parts_t &,
+                  const Path::parts_t &) {
+	return false;
+}
+
+
+bool Pack::rmdir(const Path::parts_t &) {
+	return false;
+}
+
+
+bool Pack::touch(const Path::parts_t &) {
+	return false;
+}
+
+
+bool Pack::unlink(const Path::parts_t &) {
+	return false;
+}
+
+
+int Pack::get_mtime(const Path::parts_t &parts) {
+	if (not (this->is_file(parts) or this->is_dir(parts))) {
+		throw Error{ERR << "can't get mtime"};
+	}
+	return this->mtime;
+}
+
+
+uint64_t Pack::get_filesize(const Path::parts_t &parts) {
+	return this->find_file(parts).size;
+}
+
+
+std::ostream &Pack::repr(std::ostream &stream) {
+	stream << "Pack(" << this->path << ")";
+	return stream;
+}
+
+
+PackWriter::PackWriter(size_t alignment) :
+	alignment{alignment} {
+	if (alignment == 0 or (alignment & (alignment - 1)) != 0) {
+		throw Error{ERR << "asset pack alignment must be a power of two"};
+	}
+}
+
+
+void PackWriter::add(const Path::parts_t &name,
+                     const Path &source,
+                     bool compress) {
+	if (name.empty()) {
+		throw Error{ERR << "files in asset packs need a name"};
+	}
+	this->files.push_back(source_file{join_parts(name), source, compress});
+}
+
+
+void PackWriter::add_tree(const Path &source,
+                          const Path::parts_t &prefix,
+                          bool compress) {
+	std::vector<Path::part_t> names = Path{source}.list();
+
+	// sorted for reproducible packs
+	std::sort(names.begin(), names.end());
+
+	for (auto &name : names) {
+		if (name == "." or name == "..") {
+			continue;
+		}
+
+		Path child = source / name;
+		Path::parts_t child_name = prefix;
+		child_name.push_back(name);
+
+		if (child.is_dir()) {
+			this->add_tree(child, child_name, compress);
+		}
+		else if (child.is_file()) {
+			this->add(child_name, child, compress);
+		}
+	}
+}
+
+
+void PackWriter::write(const Path &target) const {
+	std::unordered_set<std::string> names;
+	for (auto &file : this->files) {
+		if (not names.insert(file.name).second) {
+			throw Error{ERR << "duplicate file in asset pack: " << file.name};
+		}
+	}
+
+	// a name can't be both a file and a directory
+	for (auto &file : this->files) {
+		size_t sep = file.name.find('/');
+		while (sep != std::string::npos) {
+			if (names.contains(file.name.substr(0, sep))) {
+				throw Error{ERR << "file used as directory in asset pack: " << file.name};
+			}
+			sep = file.name.find('/', sep + 1);
+		}
+	}
+
+	File out = target.open_w();
+
+	std::string header{pack::magic, sizeof(pack::magic)};
+	put_u32(header, pack::version);
+	put_u32(header, this->alignment);
+	put_u32(header, 0);
+	out.write(header);
+	uint64_t pos = header.size();
+
+	std::string directory;
+	for (auto &file : this->files) {
+		std::string data = file.source.open_r().read();
+		uint64_t size = data.size();
+		uint32_t flags = 0;
+
+		if (file.compress and not data.empty()) {
+			uLongf compressed_size = compressBound(data.size());
+			std::string compressed(compressed_size, '\0');
+			int result = compress2(reinterpret_cast<Bytef *>(compressed.data()),
+			                       &compressed_size,
+			                       reinterpret_cast<const Bytef *>(data.data()),
+			                       data.size(),
+			                       Z_BEST_COMPRESSION);
+			if (result != Z_OK) {
+				throw Error{ERR << "could not compress " << file.name};
+			}
+
+			// only keep the compressed data if it is smaller
+			if (compressed_size < data.size()) {
+				compressed.resize(compressed_size);
+				data = std::move(compressed);
+				flags |= pack::flag_compressed;
+			}
+		}
+
+		size_t padding = (this->alignment - pos % this->alignment) % this->alignment;
+		if (padding > 0) {
+			out.write(std::string(padding, '\0'));
+			pos += padding;
+		}
+
+		put_u64(directory, pos);
+		put_u64(directory, data.size());
+		put_u64(directory, size);
+		put_u32(directory, flags);
+		put_u32(directory, file.name.size());
+		directory += file.name;
+
+		out.write(data);
+		pos += data.size();
+	}
+
+	std::string footer;
+	put_u64(footer, pos);
+	put_u64(footer, this->files.size());
+	footer.append(pack::magic, sizeof(pack::magic));
+	put_u32(footer, 0);
+
+	out.write(directory);
+	out.write(footer);
+	out.close();
+}
+
+} // namespace openage::util::fslike
@@ -0,0 +1,223 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../file_buffer.h"
+#include "fslike.h"
+
+
+namespace openage {
+namespace util {
+namespace fslike {
+
+/**
+ * Layout of asset pack archives.
+ *
+ * All numbers are stored in little endian.
+ *
+ *   header     magic "OAPK", uint32 version, uint32 alignment, uint32 reserved
+ *   data       file contents, each aligned to the alignment of the pack
+ *   directory  per file: uint64 offset, uint64 stored size, uint64 size,
+ *              uint32 flags, uint32 name length, name (parts joined by '/')
+ *   footer     uint64 directory offset, uint64 file count,
+ *              magic "OAPK", uint32 reserved
+ */
+namespace pack {
+
+constexpr char magic[4] = {'O', 'A', 'P', 'K'};
+constexpr uint32_t version = 1;
+constexpr size_t header_size = 16;
+constexpr size_t footer_size = 24;
+constexpr size_t directory_entry_size = 32;
+
+/**
+ * File is stored with zlib compression.
+ */
+constexpr uint32_t flag_compressed = 1 << 0;
+
+/**
+ * Maximum ratio of uncompressed to compressed size that zlib can produce.
+ */
+constexpr uint64_t max_compression_ratio = 1032;
+
+/**
+ * Maximum uncompressed size of a compressed file (1 GiB).
+ * Compressed files are inflated into memory when they are opened.
+ */
+constexpr uint64_t max_uncompressed_size = uint64_t{1} << 30;
+
+} // namespace pack
+
+
+/**
+ * Read-only filesystem-like object for a single-file asset pack archive.
+ *
+ * The pack is memory-mapped when it is opened. Files of the pack are
+ * opened as views into the mapping, so opening them requires neither
+ * system calls nor copies. Compressed files are decompressed when
+ * they are opened.
+ *
+ * Packs are created with \p PackWriter.
+ */
+class Pack : public FSLike {
+public:
+	/**
+	 * Open an asset pack.
+	 *
+	 * @param path Native path of the pack file.
+	 */
+	Pack(const std::string &path);
+
+	bool is_file(const Path::parts_t &parts) override;
+	bool is_dir(const Path::parts_t &parts) override;
+	bool writable(const Path::parts_t &parts) override;
+	std::vector<Path::part_t> list(const Path::parts_t &parts) override;
+	bool mkdirs(const Path::parts_t &parts) override;
+	File open_r(const Path::parts_t &parts) override;
+	File open_w(const Path::parts_t &parts) override;
+	File open_rw(const Path::parts_t &parts) override;
+	File open_a(const Path::parts_t &parts) override;
+	File open_ar(const Path::parts_t &parts) override;
+	std::string get_native_path(const Path::parts_t &parts) override;
+	bool rename(const Path::parts_t &parts,
+	            const Path::parts_t &target_parts) override;
+	bool rmdir(const Path::parts_t &parts) override;
+	bool touch(const Path::parts_t &parts) override;
+	bool unlink(const Path::parts_t &parts) override;
+
+	int get_mtime(const Path::parts_t &parts) override;
+	uint64_t get_filesize(const Path::parts_t &parts) override;
+
+	std::ostream &repr(std::ostream &) override;
+
+private:
+	/**
+	 * File in the pack.
+	 */
+	struct entry {
+		/// Offset of the file data in the pack.
+		uint64_t offset;
+		/// Size of the file data in the pack.
+		uint64_t stored_size;
+		/// Size of the file contents.
+		uint64_t size;
+		/// Flags from \p pack.
+		uint32_t flags;
+	};
+
+	/**
+	 * Read the pack directory into the index.
+	 */
+	void read_directory();
+
+	/**
+	 * Find a file in the pack.
+	 * Throws if the file does not exist.
+	 *
+	 * @param parts Path of the file.
+	 *
+	 * @return File entry.
+	 */
+	const entry &find_file(const Path::parts_t &parts) const;
+
+	/**
+	 * Path of the pack file.
+	 */
+	std::string path;
+
+	/**
+	 * Modification time of the pack file.
+	 */
+	int mtime;
+
+	/**
+	 * Mapped pack file. Shared with the opened files of the pack.
+	 */
+	FileBuffer contents;
+
+	/**
+	 * Files in the pack, by their name.
+	 */
+	std::unordered_map<std::string, entry> files;
+
+	/**
+	 * Directories in the pack with their contents, by their name.
+	 */
+	std::unordered_map<std::string, std::vector<Path::part_t>> dirs;
+};
+
+
+/**
+ * Creates asset pack archives that can be opened with \p Pack.
+ */
+class PackWriter {
+public:
+	/**
+	 * Create a new writer.
+	 *
+	 * @param alignment Alignment of the file data in the pack in bytes.
+	 *                  Must be a power of two.
+	 */
+	PackWriter(size_t alignment = 16);
+
+	/**
+	 * Add a file to the pack.
+	 *
+	 * @param name Path of the file in the pack.
+	 * @param source File that is added.
+	 * @param compress Whether the file should be compressed. Files that
+	 *                 don't get smaller are stored uncompressed.
+	 */
+	void add(const Path::parts_t &name,
+	         const Path &source,
+	         bool compress = false);
+
+	/**
+	 * Add all files in a directory and its subdirectories to the pack.
+	 *
+	 * @param source Directory that is added.
+	 * @param prefix Path of the directory in the pack.
+	 * @param compress Whether the files should be compressed.
+	 */
+	void add_tree(const Path &source,
+	              const Path::parts_t &prefix = {},
+	              bool compress = false);
+
+	/**
+	 * Write the pack with all added files.
+	 *
+	 * @param target Pack file that is written.
+	 */
+	void write(const Path &target) const;
+
+private:
+	/**
+	 * File that is added to the pack.
+	 */
+	struct source_file {
+		/// Path of the file in the pack, joined by '/'.
+		std::string name;
+		/// File that is added.
+		Path source;
+		/// Whether the file should be compressed.
+		bool compress;
+	};
+
+	/**
+	 * Alignment of the file data in the pack.
+	 */
+	size_t alignment;
+
+	/**
+	 * Files that are added to the pack.
+	 */
+	std::vector<source_file> files;
+};
+
+}}} // openage::util::fslike
@@ -0,0 +1,221 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "pack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "log/log.h"
+#include "testing/temp_dir.h"
+#include "testing/testing.h"
+
+#include "../file.h"
+#include "../path.h"
+
+
+namespace openage::util::fslike::tests {
+
+namespace {
+
+/**
+ * Write a file with the given contents.
+ */
+void write_file(const Path &path, const std::string &data) {
+	File file = path.open_w();
+	file.write(data);
+	file.close();
+}
+
+
+/**
+ * Create file contents that zlib can't compress.
+ */
+std::string noise(size_t size) {
+	std::string ret(size, '\0');
+	uint32_t state = 0x12345678;
+	for (auto &c : ret) {
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		c = static_cast<char>(state & 0xff);
+	}
+	return ret;
+}
+
+
+/**
+ * Replace the last occurrence of a string in a pack, i.e. in its directory.
+ */
+void patch_pack(const Path &path, const std::string &from, const std::string &to) {
+	std::string data = path.open_r().read();
+	size_t pos = data.rfind(from);
+	(pos != std::string::npos) or TESTFAIL;
+	data.replace(pos, from.size(), to);
+	write_file(path, data);
+}
+
+} // namespace
+
+
+void pack_roundtrip() {
+	testing::TempDir tmpdir{"pack"};
+	auto tmp = tmpdir.get_path();
+	auto src = tmp / "src";
+	(src / "graphics" / "terrain").mkdirs();
+
+	const std::string text = "openage";
+	const std::string sprite(64 * 1024, 'x');
+	const std::string texture = noise(10000);
+
+	write_file(src / "a.txt", text);
+	write_file(src / "empty.txt", "");
+	write_file(src / "graphics" / "unit.sprite", sprite);
+	write_file(src / "graphics" / "terrain" / "grass.png", texture);
+
+	PackWriter writer{64};
+	writer.add_tree(src, {"data"}, true);
+	writer.write(tmp / "assets.pack");
+
+	// the sprite is compressed, the noise is stored as is
+	(tmp / "assets.pack").get_filesize() < text.size() + sprite.size() + texture.size() or TESTFAIL;
+
+	auto pack = std::make_shared<Pack>((tmp / "assets.pack").resolve_native_path());
+	Path root = pack->root();
+
+	(root / "data").is_dir() or TESTFAIL;
+	(root / "data" / "graphics" / "terrain").is_dir() or TESTFAIL;
+	(not (root / "data" / "graphics").is_file()) or TESTFAIL;
+	(not (root / "data" / "missing.txt").exists()) or TESTFAIL;
+
+	auto names = (root / "data" / "graphics").list();
+	std::sort(names.begin(), names.end());
+	(names == std::vector<Path::part_t>{"terrain", "unit.sprite"}) or TESTFAIL;
+
+	TESTEQUALS((root / "data" / "a.txt").open_r().read(), text);
+	TESTEQUALS((root / "data" / "empty.txt").open_r().read(), "");
+	TESTEQUALS((root / "data" / "graphics" / "unit.sprite").open_r().read(), sprite);
+	TESTEQUALS((root / "data" / "graphics" / "terrain" / "grass.png").open_r().read(), texture);
+	TESTEQUALS((root / "data" / "graphics" / "unit.sprite").get_filesize(), sprite.size());
+
+	// files are seekable views
+	File file = (root / "data" / "graphics" / "terrain" / "grass.png").open_r();
+	file.seek(-16, File::seek_t::END);
+	TESTEQUALS(file.read(), texture.substr(texture.size() - 16));
+	TESTEQUALS(file.read(), "");
+	file.seek(100);
+	TESTEQUALS(file.read(4), texture.substr(100, 4));
+
+	// the pack is read-only
+	(not (root / "data" / "a.txt").writable()) or TESTFAIL;
+	TESTTHROWS((root / "data" / "b.txt").open_w());
+
+	// other files are rejected
+	TESTTHROWS(Pack{(src / "a.txt").resolve_native_path()});
+}
+
+
+void pack_invalid() {
+	testing::TempDir tmpdir{"pack"};
+	auto tmp = tmpdir.get_path();
+	write_file(tmp / "a", "file");
+	write_file(tmp / "b", std::string(4096, 'x'));
+
+	// the writer refuses names that are used as file and directory
+	PackWriter conflict;
+	conflict.add({"a"}, tmp / "a");
+	conflict.add({"a", "b"}, tmp / "b");
+	TESTTHROWS(conflict.write(tmp / "conflict.pack"));
+
+	// ...and so does the reader
+	PackWriter writer;
+	writer.add({"a"}, tmp / "a");
+	writer.add({"c", "b"}, tmp / "b", true);
+	writer.write(tmp / "valid.pack");
+	Pack{(tmp / "valid.pack").resolve_native_path()};
+
+	write_file(tmp / "prefix.pack", (tmp / "valid.pack").open_r().read());
+	patch_pack(tmp / "prefix.pack", "c/b", "a/b");
+	TESTTHROWS(Pack{(tmp / "prefix.pack").resolve_native_path()});
+
+	// the directory must be large enough for the number of entries in the footer
+	std::string huge_count = (tmp / "valid.pack").open_r().read();
+	for (size_t i = 0; i < 8; i++) {
+		huge_count[huge_count.size() - pack::footer_size + 8 + i] = static_cast<char>(0x0f);
+	}
+	write_file(tmp / "count.pack", huge_count);
+	TESTTHROWS(Pack{(tmp / "count.pack").resolve_native_path()});
+
+	// compressed files can't be larger than zlib can inflate them
+	// or larger than the size limit
+	for (uint64_t size : {uint64_t{4096} * pack::max_compression_ratio, pack::max_uncompressed_size + 1}) {
+		std::string valid_size;
+		std::string invalid_size;
+		for (size_t i = 0; i < 8; i++) {
+			valid_size.push_back(static_cast<char>((uint64_t{4096} >> (8 * i)) & 0xff));
+			invalid_size.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+		}
+		write_file(tmp / "size.pack", (tmp / "valid.pack").open_r().read());
+		patch_pack(tmp / "size.pack", valid_size, invalid_size);
+		TESTTHROWS(Pack{(tmp / "size.pack").resolve_native_path()});
+	}
+}
+
+
+void pack_benchmark() {
+	testing::TempDir tmpdir{"pack"};
+
+	// synthetic asset tree with 100 directories of 100 files each
+	const size_t dirs = 100;
+	const size_t files_per_dir = 100;
+	const std::string contents = noise(16 * 1024);
+
+	auto tmp = tmpdir.get_path();
+	auto src = tmp / "src";
+
+	std::vector<Path::parts_t> files;
+	files.reserve(dirs * files_per_dir);
+	for (size_t d = 0; d < dirs; ++d) {
+		std::string dir_name = "dir_" + std::to_string(d);
+		(src / dir_name).mkdirs();
+		for (size_t f = 0; f < files_per_dir; ++f) {
+			Path::parts_t parts{dir_name, "file_" + std::to_string(f) + ".png"};
+			write_file(src[parts], contents);
+			files.push_back(std::move(parts));
+		}
+	}
+
+	PackWriter writer;
+	writer.add_tree(src);
+	writer.write(tmp / "assets.pack");
+
+	auto read_all = [&](const Path &root) {
+		size_t bytes = 0;
+		for (auto &parts : files) {
+			bytes += root[parts].open_r().read().size();
+		}
+		return bytes;
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	size_t dir_bytes = read_all(src);
+	auto dir_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	auto pack = std::make_shared<Pack>((tmp / "assets.pack").resolve_native_path());
+	size_t pack_bytes = read_all(pack->root());
+	auto pack_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	TESTEQUALS(dir_bytes, pack_bytes);
+
+	const double mib = dir_bytes / (1024.0 * 1024.0);
+	log::log(MSG(info) << files.size() << " files with " << mib << " MiB");
+	log::log(MSG(info) << "  Directory: " << dir_time.count() * 1e3 << " ms, "
+	                   << mib / dir_time.count() << " MiB/s");
+	log::log(MSG(info) << "  Pack:      " << pack_time.count() * 1e3 << " ms, "
+	                   << mib / pack_time.count() << " MiB/s (including opening the pack)");
+}
+
+} // namespace openage::util::fslike::tests
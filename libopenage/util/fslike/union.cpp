@@ -0,0 +1,603 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "union.h"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+#include "error/error.h"
+
+#include "../file.h"
+#include "../path.h"
+
+
+namespace openage::util::fslike {
+
+namespace {
+
+constexpr uint64_t fnv_offset = 0xcbf29ce484222325;
+constexpr uint64_t fnv_prime = 0x100000001b3;
+
+
+/**
+ * Continue an FNV-1a hash with the given bytes.
+ */
+inline uint64_t fnv1a(uint64_t hash, std::string_view data) {
+	for (unsigned char c : data) {
+		hash ^= c;
+		hash *= fnv_prime;
+	}
+	return hash;
+}
+
+
+/**
+ * Check if a path starts with the given prefix.
+ */
+bool has_prefix(const Path::parts_t &parts, const Path::parts_t &prefix) {
+	return prefix.size() <= parts.size()
+	       and std::equal(prefix.begin(), prefix.end(), parts.begin());
+}
+
+} // namespace
+
+
+size_t Union::key_hash::operator()(std::string_view key) const {
+	return fnv1a(fnv_offset, key);
+}
+
+
+size_t Union::key_hash::operator()(const Path::parts_t &parts) const {
+	// must produce the same hash as the joined key
+	uint64_t hash = fnv_offset;
+	for (size_t i = 0; i < parts.size(); i++) {
+		if (i > 0) {
+			hash = fnv1a(hash, "/");
+		}
+		hash = fnv1a(hash, parts[i]);
+	}
+	return hash;
+}
+
+
+bool Union::key_equal::operator()(std::string_view a, std::string_view b) const {
+	return a == b;
+}
+
+
+bool Union::key_equal::operator()(std::string_view key, const Path::parts_t &parts) const {
+	size_t pos = 0;
+	for (size_t i = 0; i < parts.size(); i++) {
+		if (i > 0) {
+			if (pos >= key.size() or key[pos] != '/') {
+				return false;
+			}
+			pos += 1;
+		}
+		if (key.compare(pos, parts[i].size(), parts[i]) != 0) {
+			return false;
+		}
+		pos += parts[i].size();
+	}
+	return pos == key.size();
+}
+
+
+bool Union::key_equal::operator()(const Path::parts_t &parts, std::string_view key) const {
+	return (*this)(key, parts);
+}
+
+
+Union::Union() {
+	this->index.emplace("", entry{true, nullptr, {}});
+}
+
+
+void Union::mount(const Path &source,
+                  const Path::parts_t &mountpoint,
+                  int priority) {
+	std::unique_lock lock{this->mutex};
+
+	this->mounts.push_back(std::make_unique<mount_point>(
+		mount_point{mountpoint, source, priority, this->mounts.size()}));
+
+	this->scan(*this->mounts.back(), mountpoint);
+}
+
+
+void Union::rescan() {
+	std::unique_lock lock{this->mutex};
+
+	this->index.clear();
+	this->index.emplace("", entry{true, nullptr, {}});
+
+	for (auto &mount : this->mounts) {
+		this->scan(*mount, mount->mountpoint);
+	}
+}
+
+
+size_t Union::get_entry_count() const {
+	std::shared_lock lock{this->mutex};
+	return this->index.size();
+}
+
+
+bool Union::is_file(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	return found != nullptr and not found->is_dir;
+}
+
+
+bool Union::is_dir(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	return found != nullptr and found->is_dir;
+}
+
+
+bool Union::writable(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	for (auto mount : this->candidates(parts)) {
+		if (mount->source.get_fsobj()->writable(source_parts(*mount, parts))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+std::vector<Path::part_t> Union::list(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	if (found == nullptr or not found->is_dir) {
+		throw Error{ERR << "could not list contents of '"
+		                << make_key(parts) << "' in union"};
+	}
+
+	return found->children;
+}
+
+
+bool Union::mkdirs(const Path::parts_t &parts) {
+	std::unique_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_writable(parts);
+	bool result = mount->source.get_fsobj()->mkdirs(src);
+
+	this->reindex(parts);
+	return result;
+}
+
+
+File Union::open_r(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_provider(parts);
+	return mount->source.get_fsobj()->open_r(src);
+}
+
+
+File Union::open_w(const Path::parts_t &parts) {
+	std::unique_lock lock{this->mutex};
+
+	// new contents always go to the preferred writable mount
+	auto [mount, src] = this->find_writable(parts);
+	File file = mount->source.get_fsobj()->open_w(src);
+
+	this->reindex(parts);
+	return file;
+}
+
+
+File Union::open_rw(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_provider(parts);
+	return mount->source.get_fsobj()->open_rw(src);
+}
+
+
+File Union::open_a(const Path::parts_t &parts) {
+	std::unique_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	auto [mount, src] = (found != nullptr and found->provider != nullptr)
+	                        ? this->find_provider(parts)
+	                        : this->find_writable(parts);
+	File file = mount->source.get_fsobj()->open_a(src);
+
+	this->reindex(parts);
+	return file;
+}
+
+
+File Union::open_ar(const Path::parts_t &parts) {
+	std::unique_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	auto [mount, src] = (found != nullptr and found->provider != nullptr)
+	                        ? this->find_provider(parts)
+	                        : this->find_writable(parts);
+	File file = mount->source.get_fsobj()->open_ar(src);
+
+	this->reindex(parts);
+	return file;
+}
+
+
+std::pair<bool, Path> Union::resolve_r(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	if (found == nullptr) {
+		return std::make_pair(false, Path{});
+	}
+
+	if (found->provider == nullptr) {
+		// virtual directories only exist in the union
+		return std::make_pair(true, Path{this->shared_from_this(), parts});
+	}
+
+	const mount_point &mount = *found->provider;
+	return mount.source.get_fsobj()->resolve_r(source_parts(mount, parts));
+}
+
+
+std::pair<bool, Path> Union::resolve_w(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	for (auto mount : this->candidates(parts)) {
+		auto result = mount->source.get_fsobj()->resolve_w(source_parts(*mount, parts));
+		if (result.first) {
+			return result;
+		}
+	}
+
+	return std::make_pair(false, Path{});
+}
+
+
+std::string Union::get_native_path(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	if (found == nullptr or found->provider == nullptr) {
+		return "";
+	}
+
+	const mount_point &mount = *found->provider;
+	return mount.source.get_fsobj()->get_native_path(source_parts(mount, parts));
+}
+
+
+bool Union::rename(const Path::parts_t &parts,
+                   const Path::parts_t &target_parts) {
+	std::unique_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_provider(parts);
+
+	// files can't be moved between mounts
+	if (not has_prefix(target_parts, mount->mountpoint)) {
+		return false;
+	}
+
+	bool result = mount->source.get_fsobj()->rename(src, source_parts(*mount, target_parts));
+
+	this->reindex(parts);
+	this->reindex(target_parts);
+	return result;
+}
+
+
+bool Union::rmdir(const Path::parts_t &parts) {
+	std::unique_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_provider(parts);
+	bool result = mount->source.get_fsobj()->rmdir(src);
+
+	this->reindex(parts);
+	return result;
+}
+
+
+bool Union::touch(const Path::parts_t &parts) {
+	std::unique_lock lock{this->mutex};
+
+	const entry *found = this->find(parts);
+	auto [mount, src] = (found != nullptr and found->provider != nullptr)
+	                        ? this->find_provider(parts)
+	                        : this->find_writable(parts);
+	bool result = mount->source.get_fsobj()->touch(src);
+
+	this->reindex(parts);
+	return result;
+}
+
+
+bool Union::unlink(const Path::parts_t &parts) {
+	std::unique_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_provider(parts);
+	bool result = mount->source.get_fsobj()->unlink(src);
+
+	// files of other mounts may become visible again
+	this->reindex(parts);
+	return result;
+}
+
+
+int Union::get_mtime(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_provider(parts);
+	return mount->source.get_fsobj()->get_mtime(src);
+}
+
+
+uint64_t Union::get_filesize(const Path::parts_t &parts) {
+	std::shared_lock lock{this->mutex};
+
+	auto [mount, src] = this->find_provider(parts);
+	return mount->source.get_fsobj()->get_filesize(src);
+}
+
+
+std::ostream &Union::repr(std::ostream &stream) {
+	std::shared_lock lock{this->mutex};
+
+	stream << "Union(";
+	for (size_t i = 0; i < this->mounts.size(); i++) {
+		if (i > 0) {
+			stream << ", ";
+		}
+		const mount_point &mount = *this->mounts[i];
+		stream << "/" << make_key(mount.mountpoint) << ": " << mount.source;
+	}
+	stream << ")";
+	return stream;
+}
+
+
+bool Union::prefers(const mount_point *mount, const mount_point *other) {
+	if (other == nullptr) {
+		return true;
+	}
+	if (mount->priority != other->priority) {
+		return mount->priority > other->priority;
+	}
+	return mount->order >= other->order;
+}
+
+
+std::vector<const Union::mount_point *> Union::candidates(const Path::parts_t &parts) const {
+	std::vector<const mount_point *> ret;
+	for (auto &mount : this->mounts) {
+		if (has_prefix(parts, mount->mountpoint)) {
+			ret.push_back(mount.get());
+		}
+	}
+
+	std::stable_sort(ret.begin(), ret.end(), [](const mount_point *a, const mount_point *b) {
+		return a != b and prefers(a, b);
+	});
+
+	return ret;
+}
+
+
+Path::parts_t Union::source_parts(const mount_point &mount,
+                                  const Path::parts_t &parts) {
+	const Path::parts_t &base = mount.source.get_parts();
+
+	Path::parts_t ret;
+	ret.reserve(base.size() + parts.size() - mount.mountpoint.size());
+	ret.insert(ret.end(), base.begin(), base.end());
+	ret.insert(ret.end(), parts.begin() + mount.mountpoint.size(), parts.end());
+	return ret;
+}
+
+
+const Union::entry *Union::find(const Path::parts_t &parts) const {
+	auto it = this->index.find(parts);
+	if (it == this->index.end()) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+
+std::pair<const Union::mount_point *, Path::parts_t> Union::find_provider(const Path::parts_t &parts) const {
+	const entry *found = this->find(parts);
+	if (found == nullptr) {
+		throw Error{ERR << "'" << make_key(parts) << "' not found in union"};
+	}
+	if (found->provider == nullptr) {
+		throw Error{ERR << "'" << make_key(parts) << "' is a mountpoint directory "
+		                << "that only exists in the union"};
+	}
+
+	return std::make_pair(found->provider, source_parts(*found->provider, parts));
+}
+
+
+std::pair<const Union::mount_point *, Path::parts_t> Union::find_writable(const Path::parts_t &parts) const {
+	for (auto mount : this->candidates(parts)) {
+		Path::parts_t src = source_parts(*mount, parts);
+		if (mount->source.get_fsobj()->writable(src)) {
+			return std::make_pair(mount, std::move(src));
+		}
+	}
+
+	throw Error{ERR << "no writable mount for '" << make_key(parts) << "' in union"};
+}
+
+
+bool Union::add_entry(const Path::parts_t &parts,
+                      bool is_dir,
+                      const mount_point *provider) {
+	auto it = this->index.find(parts);
+	if (it != this->index.end()) {
+		entry &existing = it->second;
+		if (not prefers(provider, existing.provider)) {
+			// directories of both mounts are merged,
+			// everything else is hidden by the preferred mount
+			return existing.is_dir and is_dir;
+		}
+
+		if (existing.is_dir and not is_dir) {
+			// the file hides the directory contents of other mounts
+			auto children = std::move(existing.children);
+			existing.children.clear();
+
+			Path::parts_t child_parts = parts;
+			for (auto &child : children) {
+				child_parts.push_back(child);
+				this->remove_entry(child_parts);
+				child_parts.pop_back();
+			}
+		}
+
+		existing.is_dir = is_dir;
+		existing.provider = provider;
+		return true;
+	}
+
+	// the root is always in the index, so there is a parent
+	Path::parts_t parent_parts{parts.begin(), parts.end() - 1};
+	auto parent = this->index.find(parent_parts);
+	if (parent == this->index.end()) {
+		// parents inside the mount are real directories of the mount
+		const mount_point *parent_provider = nullptr;
+		if (provider != nullptr and parent_parts.size() >= provider->mountpoint.size()) {
+			parent_provider = provider;
+		}
+
+		if (not this->add_entry(parent_parts, true, parent_provider)) {
+			return false;
+		}
+		parent = this->index.find(parent_parts);
+	}
+	else if (not parent->second.is_dir) {
+		return false;
+	}
+
+	parent->second.children.push_back(parts.back());
+	this->index.emplace(make_key(parts), entry{is_dir, provider, {}});
+	return true;
+}
+
+
+void Union::scan(const mount_point &mount,
+                 const Path::parts_t &parts) {
+	FSLike *fs = mount.source.get_fsobj();
+	Path::parts_t src = source_parts(mount, parts);
+
+	if (fs->is_file(src)) {
+		this->add_entry(parts, false, &mount);
+	}
+	else if (fs->is_dir(src)) {
+		if (this->add_entry(parts, true, &mount)) {
+			Path::parts_t dir_parts = parts;
+			this->scan_dir(mount, dir_parts, src);
+		}
+	}
+}
+
+
+void Union::scan_dir(const mount_point &mount,
+                     Path::parts_t &parts,
+                     Path::parts_t &src) {
+	FSLike *fs = mount.source.get_fsobj();
+
+	for (auto &name : fs->list(src)) {
+		if (name == "." or name == "..") {
+			continue;
+		}
+
+		parts.push_back(name);
+		src.push_back(name);
+
+		if (fs->is_file(src)) {
+			this->add_entry(parts, false, &mount);
+		}
+		else if (fs->is_dir(src)) {
+			if (this->add_entry(parts, true, &mount)) {
+				this->scan_dir(mount, parts, src);
+			}
+		}
+
+		parts.pop_back();
+		src.pop_back();
+	}
+}
+
+
+std::string Union::make_key(const Path::parts_t &parts) {
+	std::string key;
+	for (size_t i = 0; i < parts.size(); i++) {
+		if (i > 0) {
+			key += '/';
+		}
+		key += parts[i];
+	}
+	return key;
+}
+
+
+void Union::remove_entry(const Path::parts_t &parts) {
+	auto it = this->index.find(parts);
+	if (it == this->index.end()) {
+		return;
+	}
+
+	// remove the subtree below the entry
+	auto children = std::move(it->second.children);
+	it->second.children.clear();
+
+	Path::parts_t child_parts = parts;
+	for (auto &child : children) {
+		child_parts.push_back(child);
+		this->remove_entry(child_parts);
+		child_parts.pop_back();
+	}
+
+	if (parts.empty()) {
+		// the root stays in the index
+		return;
+	}
+	this->index.erase(it);
+
+	Path::parts_t parent_parts{parts.begin(), parts.end() - 1};
+	auto parent = this->index.find(parent_parts);
+	if (parent != this->index.end()) {
+		auto &siblings = parent->second.children;
+		auto name = std::find(siblings.begin(), siblings.end(), parts.back());
+		if (name != siblings.end()) {
+			siblings.erase(name);
+		}
+	}
+}
+
+
+void Union::reindex(const Path::parts_t &parts) {
+	this->remove_entry(parts);
+
+	for (auto &mount : this->mounts) {
+		if (has_prefix(parts, mount->mountpoint)) {
+			this->scan(*mount, parts);
+		}
+		else if (has_prefix(mount->mountpoint, parts)) {
+			// mounts below the path are still there
+			this->scan(*mount, mount->mountpoint);
+		}
+	}
+}
+
+} // namespace openage::util::fslike
@@ -0,0 +1,270 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "fslike.h"
+
+
+namespace openage {
+namespace util {
+namespace fslike {
+
+
+/**
+ * Filesystem-like object that overlays several paths,
+ * e.g. the base assets, mods and user overrides.
+ *
+ * Every mounted path is scanned once when it is mounted. The result is
+ * stored in one hashed index of all files and directories of the union,
+ * so \p is_file(), \p is_dir() and \p list() do not touch the mounted
+ * filesystems. Changes made through the union keep the index up to date.
+ * Changes made to the mounted filesystems directly require a \p rescan().
+ *
+ * If several mounts provide the same path, mounts with a higher priority
+ * are preferred. For equal priorities, later mounts are preferred.
+ * This is the same behaviour as the Python union (util.fslike.union).
+ */
+class Union : public FSLike {
+public:
+	Union();
+
+	/**
+	 * Mount a path into the union and add its contents to the index.
+	 *
+	 * @param source Mounted path. Can be a directory or a single file.
+	 * @param mountpoint Location of the mount in the union.
+	 * @param priority Priority of the mount. Higher priorities are preferred.
+	 */
+	void mount(const Path &source,
+	           const Path::parts_t &mountpoint = {},
+	           int priority = 0);
+
+	/**
+	 * Rebuild the index by scanning all mounts again.
+	 */
+	void rescan();
+
+	/**
+	 * Get the number of files and directories in the index.
+	 *
+	 * @return Number of index entries.
+	 */
+	size_t get_entry_count() const;
+
+	bool is_file(const Path::parts_t &parts) override;
+	bool is_dir(const Path::parts_t &parts) override;
+	bool writable(const Path::parts_t &parts) override;
+	std::vector<Path::part_t> list(const Path::parts_t &parts) override;
+	bool mkdirs(const Path::parts_t &parts) override;
+	File open_r(const Path::parts_t &parts) override;
+	File open_w(const Path::parts_t &parts) override;
+	File open_rw(const Path::parts_t &parts) override;
+	File open_a(const Path::parts_t &parts) override;
+	File open_ar(const Path::parts_t &parts) override;
+	std::pair<bool, Path> resolve_r(const Path::parts_t &parts) override;
+	std::pair<bool, Path> resolve_w(const Path::parts_t &parts) override;
+	std::string get_native_path(const Path::parts_t &parts) override;
+	bool rename(const Path::parts_t &parts,
+	            const Path::parts_t &target_parts) override;
+	bool rmdir(const Path::parts_t &parts) override;
+	bool touch(const Path::parts_t &parts) override;
+	bool unlink(const Path::parts_t &parts) override;
+
+	int get_mtime(const Path::parts_t &parts) override;
+	uint64_t get_filesize(const Path::parts_t &parts) override;
+
+	std::ostream &repr(std::ostream &) override;
+
+private:
+	/**
+	 * A path that is mounted into the union.
+	 */
+	struct mount_point {
+		/// Location of the mount in the union.
+		Path::parts_t mountpoint;
+		/// Mounted path.
+		Path source;
+		/// Priority of the mount.
+		int priority;
+		/// Position in the mount order.
+		size_t order;
+	};
+
+	/**
+	 * File or directory in the index.
+	 */
+	struct entry {
+		/// true for directories, false for files.
+		bool is_dir;
+		/// Preferred mount that provides the entry. nullptr for the
+		/// virtual parent directories of mountpoints.
+		const mount_point *provider;
+		/// Names of the directory contents.
+		std::vector<Path::part_t> children;
+	};
+
+	/**
+	 * Hash for index keys. Keys are the path parts joined by '/'.
+	 * Path parts can be looked up without joining them.
+	 */
+	struct key_hash {
+		using is_transparent = void;
+		size_t operator()(std::string_view key) const;
+		size_t operator()(const Path::parts_t &parts) const;
+	};
+
+	/**
+	 * Comparison of index keys with keys or path parts.
+	 */
+	struct key_equal {
+		using is_transparent = void;
+		bool operator()(std::string_view a, std::string_view b) const;
+		bool operator()(std::string_view key, const Path::parts_t &parts) const;
+		bool operator()(const Path::parts_t &parts, std::string_view key) const;
+	};
+
+	using index_t = std::unordered_map<std::string, entry, key_hash, key_equal>;
+
+	/**
+	 * Check if a mount is preferred over another one.
+	 *
+	 * @param mount Mount that is compared.
+	 * @param other Mount that is compared against. May be nullptr.
+	 *
+	 * @return true if \p mount is preferred over \p other.
+	 */
+	static bool prefers(const mount_point *mount, const mount_point *other);
+
+	/**
+	 * Get the mounts whose mountpoint contains the given path.
+	 *
+	 * @param parts Path in the union.
+	 *
+	 * @return Mounts, most preferred first.
+	 */
+	std::vector<const mount_point *> candidates(const Path::parts_t &parts) const;
+
+	/**
+	 * Translate a path in the union to the path in a mount's source.
+	 *
+	 * @param mount Mount that contains the path.
+	 * @param parts Path in the union.
+	 *
+	 * @return Path parts for the source's filesystem-like object.
+	 */
+	static Path::parts_t source_parts(const mount_point &mount,
+	                                  const Path::parts_t &parts);
+
+	/**
+	 * Find the index entry of a path.
+	 *
+	 * @param parts Path in the union.
+	 *
+	 * @return Index entry or nullptr if the path does not exist.
+	 */
+	const entry *find(const Path::parts_t &parts) const;
+
+	/**
+	 * Find the file or directory that provides a path.
+	 * Throws if the path does not exist or is virtual.
+	 *
+	 * @param parts Path in the union.
+	 *
+	 * @return Providing mount and the path in its source.
+	 */
+	std::pair<const mount_point *, Path::parts_t> find_provider(const Path::parts_t &parts) const;
+
+	/**
+	 * Find the most preferred mount that can write a path.
+	 * Throws if none of the mounts is writable.
+	 *
+	 * @param parts Path in the union.
+	 *
+	 * @return Writable mount and the path in its source.
+	 */
+	std::pair<const mount_point *, Path::parts_t> find_writable(const Path::parts_t &parts) const;
+
+	/**
+	 * Add a path to the index. Missing parent directories are added
+	 * as virtual directories.
+	 *
+	 * @param parts Path in the union.
+	 * @param is_dir Whether the path is a directory.
+	 * @param provider Mount that provides the path.
+	 *
+	 * @return true if the path is in the index afterwards, false if
+	 *         it is hidden by a file of a preferred mount.
+	 */
+	bool add_entry(const Path::parts_t &parts,
+	               bool is_dir,
+	               const mount_point *provider);
+
+	/**
+	 * Add a path of a mount and everything below it to the index.
+	 *
+	 * @param mount Mount that provides the path.
+	 * @param parts Path in the union.
+	 */
+	void scan(const mount_point &mount,
+	          const Path::parts_t &parts);
+
+	/**
+	 * Add the contents of a directory of a mount to the index.
+	 *
+	 * @param mount Mount that provides the directory.
+	 * @param parts Path of the directory in the union. Used as scratch space.
+	 * @param src Path of the directory in the mount's source. Used as scratch space.
+	 */
+	void scan_dir(const mount_point &mount,
+	              Path::parts_t &parts,
+	              Path::parts_t &src);
+
+	/**
+	 * Get the index key of a path.
+	 *
+	 * @param parts Path in the union.
+	 *
+	 * @return Path parts joined by '/'.
+	 */
+	static std::string make_key(const Path::parts_t &parts);
+
+	/**
+	 * Remove a path and everything below it from the index.
+	 *
+	 * @param parts Path in the union.
+	 */
+	void remove_entry(const Path::parts_t &parts);
+
+	/**
+	 * Update the index for a path after it was changed.
+	 *
+	 * @param parts Path in the union.
+	 */
+	void reindex(const Path::parts_t &parts);
+
+	/**
+	 * Mounted paths in the order they were mounted.
+	 */
+	std::vector<std::unique_ptr<mount_point>> mounts;
+
+	/**
+	 * All files and directories of the union.
+	 */
+	index_t index;
+
+	/**
+	 * Mutex for protecting threaded access.
+	 */
+	mutable std::shared_mutex mutex;
+};
+
+}}} // openage::util::fslike
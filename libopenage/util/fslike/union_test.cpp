@@ -0,0 +1,159 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "union.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "log/log.h"
+#include "testing/temp_dir.h"
+#include "testing/testing.h"
+
+#include "../file.h"
+#include "../path.h"
+#include "directory.h"
+
+
+namespace openage::util::fslike::tests {
+
+namespace {
+
+/**
+ * Write a file with the given contents.
+ */
+void write_file(const Path &path, const std::string &data) {
+	File file = path.open_w();
+	file.write(data);
+	file.close();
+}
+
+
+/**
+ * Get the sorted directory contents.
+ */
+std::vector<Path::part_t> sorted_list(Path path) {
+	auto ret = path.list();
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+} // namespace
+
+
+void union_fslike() {
+	testing::TempDir tmpdir{"union"};
+	auto tmp = tmpdir.get_path();
+	auto base = tmp / "base";
+	auto mod = tmp / "mod";
+
+	(base / "sub").mkdirs();
+	(mod / "sub").mkdirs();
+	write_file(base / "a.txt", "base");
+	write_file(base / "sub" / "b.txt", "b");
+	write_file(base / "sub" / "c.txt", "c");
+	write_file(mod / "a.txt", "mod");
+	write_file(mod / "sub" / "d.txt", "d");
+
+	auto fs = std::make_shared<Union>();
+	fs->mount(base, {}, 0);
+	fs->mount(mod, {}, 1);
+	fs->mount(base / "sub", {"mnt", "deep"}, 0);
+	Path root = fs->root();
+
+	// the mod overrides the file of the base
+	(root / "a.txt").is_file() or TESTFAIL;
+	TESTEQUALS((root / "a.txt").open_r().read(), "mod");
+
+	// directory contents of all mounts are merged
+	(sorted_list(root / "sub") == std::vector<Path::part_t>{"b.txt", "c.txt", "d.txt"}) or TESTFAIL;
+	(sorted_list(root) == std::vector<Path::part_t>{"a.txt", "mnt", "sub"}) or TESTFAIL;
+
+	// parents of mountpoints only exist in the union
+	(root / "mnt").is_dir() or TESTFAIL;
+	TESTEQUALS((root / "mnt").resolve_native_path(), "");
+	TESTEQUALS((root / "mnt" / "deep" / "b.txt").open_r().read(), "b");
+	(not (root / "missing.txt").exists()) or TESTFAIL;
+
+	// base(a.txt, sub, sub/b.txt, sub/c.txt), mod(sub/d.txt),
+	// mnt(deep, deep/b.txt, deep/c.txt), mnt and the root
+	TESTEQUALS(fs->get_entry_count(), 10);
+
+	// new files are written to the preferred mount
+	write_file(root / "sub" / "e.txt", "e");
+	(mod / "sub" / "e.txt").is_file() or TESTFAIL;
+	(root / "sub" / "e.txt").is_file() or TESTFAIL;
+	TESTEQUALS(fs->get_entry_count(), 11);
+
+	// removing the override makes the base file visible again
+	(root / "a.txt").unlink() or TESTFAIL;
+	(root / "a.txt").is_file() or TESTFAIL;
+	TESTEQUALS((root / "a.txt").open_r().read(), "base");
+
+	// changes outside of the union require a rescan
+	write_file(base / "f.txt", "f");
+	(not (root / "f.txt").is_file()) or TESTFAIL;
+	fs->rescan();
+	(root / "f.txt").is_file() or TESTFAIL;
+}
+
+
+void union_benchmark() {
+	testing::TempDir tmpdir{"union"};
+
+	// synthetic asset tree with 100 directories of 1000 files each
+	const size_t dirs = 100;
+	const size_t files_per_dir = 1000;
+
+	auto dir_fs = std::make_shared<Directory>(tmpdir.get_native_path());
+	Path dir_root = dir_fs->root();
+
+	std::vector<Path::parts_t> files;
+	files.reserve(dirs * files_per_dir);
+	for (size_t d = 0; d < dirs; ++d) {
+		std::string dir_name = "dir_" + std::to_string(d);
+		(dir_root / dir_name).mkdirs();
+		for (size_t f = 0; f < files_per_dir; ++f) {
+			Path::parts_t parts{dir_name, "file_" + std::to_string(f) + ".png"};
+			(dir_root / parts[0] / parts[1]).touch();
+			files.push_back(std::move(parts));
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	auto union_fs = std::make_shared<Union>();
+	union_fs->mount(dir_root);
+	auto mount_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	TESTEQUALS(union_fs->get_entry_count(), 1 + dirs + dirs * files_per_dir);
+
+	auto lookup = [&](FSLike &fs) {
+		size_t found = 0;
+		for (auto &parts : files) {
+			found += fs.is_file(parts);
+		}
+		for (size_t d = 0; d < dirs; ++d) {
+			found += fs.list({"dir_" + std::to_string(d)}).size();
+		}
+		return found;
+	};
+
+	start = std::chrono::steady_clock::now();
+	size_t dir_found = lookup(*dir_fs);
+	auto dir_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	size_t union_found = lookup(*union_fs);
+	auto union_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	// Directory::list() also contains "." and ".."
+	TESTEQUALS(dir_found, union_found + 2 * dirs);
+
+	log::log(MSG(info) << files.size() << " files in " << dirs << " directories");
+	log::log(MSG(info) << "  mount:  " << mount_time.count() * 1e3 << " ms to index the union");
+	log::log(MSG(info) << "  lookup: " << dir_time.count() * 1e3 << " ms with Directory, "
+	                   << union_time.count() * 1e3 << " ms with Union");
+}
+
+} // namespace openage::util::fslike::tests
@@ -292,13 +292,14 @@ std::string Path::get_stem() const {
 
 
 Path Path::joinpath(const parts_t &subpaths) const {
-	parts_t new_parts = this->parts;
-	for (auto &part : subpaths) {
-		if (part.size() > 0) [[likely]] {
-			new_parts.push_back(part);
-		}
-	}
-	return Path{this->fsobj, new_parts};
+	// the own parts are normalized already, so only the
+	// new parts have to be normalized, without another copy
+	Path ret;
+	ret.fsobj = this->fsobj;
+	ret.parts.reserve(this->parts.size() + subpaths.size());
+	ret.parts.insert(ret.parts.end(), this->parts.begin(), this->parts.end());
+	path_normalizer(ret.parts, subpaths);
+	return ret;
 }
 
 Path Path::joinpath(const part_t &subpath) const {
@@ -6,6 +6,7 @@
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -140,6 +141,25 @@ std::vector<std::string> split(const std::string &txt, char delimiter) {
 }
 
 
+std::vector<std::string_view> split_view(std::string_view txt, char delimiter) {
+	std::vector<std::string_view> items;
+
+	size_t start = 0;
+	while (start < txt.size()) {
+		size_t end = txt.find(delimiter, start);
+		if (end == std::string_view::npos) {
+			end = txt.size();
+		}
+
+		// like std::getline, a trailing delimiter doesn't start a new part
+		items.push_back(txt.substr(start, end - start));
+		start = end + 1;
+	}
+
+	return items;
+}
+
+
 std::vector<std::string> split_escape(const std::string &txt, char delim, size_t size_hint) {
 
 	// output vector
@@ -210,4 +230,45 @@ std::vector<std::string> split_escape(const std::string &txt, char delim, size_t
 	return items;
 }
 
+
+void json_string(std::ostream &out, std::string_view str) {
+	static constexpr char hex[] = "0123456789abcdef";
+
+	out << '"';
+	for (char c : str) {
+		switch (c) {
+		case '"':
+			out << "\\\"";
+			break;
+		case '\\':
+			out << "\\\\";
+			break;
+		case '\b':
+			out << "\\b";
+			break;
+		case '\f':
+			out << "\\f";
+			break;
+		case '\n':
+			out << "\\n";
+			break;
+		case '\r':
+			out << "\\r";
+			break;
+		case '\t':
+			out << "\\t";
+			break;
+		default:
+			// all other control characters need an escape sequence, too
+			if (static_cast<unsigned char>(c) < 0x20) {
+				out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+			}
+			else {
+				out << c;
+			}
+		}
+	}
+	out << '"';
+}
+
 } // openage::util
@@ -8,6 +8,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #if defined(__GNUC__)
@@ -104,6 +105,14 @@ void split(const std::string &txt, char delimiter, ret_t result) {
 std::vector<std::string> split(const std::string &txt, char delim);
 
 
+/**
+ * Split a string at a delimiter into views of the string.
+ * Behaves like the above splitter, but doesn't copy the parts.
+ * The views are only valid as long as the string data is.
+ */
+std::vector<std::string_view> split_view(std::string_view txt, char delim);
+
+
 /**
  * Split a string at a delimiter into a vector.
  * size_hint is to give a predicted size of the vector already.
@@ -115,4 +124,11 @@ std::vector<std::string> split(const std::string &txt, char delim);
 std::vector<std::string> split_escape(const std::string &txt,
                                       char delim, size_t size_hint=0);
 
+
+/**
+ * Write a string as JSON string literal.
+ * Quotes, backslashes and all control characters are escaped.
+ */
+void json_string(std::ostream &out, std::string_view str);
+
 }} // openage::util
@@ -0,0 +1,95 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "symbol.h"
+
+#include <mutex>
+#include <ostream>
+
+#include "error/error.h"
+#include "log/message.h"
+
+
+namespace openage::util {
+
+SymbolTable &SymbolTable::get() {
+	// never destroyed, so symbols stay valid in destructors of other static objects
+	static SymbolTable *table = new SymbolTable{};
+	return *table;
+}
+
+
+SymbolTable::SymbolTable() :
+	chunks{},
+	ids{},
+	count{0},
+	chars{0} {
+	// the empty string always gets ID 0
+	this->intern("");
+}
+
+
+symbol_id_t SymbolTable::intern(std::string_view str) {
+	{
+		std::shared_lock lock{this->mutex};
+
+		auto it = this->ids.find(str);
+		if (it != this->ids.end()) {
+			return it->second;
+		}
+	}
+
+	std::unique_lock lock{this->mutex};
+
+	// another thread may have interned the string in the meantime
+	auto it = this->ids.find(str);
+	if (it != this->ids.end()) {
+		return it->second;
+	}
+
+	auto id = this->count;
+	auto chunk_idx = id / chunk_size;
+	if (chunk_idx >= max_chunks) [[unlikely]] {
+		throw Error{MSG(err) << "Symbol table is full (" << id << " symbols)"};
+	}
+
+	auto chunk = this->chunks[chunk_idx].load(std::memory_order_relaxed);
+	if (chunk == nullptr) {
+		chunk = new std::string[chunk_size];
+		this->chunks[chunk_idx].store(chunk, std::memory_order_release);
+	}
+
+	auto &stored = chunk[id % chunk_size];
+	stored = str;
+	this->ids.emplace(stored, id);
+	this->count += 1;
+	this->chars += str.size();
+
+	return id;
+}
+
+
+size_t SymbolTable::size() const {
+	std::shared_lock lock{this->mutex};
+
+	return this->count;
+}
+
+
+size_t SymbolTable::get_memory_usage() const {
+	std::shared_lock lock{this->mutex};
+
+	size_t used_chunks = (this->count + chunk_size - 1) / chunk_size;
+	return sizeof(SymbolTable)
+	       + used_chunks * chunk_size * sizeof(std::string)
+	       + this->chars
+	       + this->ids.bucket_count() * sizeof(void *)
+	       + this->ids.size() * (sizeof(std::string_view) + sizeof(symbol_id_t) + sizeof(void *));
+}
+
+
+std::ostream &operator<<(std::ostream &out, const Symbol &symbol) {
+	out << symbol.str();
+	return out;
+}
+
+} // namespace openage::util
@@ -0,0 +1,212 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace openage::util {
+
+/**
+ * ID of an interned string.
+ */
+using symbol_id_t = uint32_t;
+
+
+/**
+ * Global registry of interned strings.
+ *
+ * Every distinct string is stored exactly once and is assigned a 32-bit ID.
+ * Interned strings are never removed, so views of them stay valid for the
+ * lifetime of the program. All methods are thread-safe.
+ */
+class SymbolTable {
+public:
+	/**
+	 * Get the global symbol table.
+	 *
+	 * @return Symbol table.
+	 */
+	static SymbolTable &get();
+
+	/**
+	 * Intern a string.
+	 *
+	 * @param str String to intern.
+	 *
+	 * @return ID of the interned string.
+	 */
+	symbol_id_t intern(std::string_view str);
+
+	/**
+	 * Get the interned string for an ID.
+	 *
+	 * This does not lock and is safe to call concurrently with \p intern().
+	 *
+	 * @param id ID returned by \p intern().
+	 *
+	 * @return Interned string.
+	 */
+	const std::string &lookup(symbol_id_t id) const {
+		return this->chunks[id / chunk_size].load(std::memory_order_acquire)[id % chunk_size];
+	}
+
+	/**
+	 * Get the number of interned strings.
+	 *
+	 * @return Number of symbols.
+	 */
+	size_t size() const;
+
+	/**
+	 * Estimate the memory used by the table (in bytes).
+	 *
+	 * @return Memory usage.
+	 */
+	size_t get_memory_usage() const;
+
+private:
+	SymbolTable();
+	~SymbolTable() = default;
+
+	SymbolTable(const SymbolTable &) = delete;
+	SymbolTable &operator=(const SymbolTable &) = delete;
+
+	/**
+	 * Number of strings per storage chunk.
+	 */
+	static constexpr size_t chunk_size = 4096;
+
+	/**
+	 * Maximum number of storage chunks.
+	 */
+	static constexpr size_t max_chunks = 4096;
+
+	/**
+	 * Storage chunks of the interned strings. Chunks are never moved or freed,
+	 * so strings can be read without locking.
+	 */
+	std::array<std::atomic<std::string *>, max_chunks> chunks;
+
+	/**
+	 * Lookup of symbol IDs by string. The keys view the stored strings.
+	 */
+	std::unordered_map<std::string_view, symbol_id_t> ids;
+
+	/**
+	 * Number of interned strings.
+	 */
+	size_t count;
+
+	/**
+	 * Total number of characters of the interned strings.
+	 */
+	size_t chars;
+
+	/**
+	 * Mutex for protecting threaded access.
+	 */
+	mutable std::shared_mutex mutex;
+};
+
+
+/**
+ * Interned string.
+ *
+ * A symbol is a 32-bit handle to a string in the global \p SymbolTable.
+ * Copying, comparing and hashing symbols does not touch the string data.
+ * The empty string always has ID 0.
+ */
+class Symbol {
+public:
+	/**
+	 * Create a symbol for the empty string.
+	 */
+	constexpr Symbol() :
+		id{0} {}
+
+	/**
+	 * Create a symbol by interning a string.
+	 *
+	 * @param str String to intern.
+	 */
+	explicit Symbol(std::string_view str) :
+		id{SymbolTable::get().intern(str)} {}
+
+	/**
+	 * Get the ID of the symbol.
+	 *
+	 * @return Symbol ID.
+	 */
+	constexpr symbol_id_t get_id() const {
+		return this->id;
+	}
+
+	/**
+	 * Get the interned string.
+	 *
+	 * @return Interned string. The reference stays valid for the lifetime of the program.
+	 */
+	const std::string &str() const {
+		return SymbolTable::get().lookup(this->id);
+	}
+
+	/**
+	 * Get a view of the interned string.
+	 *
+	 * @return View of the interned string.
+	 */
+	std::string_view view() const {
+		return this->str();
+	}
+
+	/**
+	 * Check if this is the symbol of the empty string.
+	 *
+	 * @return true if the string is empty, else false.
+	 */
+	constexpr bool empty() const {
+		return this->id == 0;
+	}
+
+	constexpr bool operator==(const Symbol &other) const = default;
+
+	/**
+	 * Order by ID. This is not the lexicographic order of the strings.
+	 */
+	constexpr bool operator<(const Symbol &other) const {
+		return this->id < other.id;
+	}
+
+private:
+	/**
+	 * ID of the interned string.
+	 */
+	symbol_id_t id;
+};
+
+
+std::ostream &operator<<(std::ostream &out, const Symbol &symbol);
+
+} // namespace openage::util
+
+
+namespace std {
+
+template <>
+struct hash<openage::util::Symbol> {
+	size_t operator()(const openage::util::Symbol &symbol) const {
+		return std::hash<openage::util::symbol_id_t>{}(symbol.get_id());
+	}
+};
+
+} // namespace std
@@ -0,0 +1,119 @@
+// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+#include "symbol.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "log/log.h"
+#include "log/message.h"
+#include "testing/testing.h"
+
+
+namespace openage::util::tests {
+
+void symbol() {
+	Symbol empty;
+	empty.empty() or TESTFAIL;
+	TESTEQUALS(empty.get_id(), 0);
+	TESTEQUALS(empty.str(), "");
+	(Symbol{""} == empty) or TESTFAIL;
+
+	Symbol a{"graphics/knight/idle.sprite"};
+	Symbol b{std::string{"graphics/knight/"} + "idle.sprite"};
+	Symbol c{"graphics/knight/move.sprite"};
+
+	// equal strings get the same ID
+	(a == b) or TESTFAIL;
+	(a != c) or TESTFAIL;
+	(not a.empty()) or TESTFAIL;
+	TESTEQUALS(a.str(), "graphics/knight/idle.sprite");
+	TESTEQUALS(std::string{c.view()}, "graphics/knight/move.sprite");
+
+	// views stay valid while more strings are interned
+	auto view = a.view();
+	auto data = view.data();
+	for (size_t i = 0; i < 10000; ++i) {
+		Symbol{"symbol_test_" + std::to_string(i)};
+	}
+	TESTEQUALS(a.view().data(), data);
+	TESTEQUALS(std::string{view}, "graphics/knight/idle.sprite");
+
+	// concurrent interning of the same strings yields the same IDs
+	std::vector<std::vector<symbol_id_t>> results(4);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < results.size(); ++t) {
+		threads.emplace_back([&results, t]() {
+			for (size_t i = 0; i < 1000; ++i) {
+				results[t].push_back(Symbol{"symbol_thread_" + std::to_string(i)}.get_id());
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	for (size_t t = 1; t < results.size(); ++t) {
+		(results[t] == results[0]) or TESTFAIL;
+	}
+	for (size_t i = 0; i < 1000; ++i) {
+		TESTEQUALS(SymbolTable::get().lookup(results[0][i]), "symbol_thread_" + std::to_string(i));
+	}
+}
+
+
+void symbol_benchmark() {
+	const size_t distinct = 500;
+	const size_t entities = 100000;
+	const size_t lookups = 1000000;
+
+	// animation paths of entities, many entities share the same path
+	std::vector<std::string> paths;
+	for (size_t i = 0; i < distinct; ++i) {
+		paths.push_back("data/game_entity/generic/unit_" + std::to_string(i)
+		                + "/graphics/idle_" + std::to_string(i) + ".sprite");
+	}
+
+	std::vector<std::string> string_paths;
+	std::vector<Symbol> symbol_paths;
+	size_t string_memory = 0;
+	for (size_t i = 0; i < entities; ++i) {
+		auto &path = paths[i % distinct];
+		string_paths.push_back(path);
+		string_memory += sizeof(std::string) + path.capacity() + 1;
+		symbol_paths.emplace_back(path);
+	}
+	size_t symbol_memory = entities * sizeof(Symbol);
+
+	std::unordered_map<std::string, size_t> string_cache;
+	std::unordered_map<Symbol, size_t> symbol_cache;
+	for (size_t i = 0; i < distinct; ++i) {
+		string_cache.emplace(paths[i], i);
+		symbol_cache.emplace(Symbol{paths[i]}, i);
+	}
+
+	size_t found = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < lookups; ++i) {
+		found += string_cache.at(string_paths[i % entities]);
+	}
+	auto string_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < lookups; ++i) {
+		found -= symbol_cache.at(symbol_paths[i % entities]);
+	}
+	auto symbol_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+	TESTEQUALS(found, 0);
+
+	log::log(MSG(info) << entities << " entities with " << distinct << " distinct paths");
+	log::log(MSG(info) << "  memory: " << string_memory / 1024 << " KiB as std::string, "
+	                   << symbol_memory / 1024 << " KiB as Symbol (+ "
+	                   << SymbolTable::get().get_memory_usage() / 1024 << " KiB symbol table)");
+	log::log(MSG(info) << "  lookup: " << string_time.count() * 1e9 / lookups << " ns by std::string, "
+	                   << symbol_time.count() * 1e9 / lookups << " ns by Symbol");
+}
+
+} // namespace openage::util::tests
@@ -6,4 +6,7 @@ files (not to be confused with InstallShield CAB files, which are
 totally different).
 
 It allows converting media directly from the Age of Empires setup disk.
+
+nativecab wraps the C++ reader, which is used for all cabinets that are
+native files; cab.CABFile reads cabinets from any file-like object.
 """
@@ -0,0 +1,209 @@
+# Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+"""
+Python interface for the C++ CAB reader (libopenage/util/fslike/cab.h).
+
+The C++ reader maps the cabinet and decompresses its folders natively,
+which is much faster than CABFile from cab.py. It can only open cabinets
+that are files of the native filesystem; open_cab() falls back to CABFile
+for all others.
+"""
+
+from io import BytesIO
+import os
+
+from libcpp.memory cimport shared_ptr, make_shared, unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from libopenage.job.job_manager cimport JobManager
+from libopenage.util.file cimport File as File_cpp
+from libopenage.util.fslike.cab cimport CAB as CAB_cpp
+from libopenage.util.fslike.directory cimport Directory as Directory_cpp
+from libopenage.util.path cimport Path as Path_cpp
+
+from ..log import dbg
+from ..util.filelike.stream import StreamFragment
+from ..util.fslike.abstract import ReadOnlyFSLikeObject
+from .cab import CABFile
+
+
+cdef class CABReader:
+    """
+    Wraps a C++ fslike::CAB object.
+
+    Constructor arguments:
+
+    @param native_path:
+        Native path of the cabinet file.
+    """
+
+    # the C++ cabinet
+    cdef shared_ptr[CAB_cpp] cab
+
+    def __cinit__(self, bytes native_path):
+        self.cab = make_shared[CAB_cpp](<string> native_path)
+
+    def is_file(self, parts):
+        return self.cab.get().is_file(parts)
+
+    def is_dir(self, parts):
+        return self.cab.get().is_dir(parts)
+
+    def list(self, parts):
+        cdef vector[string] names = self.cab.get().list(parts)
+        return names
+
+    def read(self, parts):
+        """
+        Returns the contents of a file as bytes.
+        """
+        cdef File_cpp file = self.cab.get().open_r(parts)
+        cdef string data
+        with nogil:
+            data = file.read()
+        return data
+
+    def filesize(self, parts):
+        return self.cab.get().get_filesize(parts)
+
+    def mtime(self, parts):
+        return self.cab.get().get_mtime(parts)
+
+    def folder_count(self):
+        return self.cab.get().get_folder_count()
+
+    def extract(self, bytes native_target, int jobs=0):
+        """
+        Extracts all files to a native directory, which is created if it
+        doesn't exist.
+
+        The folders of the cabinet are decompressed in parallel
+        by the given number of worker threads.
+        If jobs is 0, all folders are decompressed in this thread.
+        """
+        cdef shared_ptr[Directory_cpp] target
+        target = make_shared[Directory_cpp](<string> native_target, True)
+        cdef Path_cpp target_path = target.get().root()
+
+        cdef unique_ptr[JobManager] job_manager
+        if jobs > 0:
+            job_manager.reset(new JobManager(jobs))
+            job_manager.get().start()
+
+        try:
+            with nogil:
+                self.cab.get().extract(target_path, job_manager.get())
+        finally:
+            if jobs > 0:
+                job_manager.get().stop()
+
+
+class NativeCABFile(ReadOnlyFSLikeObject):
+    """
+    Filesystem-like object for a cabinet that is read by the C++ reader.
+
+    It behaves like CABFile, but it can only open native files.
+
+    Constructor arguments:
+
+    @param native_path:
+        Native path of the cabinet file.
+    """
+
+    def __init__(self, native_path):
+        super().__init__()
+
+        if isinstance(native_path, str):
+            native_path = native_path.encode()
+
+        self.reader = CABReader(native_path)
+
+    def __repr__(self):
+        return "NativeCABFile"
+
+    def check_file(self, parts):
+        """
+        Raises the same errors as FileCollection for anything
+        that is not a file.
+        """
+        if self.reader.is_dir(parts):
+            raise IsADirectoryError(b"/".join(parts))
+
+        if not self.reader.is_file(parts):
+            raise FileNotFoundError(b"/".join(parts))
+
+    def open_r(self, parts):
+        self.check_file(parts)
+        data = self.reader.read(parts)
+        return StreamFragment(BytesIO(data), 0, len(data))
+
+    def list(self, parts):
+        if not self.reader.is_dir(parts):
+            raise FileNotFoundError(
+                "No such directory: " +
+                b"/".join(parts).decode(errors='replace'))
+
+        names = self.reader.list(parts)
+
+        # subdirectories first, like CABFile
+        yield from (name for name in names if self.reader.is_dir(list(parts) + [name]))
+        yield from (name for name in names if self.reader.is_file(list(parts) + [name]))
+
+    def filesize(self, parts):
+        self.check_file(parts)
+        return self.reader.filesize(parts)
+
+    def mtime(self, parts):
+        self.check_file(parts)
+        return self.reader.mtime(parts)
+
+    def is_file(self, parts):
+        return self.reader.is_file(parts)
+
+    def is_dir(self, parts):
+        return self.reader.is_dir(parts)
+
+    def watch(self, parts, callback):
+        del parts, callback  # unused
+        return False
+
+    def poll_watches(self):
+        pass
+
+    def extract(self, target, jobs=None):
+        """
+        Extracts all files to the target path,
+        decompressing the folders in parallel.
+
+        @param target:
+            Path of the target directory.
+        @param jobs:
+            Number of worker threads, by default one per CPU.
+        """
+        native_target = target.resolve_native_path_w()
+        if native_target is None:
+            raise ValueError(f"can only extract to native directories: {target}")
+
+        if isinstance(native_target, str):
+            native_target = native_target.encode()
+
+        if jobs is None:
+            jobs = os.cpu_count() or 1
+
+        self.reader.extract(native_target, jobs)
+
+
+def open_cab(path):
+    """
+    Opens a cabinet file with the C++ reader if it is a native file,
+    or else with CABFile.
+
+    Returns the filesystem-like object of the cabinet.
+    """
+    native_path = path.resolve_native_path()
+    if native_path is not None:
+        return NativeCABFile(native_path)
+
+    dbg("cabinet is not a native file, using the python reader: %s", path)
+    return CABFile(path.open('rb'))
@@ -1,4 +1,4 @@
-# Copyright 2015-2022 the openage authors. See copying.md for legal info.
+# Copyright 2015-2023 the openage authors. See copying.md for legal info.
 """
 Downloads the SFT test cab archive and uses it to test the cabextract code.
 """
@@ -6,11 +6,12 @@ from __future__ import annotations
 import typing
 
 import os
-from tempfile import gettempdir
+from tempfile import gettempdir, TemporaryDirectory
 from hashlib import md5
 from urllib.request import urlopen
 
 from .cab import CABFile
+from .nativecab import NativeCABFile
 
 if typing.TYPE_CHECKING:
     from io import BufferedReader
@@ -66,10 +67,32 @@ def test():
     """
     The actual test function; registered in openage.testing.testlist.
     """
-    from ..testing.testing import assert_value, assert_raises, result
+    from ..testing.testing import assert_value
+    from ..util.fslike.directory import Directory
+
+    # acquire the actual test archive file and test both readers
+    test_cab(CABFile(open_test_archive()).root)
+
+    open_test_archive().close()
+    native_cab = NativeCABFile(TEST_ARCHIVE_FILENAME)
+    test_cab(native_cab.root)
+
+    # extract with the native reader
+    with TemporaryDirectory() as tmpdir:
+        native_cab.extract(Directory(tmpdir).root)
+
+        for filename, (md5sum, _) in TEST_FILES.items():
+            with open(os.path.join(tmpdir, filename), 'rb') as extracted:
+                assert_value(md5(extracted.read()).hexdigest(), md5sum)
 
-    # acquire the actual test archive file and create the CABFile Path object
-    cab = CABFile(open_test_archive()).root
+
+def test_cab(cab):
+    """
+    Tests a cabinet reader with the test archive.
+
+    @param cab: Root path of the test archive.
+    """
+    from ..testing.testing import assert_value, assert_raises, result
 
     testdir = cab["..////./../testdir"]
     nonexistingdir = cab["nonexistingdir"]
@@ -6,6 +6,7 @@
 Holds the game entry point for openage.
 """
 from __future__ import annotations
+import os
 import typing
 
 
@@ -32,6 +33,15 @@ def init_subparser(cli: ArgumentParser) -> None:
         "--modpacks", nargs="+", type=bytes,
         help="list of modpacks to load")
 
+    cli.add_argument(
+        "--record-journal", metavar="FILE",
+        help="record all player input in a command journal file")
+
+    cli.add_argument(
+        "--replay", metavar="FILE",
+        help=("replay a command journal headlessly at maximum speed "
+              "and verify the recorded state checkpoints"))
+
 
 def main(args, error):
     """
@@ -42,12 +52,13 @@ def main(args, error):
 
     # we have to import stuff inside the function
     # as it depends on generated/compiled code
-    from .main_cpp import run_game
+    from .main_cpp import run_game, replay_journal
     from .. import config
     from ..assets import get_asset_path
     from ..convert.main import conversion_required, convert_assets
     from ..cppinterface.setup import setup as cpp_interface_setup
     from ..cvar.location import get_config_path
+    from ..util.fslike.directory import Directory
     from ..util.fslike.union import Union
 
     # initialize libopenage
@@ -100,5 +111,20 @@ def main(args, error):
 
         args.modpacks = mods
 
+    # command journal files can be anywhere in the file system
+    def journal_file(path, create_dir):
+        journal_dir, journal_name = os.path.split(os.path.abspath(path))
+        return Directory(journal_dir, create_if_missing=create_dir).root[journal_name]
+
+    if args.replay:
+        if not os.path.isfile(args.replay):
+            err("command journal '%s' does not exist", args.replay)
+            return 1
+
+        return replay_journal(root, journal_file(args.replay, False))
+
+    if args.record_journal:
+        args.record_journal = journal_file(args.record_journal, True)
+
     # start the game, continue in main_cpp.pyx!
     return run_game(args, root)
@@ -6,6 +6,7 @@ from libopenage.main cimport main_arguments, run_game as run_game_cpp
 from libopenage.util.path cimport Path as Path_cpp
 from libopenage.pyinterface.pyobject cimport PyObj
 from libopenage.error.handlers cimport set_exit_ok
+from libopenage.gamestate.replay cimport replay_journal_file
 
 
 def run_game(args, root_path):
@@ -32,6 +33,12 @@ def run_game(args, root_path):
         # opengl debugging
         args_cpp.gl_debug = args.gl_debug
 
+        # command journal recording
+        args_cpp.record_journal = bool(args.record_journal)
+        if args.record_journal:
+            args_cpp.journal_path = Path_cpp(PyObj(<PyObject*>args.record_journal.fsobj),
+                                             args.record_journal.parts)
+
         # run the game!
         with nogil:
             result = run_game_cpp(args_cpp)
@@ -39,3 +46,19 @@ def run_game(args, root_path):
         return result
     finally:
         set_exit_ok(True)
+
+
+def replay_journal(root_path, journal_path):
+    """
+    Replays a recorded command journal headlessly and verifies
+    the recorded state checkpoints.
+    """
+    cdef Path_cpp root_cpp = Path_cpp(PyObj(<PyObject*>root_path.fsobj),
+                                      root_path.parts)
+    cdef Path_cpp journal_cpp = Path_cpp(PyObj(<PyObject*>journal_path.fsobj),
+                                         journal_path.parts)
+
+    with nogil:
+        replay_journal_file(root_cpp, journal_cpp)
+
+    return 0
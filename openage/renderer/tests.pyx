@@ -10,6 +10,7 @@ from libopenage.util.path cimport Path as Path_cpp
 from libopenage.pyinterface.pyobject cimport PyObj
 from cpython.ref cimport PyObject
 from libopenage.renderer.demo.tests cimport renderer_demo as renderer_demo_c
+from libopenage.renderer.demo.stages_benchmark cimport renderer_stages_benchmark as renderer_stages_benchmark_c
 
 def renderer_demo(list argv):
     """
@@ -48,3 +49,22 @@ def renderer_demo(list argv):
 
     with nogil:
         renderer_demo_c(renderer_test_id, root_cpp)
+
+
+def stages_benchmark():
+    """
+    measures the CPU time of the render stages with 10k world
+    entities, using the headless null renderer.
+    """
+
+    from ..assets import get_asset_path
+    from ..util.fslike.union import Union
+
+    root = Union().root
+    root["assets"].mount(get_asset_path(None))
+
+    cdef Path_cpp root_cpp = Path_cpp(PyObj(<PyObject*>root.fsobj),
+                                      root.parts)
+
+    with nogil:
+        renderer_stages_benchmark_c(root_cpp, 10000, 100)
@@ -0,0 +1,59 @@
+# Copyright 2023-2023 the openage authors. See copying.md for legal info.
+
+"""
+Offline encoders for texture bundles.
+"""
+
+from libcpp cimport bool as cppbool
+
+from libopenage.util.path cimport Path as Path_cpp
+from libopenage.pyinterface.pyobject cimport PyObj
+from cpython.ref cimport PyObject
+from libopenage.renderer.resources.texture_bundle cimport encode_texture_bundle as encode_texture_bundle_c, \
+    encode_indexed_texture_bundle as encode_indexed_texture_bundle_c
+
+
+def encode_texture_bundle(image_path, bundle_path, use_alpha=True):
+    """
+    Encodes an image into a block-compressed texture bundle (.ctex)
+    that can be loaded by the renderer without decoding.
+
+    :param image_path: Path to the source image, e.g. a PNG file.
+    :type image_path: openage.util.fslike.path.Path
+    :param bundle_path: Output path of the texture bundle.
+    :type bundle_path: openage.util.fslike.path.Path
+    :param use_alpha: Encode with full alpha (BC3) instead of 1 bit alpha (BC1).
+    :type use_alpha: bool
+    """
+    cdef Path_cpp image_cpp = Path_cpp(PyObj(<PyObject*>image_path.fsobj),
+                                       image_path.parts)
+    cdef Path_cpp bundle_cpp = Path_cpp(PyObj(<PyObject*>bundle_path.fsobj),
+                                        bundle_path.parts)
+    cdef cppbool alpha = use_alpha
+
+    with nogil:
+        encode_texture_bundle_c(image_cpp, bundle_cpp, alpha)
+
+
+def encode_indexed_texture_bundle(image_path, palette_path, bundle_path):
+    """
+    Encodes an image into a texture bundle (.ctex) that stores
+    palette indices instead of colors. The colors are resolved
+    by the renderer when the texture is drawn.
+
+    :param image_path: Path to the source image, e.g. a PNG file.
+    :type image_path: openage.util.fslike.path.Path
+    :param palette_path: Path to the palette definition file (.opal).
+    :type palette_path: openage.util.fslike.path.Path
+    :param bundle_path: Output path of the texture bundle.
+    :type bundle_path: openage.util.fslike.path.Path
+    """
+    cdef Path_cpp image_cpp = Path_cpp(PyObj(<PyObject*>image_path.fsobj),
+                                       image_path.parts)
+    cdef Path_cpp palette_cpp = Path_cpp(PyObj(<PyObject*>palette_path.fsobj),
+                                         palette_path.parts)
+    cdef Path_cpp bundle_cpp = Path_cpp(PyObj(<PyObject*>bundle_path.fsobj),
+                                        bundle_path.parts)
+
+    with nogil:
+        encode_indexed_texture_bundle_c(image_cpp, palette_cpp, bundle_cpp)
@@ -66,6 +66,9 @@ def benchmark_py():
     yield ("openage.testing.benchmark.benchmark_test_function",
            "Benchmark yourself")
 
+    yield ("openage.renderer.tests.stages_benchmark",
+           "CPU time of the render stages with the null renderer")
+
 
 def tests_cpp():
     """
@@ -76,16 +79,29 @@ def tests_cpp():
     """
 
     yield "openage::coord::tests::coord"
+    yield "openage::datastructure::tests::chunked_spsc_queue"
     yield "openage::datastructure::tests::concurrent_queue"
     yield "openage::datastructure::tests::constexpr_map"
+    yield "openage::datastructure::tests::flat_hash_map"
+    yield "openage::datastructure::tests::mpmc_queue"
+    yield "openage::datastructure::tests::object_pool"
     yield "openage::datastructure::tests::pairing_heap"
+    yield "openage::datastructure::tests::spsc_queue"
     yield "openage::job::tests::test_job_manager"
     yield "openage::path::tests::path_node", "pathfinding"
     yield "openage::pyinterface::tests::pyobject"
     yield "openage::pyinterface::tests::err_py_to_cpp"
     yield "openage::renderer::tests::font"
     yield "openage::renderer::tests::font_manager"
+    yield "openage::renderer::null::tests::uniform_upload"
+    yield "openage::renderer::resources::tests::asset_cache"
+    yield "openage::renderer::resources::tests::frame_encoder"
+    yield "openage::renderer::resources::tests::palette_lookup"
+    yield "openage::renderer::resources::tests::texture_compression"
+    yield "openage::renderer::world::tests::frustum_culling"
+    yield "openage::renderer::world::tests::render_entity_deltas"
     yield "openage::rng::tests::run"
+    yield "openage::trace::tests::trace"
     yield "openage::util::tests::constinit_vector"
     yield "openage::util::tests::enum_"
     yield "openage::util::tests::fixed_point"
@@ -94,11 +110,28 @@ def tests_cpp():
     yield "openage::util::tests::quaternion"
     yield "openage::util::tests::vector"
     yield "openage::util::tests::siphash"
+    yield "openage::util::tests::symbol"
     yield "openage::util::tests::array_conversion"
+    yield "openage::util::tests::file_buffer"
+    yield "openage::util::fslike::tests::union_fslike"
+    yield "openage::util::fslike::tests::pack_roundtrip"
+    yield "openage::util::fslike::tests::pack_invalid"
+    yield "openage::util::fslike::tests::cab_archive"
     yield "openage::input::legacy::tests::parse_event_string", "keybinds parsing"
     yield "openage::curve::tests::container"
     yield "openage::curve::tests::curve_types"
     yield "openage::event::tests::eventtrigger"
+    yield "openage::event::tests::virtual_time"
+    yield "openage::event::tests::parallel_execution"
+    yield "openage::event::tests::parallel_repeat_order"
+    yield "openage::event::tests::profiling"
+    yield "openage::event::tests::batch_dispatch"
+    yield "openage::gamestate::tests::command_journal"
+    yield "openage::gamestate::tests::compiled_activity"
+    yield "openage::gamestate::tests::entity_prototypes"
+    yield "openage::gamestate::tests::journal_replay"
+    yield "openage::gamestate::tests::nyan_loader"
+    yield "openage::gamestate::tests::spawn_entities"
 
 
 def demos_cpp():
@@ -132,3 +165,35 @@ def benchmark_cpp():
 
     # TODO Add a real benchmark here!
     yield ("openage::test::benchmark", "Test the benchmark")
+    yield ("openage::datastructure::tests::flat_hash_map_benchmark",
+           "Insert, lookup, erase and iteration of flat hash maps vs. std::unordered_map")
+    yield ("openage::datastructure::tests::queue_benchmark",
+           "Throughput of lock-free bounded queues vs. ConcurrentQueue")
+    yield ("openage::datastructure::tests::object_pool_benchmark",
+           "Allocation count and time of pooled vs. heap-allocated objects")
+    yield ("openage::event::tests::parallel_benchmark",
+           "Serial vs. parallel execution of target local events")
+    yield ("openage::event::tests::dispatch_benchmark",
+           "Dispatch overhead of single vs. batched event invocation")
+    yield ("openage::gamestate::tests::activity_benchmark",
+           "Advances per second through a compiled activity graph")
+    yield ("openage::gamestate::tests::spawn_benchmark",
+           "Spawn throughput of single vs. batched entity creation")
+    yield ("openage::gamestate::tests::nyan_load_benchmark",
+           "Serial vs. read-ahead loading of a synthetic modpack")
+    yield ("openage::trace::tests::trace_benchmark",
+           "Overhead of disabled and enabled trace zones and counters")
+    yield ("openage::util::tests::symbol_benchmark",
+           "Memory and lookup cost of interned vs. plain path strings")
+    yield ("openage::util::fslike::tests::union_benchmark",
+           "Path lookups of the indexed union vs. a native directory")
+    yield ("openage::util::fslike::tests::pack_benchmark",
+           "Read throughput of an asset pack vs. loose files")
+    yield ("openage::util::fslike::tests::cab_benchmark",
+           "Serial vs. parallel CAB extraction and cached random access")
+    yield ("openage::util::tests::file_buffer_benchmark",
+           "Line splitting of mapped vs. copied sprite files")
+    yield ("openage::renderer::resources::tests::frame_encoder_benchmark",
+           "PNG and raw encoding time of a synthetic 1080p frame")
+    yield ("openage::renderer::world::tests::update_benchmark",
+           "Render entity update throughput of curve sync vs. delta channel")